@@ -1,6 +1,6 @@
 #!/bin/sh
 
-components="libvmcore libvmasm libvarvm vm vasm vexe tcc"
+components="libvmcore libvarshm libvmasm libvarvm vm vasm vexe vmd vaot tcc"
 
 for component in $components
 do
@@ -0,0 +1,1397 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+
+/*!
+ * @defgroup libvarshm libvarshm
+ * @brief Shared object library to share variables through shared memory
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file libvarshm.c
+
+    Share variables between Virtual Machines through shared memory
+
+    The Variable Shared Memory library provides a mechanism to allow
+    virtual machines running in different processes on the same host
+    to set/get variables without a variable server.  The variables are
+    stored in a fixed size table of slots in a named POSIX shared memory
+    segment, which is created by the first process to use it.
+
+    Variables in the tiny-c application which are declared "extern"
+    will be linked to the shared memory segment.  A variable is created
+    the first time its name is referenced.
+
+    Each slot is protected by a sequence lock.  Readers never block:
+    they copy the slot and retry if a writer changed it during the copy.
+    Writers update the slot with atomic stores, and then send a MODIFIED
+    notification to each process which requested one for the variable.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vmcore/externvars.h>
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+#ifndef EOK
+/*! success response */
+#define EOK 0
+#endif
+
+/*! environment variable which overrides the shared memory segment name */
+#define VARSHM_NAME_ENV "VARSHM_NAME"
+
+/*! default name of the shared memory segment */
+#define VARSHM_DEFAULT_NAME "/varshm"
+
+/*! identifies a shared memory segment with this slot table layout */
+#define VARSHM_MAGIC ( 0x56534D01 )
+
+/*! number of variable slots in the shared memory segment.
+    This must be a power of 2 */
+#define VARSHM_MAX_VARS ( 1024 )
+
+/*! maximum length of a variable name including its NUL terminator */
+#define VARSHM_NAME_LEN ( 64 )
+
+/*! maximum length of a string value including its NUL terminator.
+    This must be a multiple of 4 */
+#define VARSHM_STR_LEN ( 256 )
+
+/*! maximum number of processes notified when a variable is modified */
+#define VARSHM_MAX_NOTIFY ( 8 )
+
+/*! signal which delivers a MODIFIED notification, with the variable
+    handle as its value.  It is the signal used by the variable server,
+    so programs waiting in WFS receive it unchanged */
+#define VARSHM_SIG_MODIFIED ( SIGRTMIN+6 )
+
+/*! number of failed attempts to read a slot before yielding the CPU */
+#define VARSHM_SPIN ( 64 )
+
+/*! slot state: the slot is not used */
+#define VARSHM_SLOT_FREE ( 0 )
+
+/*! slot state: a process is writing the name of a new variable */
+#define VARSHM_SLOT_CLAIMED ( 1 )
+
+/*! slot state: the slot holds a variable */
+#define VARSHM_SLOT_READY ( 2 )
+
+/*==============================================================================
+        Type Definitions
+==============================================================================*/
+
+/*! The VarShmSlot structure holds one variable in the shared memory
+    segment.  A zero filled slot is unused. */
+typedef struct _VarShmSlot
+{
+    /*! VARSHM_SLOT_xxx state of the slot */
+    _Atomic uint32_t state;
+
+    /*! sequence lock counter, which is odd while the value is written */
+    _Atomic uint32_t seq;
+
+    /*! hash of the variable name */
+    uint32_t hash;
+
+    /*! variable name, which does not change once the slot is ready */
+    char name[VARSHM_NAME_LEN];
+
+    /*! EXTERNVAR_TYPE_xxx type of the value */
+    _Atomic uint32_t type;
+
+    /*! 32-bit integer or floating point value */
+    _Atomic uint32_t val;
+
+    /*! length of the string value */
+    _Atomic uint32_t len;
+
+    /*! string value, stored as 32-bit words */
+    _Atomic uint32_t str[VARSHM_STR_LEN / sizeof( uint32_t )];
+
+    /*! process ids to notify when the variable is modified (0=unused) */
+    _Atomic pid_t notify[VARSHM_MAX_NOTIFY];
+} VarShmSlot;
+
+/*! The VarShmTable structure is the layout of the shared memory segment.
+    The segment is zero filled when it is created, which is a valid
+    empty table, so it needs no initialization by its creator. */
+typedef struct _VarShmTable
+{
+    /*! set to VARSHM_MAGIC by the first process to map the segment */
+    _Atomic uint32_t magic;
+
+    /*! variable slots, where slot[i] holds the variable with handle i+1 */
+    VarShmSlot slot[VARSHM_MAX_VARS];
+} VarShmTable;
+
+/*! The VarShm structure is an opaque structure which is shared with the
+    VM (returned via the init() function) which allows the shared memory
+    link to be re-entrant since the VarShm structure is passed to each
+    function. */
+typedef struct _VarShm
+{
+    /*! mapping of the shared memory segment */
+    VarShmTable *pTable;
+
+    /*! process id sent with notification requests */
+    pid_t pid;
+
+    /*! copy of the last string value returned by varshm_fnGetString */
+    uint32_t str[VARSHM_STR_LEN / sizeof( uint32_t )];
+} VarShm;
+
+/*! The VarShmValue structure is a consistent copy of a variable value */
+typedef struct _VarShmValue
+{
+    /*! EXTERNVAR_TYPE_xxx type of the value */
+    uint32_t type;
+
+    /*! 32-bit integer or floating point value */
+    union
+    {
+        /*! 32-bit integer value */
+        uint32_t ul;
+
+        /*! floating point value */
+        float f;
+    } val;
+} VarShmValue;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+tzEXTVARAPI *getapi(void);
+int getapiversion(void);
+void *init( void );
+int shutdown( void *pExt );
+
+static uint32_t varshm_fnGetHandle( void *pExt, char *name );
+static void varshm_fnSet( void *pExt, uint32_t handle, uint32_t val );
+static void varshm_fnSetFloat( void *pExt, uint32_t handle, float val );
+static void varshm_fnSetString( void *pExt, uint32_t handle, char * val );
+static uint32_t varshm_fnGet( void *pExt, uint32_t handle );
+static float varshm_fnGetFloat( void *pExt, uint32_t handle );
+static char *varshm_fnGetString( void *pExt, uint32_t handle );
+static int varshm_fnNotify( void *pExt, uint32_t handle, uint32_t request );
+static int varshm_fnValidateStart( void *pExt,
+                                   uint32_t handle,
+                                   uint32_t *hVar );
+static int varshm_fnValidateEnd( void *pExt, uint32_t handle, int result );
+
+static int varshm_fnOpenPrintSession( void *pExt,
+                                      uint32_t handle,
+                                      uint32_t *hVar,
+                                      int *fd );
+
+static int varshm_fnClosePrintSession( void *pExt, uint32_t handle, int fd );
+
+static int varshm_fnGetMany( void *pExt, tzExternValue *pValues, size_t n );
+static int varshm_fnSetMany( void *pExt, tzExternValue *pValues, size_t n );
+static int varshm_fnGetHandles( void *pExt,
+                                char **ppNames,
+                                uint32_t *pHandles,
+                                size_t n );
+
+static VarShmSlot *varshm_fnSlot( VarShm *pVarShm, uint32_t handle );
+static uint32_t varshm_fnHash( char *name );
+static void varshm_fnWriteBegin( VarShmSlot *pSlot );
+static void varshm_fnWriteEnd( VarShm *pVarShm,
+                               VarShmSlot *pSlot,
+                               uint32_t handle );
+static void varshm_fnRead( VarShmSlot *pSlot, VarShmValue *pValue );
+static void varshm_fnWrite( VarShm *pVarShm,
+                            uint32_t handle,
+                            uint32_t type,
+                            uint32_t val );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/* getapi                                                                     */
+/*!
+    Get a pointer to the VARSHM API functions
+
+    The getapi function is a public function which is expected to be
+    present by the VM core.  The VM core will call this function
+    to get a handle to the API functions for manipulating variables
+
+    @return a pointer to the variable manipulation functions
+
+==============================================================================*/
+tzEXTVARAPI *getapi(void)
+{
+    static tzEXTVARAPI varshmAPI = {
+            varshm_fnGetHandle,
+            varshm_fnSet,
+            varshm_fnSetFloat,
+            varshm_fnSetString,
+            varshm_fnGet,
+            varshm_fnGetFloat,
+            varshm_fnGetString,
+            varshm_fnNotify,
+            varshm_fnValidateStart,
+            varshm_fnValidateEnd,
+            varshm_fnOpenPrintSession,
+            varshm_fnClosePrintSession,
+            varshm_fnGetMany,
+            varshm_fnSetMany,
+            varshm_fnGetHandles
+    };
+
+    return &varshmAPI;
+}
+
+/*============================================================================*/
+/*  getapiversion                                                             */
+/*!
+    Get the version of the VARSHM API functions
+
+    The getapiversion function is a public function which is used by the
+    VM core to find out which entries of the API list returned by getapi()
+    are present.
+
+    @return the EXTERNVAR_API_VERSION the library was built with
+
+==============================================================================*/
+int getapiversion(void)
+{
+    return EXTERNVAR_API_VERSION;
+}
+
+/*============================================================================*/
+/*  init                                                                      */
+/*!
+    Initialize VARSHM API library
+
+    The init function is a public function which is expected to be
+    present by the VM core.  The VM core will call this function
+    to initialize the variable handling library.
+
+    It opens the shared memory segment named by the VARSHM_NAME
+    environment variable (default /varshm), creating it if it does not
+    exist, and maps it into the process.
+
+    @retval pointer to the library instance (VarShm *)
+    @retval NULL unable to initialize the library
+
+==============================================================================*/
+void *init( void )
+{
+    VarShm *pVarShm;
+    char *name;
+    struct stat sb;
+    uint32_t magic = 0;
+    void *p = MAP_FAILED;
+    int fd;
+
+    name = getenv( VARSHM_NAME_ENV );
+    if( name == NULL )
+    {
+        name = VARSHM_DEFAULT_NAME;
+    }
+
+    pVarShm = calloc( 1, sizeof( VarShm ) );
+    fd = shm_open( name, O_RDWR | O_CREAT, 0660 );
+    if( ( pVarShm != NULL ) && ( fd != -1 ) )
+    {
+        /* every process sizes the segment the same way, so it does not
+           matter which one creates it */
+        if( ( fstat( fd, &sb ) == 0 ) &&
+            ( ( sb.st_size == sizeof( VarShmTable ) ) ||
+              ( ( sb.st_size == 0 ) &&
+                ( ftruncate( fd, sizeof( VarShmTable ) ) == 0 ) ) ) )
+        {
+            p = mmap( NULL,
+                      sizeof( VarShmTable ),
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED,
+                      fd,
+                      0 );
+        }
+    }
+
+    if( p != MAP_FAILED )
+    {
+        pVarShm->pTable = (VarShmTable *)p;
+        pVarShm->pid = getpid();
+
+        /* claim a new segment, or check the layout of an existing one */
+        if( ( atomic_compare_exchange_strong( &pVarShm->pTable->magic,
+                                              &magic,
+                                              VARSHM_MAGIC ) == false ) &&
+            ( magic != VARSHM_MAGIC ) )
+        {
+            munmap( p, sizeof( VarShmTable ) );
+            p = MAP_FAILED;
+        }
+    }
+
+    if( fd != -1 )
+    {
+        close( fd );
+    }
+
+    if( p == MAP_FAILED )
+    {
+        printf( "Failed to open shared memory %s\n", name );
+        free( pVarShm );
+        pVarShm = NULL;
+    }
+
+    return pVarShm;
+}
+
+/*============================================================================*/
+/*  shutdown                                                                  */
+/*!
+    Shut Down VARSHM API library
+
+    The shutdown function is a public function which is expected to be
+    present by the VM core.  The VM core will call this function
+    to shut down the variable handling library.  The shared memory
+    segment is left in place for the other processes using it.
+
+    @param[in]
+        pointer to the library instance obtained via the init() function call
+
+    @retval EINVAL invalid arguments
+    @retval EOK the library was successfully shut down
+
+==============================================================================*/
+int shutdown( void *pExt )
+{
+    int result = EINVAL;
+    VarShm *pVarShm = (VarShm *)pExt;
+
+    if( pVarShm != NULL )
+    {
+        munmap( pVarShm->pTable, sizeof( VarShmTable ) );
+        free( pVarShm );
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnGetHandle                                                        */
+/*!
+    Get a handle to a variable given its name
+
+    The varshm_fnGetHandle function looks up a variable in the shared
+    memory slot table given its name, creating it if it does not exist.
+    The name is hashed to its first slot, and the following slots are
+    probed in turn.  A free slot is claimed with a compare and swap, so
+    processes creating the same variable at the same time get the same
+    slot.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        name
+            name of the variable to query
+
+    @retval handle of the variable
+    @retval 0 the name is too long, or the slot table is full
+
+==============================================================================*/
+static uint32_t varshm_fnGetHandle( void *pExt, char *name )
+{
+    VarShm *pVarShm = (VarShm *)pExt;
+    VarShmSlot *pSlot;
+    uint32_t hash;
+    uint32_t state;
+    uint32_t i;
+    uint32_t n;
+    uint32_t handle = 0;
+
+    if( ( pVarShm != NULL ) &&
+        ( name != NULL ) &&
+        ( strlen( name ) < VARSHM_NAME_LEN ) )
+    {
+        hash = varshm_fnHash( name );
+        i = hash & ( VARSHM_MAX_VARS - 1 );
+
+        for( n = 0; ( n < VARSHM_MAX_VARS ) && ( handle == 0 ); )
+        {
+            pSlot = &pVarShm->pTable->slot[i];
+            state = atomic_load_explicit( &pSlot->state,
+                                          memory_order_acquire );
+            if( state == VARSHM_SLOT_READY )
+            {
+                if( ( pSlot->hash == hash ) &&
+                    ( strcmp( pSlot->name, name ) == 0 ) )
+                {
+                    handle = i + 1;
+                }
+                else
+                {
+                    i = ( i + 1 ) & ( VARSHM_MAX_VARS - 1 );
+                    n++;
+                }
+            }
+            else if( state == VARSHM_SLOT_CLAIMED )
+            {
+                /* wait for the new variable to be named */
+                sched_yield();
+            }
+            else if( atomic_compare_exchange_strong( &pSlot->state,
+                                                     &state,
+                                                     VARSHM_SLOT_CLAIMED ) )
+            {
+                pSlot->hash = hash;
+                strcpy( pSlot->name, name );
+                atomic_store_explicit( &pSlot->state,
+                                       VARSHM_SLOT_READY,
+                                       memory_order_release );
+                handle = i + 1;
+            }
+        }
+    }
+
+    if( handle == 0 )
+    {
+        printf( "Failed to get handle for %s\n", name ? name : "(null)" );
+    }
+
+    return handle;
+}
+
+/*============================================================================*/
+/*  varshm_fnSet                                                              */
+/*!
+    Set a variable value given its handle
+
+    The varshm_fnSet function sets the 32-bit integer value of the
+    variable specified by its handle
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to set
+
+    @param[in]
+        val
+            value (uint32_t) of the variable to set
+
+==============================================================================*/
+static void varshm_fnSet( void *pExt, uint32_t handle, uint32_t val )
+{
+    varshm_fnWrite( (VarShm *)pExt, handle, EXTERNVAR_TYPE_UINT32, val );
+}
+
+/*============================================================================*/
+/*  varshm_fnSetFloat                                                         */
+/*!
+    Set a variable value given its handle
+
+    The varshm_fnSetFloat function sets the floating point value of the
+    variable specified by its handle
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to set
+
+    @param[in]
+        val
+            value (float) of the variable to set
+
+==============================================================================*/
+static void varshm_fnSetFloat( void *pExt, uint32_t handle, float val )
+{
+    uint32_t bits;
+
+    memcpy( &bits, &val, sizeof( bits ) );
+    varshm_fnWrite( (VarShm *)pExt, handle, EXTERNVAR_TYPE_FLOAT, bits );
+}
+
+/*============================================================================*/
+/*  varshm_fnSetString                                                        */
+/*!
+    Set a variable value given its handle
+
+    The varshm_fnSetString function sets the string value of the variable
+    specified by its handle.  Strings longer than the slot are truncated.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to set
+
+    @param[in]
+        val
+            pointer to a NUL terminated character string to set
+
+==============================================================================*/
+static void varshm_fnSetString( void *pExt, uint32_t handle, char *val )
+{
+    VarShm *pVarShm = (VarShm *)pExt;
+    VarShmSlot *pSlot;
+    uint32_t words[VARSHM_STR_LEN / sizeof( uint32_t )] = {0};
+    size_t len;
+    size_t i;
+
+    pSlot = varshm_fnSlot( pVarShm, handle );
+    if( ( pSlot != NULL ) && ( val != NULL ) )
+    {
+        len = strnlen( val, VARSHM_STR_LEN - 1 );
+        memcpy( words, val, len );
+
+        varshm_fnWriteBegin( pSlot );
+
+        atomic_store_explicit( &pSlot->type,
+                               EXTERNVAR_TYPE_STRING,
+                               memory_order_relaxed );
+        atomic_store_explicit( &pSlot->len, len, memory_order_relaxed );
+
+        /* store the words holding the string and its NUL terminator */
+        for( i = 0; i <= len / sizeof( uint32_t ); i++ )
+        {
+            atomic_store_explicit( &pSlot->str[i],
+                                   words[i],
+                                   memory_order_relaxed );
+        }
+
+        varshm_fnWriteEnd( pVarShm, pSlot, handle );
+    }
+}
+
+/*============================================================================*/
+/*  varshm_fnGet                                                              */
+/*!
+    Get a variable value given its handle
+
+    The varshm_fnGet function gets the 32-bit integer value of the
+    variable specified by its handle.
+
+    If the variable cannot be retrieved, zero is returned for its value
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to get
+
+    @return the value (cast to a uint32_t) of the variable
+
+==============================================================================*/
+static uint32_t varshm_fnGet( void *pExt, uint32_t handle )
+{
+    VarShmSlot *pSlot;
+    VarShmValue value;
+    uint32_t result = 0;
+
+    pSlot = varshm_fnSlot( (VarShm *)pExt, handle );
+    if( pSlot != NULL )
+    {
+        varshm_fnRead( pSlot, &value );
+        if( value.type == EXTERNVAR_TYPE_UINT32 )
+        {
+            result = value.val.ul;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnGetFloat                                                         */
+/*!
+    Get a variable value given its handle
+
+    The varshm_fnGetFloat function gets the floating point value of the
+    variable specified by its handle.
+
+    If the variable cannot be retrieved, zero is returned for its value
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to get
+
+    @return the value (cast to a float) of the variable
+
+==============================================================================*/
+static float varshm_fnGetFloat( void *pExt, uint32_t handle )
+{
+    VarShmSlot *pSlot;
+    VarShmValue value;
+    float result = 0.0;
+
+    pSlot = varshm_fnSlot( (VarShm *)pExt, handle );
+    if( pSlot != NULL )
+    {
+        varshm_fnRead( pSlot, &value );
+        switch( value.type )
+        {
+            case EXTERNVAR_TYPE_UINT32:
+                result = (float)( value.val.ul );
+                break;
+
+            case EXTERNVAR_TYPE_FLOAT:
+                result = value.val.f;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnGetString                                                        */
+/*!
+    Get a variable value given its handle
+
+    The varshm_fnGetString function gets the string value of the variable
+    specified by its handle.  The string is copied out of the slot with
+    the same sequence lock retry as the other values, and is valid until
+    the next call to varshm_fnGetString.
+
+    If the variable cannot be retrieved, NULL is returned for its value
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to get
+
+    @retval pointer to the NUL terminated variable string value
+    @retval NULL if the variable cannot be retrieved
+
+==============================================================================*/
+static char *varshm_fnGetString( void *pExt, uint32_t handle )
+{
+    VarShm *pVarShm = (VarShm *)pExt;
+    VarShmSlot *pSlot;
+    uint32_t seq;
+    uint32_t type;
+    uint32_t len;
+    uint32_t i;
+    uint32_t spin = 0;
+    char *result = NULL;
+
+    pSlot = varshm_fnSlot( pVarShm, handle );
+    if( pSlot != NULL )
+    {
+        do
+        {
+            if( ++spin % VARSHM_SPIN == 0 )
+            {
+                sched_yield();
+            }
+
+            seq = atomic_load_explicit( &pSlot->seq, memory_order_acquire );
+            type = atomic_load_explicit( &pSlot->type, memory_order_relaxed );
+            len = atomic_load_explicit( &pSlot->len, memory_order_relaxed );
+            len = ( len < VARSHM_STR_LEN ) ? len : VARSHM_STR_LEN - 1;
+            for( i = 0; ( type == EXTERNVAR_TYPE_STRING ) &&
+                        ( i <= len / sizeof( uint32_t ) ); i++ )
+            {
+                pVarShm->str[i] = atomic_load_explicit( &pSlot->str[i],
+                                                        memory_order_relaxed );
+            }
+
+            atomic_thread_fence( memory_order_acquire );
+        } while( ( ( seq & 1 ) != 0 ) ||
+                 ( seq != atomic_load_explicit( &pSlot->seq,
+                                                memory_order_relaxed ) ) );
+
+        if( type == EXTERNVAR_TYPE_STRING )
+        {
+            result = (char *)pVarShm->str;
+            result[len] = '\0';
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnNotify                                                           */
+/*!
+    Request notification on a variable given its handle
+
+    The varshm_fnNotify function adds the calling process to the processes
+    which are sent a MODIFIED notification when the variable is written.
+    The notification is the VARSHM_SIG_MODIFIED signal, carrying the
+    variable handle, which is the signal the VM receives from the
+    variable server.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to get
+
+    @param[in]
+        request
+            type of notification being requested:
+                - 1 = MODIFIED
+
+    @retval EOK the notification request was successful
+    @retval ENOTSUP the notification type is not supported
+    @retval ENOSPC too many processes are notified for the variable
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+static int varshm_fnNotify( void *pExt, uint32_t handle, uint32_t request )
+{
+    VarShm *pVarShm = (VarShm *)pExt;
+    VarShmSlot *pSlot;
+    pid_t pid;
+    int i;
+    int result = EINVAL;
+
+    pSlot = varshm_fnSlot( pVarShm, handle );
+    if( ( pSlot != NULL ) && ( request != EXTERNVAR_NOTIFY_MODIFIED ) )
+    {
+        result = ENOTSUP;
+    }
+    else if( pSlot != NULL )
+    {
+        result = ENOSPC;
+
+        for( i = 0; ( i < VARSHM_MAX_NOTIFY ) && ( result != EOK ); i++ )
+        {
+            if( atomic_load( &pSlot->notify[i] ) == pVarShm->pid )
+            {
+                result = EOK;
+            }
+        }
+
+        for( i = 0; ( i < VARSHM_MAX_NOTIFY ) && ( result != EOK ); i++ )
+        {
+            pid = 0;
+            if( atomic_compare_exchange_strong( &pSlot->notify[i],
+                                                &pid,
+                                                pVarShm->pid ) )
+            {
+                result = EOK;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnValidateStart                                                    */
+/*!
+    Start validation on a variable
+
+    Variable validation is routed through the variable server, so it is
+    not supported for shared memory variables.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the validation context
+
+    @param[out]
+        hVar
+            pointer to the location to store the handle of the variable
+            being validated
+
+    @retval ENOTSUP validation is not supported
+
+==============================================================================*/
+static int varshm_fnValidateStart( void *pExt,
+                                   uint32_t handle,
+                                   uint32_t *hVar )
+{
+    (void)pExt;
+    (void)handle;
+    (void)hVar;
+
+    return ENOTSUP;
+}
+
+/*============================================================================*/
+/*  varshm_fnValidateEnd                                                      */
+/*!
+    End validation on a variable
+
+    Variable validation is routed through the variable server, so it is
+    not supported for shared memory variables.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the validation context
+
+    @param[in]
+        result
+            validation result
+
+    @retval ENOTSUP validation is not supported
+
+==============================================================================*/
+static int varshm_fnValidateEnd( void *pExt, uint32_t handle, int result )
+{
+    (void)pExt;
+    (void)handle;
+    (void)result;
+
+    return ENOTSUP;
+}
+
+/*============================================================================*/
+/*  varshm_fnOpenPrintSession                                                 */
+/*!
+    Open a print session for a variable
+
+    Print sessions are routed through the variable server, so they are
+    not supported for shared memory variables.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the print session context
+
+    @param[out]
+        hVar
+            pointer to the location to store the variable handle
+
+    @param[out]
+        fd
+            pointer to the location to store the output file descriptor
+
+    @retval ENOTSUP print sessions are not supported
+
+==============================================================================*/
+static int varshm_fnOpenPrintSession( void *pExt,
+                                      uint32_t handle,
+                                      uint32_t *hVar,
+                                      int *fd )
+{
+    (void)pExt;
+    (void)handle;
+    (void)hVar;
+    (void)fd;
+
+    return ENOTSUP;
+}
+
+/*============================================================================*/
+/*  varshm_fnClosePrintSession                                                */
+/*!
+    Close a print session for a variable
+
+    Print sessions are routed through the variable server, so they are
+    not supported for shared memory variables.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the print session context
+
+    @param[in]
+        fd
+            output file descriptor of the print session
+
+    @retval ENOTSUP print sessions are not supported
+
+==============================================================================*/
+static int varshm_fnClosePrintSession( void *pExt, uint32_t handle, int fd )
+{
+    (void)pExt;
+    (void)handle;
+    (void)fd;
+
+    return ENOTSUP;
+}
+
+/*============================================================================*/
+/*  varshm_fnGetMany                                                          */
+/*!
+    Get the values of several variables
+
+    The varshm_fnGetMany function gets the values of an array of
+    variables.  Each value is read under its own sequence lock.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in,out]
+        pValues
+            array of handles and value types, which receives the values
+
+    @param[in]
+        n
+            number of elements in the array
+
+    @retval EOK the values were retrieved
+    @retval ENOTSUP an element has an unsupported value type
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+static int varshm_fnGetMany( void *pExt, tzExternValue *pValues, size_t n )
+{
+    size_t i;
+    int result = EINVAL;
+
+    if( ( pExt != NULL ) && ( ( pValues != NULL ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        for( i = 0; i < n; i++ )
+        {
+            switch( pValues[i].type )
+            {
+                case EXTERNVAR_TYPE_UINT32:
+                    pValues[i].val.ul = varshm_fnGet( pExt,
+                                                      pValues[i].handle );
+                    break;
+
+                case EXTERNVAR_TYPE_FLOAT:
+                    pValues[i].val.f = varshm_fnGetFloat( pExt,
+                                                          pValues[i].handle );
+                    break;
+
+                default:
+                    result = ENOTSUP;
+                    break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnSetMany                                                          */
+/*!
+    Set the values of several variables
+
+    The varshm_fnSetMany function sets the values of an array of
+    variables.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        pValues
+            array of handles, value types and values to set
+
+    @param[in]
+        n
+            number of elements in the array
+
+    @retval EOK the values were set
+    @retval ENOTSUP an element has an unsupported value type
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+static int varshm_fnSetMany( void *pExt, tzExternValue *pValues, size_t n )
+{
+    size_t i;
+    int result = EINVAL;
+
+    if( ( pExt != NULL ) && ( ( pValues != NULL ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        for( i = 0; i < n; i++ )
+        {
+            if( ( pValues[i].type == EXTERNVAR_TYPE_UINT32 ) ||
+                ( pValues[i].type == EXTERNVAR_TYPE_FLOAT ) )
+            {
+                varshm_fnWrite( (VarShm *)pExt,
+                                pValues[i].handle,
+                                pValues[i].type,
+                                pValues[i].val.ul );
+            }
+            else
+            {
+                result = ENOTSUP;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnGetHandles                                                       */
+/*!
+    Get the handles of several variables given their names
+
+    The varshm_fnGetHandles function gets the handles of an array of
+    variable names, creating the variables which do not exist.  It is
+    used to resolve the import table of a program once, when the program
+    is loaded.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarShm object
+
+    @param[in]
+        ppNames
+            array of variable names
+
+    @param[out]
+        pHandles
+            array which receives the handle of each variable, or
+            0 if the variable cannot be created
+
+    @param[in]
+        n
+            number of elements in the arrays
+
+    @retval EOK all of the variables were found
+    @retval ENOENT one or more of the variables cannot be created
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+static int varshm_fnGetHandles( void *pExt,
+                                char **ppNames,
+                                uint32_t *pHandles,
+                                size_t n )
+{
+    size_t i;
+    int result = EINVAL;
+
+    if( ( pExt != NULL ) &&
+        ( ( ( ppNames != NULL ) && ( pHandles != NULL ) ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        for( i = 0; i < n; i++ )
+        {
+            pHandles[i] = varshm_fnGetHandle( pExt, ppNames[i] );
+            if( pHandles[i] == 0 )
+            {
+                result = ENOENT;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varshm_fnSlot                                                             */
+/*!
+    Get the slot of a variable given its handle
+
+    The varshm_fnSlot function gets the shared memory slot which holds
+    the variable with the specified handle.
+
+    @param[in]
+        pVarShm
+            pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable
+
+    @retval pointer to the slot of the variable
+    @retval NULL the handle does not refer to a variable
+
+==============================================================================*/
+static VarShmSlot *varshm_fnSlot( VarShm *pVarShm, uint32_t handle )
+{
+    VarShmSlot *pSlot = NULL;
+
+    if( ( pVarShm != NULL ) &&
+        ( handle != 0 ) &&
+        ( handle <= VARSHM_MAX_VARS ) )
+    {
+        pSlot = &pVarShm->pTable->slot[handle - 1];
+        if( atomic_load_explicit( &pSlot->state,
+                                  memory_order_acquire ) != VARSHM_SLOT_READY )
+        {
+            pSlot = NULL;
+        }
+    }
+
+    return pSlot;
+}
+
+/*============================================================================*/
+/*  varshm_fnHash                                                             */
+/*!
+    Calculate the hash of a variable name
+
+    The varshm_fnHash function calculates the 32-bit FNV-1a hash of a
+    variable name.
+
+    @param[in]
+        name
+            variable name
+
+    @retval hash of the name
+
+==============================================================================*/
+static uint32_t varshm_fnHash( char *name )
+{
+    uint32_t hash = 0x811C9DC5u;
+
+    while( *name != '\0' )
+    {
+        hash ^= (uint8_t)*name++;
+        hash *= 0x01000193u;
+    }
+
+    return hash;
+}
+
+/*============================================================================*/
+/*  varshm_fnWriteBegin                                                       */
+/*!
+    Start writing a variable
+
+    The varshm_fnWriteBegin function takes the sequence lock of a slot
+    for writing by making its sequence counter odd, waiting for any
+    other writer to finish first.  Readers which see an odd or changed
+    sequence counter retry their read.
+
+    @param[in]
+        pSlot
+            pointer to the slot to write
+
+==============================================================================*/
+static void varshm_fnWriteBegin( VarShmSlot *pSlot )
+{
+    uint32_t seq;
+    uint32_t spin = 0;
+
+    seq = atomic_load_explicit( &pSlot->seq, memory_order_relaxed );
+    while( ( ( seq & 1 ) != 0 ) ||
+           ( atomic_compare_exchange_weak_explicit( &pSlot->seq,
+                                                    &seq,
+                                                    seq + 1,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed )
+             == false ) )
+    {
+        if( ++spin % VARSHM_SPIN == 0 )
+        {
+            sched_yield();
+        }
+
+        seq = atomic_load_explicit( &pSlot->seq, memory_order_relaxed );
+    }
+
+    /* the odd sequence counter is visible before the new value */
+    atomic_thread_fence( memory_order_release );
+}
+
+/*============================================================================*/
+/*  varshm_fnWriteEnd                                                         */
+/*!
+    Finish writing a variable
+
+    The varshm_fnWriteEnd function releases the sequence lock of a slot
+    by making its sequence counter even again, and sends a MODIFIED
+    notification to each process which requested one.  Processes which
+    no longer exist are removed from the slot.
+
+    @param[in]
+        pVarShm
+            pointer to the VarShm object
+
+    @param[in]
+        pSlot
+            pointer to the slot which was written
+
+    @param[in]
+        handle
+            handle of the variable which was written
+
+==============================================================================*/
+static void varshm_fnWriteEnd( VarShm *pVarShm,
+                               VarShmSlot *pSlot,
+                               uint32_t handle )
+{
+    union sigval sv;
+    pid_t pid;
+    int i;
+
+    (void)pVarShm;
+
+    atomic_fetch_add_explicit( &pSlot->seq, 1, memory_order_release );
+
+    sv.sival_int = (int)handle;
+    for( i = 0; i < VARSHM_MAX_NOTIFY; i++ )
+    {
+        pid = atomic_load_explicit( &pSlot->notify[i], memory_order_relaxed );
+        if( ( pid != 0 ) &&
+            ( sigqueue( pid, VARSHM_SIG_MODIFIED, sv ) == -1 ) &&
+            ( errno == ESRCH ) )
+        {
+            atomic_compare_exchange_strong( &pSlot->notify[i], &pid, 0 );
+        }
+    }
+}
+
+/*============================================================================*/
+/*  varshm_fnRead                                                             */
+/*!
+    Read a variable value
+
+    The varshm_fnRead function copies the type and value of a slot
+    without taking a lock.  The copy is retried until the sequence
+    counter is even and unchanged across the copy, so a value is never
+    torn by a concurrent writer.
+
+    @param[in]
+        pSlot
+            pointer to the slot to read
+
+    @param[out]
+        pValue
+            pointer to the location to store the copied value
+
+==============================================================================*/
+static void varshm_fnRead( VarShmSlot *pSlot, VarShmValue *pValue )
+{
+    uint32_t seq;
+    uint32_t spin = 0;
+
+    do
+    {
+        if( ++spin % VARSHM_SPIN == 0 )
+        {
+            sched_yield();
+        }
+
+        seq = atomic_load_explicit( &pSlot->seq, memory_order_acquire );
+        pValue->type = atomic_load_explicit( &pSlot->type,
+                                             memory_order_relaxed );
+        pValue->val.ul = atomic_load_explicit( &pSlot->val,
+                                               memory_order_relaxed );
+        atomic_thread_fence( memory_order_acquire );
+    } while( ( ( seq & 1 ) != 0 ) ||
+             ( seq != atomic_load_explicit( &pSlot->seq,
+                                            memory_order_relaxed ) ) );
+}
+
+/*============================================================================*/
+/*  varshm_fnWrite                                                            */
+/*!
+    Write a numeric variable value
+
+    The varshm_fnWrite function stores the type and 32-bit value of a
+    variable under its sequence lock, and notifies the processes waiting
+    for it to be modified.
+
+    @param[in]
+        pVarShm
+            pointer to the VarShm object
+
+    @param[in]
+        handle
+            handle of the variable to write
+
+    @param[in]
+        type
+            EXTERNVAR_TYPE_UINT32 or EXTERNVAR_TYPE_FLOAT
+
+    @param[in]
+        val
+            32-bit integer value or floating point bit pattern
+
+==============================================================================*/
+static void varshm_fnWrite( VarShm *pVarShm,
+                            uint32_t handle,
+                            uint32_t type,
+                            uint32_t val )
+{
+    VarShmSlot *pSlot;
+
+    pSlot = varshm_fnSlot( pVarShm, handle );
+    if( pSlot != NULL )
+    {
+        varshm_fnWriteBegin( pSlot );
+        atomic_store_explicit( &pSlot->type, type, memory_order_relaxed );
+        atomic_store_explicit( &pSlot->val, val, memory_order_relaxed );
+        varshm_fnWriteEnd( pVarShm, pSlot, handle );
+    }
+}
+
+/*! @}
+ * end of libvarshm group */
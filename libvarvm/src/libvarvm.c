@@ -104,6 +104,7 @@ typedef struct _VarVM
         Private function declarations
 ==============================================================================*/
 tzEXTVARAPI *getapi(void);
+int getapiversion(void);
 void *init( void );
 int shutdown( void *pExt );
 
@@ -127,6 +128,13 @@ static int varvm_fnOpenPrintSession( void *pExt,
 
 static int varvm_fnClosePrintSession( void *pExt, uint32_t handle, int fd );
 
+static int varvm_fnGetMany( void *pExt, tzExternValue *pValues, size_t n );
+static int varvm_fnSetMany( void *pExt, tzExternValue *pValues, size_t n );
+static int varvm_fnGetHandles( void *pExt,
+                               char **ppNames,
+                               uint32_t *pHandles,
+                               size_t n );
+
 /*==============================================================================
         Function definitions
 ==============================================================================*/
@@ -168,12 +176,32 @@ tzEXTVARAPI *getapi(void)
             varvm_fnValidateStart,
             varvm_fnValidateEnd,
             varvm_fnOpenPrintSession,
-            varvm_fnClosePrintSession
+            varvm_fnClosePrintSession,
+            varvm_fnGetMany,
+            varvm_fnSetMany,
+            varvm_fnGetHandles
     };
 
     return &varvmAPI;
 }
 
+/*============================================================================*/
+/*  getapiversion                                                             */
+/*!
+    Get the version of the VARVM API functions
+
+    The getapiversion function is a public function which is used by the
+    VM core to find out which entries of the API list returned by getapi()
+    are present.
+
+    @return the EXTERNVAR_API_VERSION the library was built with
+
+==============================================================================*/
+int getapiversion(void)
+{
+    return EXTERNVAR_API_VERSION;
+}
+
 /*============================================================================*/
 /*  init                                                                      */
 /*!
@@ -893,5 +921,258 @@ static int varvm_fnClosePrintSession( void *pExt, uint32_t handle, int fd )
     return result;
 }
 
+/*============================================================================*/
+/*  varvm_fnGetMany                                                           */
+/*!
+    Get the values of several variables given their handles
+
+    The varvm_fnGetMany function gets the values of an array of 32-bit
+    integer and floating point variables from the variable server.
+    The variable being validated is read from the validation data.
+    Variables which cannot be retrieved get a value of zero.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarVM object which contains the handle
+            to the Variable Server
+
+    @param[in,out]
+        pValues
+            array of handles and value types, which receives the values
+
+    @param[in]
+        n
+            number of elements in the array
+
+    @retval EOK all of the values were retrieved
+    @retval ENOTSUP an element has an unsupported value type
+    @retval EINVAL invalid arguments
+    @retval other a variable could not be retrieved
+
+==============================================================================*/
+static int varvm_fnGetMany( void *pExt, tzExternValue *pValues, size_t n )
+{
+    VarVM *pVarVM = (VarVM *)pExt;
+    VarObject varObject;
+    VarObject *pVarObject;
+    tzExternValue *pValue;
+    size_t i;
+    int rc;
+    int result = EINVAL;
+
+    if( ( pVarVM != NULL ) &&
+        ( pVarVM->get != NULL ) &&
+        ( ( pValues != NULL ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        for( i = 0; i < n; i++ )
+        {
+            pValue = &pValues[i];
+            pValue->val.ul = 0;
+            pVarObject = &varObject;
+
+            if( pVarVM->hValidationVar == pValue->handle )
+            {
+                /* get the variable data from the validation data */
+                pVarObject = &(pVarVM->validationData);
+            }
+            else
+            {
+                memset( &varObject, 0, sizeof( VarObject ) );
+                rc = pVarVM->get( pVarVM->hVarServer,
+                                  (VAR_HANDLE)pValue->handle,
+                                  &varObject );
+                if( rc != EOK )
+                {
+                    result = rc;
+                    pVarObject = NULL;
+                }
+            }
+
+            if( ( pValue->type != EXTERNVAR_TYPE_UINT32 ) &&
+                ( pValue->type != EXTERNVAR_TYPE_FLOAT ) )
+            {
+                result = ENOTSUP;
+            }
+            else if( pVarObject != NULL )
+            {
+                switch( pVarObject->type )
+                {
+                    case VARTYPE_UINT32:
+                        pValue->val.ul = pVarObject->val.ul;
+                        break;
+
+                    case VARTYPE_UINT16:
+                        pValue->val.ul = pVarObject->val.ui;
+                        break;
+
+                    case VARTYPE_FLOAT:
+                        if( pValue->type == EXTERNVAR_TYPE_FLOAT )
+                        {
+                            pValue->val.f = pVarObject->val.f;
+                        }
+                        break;
+
+                    default:
+                        break;
+                }
+
+                if( ( pValue->type == EXTERNVAR_TYPE_FLOAT ) &&
+                    ( pVarObject->type != VARTYPE_FLOAT ) )
+                {
+                    /* convert the integer value */
+                    pValue->val.f = (float)pValue->val.ul;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varvm_fnSetMany                                                           */
+/*!
+    Set the values of several variables given their handles
+
+    The varvm_fnSetMany function requests the variable server to set the
+    values of an array of 32-bit integer and floating point variables.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarVM object which contains the handle
+            to the Variable Server
+
+    @param[in]
+        pValues
+            array of handles, value types and values to set
+
+    @param[in]
+        n
+            number of elements in the array
+
+    @retval EOK all of the values were set
+    @retval ENOTSUP an element has an unsupported value type
+    @retval EINVAL invalid arguments
+    @retval other a variable could not be set
+
+==============================================================================*/
+static int varvm_fnSetMany( void *pExt, tzExternValue *pValues, size_t n )
+{
+    VarVM *pVarVM = (VarVM *)pExt;
+    VarObject varObject;
+    tzExternValue *pValue;
+    size_t i;
+    int rc;
+    int result = EINVAL;
+
+    if( ( pVarVM != NULL ) &&
+        ( pVarVM->set != NULL ) &&
+        ( ( pValues != NULL ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        for( i = 0; i < n; i++ )
+        {
+            pValue = &pValues[i];
+            memset( &varObject, 0, sizeof( VarObject ) );
+            rc = ENOTSUP;
+
+            if( pValue->type == EXTERNVAR_TYPE_UINT32 )
+            {
+                varObject.type = VARTYPE_UINT32;
+                varObject.len = sizeof( uint32_t );
+                varObject.val.ul = pValue->val.ul;
+                rc = EOK;
+            }
+            else if( pValue->type == EXTERNVAR_TYPE_FLOAT )
+            {
+                varObject.type = VARTYPE_FLOAT;
+                varObject.len = sizeof( float );
+                varObject.val.f = pValue->val.f;
+                rc = EOK;
+            }
+
+            if( rc == EOK )
+            {
+                rc = pVarVM->set( pVarVM->hVarServer,
+                                  (VAR_HANDLE)pValue->handle,
+                                  &varObject );
+            }
+
+            if( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varvm_fnGetHandles                                                        */
+/*!
+    Get the handles of several variables given their names
+
+    The varvm_fnGetHandles function queries the variable server for the
+    handles of an array of variable names.  It is used to resolve the
+    import table of a program once, when the program is loaded.
+
+    @param[in]
+        pExt
+            opaque pointer to the VarVM object which contains the handle
+            to the Variable Server to query
+
+    @param[in]
+        ppNames
+            array of variable names
+
+    @param[out]
+        pHandles
+            array which receives the handle of each variable, or
+            VAR_INVALID if the variable does not exist
+
+    @param[in]
+        n
+            number of elements in the arrays
+
+    @retval EOK all of the variables were found
+    @retval ENOENT one or more of the variables does not exist
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+static int varvm_fnGetHandles( void *pExt,
+                               char **ppNames,
+                               uint32_t *pHandles,
+                               size_t n )
+{
+    VarVM *pVarVM = (VarVM *)pExt;
+    size_t i;
+    int result = EINVAL;
+
+    if( ( pVarVM != NULL ) &&
+        ( pVarVM->find != NULL ) &&
+        ( ( ( ppNames != NULL ) && ( pHandles != NULL ) ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        /* the variable server has no batched lookup, so each name
+           is found separately */
+        for( i = 0; i < n; i++ )
+        {
+            pHandles[i] = (uint32_t)pVarVM->find( pVarVM->hVarServer,
+                                                  ppNames[i] );
+            if( pHandles[i] == VAR_INVALID )
+            {
+                result = ENOENT;
+            }
+        }
+    }
+
+    return result;
+}
+
 /*! @}
  * end of libvarvm group */
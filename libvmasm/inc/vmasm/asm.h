@@ -69,12 +69,18 @@ typedef struct zASMState
     /* error state */
     int error;
 
+    /* true to store multi-byte values in the host byte order */
+    bool nativeEndian;
+
 } tzASMState;
 
 /*==============================================================================
         Public function declarations
 ==============================================================================*/
 
-int assemble_program( char *filename, uint8_t *memory, size_t *length );
+int assemble_program( char *filename,
+                      uint8_t *memory,
+                      size_t *length,
+                      bool nativeEndian );
 
 #endif
@@ -75,6 +75,6 @@ typedef struct BackpatchRec
 backpatchRecPtr findLabelRec();
 void enterLabel(char *label, uint16_t addr);
 void setLabelAddr(char *label, uint16_t addr);
-int LinkLabels(uint8_t *memory, bool verbose, bool showLabels);
+int LinkLabels(uint8_t *memory, bool nativeEndian, bool verbose, bool showLabels);
 
 #endif
\ No newline at end of file
@@ -58,7 +58,8 @@ typedef enum eParseType
     eSTRING,
     eCHAR,
     eREGISTER,
-    eOP
+    eOP,
+    eMEMORY
 } teParseType;
 
 /*! structure returned by the lexer */
@@ -79,6 +80,13 @@ typedef struct zParseInfo
         char *pStrVal;
         uint8_t regnum;
         uint8_t op;
+        struct
+        {
+            uint8_t base;
+            uint8_t index;
+            int8_t scale;
+            int32_t disp;
+        } mem;
     } value;
 } tzParseInfo;
 
@@ -107,6 +115,12 @@ tzParseInfo EncodeChar( char *valueText,
 tzParseInfo GetRegister( char *regdef,
                          int line_number );
 
+tzParseInfo EncodeMemory( tzParseInfo *pBase,
+                          tzParseInfo *pIndex,
+                          tzParseInfo *pScale,
+                          tzParseInfo *pDisp,
+                          int lineno );
+
 int copystring( tzParseInfo *pParseInfo,
                 uint8_t *destination );
 
@@ -118,6 +132,7 @@ void CheckParseInfo( uint8_t *instptr,
 void storeValue( tzParseInfo *pParseInfo,
                  uint8_t *memory,
                  uint16_t address,
+                 bool nativeEndian,
                  int lineno );
 
 #endif
@@ -95,12 +95,20 @@ extern int yyparse(tzASMState *pASM);
             pointer to the max length of the VM Core binary
             The assembled binary object size is returned via this argument
 
+    @param[in]
+        nativeEndian
+            true to store multi-byte values in the host byte order,
+            false to store them in big endian format
+
     @retval EOK - the VarObject was created ok
     @retval ENOMEM - memory allocation failed
     @retval EINVAL - invalid arguments
 
 ==============================================================================*/
-int assemble_program( char *filename, uint8_t *memory, size_t *length )
+int assemble_program( char *filename,
+                      uint8_t *memory,
+                      size_t *length,
+                      bool nativeEndian )
 {
     int result = EINVAL;
     tzASMState asmState;
@@ -124,6 +132,9 @@ int assemble_program( char *filename, uint8_t *memory, size_t *length )
         /* initialize semantic error flag */
         pASM->error = 0;
 
+        /* select the byte order of multi-byte values */
+        pASM->nativeEndian = nativeEndian;
+
         /* open input file */
         if ( filename != NULL )
         {
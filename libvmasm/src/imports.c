@@ -0,0 +1,157 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @defgroup imports Import Manager
+ * @brief VM Assembler Import Manager
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file imports.c
+
+    Virtual Machine Assembler Import Manager
+
+    The Virtual Machine Assembler Import Manager module manages the
+    names of the external variables imported by the program.  Each
+    name is assigned a slot in the import table which is saved with
+    the program image, and the IMP instruction references the slot.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <vmasm/imports.h>
+
+/*==============================================================================
+        File Scoped Variables
+==============================================================================*/
+
+/*! import table of external variable names */
+static char **imports = NULL;
+
+/*! number of names in the import table */
+static size_t numImports = 0;
+
+/*! capacity of the import table */
+static size_t maxImports = 0;
+
+/*==============================================================================
+        Public Function Definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  AddImport                                                                 */
+/*!
+    Add an external variable name to the import table
+
+    The AddImport function gets the import table slot of the specified
+    external variable name.  A name which is not already in the import
+    table is added to the end of it.
+
+    @param[in]
+        name
+            pointer to the external variable name
+
+    @retval import table slot of the name
+    @retval -1 the name could not be added
+
+==============================================================================*/
+int AddImport( char *name )
+{
+    char **p;
+    size_t i;
+    int slot = -1;
+
+    if( ( name != NULL ) && ( *name != '\0' ) )
+    {
+        for( i = 0; ( i < numImports ) && ( slot == -1 ); i++ )
+        {
+            if( strcmp( imports[i], name ) == 0 )
+            {
+                slot = (int)i;
+            }
+        }
+
+        if( ( slot == -1 ) && ( numImports == maxImports ) )
+        {
+            maxImports = ( maxImports == 0 ) ? 16 : maxImports * 2;
+            p = realloc( imports, maxImports * sizeof( char * ) );
+            if( p != NULL )
+            {
+                imports = p;
+            }
+            else
+            {
+                maxImports = numImports;
+            }
+        }
+
+        if( ( slot == -1 ) && ( numImports < maxImports ) )
+        {
+            imports[numImports] = strdup( name );
+            if( imports[numImports] != NULL )
+            {
+                slot = (int)numImports++;
+            }
+        }
+    }
+
+    return slot;
+}
+
+/*============================================================================*/
+/*  GetImports                                                                */
+/*!
+    Get the import table
+
+    The GetImports function gets the external variable names in the
+    import table, indexed by their import table slot.
+
+    @param[out]
+        pCount
+            pointer to a location to store the number of names
+
+    @retval pointer to the array of external variable names
+
+==============================================================================*/
+char **GetImports( size_t *pCount )
+{
+    if( pCount != NULL )
+    {
+        *pCount = numImports;
+    }
+
+    return imports;
+}
+
+/*! @}
+ * end of imports group */
@@ -229,6 +229,10 @@ backpatchRecPtr findLabelRec(char *label)
         memory
             pointer to the virtual machine memory
 
+    @param[in]
+        nativeEndian
+            true to store the label addresses in the host byte order
+
     @param[in]
         verbose
             enable (true) or disable (false) diagnostic output
@@ -241,11 +245,12 @@ backpatchRecPtr findLabelRec(char *label)
     @retval -1 an error occurred
 
 ==============================================================================*/
-int LinkLabels(uint8_t *memory, bool verbose, bool showLabels)
+int LinkLabels(uint8_t *memory, bool nativeEndian, bool verbose, bool showLabels)
 {
 	backpatchptr addr;
 	backpatchRecPtr label;
     uint16_t loc;
+    uint16_t labelAddr;
     int status = 0;
 
 	if (verbose)
@@ -277,8 +282,16 @@ int LinkLabels(uint8_t *memory, bool verbose, bool showLabels)
 			while ( addr != NULL )
 			{
                 loc = addr->location;
-                memory[loc] = ( ( label->address & 0xFF00 ) >> 8 );
-                memory[loc+1] = ( label->address & 0x00FF );
+                if( nativeEndian )
+                {
+                    labelAddr = (uint16_t)label->address;
+                    memcpy( &memory[loc], &labelAddr, sizeof( labelAddr ) );
+                }
+                else
+                {
+                    memory[loc] = ( ( label->address & 0xFF00 ) >> 8 );
+                    memory[loc+1] = ( label->address & 0x00FF );
+                }
 
                 if ( showLabels )
                 {
@@ -49,6 +49,7 @@ static void allCAPS( char *str);
 static uint32_t xtol( char *hexstring );
 static uint16_t hexdigit( char digit, uint16_t *val );
 static unsigned char ParseChar( char *input, int *length );
+static int32_t GetInteger( tzParseInfo *pParseInfo );
 
 /*==============================================================================
         Public Function Definitions
@@ -449,6 +450,97 @@ tzParseInfo EncodeChar( char *valueText, size_t length, int lineno)
 	return parseInfo;
 }
 
+/*============================================================================*/
+/*  EncodeMemory                                                              */
+/*!
+    Encode a memory operand into a tzParseInfo Object
+
+    The EncodeMemory function builds a tzParseInfo object describing a
+    memory operand of the form [Rb+disp] or [Rb+Ri*scale+disp].
+    The width of the object is the size of the encoded displacement.
+
+    @param[in]
+        pBase
+            pointer to the parse info for the base register
+
+    @param[in]
+        pIndex
+            pointer to the parse info for the index register, or NULL
+
+    @param[in]
+        pScale
+            pointer to the parse info for the index scale, or NULL for 1
+
+    @param[in]
+        pDisp
+            pointer to the parse info for the displacement, or NULL for 0
+
+    @param[in]
+        lineno
+            the line number of the memory operand
+
+    @retval a tzParseInfo object containing the memory operand
+
+==============================================================================*/
+tzParseInfo EncodeMemory( tzParseInfo *pBase,
+                          tzParseInfo *pIndex,
+                          tzParseInfo *pScale,
+                          tzParseInfo *pDisp,
+                          int lineno )
+{
+    tzParseInfo parseInfo;
+    int32_t scale = 1;
+    int32_t disp = 0;
+
+    memset(&parseInfo, 0, sizeof( parseInfo ));
+
+    parseInfo.type = eMEMORY;
+    parseInfo.value.mem.base = pBase->value.regnum & 0x0F;
+
+    if( pIndex != NULL )
+    {
+        if( pScale != NULL )
+        {
+            scale = GetInteger( pScale );
+        }
+
+        /* the scale is encoded as a signed 4-bit value, where 0 means
+           there is no index register */
+        if( ( scale < -8 ) || ( scale > 7 ) || ( scale == 0 ) )
+        {
+            printf( "Line: %d: Invalid index scale: %d\n", lineno, scale );
+            exit(1);
+        }
+
+        parseInfo.value.mem.index = pIndex->value.regnum & 0x0F;
+        parseInfo.value.mem.scale = (int8_t)scale;
+    }
+
+    if( pDisp != NULL )
+    {
+        disp = GetInteger( pDisp );
+    }
+
+    parseInfo.value.mem.disp = disp;
+    if( ( disp >= -128 ) && ( disp <= 127 ) )
+    {
+        parseInfo.n = 1;
+        parseInfo.width = 1;
+    }
+    else if( ( disp >= -32768 ) && ( disp <= 32767 ) )
+    {
+        parseInfo.n = 2;
+        parseInfo.width = 2;
+    }
+    else
+    {
+        parseInfo.n = 4;
+        parseInfo.width = 4;
+    }
+
+    return parseInfo;
+}
+
 /*============================================================================*/
 /*  copystring                                                                */
 /*!
@@ -730,6 +822,45 @@ static uint16_t hexdigit(char digit, uint16_t *val)
 	}
 }
 
+/*============================================================================*/
+/*  GetInteger                                                                */
+/*!
+    Get the value of an integer literal
+
+    The GetInteger function gets the signed value of an integer literal
+    from a tzParseInfo object created by EncodeValue.
+
+    @param[in]
+        pParseInfo
+            pointer to the tzParseInfo object containing the integer
+
+    @retval the value of the integer literal
+
+==============================================================================*/
+static int32_t GetInteger( tzParseInfo *pParseInfo )
+{
+    switch( pParseInfo->type )
+    {
+        case eUINT8:
+            return pParseInfo->value.ucVal;
+
+        case eSINT8:
+            return pParseInfo->value.scVal;
+
+        case eUINT16:
+            return pParseInfo->value.uiVal;
+
+        case eSINT16:
+            return pParseInfo->value.siVal;
+
+        case eSINT32:
+            return pParseInfo->value.slVal;
+
+        default:
+            return (int32_t)pParseInfo->value.ulVal;
+    }
+}
+
 /*============================================================================*/
 /*  CheckParseInfo                                                            */
 /*!
@@ -810,7 +941,8 @@ void CheckParseInfo( uint8_t *instptr,
 
     The storeValue function stores a value from the tzParseInfo object
     into the Virtual Machine memory at the specified location.
-    The value is stored in Big Endian format (MSB first).
+    The value is stored in Big Endian format (MSB first), or in the
+    host byte order for a native endian image.
 
     @param[in]
         pParseInfo
@@ -824,6 +956,10 @@ void CheckParseInfo( uint8_t *instptr,
         address
             unused
 
+    @param[in]
+        nativeEndian
+            true to store the value in the host byte order
+
     @param[in]
         lineno
             line number
@@ -832,6 +968,7 @@ void CheckParseInfo( uint8_t *instptr,
 void storeValue( tzParseInfo *pParseInfo,
                  uint8_t *memory,
                  uint16_t address,
+                 bool nativeEndian,
                  int lineno )
 {
 	uint8_t b0;
@@ -853,6 +990,49 @@ void storeValue( tzParseInfo *pParseInfo,
         exit(1);
     }
 
+    if( nativeEndian == true )
+    {
+        switch( pParseInfo->type )
+        {
+            case eUINT16:
+            case eSINT16:
+                uiVal = pParseInfo->value.uiVal;
+                memcpy( memory, &uiVal, sizeof( uiVal ) );
+                return;
+
+            case eUINT32:
+            case eSINT32:
+                ulVal = pParseInfo->value.ulVal;
+                memcpy( memory, &ulVal, sizeof( ulVal ) );
+                return;
+
+            case eFLOAT32:
+                memcpy( memory,
+                        &pParseInfo->value.fVal,
+                        sizeof( pParseInfo->value.fVal ) );
+                return;
+
+            case eMEMORY:
+                if( pParseInfo->width == 2 )
+                {
+                    uiVal = (uint16_t)pParseInfo->value.mem.disp;
+                    memcpy( memory, &uiVal, sizeof( uiVal ) );
+                    return;
+                }
+                else if( pParseInfo->width == 4 )
+                {
+                    ulVal = (uint32_t)pParseInfo->value.mem.disp;
+                    memcpy( memory, &ulVal, sizeof( ulVal ) );
+                    return;
+                }
+                break;
+
+            default:
+                /* single bytes have no byte order */
+                break;
+        }
+    }
+
     switch( pParseInfo->type )
     {
         case eUINT8:
@@ -913,6 +1093,21 @@ void storeValue( tzParseInfo *pParseInfo,
 			memory[3] = data.uVal[0];
             break;
 
+        case eMEMORY:
+            /* displacement of a memory operand */
+            ulVal = (uint32_t)pParseInfo->value.mem.disp;
+            if( pParseInfo->width == 4 )
+            {
+                *memory++ = (uint8_t)((ulVal & 0xFF000000) >> 24);
+                *memory++ = (uint8_t)((ulVal & 0x00FF0000) >> 16);
+            }
+            if( pParseInfo->width >= 2 )
+            {
+                *memory++ = (uint8_t)((ulVal & 0xFF00) >> 8);
+            }
+            *memory = (uint8_t)(ulVal & 0x00FF);
+            break;
+
         default:
             printf( "Line: %d: unsupported type: %d\n",
                     lineno,
@@ -28,7 +28,9 @@ SOFTWARE.
 ==============================================================================*/
 #include <vmasm/asm.h>
 #include <vmasm/labels.h>
+#include <vmasm/imports.h>
 #include <stdio.h>
+#include <string.h>
 
 /*==============================================================================
         Definitions
@@ -83,6 +85,10 @@ void errmsg(char *msg, int line);
 %token	REG
 %token	DAT
 %token	COMMA
+%token	LBRACKET
+%token	RBRACKET
+%token	PLUS
+%token	TIMES
 %token	LABEL
 %token	EOLN
 %token  JMP
@@ -130,6 +136,20 @@ void errmsg(char *msg, int line);
 %token	POP
 %token	CMP
 %token  MDUMP
+%token  EVQ
+%token  VEC
+%token  DSP
+%token  MGT
+%token  MST
+%token  TXB
+%token  TXC
+%token  IMP
+%token  LDL
+%token  STL
+%token  BLT
+%token  BLE
+%token  BEQ
+%token  BNE
 %token  WRS
 %token  CSB
 %token  ZSB
@@ -201,6 +221,7 @@ smplcmd	: DAT val
                 storeValue( pParseInfo2,
                             &MEMORY[POINTER],
                             pASM->pointer,
+                            pASM->nativeEndian,
                             yylineno );
                 INCPOINTER(pParseInfo2->n);
             }
@@ -244,6 +265,56 @@ smplcmd	: DAT val
                 INCPOINTER(n);
 			}
 
+	| instr2 REG delim memory
+            {
+                pParseInfo1 = (tzParseInfo *)&$1;
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                if( ( pParseInfo1->value.op & 0x1F ) != HLOD )
+                {
+                    errmsg("Invalid memory operand", yylineno );
+                    exit(1);
+                }
+
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HLDX | ( pParseInfo1->value.op & ( BYTE | WORD ) );
+                instptr[3] = ( ( pParseInfo2->value.regnum & 0x0F ) << 4 ) +
+                             pParseInfo4->value.mem.base;
+                instptr[4] = ( pParseInfo4->value.mem.index << 4 ) +
+                             ( pParseInfo4->value.mem.scale & 0x0F );
+                CheckParseInfo(&instptr[1], pParseInfo2, pParseInfo4, yylineno);
+                storeValue( pParseInfo4,
+                            &instptr[5],
+                            POINTER+5,
+                            pASM->nativeEndian,
+                            yylineno );
+                INCPOINTER(pParseInfo4->n+5);
+            }
+
+	| STR memory delim REG
+            {
+                pParseInfo1 = (tzParseInfo *)&$1;
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HSTX | ( pParseInfo1->value.op & ( BYTE | WORD ) );
+                instptr[3] = ( ( pParseInfo4->value.regnum & 0x0F ) << 4 ) +
+                             pParseInfo2->value.mem.base;
+                instptr[4] = ( pParseInfo2->value.mem.index << 4 ) +
+                             ( pParseInfo2->value.mem.scale & 0x0F );
+                CheckParseInfo(&instptr[1], pParseInfo4, pParseInfo2, yylineno);
+                storeValue( pParseInfo2,
+                            &instptr[5],
+                            POINTER+5,
+                            pASM->nativeEndian,
+                            yylineno );
+                INCPOINTER(pParseInfo2->n+5);
+            }
+
 	| STR args2
             {
                 pParseInfo1 = (tzParseInfo *)&$1;
@@ -505,10 +576,69 @@ smplcmd	: DAT val
                 instptr[2] = pParseInfo1->value.op | MODE_REG;
                 instptr[3] = pParseInfo2->value.regnum & 0x0F;
                 CheckParseInfo(&instptr[1], pParseInfo2, pParseInfo4, yylineno);
-                storeValue( pParseInfo4, &instptr[4], POINTER+4, yylineno );
+                storeValue( pParseInfo4,
+                            &instptr[4],
+                            POINTER+4,
+                            pASM->nativeEndian,
+                            yylineno );
+                INCPOINTER(pParseInfo4->n+4);
+            }
+
+    | local REG delim NUM
+            {
+                pParseInfo1 = (tzParseInfo *)&$1;
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                if( ( pParseInfo4->type == eUINT8 ) &&
+                    ( pParseInfo4->value.ucVal > 0x7F ) )
+                {
+                    /* the displacement is signed */
+                    pParseInfo4->type = eUINT16;
+                    pParseInfo4->value.uiVal = pParseInfo4->value.ucVal;
+                    pParseInfo4->n = 2;
+                    pParseInfo4->width = 2;
+                }
+
+                if( ( pParseInfo4->width > 2 ) ||
+                    ( ( pParseInfo4->type == eUINT16 ) &&
+                      ( pParseInfo4->value.uiVal > 0x7FFF ) ) )
+                {
+                    errmsg("Invalid displacement", yylineno );
+                    exit(1);
+                }
+
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = pParseInfo1->value.op;
+                instptr[3] = pParseInfo2->value.regnum & 0x0F;
+                CheckParseInfo(&instptr[1], pParseInfo2, pParseInfo4, yylineno);
+                storeValue( pParseInfo4,
+                            &instptr[4],
+                            POINTER+4,
+                            pASM->nativeEndian,
+                            yylineno );
                 INCPOINTER(pParseInfo4->n+4);
             }
 
+    | branch REG delim REG delim LABEL
+            {
+                pParseInfo1 = (tzParseInfo *)&$1;
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                pParseInfo3 = (tzParseInfo *)&$6;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT | WORD;
+                instptr[2] = pParseInfo1->value.op;
+                instptr[3] = ( ( pParseInfo2->value.regnum & 0x0F ) << 4 ) +
+                             ( pParseInfo4->value.regnum & 0x0F );
+
+                /* leave room for a 16-bit branch target */
+                enterLabel( pParseInfo3->value.pStrVal, POINTER+4 );
+                INCPOINTER(6);
+            }
+
 	| RDN REG
             {
                 pParseInfo1 = (tzParseInfo *)&$1;
@@ -561,7 +691,11 @@ smplcmd	: DAT val
                 instptr[0] = HNEXT;
                 instptr[1] = pParseInfo1->value.op;
                 CheckParseInfo(&instptr[1], pParseInfo1, pParseInfo2, yylineno);
-                storeValue( pParseInfo2, &instptr[2], POINTER+2, yylineno );
+                storeValue( pParseInfo2,
+                            &instptr[2],
+                            POINTER+2,
+                            pASM->nativeEndian,
+                            yylineno );
                 INCPOINTER(pParseInfo2->n+2);
             }
 
@@ -590,7 +724,11 @@ smplcmd	: DAT val
                 }
                 else
                 {
-                    storeValue( pParseInfo2, &instptr[2], POINTER+2, yylineno );
+                    storeValue( pParseInfo2,
+                                &instptr[2],
+                                POINTER+2,
+                                pASM->nativeEndian,
+                                yylineno );
                 }
 
                 INCPOINTER(pParseInfo2->n+2);
@@ -641,7 +779,11 @@ smplcmd	: DAT val
                 }
                 else
                 {
-                    storeValue( pParseInfo2, &instptr[1], POINTER+1, yylineno );
+                    storeValue( pParseInfo2,
+                                &instptr[1],
+                                POINTER+1,
+                                pASM->nativeEndian,
+                                yylineno );
                 }
 
                 INCPOINTER(pParseInfo2->n+1);
@@ -734,6 +876,124 @@ smplcmd	: DAT val
                 INCPOINTER(3);
             }
 
+    | EVQ REG
+            {
+                pParseInfo2 = (tzParseInfo *)&$2;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HEVQ;
+                instptr[3] = pParseInfo2->value.regnum & 0x0F;
+                INCPOINTER(4);
+            }
+
+    | VEC REG delim REG delim REG
+            {
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                pParseInfo3 = (tzParseInfo *)&$6;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HVEC;
+                instptr[3] = ( ( pParseInfo2->value.regnum & 0x0F ) << 4 ) +
+                             ( pParseInfo4->value.regnum & 0x0F );
+                instptr[4] = pParseInfo3->value.regnum & 0x0F;
+                INCPOINTER(5);
+            }
+
+    | DSP REG delim REG
+            {
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HDSP;
+                instptr[3] = ( ( pParseInfo2->value.regnum & 0x0F ) << 4 ) +
+                             ( pParseInfo4->value.regnum & 0x0F );
+                INCPOINTER(4);
+            }
+
+    | MGT REG delim REG
+            {
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HMGT;
+                instptr[3] = ( ( pParseInfo2->value.regnum & 0x0F ) << 4 ) +
+                             ( pParseInfo4->value.regnum & 0x0F );
+                INCPOINTER(4);
+            }
+
+    | MST REG delim REG
+            {
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HMST;
+                instptr[3] = ( ( pParseInfo2->value.regnum & 0x0F ) << 4 ) +
+                             ( pParseInfo4->value.regnum & 0x0F );
+                INCPOINTER(4);
+            }
+
+    | TXB
+            {
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HTXB;
+                INCPOINTER(3);
+            }
+
+    | TXC REG
+            {
+                pParseInfo2 = (tzParseInfo *)&$2;
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT;
+                instptr[2] = HTXC;
+                instptr[3] = pParseInfo2->value.regnum & 0x0F;
+                INCPOINTER(4);
+            }
+
+    | IMP REG delim STRING
+            {
+                int slot;
+                uint16_t slot16;
+                pParseInfo2 = (tzParseInfo *)&$2;
+                pParseInfo4 = (tzParseInfo *)&$4;
+                slot = AddImport( pParseInfo4->value.pStrVal );
+                if( ( slot < 0 ) || ( slot > 0xFFFF ) )
+                {
+                    errmsg("Invalid import", yylineno );
+                    exit(1);
+                }
+
+                instptr = (unsigned char *)&(MEMORY[POINTER]);
+                instptr[0] = HNEXT;
+                instptr[1] = HNEXT | WORD;
+                instptr[2] = HIMP;
+                instptr[3] = pParseInfo2->value.regnum & 0x0F;
+
+                /* 16-bit import table slot */
+                slot16 = (uint16_t)slot;
+                if( pASM->nativeEndian )
+                {
+                    memcpy( &instptr[4], &slot16, sizeof( slot16 ) );
+                }
+                else
+                {
+                    instptr[4] = ( slot16 >> 8 ) & 0xFF;
+                    instptr[5] = slot16 & 0xFF;
+                }
+                INCPOINTER(6);
+            }
+
     | WFS REG delim REG
             {
                 pParseInfo1 = (tzParseInfo *)&$1;
@@ -908,7 +1168,11 @@ args1	: REG delim val
                 }
                 else
                 {
-                    storeValue( pParseInfo3, &instptr[2], POINTER+2, yylineno );
+                    storeValue( pParseInfo3,
+                                &instptr[2],
+                                POINTER+2,
+                                pASM->nativeEndian,
+                                yylineno );
                 }
 
                 /* pass some information back to out parent */
@@ -955,7 +1219,11 @@ args2	: val delim REG
                 }
                 else
                 {
-                    storeValue( pParseInfo1, &instptr[2], POINTER+2, yylineno );
+                    storeValue( pParseInfo1,
+                                &instptr[2],
+                                POINTER+2,
+                                pASM->nativeEndian,
+                                yylineno );
                 }
 
                 parseInfo.n = pParseInfo1->n + pParseInfo3->n;
@@ -1003,6 +1271,44 @@ badarg	: val
 	| REG
 	;
 
+memory	: LBRACKET REG RBRACKET
+            {
+                $$ = EncodeMemory( &$2, NULL, NULL, NULL, yylineno );
+            }
+
+	| LBRACKET REG disp RBRACKET
+            {
+                $$ = EncodeMemory( &$2, NULL, NULL, &$3, yylineno );
+            }
+
+	| LBRACKET REG PLUS REG RBRACKET
+            {
+                $$ = EncodeMemory( &$2, &$4, NULL, NULL, yylineno );
+            }
+
+	| LBRACKET REG PLUS REG disp RBRACKET
+            {
+                $$ = EncodeMemory( &$2, &$4, NULL, &$5, yylineno );
+            }
+
+	| LBRACKET REG PLUS REG TIMES NUM RBRACKET
+            {
+                $$ = EncodeMemory( &$2, &$4, &$6, NULL, yylineno );
+            }
+
+	| LBRACKET REG PLUS REG TIMES NUM disp RBRACKET
+            {
+                $$ = EncodeMemory( &$2, &$4, &$6, &$7, yylineno );
+            }
+	;
+
+disp	: NUM
+	| PLUS NUM
+            {
+                $$ = $2;
+            }
+	;
+
 instr2	: LOD
 	| MOV
 	| ADD
@@ -1018,6 +1324,16 @@ shift	: SHR
 	| SHL
 	;
 
+local	: LDL
+	| STL
+	;
+
+branch	: BLT
+	| BLE
+	| BEQ
+	| BNE
+	;
+
 jump	: JMP
 	| JZR
 	| JNZ
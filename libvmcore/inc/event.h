@@ -0,0 +1,247 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+#ifndef EVENT_H
+#define EVENT_H
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <signal.h>
+
+/*==============================================================================
+        Public definitions
+==============================================================================*/
+
+/*! signal number reported for a timer expiration */
+#define EVENT_SIG_TIMER ( SIGRTMIN+5 )
+
+/*! first external variable notification signal */
+#define EVENT_SIG_FIRST ( SIGRTMIN+6 )
+
+/*! last external variable notification signal */
+#define EVENT_SIG_LAST ( SIGRTMIN+9 )
+
+/*! maximum number of program timers */
+#define EVENT_MAX_TIMERS ( 65536 )
+
+/*! resolution of the program timers in milliseconds */
+#define EVENT_TICK_MS ( 1 )
+
+/*! number of slots in the timer wheel */
+#define EVENT_WHEEL_SIZE ( 1024 )
+
+/*! maximum number of signals waiting in the ready queue.
+    This must be a power of 2 */
+#define EVENT_QUEUE_SIZE ( 256 )
+
+/*! maximum number of signals read from the signalfd by one read */
+#define EVENT_READ_BATCH ( 32 )
+
+/*! the tzEvent object is a signal received by the VM program */
+typedef struct zEvent
+{
+    /*! signal number, or 0 for a signal discarded by the filter */
+    int signum;
+
+    /*! signal id: the timer identifier or the notification value */
+    int id;
+} tzEvent;
+
+/*! the tzEventSlot object is one entry of the ready queue.  The
+    sequence number tells producers when the slot is free, and the
+    consumer when the event in the slot has been written */
+typedef struct zEventSlot
+{
+    /*! sequence number of the slot */
+    atomic_uint seq;
+
+    /*! queued signal */
+    tzEvent event;
+} tzEventSlot;
+
+/*! the tzEventTimer object is a program timer in the timer wheel.
+    Timers are linked by their identifier, and 0 ends a list */
+typedef struct zEventTimer
+{
+    /*! tick when the timer next expires */
+    uint64_t expiry;
+
+    /*! timer period in ticks, or 0 for a one-shot timer */
+    uint32_t interval;
+
+    /*! next timer in the same wheel slot */
+    uint32_t next;
+
+    /*! previous timer in the same wheel slot */
+    uint32_t prev;
+
+    /*! next timer in the expired list */
+    uint32_t nextExpired;
+
+    /*! set while the timer is in the timer wheel */
+    bool active;
+
+    /*! set while the timer is in the expired list */
+    bool pending;
+} tzEventTimer;
+
+/*! the tzEventHandler object maps a signal number and signal id to the
+    program address which handles the signal */
+typedef struct zEventHandler
+{
+    /*! signal number, or 0 for an unused entry */
+    int signum;
+
+    /*! signal id, or 0 to handle every id of the signal number */
+    int id;
+
+    /*! program address of the handler, or 0 if the handler was removed */
+    uint32_t address;
+} tzEventHandler;
+
+/*! the tzEvents object is the event backend of a VM instance.  Program
+    timers are kept in a hashed timer wheel driven by a single timerfd,
+    and the notification signals are received through a signalfd.  Both
+    are registered with a single epoll instance.  Expired timers and
+    received signals are consumed by the WFS instruction.
+
+    The ready queue is a bounded lock-free multi-producer single-consumer
+    ring, so that other threads of the host can post events to the
+    program without taking a lock.  Only the thread running the program
+    may consume events */
+typedef struct zEvents
+{
+    /*! epoll instance watching the timer wheel and notification signals */
+    int epfd;
+
+    /*! signalfd receiving the notification signals, or -1 */
+    int sigfd;
+
+    /*! timerfd which expires at the next occupied wheel slot */
+    int timerfd;
+
+    /*! eventfd which wakes the program when an event is posted */
+    int postfd;
+
+    /*! program timers indexed by their identifier */
+    tzEventTimer *pTimers;
+
+    /*! number of entries in the timer array */
+    size_t numTimers;
+
+    /*! first timer in each slot of the timer wheel */
+    uint32_t wheel[EVENT_WHEEL_SIZE];
+
+    /*! monotonic clock time of tick 0 in milliseconds */
+    uint64_t base;
+
+    /*! last tick processed by the timer wheel */
+    uint64_t tick;
+
+    /*! tick when the timerfd expires, or 0 if it is not armed */
+    uint64_t armed;
+
+    /*! first timer in the expired list */
+    uint32_t expiredHead;
+
+    /*! last timer in the expired list */
+    uint32_t expiredTail;
+
+    /*! number of timers in the expired list */
+    size_t expired;
+
+    /*! ready queue of received and posted signals */
+    tzEventSlot queue[EVENT_QUEUE_SIZE];
+
+    /*! position of the next signal to take from the ready queue */
+    unsigned int head;
+
+    /*! position of the next signal to add to the ready queue */
+    atomic_uint tail;
+
+    /*! position of the next signal to pass to the filter function */
+    unsigned int filtered;
+
+    /*! tick when the signalfd was last read by EVENT_fnSync */
+    uint64_t synced;
+
+    /*! number of posted signals lost because the ready queue was full */
+    atomic_uint overflow;
+
+    /*! set while the postfd has been written and not yet read */
+    atomic_bool posted;
+
+    /*! open addressed hash table of the signal handlers */
+    tzEventHandler *pHandlers;
+
+    /*! number of entries in the signal handler table */
+    size_t numHandlers;
+
+    /*! number of used entries in the signal handler table */
+    size_t usedHandlers;
+
+    /*! function which decides if a queued signal is received, or NULL */
+    bool (*pfnFilter)( void *pArg, int signum, int id );
+
+    /*! argument passed to the pfnFilter function */
+    void *pFilterArg;
+} tzEvents;
+
+/*==============================================================================
+        Public function declarations
+==============================================================================*/
+
+int EVENT_fnInit( tzEvents *pEvents );
+void EVENT_fnDestroy( tzEvents *pEvents );
+int EVENT_fnStartTimer( tzEvents *pEvents,
+                        uint32_t id,
+                        uint32_t intervalMS,
+                        bool periodic );
+int EVENT_fnStopTimer( tzEvents *pEvents, uint32_t id );
+int EVENT_fnEnableSignals( tzEvents *pEvents );
+int EVENT_fnWait( tzEvents *pEvents, bool block, int *signum, int *id );
+int EVENT_fnGetFd( tzEvents *pEvents );
+size_t EVENT_fnPending( tzEvents *pEvents );
+void EVENT_fnSync( tzEvents *pEvents );
+int EVENT_fnPost( tzEvents *pEvents, int signum, int id );
+unsigned int EVENT_fnOverflow( tzEvents *pEvents );
+void EVENT_fnSetFilter( tzEvents *pEvents,
+                        bool (*pfnFilter)( void *pArg, int signum, int id ),
+                        void *pArg );
+int EVENT_fnSetHandler( tzEvents *pEvents,
+                        int signum,
+                        int id,
+                        uint32_t address );
+int EVENT_fnGetHandler( tzEvents *pEvents,
+                        int signum,
+                        int id,
+                        uint32_t *pAddress );
+
+#endif
@@ -29,6 +29,7 @@ SOFTWARE.
 ==============================================================================*/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /*==============================================================================
         Public definitions
@@ -38,21 +39,57 @@ SOFTWARE.
 #define EOK 0
 #endif
 
+/*! Maximum number of open files in the virtual machine */
+#define MAX_OPEN_FILES ( 20 )
+
+/*! File Descriptor object to associated the file descriptor and its mode */
+typedef struct _FileDescriptor
+{
+    /*! file descriptor id */
+    uint32_t fd;
+
+    /*! file descriptor mode 'r' or 'w' */
+    char mode;
+
+    /*! set if the file was opened by the VM and must be closed by it */
+    bool opened;
+} FileDescriptor;
+
+/*! The tzFiles object holds the open files of a VM instance */
+typedef struct zFiles
+{
+    /*! the currently active read file descriptor */
+    int active_read_fd;
+
+    /*! the currently active write file descriptor */
+    int active_write_fd;
+
+    /*! number of open files */
+    int numOpenFiles;
+
+    /*! file descriptor storage */
+    FileDescriptor files[MAX_OPEN_FILES];
+} tzFiles;
+
 /*==============================================================================
         Public function declarations
 ==============================================================================*/
 
-void InitFiles( void );
-int SetExternWriteFileDescriptor( int fd, char mode );
-int ClearExternFileDescriptor( int fd );
-int SetActiveFileDescriptor( int fd );
-int OpenFileDescriptor( int stringID, char mode, int *fd );
-int CloseFileDescriptor( int fd );
-int WriteString( char *str );
-int WriteNum( int n );
-int WriteFloat( float f );
-int WriteChar( char c );
-int ReadNum( int *n );
-int ReadChar( char *c );
+void InitFiles( tzFiles *pFiles );
+void CloseFiles( tzFiles *pFiles );
+int SetExternWriteFileDescriptor( tzFiles *pFiles, int fd, char mode );
+int ClearExternFileDescriptor( tzFiles *pFiles, int fd );
+int SetActiveFileDescriptor( tzFiles *pFiles, int fd );
+int OpenFileDescriptor( tzFiles *pFiles,
+                        char *pFileName,
+                        char mode,
+                        int *fd );
+int CloseFileDescriptor( tzFiles *pFiles, int fd );
+int WriteString( tzFiles *pFiles, char *str );
+int WriteNum( tzFiles *pFiles, int n );
+int WriteFloat( tzFiles *pFiles, float f );
+int WriteChar( tzFiles *pFiles, char c );
+int ReadNum( tzFiles *pFiles, int *n );
+int ReadChar( tzFiles *pFiles, char *c );
 
 #endif
@@ -0,0 +1,106 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+#ifndef JIT_H
+#define JIT_H
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*==============================================================================
+        Public definitions
+==============================================================================*/
+
+/*! zero flag bit of the VM core status register */
+#define JIT_ZFLAG   0x00000001
+
+/*! negative flag bit of the VM core status register */
+#define JIT_NFLAG   0x00000002
+
+/*! carry flag bit of the VM core status register */
+#define JIT_CFLAG   0x00000004
+
+/*! opaque JIT compiler object */
+typedef struct zJIT tzJIT;
+
+/*! the tzJITConfig object describes the VM core state which is accessed
+    directly by the translated code */
+typedef struct zJITConfig
+{
+    /*! opaque pointer to the VM core passed to pfnStep */
+    void *pCore;
+
+    /*! pointer to the 16 VM core registers (R14=SP, R15=PC) */
+    int32_t *pReg;
+
+    /*! pointer to the VM core status register */
+    uint32_t *pStatus;
+
+    /*! pointer to the VM core memory */
+    uint8_t *pMemory;
+
+    /*! size of the VM core memory */
+    size_t coreSize;
+
+    /*! size of the program loaded into the VM core memory */
+    size_t programSize;
+
+    /*! pointer to the VM core running state */
+    bool *pRunning;
+
+    /*! pointer to the VM core error state */
+    bool *pError;
+
+    /*! pointer to the VM core flag set when the VM core memory uses the
+        host byte order instead of big endian format */
+    bool *pNativeEndian;
+
+    /*! pointer to the VM core flag set when the program has an
+        instruction budget */
+    bool *pBudgeted;
+
+    /*! pointer to the remaining instruction budget of the program */
+    uint32_t *pBudget;
+
+    /*! function to execute the instruction at the PC using the interpreter */
+    void (*pfnStep)( void *pCore );
+} tzJITConfig;
+
+/*==============================================================================
+        Public function declarations
+==============================================================================*/
+
+bool JIT_fnSupported( void );
+tzJIT *JIT_fnCreate( tzJITConfig *pConfig );
+void JIT_fnDestroy( tzJIT *pJIT );
+int JIT_fnExecute( tzJIT *pJIT );
+void JIT_fnReset( tzJIT *pJIT, size_t programSize );
+void JIT_fnInvalidate( tzJIT *pJIT, uint32_t addr, size_t len );
+
+#endif
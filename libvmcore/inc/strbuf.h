@@ -30,26 +30,88 @@ SOFTWARE.
 ==============================================================================*/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include "files.h"
+
+/*==============================================================================
+        Public definitions
+==============================================================================*/
+
+/*! The tzStringBuffer object defines the attributes of a string buffer */
+typedef struct zStringBuffer
+{
+    /*! string buffer identifier */
+    int id;
+
+    /*! call stack level */
+    int level;
+
+    /*! string buffer write location (for append operations) */
+    size_t offset;
+
+    /*! string buffer read/write location for character operations */
+    size_t rwOffset;
+
+    /*! total size of the string buffer */
+    size_t size;
+
+    /*! pointer to the memory buffer */
+    char *pBuffer;
+
+    /*! pointer to the next string buffer in the list */
+    struct zStringBuffer *pNext;
+
+} tzStringBuffer;
+
+/*! The tzStringBufferList object holds the string buffers of a VM instance */
+typedef struct zStringBufferList
+{
+    /*! pointer to the first string buffer */
+    tzStringBuffer *pFirst;
+
+    /*! pointer to the list of freed string buffers */
+    tzStringBuffer *pFreeList;
+
+    /*! current call stack level */
+    int level;
+
+} tzStringBufferList;
 
 /*==============================================================================
         Public function declarations
 ==============================================================================*/
 
-void STRINGBUFFER_fnSetLevel( int level );
-bool STRINGBUFFER_fnCreate( int id );
-void STRINGBUFFER_fnClear( int id );
-void STRINGBUFFER_fnAppendChar( int id, char c );
-void STRINGBUFFER_fnAppendNumber( int id, int32_t number );
-void STRINGBUFFER_fnAppendFloat( int id, float number );
-void STRINGBUFFER_fnAppendString( int id, char *string );
-void STRINGBUFFER_fnAppendBuffer( int dest_id, int src_id );
-void STRINGBUFFER_fnWrite( FILE *fp, int id );
-char *STRINGBUFFER_fnGet( int id );
-void STRINGBUFFER_fnFree( int level );
-size_t STRINGBUFFER_fnGetLength( int id );
-void STRINGBUFFER_fnSetRWOffset( int id, uint32_t offset );
-char STRINGBUFFER_fnGetCharAtOffset( int id );
-void STRINGBUFFER_fnSetCharAtOffset( int id, char c );
+void STRINGBUFFER_fnInit( tzStringBufferList *pList );
+void STRINGBUFFER_fnDestroy( tzStringBufferList *pList );
+void STRINGBUFFER_fnSetLevel( tzStringBufferList *pList, int level );
+bool STRINGBUFFER_fnCreate( tzStringBufferList *pList, int id );
+void STRINGBUFFER_fnClear( tzStringBufferList *pList, int id );
+void STRINGBUFFER_fnAppendChar( tzStringBufferList *pList, int id, char c );
+void STRINGBUFFER_fnAppendNumber( tzStringBufferList *pList,
+                                  int id,
+                                  int32_t number );
+void STRINGBUFFER_fnAppendFloat( tzStringBufferList *pList,
+                                 int id,
+                                 float number );
+void STRINGBUFFER_fnAppendString( tzStringBufferList *pList,
+                                  int id,
+                                  char *string );
+void STRINGBUFFER_fnAppendBuffer( tzStringBufferList *pList,
+                                  int dest_id,
+                                  int src_id );
+void STRINGBUFFER_fnWrite( tzStringBufferList *pList,
+                           tzFiles *pFiles,
+                           int id );
+char *STRINGBUFFER_fnGet( tzStringBufferList *pList, int id );
+void STRINGBUFFER_fnFree( tzStringBufferList *pList, int level );
+size_t STRINGBUFFER_fnGetLength( tzStringBufferList *pList, int id );
+void STRINGBUFFER_fnSetRWOffset( tzStringBufferList *pList,
+                                 int id,
+                                 uint32_t offset );
+char STRINGBUFFER_fnGetCharAtOffset( tzStringBufferList *pList, int id );
+void STRINGBUFFER_fnSetCharAtOffset( tzStringBufferList *pList,
+                                     int id,
+                                     char c );
 
 #endif
\ No newline at end of file
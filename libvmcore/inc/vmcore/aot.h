@@ -0,0 +1,404 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+#ifndef AOT_H
+#define AOT_H
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*==============================================================================
+        Public definitions
+==============================================================================*/
+
+/*! version of the native module interface */
+#define VMAOT_VERSION   ( 2 )
+
+/*! name of the tzVMAOTInfo object exported by a native module */
+#define VMAOT_INFO_SYMBOL       "VMAOT_info"
+
+/*! name of the entry point exported by a native module */
+#define VMAOT_EXECUTE_SYMBOL    "VMAOT_fnExecute"
+
+/*! zero flag bit of the VM core status register */
+#define VMAOT_ZFLAG     0x00000001
+
+/*! negative flag bit of the VM core status register */
+#define VMAOT_NFLAG     0x00000002
+
+/*! carry flag bit of the VM core status register */
+#define VMAOT_CFLAG     0x00000004
+
+/*! the tzVMAOTContext object describes the VM core state which is
+    accessed directly by a native module */
+typedef struct zVMAOTContext
+{
+    /*! opaque pointer to the VM core passed to pfnStep */
+    void *pCore;
+
+    /*! pointer to the 16 VM core registers (R14=SP, R15=PC) */
+    int32_t *pReg;
+
+    /*! pointer to the VM core status register */
+    uint32_t *pStatus;
+
+    /*! pointer to the VM core memory */
+    uint8_t *pMemory;
+
+    /*! size of the VM core memory */
+    size_t coreSize;
+
+    /*! size of the program loaded into the VM core memory */
+    size_t programSize;
+
+    /*! pointer to the VM core running state */
+    bool *pRunning;
+
+    /*! pointer to the VM core error state */
+    bool *pError;
+
+    /*! pointer to the flag set when the program image is modified */
+    bool *pStale;
+
+    /*! pointer to the flag set when the program has an instruction budget */
+    bool *pBudgeted;
+
+    /*! pointer to the remaining instruction budget of the program */
+    uint32_t *pBudget;
+
+    /*! function to execute the instruction at the PC using the interpreter */
+    void (*pfnStep)( void *pCore );
+} tzVMAOTContext;
+
+/*! the tzVMAOTInfo object identifies the program image a native
+    module was generated from */
+typedef struct zVMAOTInfo
+{
+    /*! native module interface version */
+    uint32_t version;
+
+    /*! size of the program image */
+    uint32_t programSize;
+
+    /*! checksum of the program image calculated by CORE_fnChecksum */
+    uint32_t checksum;
+} tzVMAOTInfo;
+
+/*! The following macros are used by the code generated by vaot.
+    They expect the VM core context in pCtx and the cached VM status
+    register in st */
+
+/*! set the zero, negative and carry flags from a result */
+#define VMAOT_SETFLAGS(OLD,VAL) \
+    st = ( st & ~( VMAOT_ZFLAG | VMAOT_NFLAG | VMAOT_CFLAG ) ) | \
+         ( ( (VAL) == 0 ) ? VMAOT_ZFLAG : 0 ) | \
+         ( ( (VAL) < 0 ) ? VMAOT_NFLAG : 0 ) | \
+         ( ( ( (OLD) ^ (VAL) ) < 0 ) ? VMAOT_CFLAG : 0 )
+
+/*! return to the VM core and continue at the specified address */
+#define VMAOT_EXIT(PC) { \
+            *pCtx->pStatus = st; \
+            pCtx->pReg[15] = (PC); \
+            return 0; \
+            }
+
+/*! return to the VM core to interpret the instruction at the address */
+#define VMAOT_BAIL(PC) { \
+            *pCtx->pStatus = st; \
+            pCtx->pReg[15] = (PC); \
+            return 1; \
+            }
+
+/*! charge a taken branch to the instruction budget, and return to the
+    VM core at the branch target when the budget has been used */
+#define VMAOT_PREEMPT(PC) \
+            if( *pCtx->pBudgeted ) \
+            { \
+                if( *pCtx->pBudget == 0 ) VMAOT_EXIT(PC); \
+                (*pCtx->pBudget)--; \
+            }
+
+/*! interpret the instruction at the address, and return to the VM core */
+#define VMAOT_CALL(PC) { \
+            *pCtx->pStatus = st; \
+            pCtx->pReg[15] = (PC); \
+            pCtx->pfnStep( pCtx->pCore ); \
+            return 0; \
+            }
+
+/*! interpret the instruction at the address, and continue with the
+    native code if execution continues at the next instruction */
+#define VMAOT_STEP(PC,NEXT) { \
+            *pCtx->pStatus = st; \
+            pCtx->pReg[15] = (PC); \
+            pCtx->pfnStep( pCtx->pCore ); \
+            st = *pCtx->pStatus; \
+            if( ( *pCtx->pRunning == false ) || \
+                ( *pCtx->pError == true ) || \
+                ( *pCtx->pStale == true ) || \
+                ( pCtx->pReg[15] != (NEXT) ) ) \
+            { \
+                return 0; \
+            } \
+            }
+
+/*==============================================================================
+        Public function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  VMAOT_fnLoad                                                              */
+/*!
+    Load a big endian value from the VM core memory
+
+    The VMAOT_fnLoad function implements the data transfer of the LOD
+    instruction.  Only the bytes specified by the width are replaced in
+    the register value.
+
+    @param[in]
+        pMemory
+            pointer to the VM core memory
+
+    @param[in]
+        addr
+            address to load from
+
+    @param[in]
+        width
+            number of bytes to load (1, 2, or 4)
+
+    @param[in]
+        reg
+            current value of the destination register
+
+    @retval new value of the destination register
+
+==============================================================================*/
+static inline int32_t VMAOT_fnLoad( const uint8_t *pMemory,
+                                    uint32_t addr,
+                                    int width,
+                                    int32_t reg )
+{
+    const uint8_t *p = &pMemory[addr];
+
+    switch( width )
+    {
+        case 1:
+            return (int32_t)( ( (uint32_t)reg & 0xFFFFFF00 ) | p[0] );
+
+        case 2:
+            return (int32_t)( ( (uint32_t)reg & 0xFFFF0000 ) |
+                              ( p[0] << 8 ) | p[1] );
+
+        default:
+            return (int32_t)( ( (uint32_t)p[0] << 24 ) |
+                              ( p[1] << 16 ) |
+                              ( p[2] << 8 ) |
+                              p[3] );
+    }
+}
+
+/*============================================================================*/
+/*  VMAOT_fnStore                                                             */
+/*!
+    Store a big endian value into the VM core memory
+
+    The VMAOT_fnStore function implements the data transfer of the STR
+    instruction.
+
+    @param[in]
+        pMemory
+            pointer to the VM core memory
+
+    @param[in]
+        addr
+            address to store to
+
+    @param[in]
+        width
+            number of bytes to store (1, 2, or 4)
+
+    @param[in]
+        val
+            register value to store
+
+==============================================================================*/
+static inline void VMAOT_fnStore( uint8_t *pMemory,
+                                  uint32_t addr,
+                                  int width,
+                                  int32_t val )
+{
+    uint8_t *p = &pMemory[addr];
+
+    switch( width )
+    {
+        case 1:
+            p[0] = (uint8_t)val;
+            break;
+
+        case 2:
+            p[0] = (uint8_t)( val >> 8 );
+            p[1] = (uint8_t)val;
+            break;
+
+        default:
+            p[0] = (uint8_t)( val >> 24 );
+            p[1] = (uint8_t)( val >> 16 );
+            p[2] = (uint8_t)( val >> 8 );
+            p[3] = (uint8_t)val;
+            break;
+    }
+}
+
+/*============================================================================*/
+/*  VMAOT_fnLoadNative                                                        */
+/*!
+    Load a host byte order value from the VM core memory
+
+    The VMAOT_fnLoadNative function implements the data transfer of the
+    LOD instruction for a VM core memory which uses the host byte order.
+    Only the bytes specified by the width are replaced in the register
+    value.
+
+    @param[in]
+        pMemory
+            pointer to the VM core memory
+
+    @param[in]
+        addr
+            address to load from
+
+    @param[in]
+        width
+            number of bytes to load (1, 2, or 4)
+
+    @param[in]
+        reg
+            current value of the destination register
+
+    @retval new value of the destination register
+
+==============================================================================*/
+static inline int32_t VMAOT_fnLoadNative( const uint8_t *pMemory,
+                                          uint32_t addr,
+                                          int width,
+                                          int32_t reg )
+{
+    uint16_t val16;
+    int32_t val32;
+
+    switch( width )
+    {
+        case 1:
+            return (int32_t)( ( (uint32_t)reg & 0xFFFFFF00 ) | pMemory[addr] );
+
+        case 2:
+            memcpy( &val16, &pMemory[addr], sizeof( val16 ) );
+            return (int32_t)( ( (uint32_t)reg & 0xFFFF0000 ) | val16 );
+
+        default:
+            memcpy( &val32, &pMemory[addr], sizeof( val32 ) );
+            return val32;
+    }
+}
+
+/*============================================================================*/
+/*  VMAOT_fnStoreNative                                                       */
+/*!
+    Store a host byte order value into the VM core memory
+
+    The VMAOT_fnStoreNative function implements the data transfer of the
+    STR instruction for a VM core memory which uses the host byte order.
+
+    @param[in]
+        pMemory
+            pointer to the VM core memory
+
+    @param[in]
+        addr
+            address to store to
+
+    @param[in]
+        width
+            number of bytes to store (1, 2, or 4)
+
+    @param[in]
+        val
+            register value to store
+
+==============================================================================*/
+static inline void VMAOT_fnStoreNative( uint8_t *pMemory,
+                                        uint32_t addr,
+                                        int width,
+                                        int32_t val )
+{
+    uint16_t val16 = (uint16_t)val;
+
+    switch( width )
+    {
+        case 1:
+            pMemory[addr] = (uint8_t)val;
+            break;
+
+        case 2:
+            memcpy( &pMemory[addr], &val16, sizeof( val16 ) );
+            break;
+
+        default:
+            memcpy( &pMemory[addr], &val, sizeof( val ) );
+            break;
+    }
+}
+
+/*============================================================================*/
+/*  VMAOT_fnFloat                                                             */
+/*!
+    Get the floating point value of a VM register
+
+    The VMAOT_fnFloat function reinterprets a VM register value as the
+    IEEE754 single precision value it holds, for the floating point
+    compare and branch instructions.
+
+    @param[in]
+        reg
+            VM register value
+
+    @retval floating point value of the register
+
+==============================================================================*/
+static inline float VMAOT_fnFloat( int32_t reg )
+{
+    float val;
+
+    memcpy( &val, &reg, sizeof( val ) );
+    return val;
+}
+
+#endif
@@ -105,16 +105,105 @@ SOFTWARE.
 
 #define HMDUMP 0x00
 #define HRDUMP 0x01
+#define HLDL   0x02
+#define HSTL   0x03
+#define HBLT   0x04
+#define HBLE   0x05
+#define HBEQ   0x06
+#define HBNE   0x07
+#define HLDX   0x08
+#define HSTX   0x09
+#define HEVQ   0x0A
+#define HVEC   0x0B
+#define HDSP   0x0C
+#define HMGT   0x0D
+#define HMST   0x0E
+#define HTXB   0x0F
+#define HTXC   0x10
+#define HIMP   0x11
 
 #define HDAT   0xA4
 
+/*! magic number at the start of a VM core image with a header.  It is
+    an illegal instruction, so it cannot start a headerless image */
+#define CORE_IMAGE_MAGIC { HNEXT, HNEXT, HNEXT, 'V' }
+
+/*! length of the VM core image magic number */
+#define CORE_IMAGE_MAGIC_LEN ( 4 )
+
+/*! VM core image header version */
+#define CORE_IMAGE_VERSION ( 1 )
+
+/*! image flag: multi-byte values in the image are stored little endian */
+#define CORE_IMAGE_LITTLE_ENDIAN ( 0x01 )
+
+/*! image flag: an import table of external variable names follows the
+    header.  Each name is NUL terminated, and the table is terminated by
+    an empty name */
+#define CORE_IMAGE_IMPORTS ( 0x02 )
+
+/*! STM interval flag: the timer expires once instead of periodically */
+#define CORE_TIMER_ONESHOT ( 0x40000000 )
+
+/*! STM interval mask: the timer interval in milliseconds */
+#define CORE_TIMER_INTERVAL ( 0x3FFFFFFF )
+
 typedef struct zCore tzCore;
 
+/*! VM core image header.  Images without a header (legacy images)
+    store all multi-byte values in big endian format */
+typedef struct zCoreImageHeader
+{
+    /*! magic number CORE_IMAGE_MAGIC */
+    uint8_t magic[CORE_IMAGE_MAGIC_LEN];
+
+    /*! image header version */
+    uint8_t version;
+
+    /*! CORE_IMAGE_xxx image flags */
+    uint8_t flags;
+
+    /*! reserved for future use */
+    uint8_t reserved[2];
+} tzCoreImageHeader;
+
+/*! VM core execution engines */
+typedef enum eCoreEngine
+{
+    eCORE_ENGINE_DECODED=0,
+    eCORE_ENGINE_THREADED,
+    eCORE_ENGINE_JIT,
+    eCORE_ENGINE_NATIVE
+} teCoreEngine;
+
+/*! VM core run status returned by CORE_fnRun */
+typedef enum eCoreRunStatus
+{
+    /*! the program is ready to run */
+    eCORE_RUN_READY=0,
+
+    /*! the program has halted */
+    eCORE_RUN_HALTED,
+
+    /*! the program was stopped by an error */
+    eCORE_RUN_ERROR,
+
+    /*! the program used its instruction budget and can be resumed */
+    eCORE_RUN_PREEMPTED,
+
+    /*! the program is suspended in a DLY instruction */
+    eCORE_RUN_BLOCKED_DELAY,
+
+    /*! the program is suspended in a WFS instruction */
+    eCORE_RUN_BLOCKED_SIGNAL
+} teCoreRunStatus;
+
 /*==============================================================================
         Public function declarations
 ==============================================================================*/
 
 tzCore *CORE_fnCreate( size_t max_program_size, size_t max_stack_size );
+void CORE_fnDestroy( tzCore *pCore );
 uint8_t *CORE_fnMemory( tzCore *pCore );
 size_t CORE_fnSize( tzCore *pCore );
 size_t CORE_fnStackSize( tzCore *pCore );
@@ -127,10 +216,37 @@ void CORE_fnDumpMemory( tzCore *pCore,
                         FILE *fp );
 void CORE_fnDumpStack(tzCore *pCore, FILE *fp);
 bool CORE_fnLoad( tzCore *pCore, char *programFile );
+int CORE_fnLoadNative( tzCore *pCore, char *filename );
 int CORE_fnExecute( tzCore *pCore );
+teCoreRunStatus CORE_fnRun( tzCore *pCore, uint32_t budget );
+uint32_t CORE_fnGetDelay( tzCore *pCore );
+int CORE_fnDeliverSignal( tzCore *pCore, int signum, int id );
+int CORE_fnGetEventFd( tzCore *pCore );
+int CORE_fnPostEvent( tzCore *pCore, int signum, int id );
+int CORE_fnSetSignalRouter( tzCore *pCore,
+                            void (*pfnRoute)( void *pArg,
+                                              tzCore *pCore,
+                                              int signum,
+                                              uint32_t id ),
+                            void *pArg );
+unsigned int CORE_fnGetEventOverflow( tzCore *pCore );
+int CORE_fnGetResult( tzCore *pCore );
+int CORE_fnSetEngine( tzCore *pCore, teCoreEngine engine );
 void CORE_fnSetProgramSize( tzCore *pCore, size_t programSize );
 size_t CORE_fnGetProgramSize( tzCore *pCore );
+uint32_t CORE_fnChecksum( tzCore *pCore );
+size_t CORE_fnInstructionLength( tzCore *pCore, uint32_t addr );
+int CORE_fnVerify( tzCore *pCore );
+void CORE_fnSetNativeEndian( tzCore *pCore, bool nativeEndian );
+bool CORE_fnIsNativeEndian( tzCore *pCore );
 int CORE_fnInitExternalsLib( tzCore *pCore, char *libname );
 int CORE_fnShutdownExternalsLib( tzCore *pCore );
+int CORE_fnEnableExternCache( tzCore *pCore );
+int CORE_fnGetExternCacheStats( tzCore *pCore,
+                                uint32_t handle,
+                                uint32_t *pHits,
+                                uint32_t *pMisses );
+void CORE_fnDumpExternCache( tzCore *pCore, FILE *fp );
+int CORE_fnSetImports( tzCore *pCore, char **ppNames, size_t n );
 
 #endif
@@ -30,12 +30,53 @@ SOFTWARE.
 ==============================================================================*/
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 
 /*==============================================================================
         Public definitions
 ==============================================================================*/
 
+/*! version of the tzEXTVARAPI structure.  An external variable library
+    reports the version of the structure returned by its getapi() function
+    with an exported getapiversion() function.  A library without one is
+    version 1, whose structure ends at pfnClosePrintSession */
+#define EXTERNVAR_API_VERSION ( 2 )
+
+/*! MODIFIED notification request type */
+#define EXTERNVAR_NOTIFY_MODIFIED ( 1 )
+
+/*! tzExternValue type of a 32-bit integer value */
+#define EXTERNVAR_TYPE_UINT32 ( 0 )
+
+/*! tzExternValue type of a 32-bit IEEE754 floating point value */
+#define EXTERNVAR_TYPE_FLOAT ( 1 )
+
+/*! tzExternValue type of a string value buffered by a transaction */
+#define EXTERNVAR_TYPE_STRING ( 2 )
+
+/*! The tzExternValue object is one element of a batched get or set of
+    external variables */
+typedef struct zExternValue
+{
+    /*! handle of the external variable */
+    uint32_t handle;
+
+    /*! type of the value: EXTERNVAR_TYPE_UINT32 or EXTERNVAR_TYPE_FLOAT */
+    uint32_t type;
+
+    /*! value of the external variable */
+    union
+    {
+        /*! 32-bit integer value */
+        uint32_t ul;
+
+        /*! floating point value */
+        float f;
+    } val;
+} tzExternValue;
+
 typedef struct zEXTVARAPI
 {
     uint32_t (*pfnGetHandle)(void *pExt, char *name);
@@ -53,30 +94,168 @@ typedef struct zEXTVARAPI
                                 uint32_t *hVar,
                                 int *fd );
     int (*pfnClosePrintSession)( void *pExt, uint32_t handle, int fd );
+
+    /* version 2: optional batched operations.  The single variable
+       operations are used for libraries which leave these NULL */
+    int (*pfnGetMany)( void *pExt, tzExternValue *pValues, size_t n );
+    int (*pfnSetMany)( void *pExt, tzExternValue *pValues, size_t n );
+
+    /* version 2: optional batched handle lookup used to resolve the
+       import table of a program when it is loaded */
+    int (*pfnGetHandles)( void *pExt,
+                          char **ppNames,
+                          uint32_t *pHandles,
+                          size_t n );
 } tzEXTVARAPI;
 
+/*! The tzExternCacheEntry object holds the last value read from one
+    external variable by the read-through cache */
+typedef struct zExternCacheEntry
+{
+    /*! handle of the external variable, or 0 for an unused entry */
+    uint32_t handle;
+
+    /*! last 32-bit integer value read from the external variable */
+    uint32_t val;
+
+    /*! number of reads served from the cache */
+    uint32_t hits;
+
+    /*! number of reads passed to the external variable library */
+    uint32_t misses;
+
+    /*! set while the cached value is current */
+    bool valid;
+
+    /*! set once MODIFIED notifications have been requested */
+    bool subscribed;
+
+    /*! set if the program itself requested MODIFIED notifications */
+    bool notify;
+} tzExternCacheEntry;
+
+/*! The tzExternVars object binds an external variable API set to the
+    instance state it operates on.  Each VM instance owns one. */
+typedef struct zExternVars
+{
+    /*! external variable API set */
+    tzEXTVARAPI *pAPI;
+
+    /*! opaque pointer to the instance state used by the API set */
+    void *pExt;
+
+    /*! open addressed hash table of the read-through cache, or NULL
+        if the cache is not enabled */
+    tzExternCacheEntry *pCache;
+
+    /*! number of entries in the cache table */
+    size_t cacheSize;
+
+    /*! number of used entries in the cache table */
+    size_t cacheUsed;
+
+    /*! set while a variable is being validated */
+    bool validating;
+
+    /*! handle of the variable being validated, which bypasses the cache */
+    uint32_t hValidating;
+
+    /*! function called before a cached value is used, to receive the
+        pending MODIFIED notifications */
+    void (*pfnSync)( void *pArg );
+
+    /*! argument passed to the pfnSync function */
+    void *pSyncArg;
+
+    /*! function called before a notification is requested from the
+        external variable library, or NULL */
+    void (*pfnRequest)( void *pArg, uint32_t handle, uint32_t request );
+
+    /*! argument passed to the pfnRequest function */
+    void *pRequestArg;
+
+    /*! transaction nesting depth, or 0 if no transaction is open */
+    uint32_t txDepth;
+
+    /*! values set in the open transaction, in the order first set */
+    tzExternValue *pTx;
+
+    /*! copies of the string values set in the open transaction */
+    char **ppTxStr;
+
+    /*! open addressed hash index of pTx by handle, holding the index
+        of each value plus one, or 0 for an unused entry */
+    uint32_t *pTxIndex;
+
+    /*! number of values in pTx */
+    size_t txUsed;
+
+    /*! capacity of pTx.  The index has twice as many entries */
+    size_t txSize;
+} tzExternVars;
+
 /*==============================================================================
         Public function declarations
 ==============================================================================*/
 
-void *EXTERNVAR_Init( void );
-void EXTERNVAR_fnSetAPI( tzEXTVARAPI *pEXTVARAPI );
-uint32_t EXTERNVAR_fnGetHandle( void *pExt, char *name );
-void EXTERNVAR_fnSet( void *pExt, uint32_t handle, uint32_t val );
-void EXTERNVAR_fnSetFloat( void *pExt, uint32_t handle, float val );
-void EXTERNVAR_fnSetString( void *pExt, uint32_t handle, char * val );
-uint32_t EXTERNVAR_fnGet( void *pExt, uint32_t handle );
-float EXTERNVAR_fnGetFloat( void *pExt, uint32_t handle );
-char *EXTERNVAR_fnGetString( void *pExt, uint32_t handle );
-int EXTERNVAR_fnNotify( void *pExt, uint32_t handle, uint32_t request );
-int EXTERNVAR_fnValidateStart( void *pExt,
+int EXTERNVAR_Init( tzExternVars *pExtVars );
+void EXTERNVAR_fnSetAPI( tzExternVars *pExtVars,
+                         tzEXTVARAPI *pEXTVARAPI,
+                         void *pExt );
+void EXTERNVAR_fnShutdown( tzExternVars *pExtVars );
+uint32_t EXTERNVAR_fnGetHandle( tzExternVars *pExtVars, char *name );
+int EXTERNVAR_fnGetHandles( tzExternVars *pExtVars,
+                            char **ppNames,
+                            uint32_t *pHandles,
+                            size_t n );
+void EXTERNVAR_fnSet( tzExternVars *pExtVars, uint32_t handle, uint32_t val );
+void EXTERNVAR_fnSetFloat( tzExternVars *pExtVars,
+                           uint32_t handle,
+                           float val );
+void EXTERNVAR_fnSetString( tzExternVars *pExtVars,
+                            uint32_t handle,
+                            char * val );
+uint32_t EXTERNVAR_fnGet( tzExternVars *pExtVars, uint32_t handle );
+float EXTERNVAR_fnGetFloat( tzExternVars *pExtVars, uint32_t handle );
+char *EXTERNVAR_fnGetString( tzExternVars *pExtVars, uint32_t handle );
+int EXTERNVAR_fnGetMany( tzExternVars *pExtVars,
+                         tzExternValue *pValues,
+                         size_t n );
+int EXTERNVAR_fnSetMany( tzExternVars *pExtVars,
+                         tzExternValue *pValues,
+                         size_t n );
+int EXTERNVAR_fnNotify( tzExternVars *pExtVars,
+                        uint32_t handle,
+                        uint32_t request );
+int EXTERNVAR_fnValidateStart( tzExternVars *pExtVars,
                                uint32_t handle,
                                uint32_t *hVar );
-int EXTERNVAR_fnValidateEnd( void *pExt, uint32_t handle, int result );
-int EXTERNVAR_fnOpenPrintSession( void *pExt,
+int EXTERNVAR_fnValidateEnd( tzExternVars *pExtVars,
+                             uint32_t handle,
+                             int result );
+int EXTERNVAR_fnOpenPrintSession( tzExternVars *pExtVars,
                                   uint32_t handle,
                                   uint32_t *hVar,
                                   int *fd );
-int EXTERNVAR_fnClosePrintSession( void *pExt, uint32_t handle, int fd );
+int EXTERNVAR_fnClosePrintSession( tzExternVars *pExtVars,
+                                   uint32_t handle,
+                                   int fd );
+int EXTERNVAR_fnEnableCache( tzExternVars *pExtVars,
+                             void (*pfnSync)( void *pArg ),
+                             void *pSyncArg );
+bool EXTERNVAR_fnInvalidate( tzExternVars *pExtVars, uint32_t handle );
+void EXTERNVAR_fnInvalidateAll( tzExternVars *pExtVars );
+void EXTERNVAR_fnSetRequestHook( tzExternVars *pExtVars,
+                                 void (*pfnRequest)( void *pArg,
+                                                     uint32_t handle,
+                                                     uint32_t request ),
+                                 void *pRequestArg );
+int EXTERNVAR_fnGetCacheStats( tzExternVars *pExtVars,
+                               uint32_t handle,
+                               uint32_t *pHits,
+                               uint32_t *pMisses );
+void EXTERNVAR_fnDumpCache( tzExternVars *pExtVars, FILE *fp );
+int EXTERNVAR_fnBegin( tzExternVars *pExtVars );
+int EXTERNVAR_fnCommit( tzExternVars *pExtVars );
 
 #endif
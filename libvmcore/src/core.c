@@ -35,6 +35,7 @@ SOFTWARE.
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <ctype.h>
 #include <errno.h>
 #include <dlfcn.h>
@@ -46,7 +47,10 @@ SOFTWARE.
 #include "ask.h"
 #include "strbuf.h"
 #include <vmcore/externvars.h>
+#include <vmcore/aot.h>
 #include "files.h"
+#include "jit.h"
+#include "event.h"
 
 /*==============================================================================
         Private definitions
@@ -124,14 +128,17 @@ SOFTWARE.
                     ? (STATUS | CFLAG) \
                     : (STATUS & CMASK)
 
-/*! Set all the flags based on the register value */
-#define SETFLAGS(REGVAL) ZSET(REGVAL); NSET(REGVAL); CSET(REGVAL);
+/*! Record the result and operand used to evaluate all the flags when
+    they are next read */
+#define SETFLAGS(REGVAL) pCore->flagResult = (REGVAL); \
+                         pCore->flagOld = oldvalue; \
+                         pCore->flagsPending = true;
 
 /*! Set Zero and Negative flags based on register value */
-#define SETFFLAGS(REGVAL) ZSET(REGVAL); NSET(REGVAL);
+#define SETFFLAGS(REGVAL) (void)FLAGS; ZSET(REGVAL); NSET(REGVAL);
 
-/*! define the maximum number of timers allowed in the user program */
-#define MAX_TIMERS  ( 20 )
+/*! Read the status register, evaluating any pending flags */
+#define FLAGS ( ( pCore->flagsPending ) ? core_fnEvalFlags( pCore ) : STATUS )
 
 /*! DUMPLINE helper macro for coreDump function */
 #define DUMPLINE(N) { \
@@ -147,6 +154,108 @@ SOFTWARE.
 /*! WORD mask */
 #define WORD_MASK ( 0x40 )
 
+/*! length in bytes of the longest VM instruction: LDX/STX with a 32-bit
+    displacement */
+#define MAX_INSTRUCTION_LENGTH ( 9 )
+
+/*! decode map marker for a program address which has not been decoded */
+#define DECODE_NONE ( -1 )
+
+/*! verifier mark for the first byte of a reachable instruction */
+#define VERIFY_START ( 0x01 )
+
+/*! verifier mark for the remaining bytes of a reachable instruction */
+#define VERIFY_BODY ( 0x02 )
+
+/*! verifier mark for an instruction address waiting to be checked */
+#define VERIFY_QUEUED ( 0x04 )
+
+/*! integer source operand of a decoded instruction */
+#define DEC_OPERAND(I) ( ( (I)->opcode & MODE_REG ) \
+                         ? REG[(I)->src] \
+                         : (I)->imm.val )
+
+/*! floating point source operand of a decoded instruction */
+#define DEC_FOPERAND(I) ( ( (I)->opcode & MODE_REG ) \
+                          ? REGF[(I)->src] \
+                          : (I)->imm.fval )
+
+/*! signed index scale held in the low nibble of an indexed access */
+#define INDEX_SCALE(B) ( (int8_t)( ( (B) & 0x0F ) ^ 0x08 ) - 8 )
+
+/*! number of bytes accessed by a memory operation with the specified
+    BYTE/WORD width flags */
+#define DATA_WIDTH(B) ( ( (B) & BYTE ) ? 1 : ( (B) & WORD ) ? 2 : 4 )
+
+/*! size of an entry of an MGT or MST extern table: handle, type, value */
+#define EXTERN_ENTRY_SIZE ( 12 )
+
+/*! number of extern table entries passed to the externals library at once */
+#define EXTERN_BATCH ( 32 )
+
+#if defined( VMCORE_THREADED ) && !defined( __GNUC__ )
+/* the threaded execution engine requires GCC labels as values */
+#undef VMCORE_THREADED
+#endif
+
+#ifdef VMCORE_THREADED
+
+/*! number of entries in the flattened threaded dispatch table */
+#define THREADED_TABLE_SIZE ( 3 * ( HRMAXINST + 1 ) )
+
+/*! threaded engine: read a register, using the cached PC and SP */
+#define T_GET(R) ( ( (R) < 14 ) ? reg[(R)] : ( (R) == 14 ) ? sp : pc )
+
+/*! threaded engine: write a register, using the cached PC and SP */
+#define T_SET(R,V) if( (R) < 14 ) { reg[(R)] = (V); } \
+                   else if( (R) == 14 ) { sp = (V); } \
+                   else { pc = (V); }
+
+/*! threaded engine: set all the cached flags based on a result value */
+#define T_SETFLAGS(VAL) status = ( status & ~( ZFLAG | NFLAG | CFLAG ) ) \
+                        | ( ( (VAL) == 0 ) ? ZFLAG : 0 ) \
+                        | ( ( (int32_t)(VAL) < 0 ) ? NFLAG : 0 ) \
+                        | ( ( ( oldvalue ^ (VAL) ) & SIGNBIT ) ? CFLAG : 0 )
+
+/*! threaded engine: jump to the handler for the instruction at the PC */
+#define T_DISPATCH goto *dispatch[mem[pc] & 0x1F]
+
+/*! threaded engine: advance the PC and dispatch the next instruction */
+#define T_NEXT(N) pc += (N); \
+                  if( (size_t)pc > progsize ) \
+                  { printf("Illegal PC address\n"); goto t_stop; } \
+                  T_DISPATCH
+
+/*! threaded engine: dispatch the target of a taken branch, call or return,
+    and preempt the program when its instruction budget has been used */
+#define T_JUMP if( ( pCore->budgeted ) && ( pCore->budget-- == 0 ) ) \
+               { core_fnPreempt( pCore ); goto t_exit; } \
+               T_DISPATCH
+
+/*! threaded engine: conditionally jump to the target of a Jxx instruction */
+#define T_BRANCH(COND) if( COND ) \
+                       { (void)core_fnDecodeData( pCore, &mem[pc], 1, \
+                                                  false, &val ); \
+                         pc = val; \
+                         T_JUMP; } \
+                       T_NEXT(3)
+
+/*! threaded engine: write the cached state back to the core */
+#define T_SPILL PC = pc; SP = sp; STATUS = status
+
+/*! threaded engine: reload the cached state from the core */
+#define T_RELOAD pc = PC; sp = SP; status = FLAGS
+
+/*! threaded engine: execute an instruction using its opXXX function */
+#define T_CALL(FN) T_SPILL; \
+                   FN( pCore ); \
+                   T_RELOAD; \
+                   if( ( pCore->running == false ) || ( pCore->error ) ) \
+                   { goto t_exit; } \
+                   T_DISPATCH
+
+#endif
+
 /*! the tzRegBytes object maps a 32-bit register to its bytes */
 typedef struct zRegBytes
 {
@@ -168,6 +277,52 @@ typedef union uRegisters
     tzRegBytes bytes[16];
 } tuRegisters;
 
+/*! the tzDecoded object is a single pre-decoded VM instruction */
+typedef struct zDecoded tzDecoded;
+
+/*! the tzDecoded object holds the fields of a VM instruction which were
+    extracted from the program image at load time, so the interpreter does
+    not need to re-decode the instruction bytes each time it is executed */
+struct zDecoded
+{
+    /*! function to execute the decoded instruction */
+    void (*exec)( tzCore *pCore, const tzDecoded *pInst );
+
+    /*! address of the instruction in the VM core memory */
+    int32_t pc;
+
+    /*! address of the next sequential instruction */
+    int32_t next;
+
+    /*! immediate operand: literal value, memory address or branch target */
+    union
+    {
+        /*! signed literal value */
+        int32_t val;
+
+        /*! memory address or branch target */
+        uint32_t addr;
+
+        /*! floating point literal value */
+        float fval;
+    } imm;
+
+    /*! instruction byte containing the width and mode flags */
+    uint8_t opcode;
+
+    /*! destination register */
+    uint8_t dst;
+
+    /*! source register */
+    uint8_t src;
+
+    /*! index register of an indexed memory access */
+    uint8_t index;
+
+    /*! scale applied to the index register, or 0 for no index */
+    int8_t scale;
+};
+
 /*! the tzCore structure represents the state of the virtual machine core */
 struct zCore
 {
@@ -210,8 +365,126 @@ struct zCore
     /*! opaque pointer to external variable library */
     void *pExternLib;
 
-    /*! opaque pointer to external variable state */
-    void *pExt;
+    /*! copy of the API of the external variable library, with the entries
+        beyond the version reported by the library set to NULL */
+    tzEXTVARAPI externAPI;
+
+    /*! external variable API and state of this VM instance */
+    tzExternVars extVars;
+
+    /*! function which routes the notification signals requested by this
+        VM instance, or NULL if it receives them with its own signalfd */
+    void (*pfnRoute)( void *pArg, tzCore *pCore, int signum, uint32_t id );
+
+    /*! argument passed to the pfnRoute function */
+    void *pRouteArg;
+
+    /*! number of lost events when the extern cache was last synced */
+    unsigned int overflow;
+
+    /*! NUL terminated names of the external variables imported by the
+        program, in import slot order */
+    char *pImportNames;
+
+    /*! length of the import names including their NUL terminators */
+    size_t importNamesLen;
+
+    /*! pointer to the name of each import slot */
+    char **ppImports;
+
+    /*! external variable handle of each import slot */
+    uint32_t *pImportHandles;
+
+    /*! number of import slots */
+    size_t numImports;
+
+    /*! set when the import slots hold the external variable handles */
+    bool importsResolved;
+
+    /*! string buffers of this VM instance */
+    tzStringBufferList strbufs;
+
+    /*! open files of this VM instance */
+    tzFiles files;
+
+    /*! program timers and notification signals of this VM instance */
+    tzEvents events;
+
+    /*! array of pre-decoded instructions */
+    tzDecoded *pDecoded;
+
+    /*! number of entries used in the pre-decoded instruction array */
+    size_t numDecoded;
+
+    /*! capacity of the pre-decoded instruction array */
+    size_t maxDecoded;
+
+    /*! map from program address to pre-decoded instruction index */
+    int32_t *pDecodeMap;
+
+    /*! execution engine used by CORE_fnExecute */
+    teCoreEngine engine;
+
+    /*! JIT compiler used by the JIT execution engine */
+    tzJIT *pJIT;
+
+    /*! handle to the native module used by the native execution engine */
+    void *pNativeLib;
+
+    /*! entry point of the native module */
+    int (*pfnNative)( tzVMAOTContext *pCtx );
+
+    /*! VM core state accessed by the native module */
+    tzVMAOTContext native;
+
+    /*! set when the program no longer matches the native module */
+    bool nativeStale;
+
+    /*! set when the decode tables only contain verified instructions */
+    bool verified;
+
+    /*! set while the verified fast path is executing */
+    bool fastPath;
+
+    /*! set when multi-byte values in the VM core memory are stored in the
+        host byte order instead of big endian format */
+    bool nativeEndian;
+
+    /*! result of the last instruction which set the flags */
+    int32_t flagResult;
+
+    /*! destination value before the last instruction which set the flags */
+    int32_t flagOld;
+
+    /*! set when the flags must be evaluated from flagResult and flagOld */
+    bool flagsPending;
+
+    /*! set while CORE_fnRun is executing the program, so WFS and DLY
+        suspend the program instead of blocking the calling thread */
+    bool suspend;
+
+    /*! run status of the program executed by CORE_fnRun */
+    teCoreRunStatus runStatus;
+
+    /*! set when CORE_fnRun is preempted after an instruction budget */
+    bool budgeted;
+
+    /*! instructions left before CORE_fnRun is preempted */
+    uint32_t budget;
+
+    /*! delay time in milliseconds requested by a suspended DLY */
+    uint32_t delayMS;
+
+    /*! registers receiving the signal number and id of a suspended WFS
+        or DSP */
+    uint8_t signalReg[2];
+
+    /*! length of the suspended WFS or DSP instruction */
+    uint8_t signalLen;
+
+    /*! set when the suspended instruction is a DSP, which calls the
+        handler of the received signal */
+    bool signalDispatch;
 };
 
 /*! The tzZInstruction object maps an OPCODE and description to a
@@ -233,6 +506,7 @@ typedef struct zInstruction
 ==============================================================================*/
 
 static bool core_fnCheckInstructionList();
+static bool core_fnIsLittleEndianHost( void );
 static uint32_t core_fnGetUnsignedData( tzCore *pCore,
                                         uint8_t *memory,
                                         int32_t pc,
@@ -254,12 +528,108 @@ static void core_fnSetStackData( tzCore *pCore,
 
 static uint32_t core_fnGetStackData( tzCore *pCore, uint32_t sp );
 
+static void core_fnCall( tzCore *pCore, uint32_t target );
+static void core_fnDispatch( tzCore *pCore, int signum, int id );
+static bool core_fnFilterEvent( void *pArg, int signum, int id );
+static void core_fnSyncExterns( void *pArg );
+static int core_fnEnableSignals( tzCore *pCore );
+static void core_fnRequested( void *pArg, uint32_t handle, uint32_t request );
+static void core_fnExternTable( tzCore *pCore, bool set );
+static int core_fnBuildImports( tzCore *pCore, char *pNames, size_t len );
+static void core_fnFreeImports( tzCore *pCore );
+static int core_fnResolveImports( tzCore *pCore );
+static bool core_fnReadImports( tzCore *pCore, FILE *fp, size_t *pSize );
+
 static void core_fnStoreData( tzCore *pCore,
                               uint8_t *instr,
                               uint8_t *dest,
                               uint8_t *src );
-static int setupTimer( int id, int intervalMS );
-static int waitSignal( int *signum, int *id );
+
+/* instruction pre-decoding functions */
+static void core_fnDecodeProgram( tzCore *pCore );
+static int32_t core_fnDecodeAt( tzCore *pCore, int32_t pc );
+static void core_fnDecode( tzCore *pCore, int32_t pc, tzDecoded *pInst );
+static size_t core_fnDecodeData( tzCore *pCore,
+                                 uint8_t *instr,
+                                 uint8_t offset,
+                                 bool isSigned,
+                                 int32_t *pValue );
+static size_t core_fnInstructionLength( tzCore *pCore, int32_t pc );
+static void core_fnInvalidateDecode( tzCore *pCore,
+                                     uint32_t addr,
+                                     size_t len );
+
+/* program verification functions */
+static int core_fnVerifyInstruction( tzCore *pCore,
+                                     uint32_t pc,
+                                     uint8_t *pMarks,
+                                     uint32_t *pWork,
+                                     size_t *pNumWork );
+static int core_fnVerifyTarget( tzCore *pCore,
+                                uint32_t pc,
+                                uint32_t target,
+                                uint8_t *pMarks,
+                                uint32_t *pWork,
+                                size_t *pNumWork );
+static void core_fnExecuteEngine( tzCore *pCore );
+static void core_fnPreempt( tzCore *pCore );
+static void core_fnExecuteVerified( tzCore *pCore );
+static void core_fnLeaveFastPath( tzCore *pCore );
+
+/* status flag and condition functions */
+static uint32_t core_fnEvalFlags( tzCore *pCore );
+static inline bool core_fnCompare( uint8_t op, int32_t a, int32_t b );
+
+#ifdef VMCORE_THREADED
+static void core_fnExecuteThreaded( tzCore *pCore );
+#endif
+
+/* JIT and native execution functions */
+static void core_fnExecuteJIT( tzCore *pCore );
+static void core_fnExecuteNative( tzCore *pCore );
+static void core_fnStepInstruction( void *p );
+
+/* pre-decoded instruction functions */
+static void decNOP( tzCore *pCore, const tzDecoded *pInst );
+static void decLOD( tzCore *pCore, const tzDecoded *pInst );
+static void decSTR( tzCore *pCore, const tzDecoded *pInst );
+static void decMOV( tzCore *pCore, const tzDecoded *pInst );
+static void decADD( tzCore *pCore, const tzDecoded *pInst );
+static void decADDF( tzCore *pCore, const tzDecoded *pInst );
+static void decSUB( tzCore *pCore, const tzDecoded *pInst );
+static void decSUBF( tzCore *pCore, const tzDecoded *pInst );
+static void decMUL( tzCore *pCore, const tzDecoded *pInst );
+static void decMULF( tzCore *pCore, const tzDecoded *pInst );
+static void decDIV( tzCore *pCore, const tzDecoded *pInst );
+static void decDIVF( tzCore *pCore, const tzDecoded *pInst );
+static void decAND( tzCore *pCore, const tzDecoded *pInst );
+static void decOR( tzCore *pCore, const tzDecoded *pInst );
+static void decNOT( tzCore *pCore, const tzDecoded *pInst );
+static void decSHR( tzCore *pCore, const tzDecoded *pInst );
+static void decJMP( tzCore *pCore, const tzDecoded *pInst );
+static void decJMPIF( tzCore *pCore, const tzDecoded *pInst );
+static void decCAL( tzCore *pCore, const tzDecoded *pInst );
+static void decRET( tzCore *pCore, const tzDecoded *pInst );
+static void decCMP( tzCore *pCore, const tzDecoded *pInst );
+static void decCMPF( tzCore *pCore, const tzDecoded *pInst );
+static void decTOF( tzCore *pCore, const tzDecoded *pInst );
+static void decTOI( tzCore *pCore, const tzDecoded *pInst );
+static void decPSH( tzCore *pCore, const tzDecoded *pInst );
+static void decPOP( tzCore *pCore, const tzDecoded *pInst );
+static void decHLT( tzCore *pCore, const tzDecoded *pInst );
+static void decLDL( tzCore *pCore, const tzDecoded *pInst );
+static void decSTL( tzCore *pCore, const tzDecoded *pInst );
+static void decBLT( tzCore *pCore, const tzDecoded *pInst );
+static void decBLE( tzCore *pCore, const tzDecoded *pInst );
+static void decBEQ( tzCore *pCore, const tzDecoded *pInst );
+static void decBNE( tzCore *pCore, const tzDecoded *pInst );
+static void decBCCF( tzCore *pCore, const tzDecoded *pInst );
+static void decLDX( tzCore *pCore, const tzDecoded *pInst );
+static void decSTX( tzCore *pCore, const tzDecoded *pInst );
+static void decINST( tzCore *pCore, const tzDecoded *pInst );
+static void decLODA( tzCore *pCore, const tzDecoded *pInst );
+static void decSTRA( tzCore *pCore, const tzDecoded *pInst );
+static void decINSTV( tzCore *pCore, const tzDecoded *pInst );
 
 /* opcode functions */
 static void opNOP(tzCore *pCore);
@@ -304,6 +674,11 @@ static void opSET( tzCore *pCore );
 static void opINST1(tzCore *pCore);
 static void opINST2(tzCore *pCore);
 static void opMDUMP( tzCore *pCore );
+static void opLDL( tzCore *pCore );
+static void opSTL( tzCore *pCore );
+static void opBCC( tzCore *pCore );
+static void opLDX( tzCore *pCore );
+static void opSTX( tzCore *pCore );
 static void opWRS( tzCore *pCore );
 static void opCSB( tzCore *pCore );
 static void opZSB( tzCore *pCore );
@@ -318,6 +693,14 @@ static void opSTM( tzCore *pCore );
 static void opCTM( tzCore *pCore );
 static void opNFY( tzCore *pCore );
 static void opWFS( tzCore *pCore );
+static void opEVQ( tzCore *pCore );
+static void opVEC( tzCore *pCore );
+static void opDSP( tzCore *pCore );
+static void opMGT( tzCore *pCore );
+static void opMST( tzCore *pCore );
+static void opTXB( tzCore *pCore );
+static void opTXC( tzCore *pCore );
+static void opIMP( tzCore *pCore );
 static void opEVS( tzCore *pCore );
 static void opEVE( tzCore *pCore );
 static void opSBL( tzCore *pCore );
@@ -335,9 +718,6 @@ static void opEXE( tzCore *pCore );
         File Scoped variables
 ==============================================================================*/
 
-/*! storage for the program timers */
-static timer_t timers[MAX_TIMERS] = {0};
-
 /* virtual machine instructions */
 /* THESE MUST BE IN THE SAME ORDER AS THEY ARE DEFINED */
 tzInstruction instructions0[HRMAXINST+1] =
@@ -418,22 +798,22 @@ tzInstruction instructions2[HRMAXINST+1] =
 {
         { HMDUMP, "MDUMP", opMDUMP     }, // 0x00
         { HRDUMP, "RDUMP", opRDUMP     }, // 0x01
-        { 0x02,   "I02",   opILLEGAL   }, // 0x02
-        { 0x03,   "I03",   opILLEGAL   }, // 0x03
-        { 0x04,   "I04",   opILLEGAL   }, // 0x04
-        { 0x05,   "I05",   opILLEGAL   }, // 0x05
-        { 0x06,   "I06",   opILLEGAL   }, // 0x06
-        { 0x07,   "I07",   opILLEGAL   }, // 0x07
-        { 0x08,   "I08",   opILLEGAL   }, // 0x08
-        { 0x09,   "I09",   opILLEGAL   }, // 0x09
-        { 0x0A,   "I0A",   opILLEGAL   }, // 0x0A
-        { 0x0B,   "I0B",   opILLEGAL   }, // 0x0B
-        { 0x0C,   "I0C",   opILLEGAL   }, // 0x0C
-        { 0x0D,   "I0D",   opILLEGAL   }, // 0x0D
-        { 0x0E,   "I0E",   opILLEGAL   }, // 0x0E
-        { 0x0F,   "I0F",   opILLEGAL   }, // 0x0F
-        { 0x10,   "I10",   opILLEGAL   }, // 0x10
-        { 0x11,   "I11",   opILLEGAL   }, // 0x11
+        { HLDL,   "LDL",   opLDL       }, // 0x02
+        { HSTL,   "STL",   opSTL       }, // 0x03
+        { HBLT,   "BLT",   opBCC       }, // 0x04
+        { HBLE,   "BLE",   opBCC       }, // 0x05
+        { HBEQ,   "BEQ",   opBCC       }, // 0x06
+        { HBNE,   "BNE",   opBCC       }, // 0x07
+        { HLDX,   "LDX",   opLDX       }, // 0x08
+        { HSTX,   "STX",   opSTX       }, // 0x09
+        { HEVQ,   "EVQ",   opEVQ       }, // 0x0A
+        { HVEC,   "VEC",   opVEC       }, // 0x0B
+        { HDSP,   "DSP",   opDSP       }, // 0x0C
+        { HMGT,   "MGT",   opMGT       }, // 0x0D
+        { HMST,   "MST",   opMST       }, // 0x0E
+        { HTXB,   "TXB",   opTXB       }, // 0x0F
+        { HTXC,   "TXC",   opTXC       }, // 0x10
+        { HIMP,   "IMP",   opIMP       }, // 0x11
         { 0x12,   "I12",   opILLEGAL   }, // 0x12
         { 0x13,   "I13",   opILLEGAL   }, // 0x13
         { 0x14,   "I14",   opILLEGAL   }, // 0x14
@@ -462,7 +842,9 @@ tzInstruction instructions2[HRMAXINST+1] =
 
     The CORE_fnCreate function allocates memory for the Virtual Machine core
     and initializes its state.  The core memory size and stack size are
-    configurable.
+    configurable.  All the state of the VM core, including its string
+    buffers, files, timers and external variables, is held in the core
+    so any number of cores can be created in one process.
 
     @param[in]
         core_size
@@ -481,9 +863,6 @@ tzCore *CORE_fnCreate( size_t core_size, size_t stack_size )
     /* allocate memory for the core */
     tzCore *pCore;
 
-    /* Initialize the File Handles */
-    InitFiles();
-
     /* validate the instruction list */
     if( core_fnCheckInstructionList() == false )
     {
@@ -504,6 +883,18 @@ tzCore *CORE_fnCreate( size_t core_size, size_t stack_size )
         return NULL;
     }
 
+    /* create the event backend for the program timers and signals */
+    if( EVENT_fnInit( &pCore->events ) != EOK )
+    {
+        free( pCore->memory );
+        free( pCore );
+        return NULL;
+    }
+
+    /* Initialize the File Handles and String Buffers */
+    InitFiles( &pCore->files );
+    STRINGBUFFER_fnInit( &pCore->strbufs );
+
     /* initialize the core attributes */
     pCore->stack_size = stack_size;
     pCore->core_size = core_size;
@@ -518,6 +909,55 @@ tzCore *CORE_fnCreate( size_t core_size, size_t stack_size )
     return pCore;
 }
 
+/*============================================================================*/
+/*  CORE_fnDestroy                                                            */
+/*!
+    Destroy a Virtual Machine Core
+
+    The CORE_fnDestroy function releases all the resources held by the
+    Virtual Machine core: its timers, the files it opened, its string
+    buffers, its internal external variables, its import table, its
+    decode tables, its JIT compiler, its native module and its memory.
+    An external variable
+    library must be shut down with CORE_fnShutdownExternalsLib first.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object to destroy
+
+==============================================================================*/
+void CORE_fnDestroy( tzCore *pCore )
+{
+    if( pCore == NULL )
+    {
+        return;
+    }
+
+    EVENT_fnDestroy( &pCore->events );
+
+    CloseFiles( &pCore->files );
+    STRINGBUFFER_fnDestroy( &pCore->strbufs );
+    EXTERNVAR_fnShutdown( &pCore->extVars );
+
+    if( pCore->pExternLib != NULL )
+    {
+        dlclose( pCore->pExternLib );
+    }
+
+    if( pCore->pNativeLib != NULL )
+    {
+        dlclose( pCore->pNativeLib );
+    }
+
+    JIT_fnDestroy( pCore->pJIT );
+
+    core_fnFreeImports( pCore );
+    free( pCore->pDecoded );
+    free( pCore->pDecodeMap );
+    free( pCore->memory );
+    free( pCore );
+}
+
 /*============================================================================*/
 /*  CORE_fnInitExternalsLib                                                   */
 /*!
@@ -526,6 +966,11 @@ tzCore *CORE_fnCreate( size_t core_size, size_t stack_size )
     The CORE_fnInitExternalsLib function initializes the external variables
     dynamic library.  If no external variable library is specified,
     then the internal external variable functionality will be used instead.
+    Only the API entries of the tzEXTVARAPI version reported by the
+    library's getapiversion() function are used, so libraries built
+    against an older API are not read past the end of their API list.
+    The external variables imported by a program which is already loaded
+    are resolved once the library is initialized.
 
     @param[in]
         pCore
@@ -537,6 +982,7 @@ tzCore *CORE_fnCreate( size_t core_size, size_t stack_size )
             (eg libvarvm.so)
 
     @retval EOK external variable library initialized ok
+    @retval ENOENT an imported external variable was not found
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
@@ -546,14 +992,16 @@ int CORE_fnInitExternalsLib( tzCore *pCore, char *libname )
     void *handle;
     void *(*init)(void);
     tzEXTVARAPI *(*getapi)(void);
+    tzEXTVARAPI *pAPI;
+    int (*getapiversion)(void);
+    size_t size = offsetof( tzEXTVARAPI, pfnGetMany );
 
     if( pCore != NULL )
     {
         if( libname == NULL)
         {
             /* use the internal implementation of "extern" variables */
-            pCore->pExt = EXTERNVAR_Init();
-            result = EOK;
+            result = EXTERNVAR_Init( &pCore->extVars );
         }
         else
         {
@@ -564,16 +1012,32 @@ int CORE_fnInitExternalsLib( tzCore *pCore, char *libname )
                 init = dlsym( pCore->pExternLib, "init" );
                 if( init != NULL )
                 {
-                    /* initialize the library */
-                    pCore->pExt = init();
-
                     /* get the API list */
                     getapi = dlsym( pCore->pExternLib, "getapi" );
-                    if( getapi != NULL )
+                    pAPI = ( getapi != NULL ) ? getapi() : NULL;
+                    if( pAPI != NULL )
                     {
-                        /* get the API list and initialize the
+                        /* only copy the API entries the library has.
+                           Libraries without getapiversion() predate the
+                           batched operations */
+                        getapiversion = dlsym( pCore->pExternLib,
+                                               "getapiversion" );
+                        if( ( getapiversion != NULL ) &&
+                            ( getapiversion() >= 2 ) )
+                        {
+                            size = sizeof( tzEXTVARAPI );
+                        }
+
+                        memset( &pCore->externAPI,
+                                0,
+                                sizeof( tzEXTVARAPI ) );
+                        memcpy( &pCore->externAPI, pAPI, size );
+
+                        /* initialize the library instance and the
                         external variable interface */
-                        EXTERNVAR_fnSetAPI( getapi() );
+                        EXTERNVAR_fnSetAPI( &pCore->extVars,
+                                            &pCore->externAPI,
+                                            init() );
 
                         result = EOK;
                     }
@@ -594,6 +1058,11 @@ int CORE_fnInitExternalsLib( tzCore *pCore, char *libname )
                 fprintf( stderr, "Error: %s\n", dlerror());
             }
         }
+
+        if( result == EOK )
+        {
+            result = core_fnResolveImports( pCore );
+        }
     }
 
     return result;
@@ -626,13 +1095,14 @@ int CORE_fnShutdownExternalsLib( tzCore *pCore )
     {
         result = ENOENT;
 
-        if( ( pCore->pExt != NULL ) &&
+        if( ( pCore->extVars.pExt != NULL ) &&
             ( pCore->pExternLib != NULL ) )
         {
             shutdown = dlsym( pCore->pExternLib, "shutdown" );
             if( shutdown != NULL )
             {
-                result = shutdown( pCore->pExt );
+                result = shutdown( pCore->extVars.pExt );
+                EXTERNVAR_fnSetAPI( &pCore->extVars, NULL, NULL );
             }
             else
             {
@@ -650,6 +1120,211 @@ int CORE_fnShutdownExternalsLib( tzCore *pCore )
     return result;
 }
 
+/*============================================================================*/
+/*  CORE_fnEnableExternCache                                                  */
+/*!
+    Enable the extern read-through cache
+
+    The CORE_fnEnableExternCache function enables the read-through cache
+    of the 32-bit integer external variables of a VM instance.  The
+    first GET of a variable requests MODIFIED notifications for it from
+    the externals library, and following GETs are served from the cache
+    until a MODIFIED notification for the variable is received or the
+    program sets it.  Notifications requested only by the cache are not
+    passed on to the program.  The received and posted notifications
+    are checked on each cached GET without a system call, and the whole
+    cache is discarded if notifications may have been lost.
+
+    The externals library must be initialized before the cache is
+    enabled.  Variables whose value is computed when they are read
+    (e.g. by a CALC handler) should not be used with the cache.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @retval EOK the cache was enabled
+    @retval ENOMEM memory allocation failure
+    @retval EINVAL invalid arguments
+    @retval other the notification signals could not be enabled
+
+==============================================================================*/
+int CORE_fnEnableExternCache( tzCore *pCore )
+{
+    int result = EINVAL;
+
+    if( pCore != NULL )
+    {
+        /* receive the notification signals before they can be sent */
+        result = core_fnEnableSignals( pCore );
+        if( result == EOK )
+        {
+            pCore->overflow = EVENT_fnOverflow( &pCore->events );
+            EVENT_fnSetFilter( &pCore->events, core_fnFilterEvent, pCore );
+            result = EXTERNVAR_fnEnableCache( &pCore->extVars,
+                                              core_fnSyncExterns,
+                                              pCore );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  CORE_fnGetExternCacheStats                                                */
+/*!
+    Get the extern read-through cache counters of a variable
+
+    The CORE_fnGetExternCacheStats function gets the number of GETs of
+    an external variable which were served from the read-through cache
+    (hits), and the number which were passed to the externals library
+    (misses).
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @param[out]
+        pHits
+            pointer to the location to store the number of cache hits
+
+    @param[out]
+        pMisses
+            pointer to the location to store the number of cache misses
+
+    @retval EOK the counters were retrieved
+    @retval ENOENT the variable has not been read through the cache
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int CORE_fnGetExternCacheStats( tzCore *pCore,
+                                uint32_t handle,
+                                uint32_t *pHits,
+                                uint32_t *pMisses )
+{
+    return ( pCore != NULL ) ? EXTERNVAR_fnGetCacheStats( &pCore->extVars,
+                                                          handle,
+                                                          pHits,
+                                                          pMisses )
+                             : EINVAL;
+}
+
+/*============================================================================*/
+/*  CORE_fnDumpExternCache                                                    */
+/*!
+    Output the extern read-through cache counters
+
+    The CORE_fnDumpExternCache function outputs the cache hits and
+    misses of each external variable read through the read-through
+    cache.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        fp
+            output stream
+
+==============================================================================*/
+void CORE_fnDumpExternCache( tzCore *pCore, FILE *fp )
+{
+    if( pCore != NULL )
+    {
+        EXTERNVAR_fnDumpCache( &pCore->extVars, fp );
+    }
+}
+
+/*============================================================================*/
+/*  CORE_fnSetImports                                                         */
+/*!
+    Set the import table of the program
+
+    The CORE_fnSetImports function sets the names of the external
+    variables imported by the program in the VM core memory.  The index
+    of each name is the import slot referenced by the IMP instruction.
+    The import table is written to the program image by CORE_fnSave,
+    and it is resolved immediately if an external variables library
+    is already initialized.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        ppNames
+            array of external variable names
+
+    @param[in]
+        n
+            number of names in the array
+
+    @retval EOK the import table was set
+    @retval ENOENT an imported external variable was not found
+    @retval ENOMEM memory allocation failed
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int CORE_fnSetImports( tzCore *pCore, char **ppNames, size_t n )
+{
+    char *pNames = NULL;
+    size_t len = 0;
+    size_t i;
+    int result = EINVAL;
+
+    if( ( pCore != NULL ) && ( ( ppNames != NULL ) || ( n == 0 ) ) )
+    {
+        result = EOK;
+
+        for( i = 0; i < n; i++ )
+        {
+            if( ( ppNames[i] == NULL ) || ( ppNames[i][0] == '\0' ) )
+            {
+                /* an empty name would end the import table */
+                result = EINVAL;
+            }
+            else
+            {
+                len += strlen( ppNames[i] ) + 1;
+            }
+        }
+
+        if( ( result == EOK ) && ( len > 0 ) )
+        {
+            pNames = malloc( len );
+            if( pNames != NULL )
+            {
+                len = 0;
+                for( i = 0; i < n; i++ )
+                {
+                    strcpy( &pNames[len], ppNames[i] );
+                    len += strlen( ppNames[i] ) + 1;
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if( result == EOK )
+        {
+            result = core_fnBuildImports( pCore, pNames, len );
+        }
+
+        if( result == EOK )
+        {
+            result = core_fnResolveImports( pCore );
+        }
+    }
+
+    return result;
+}
+
 /*============================================================================*/
 /*  CORE_fnMemory                                                             */
 /*!
@@ -733,6 +1408,9 @@ size_t CORE_fnStackSize( tzCore *pCore )
     Set the VM Core Program size
 
     The CORE_fnSetProgramSize function sets the size of the VM core program.
+    The program image is pre-decoded for execution, so this function
+    must be called after the image has been fully written (and linked)
+    into the VM core memory.
 
     @param[in]
         pCore
@@ -746,6 +1424,9 @@ size_t CORE_fnStackSize( tzCore *pCore )
 void CORE_fnSetProgramSize( tzCore *pCore, size_t programSize )
 {
     pCore->programSize = programSize;
+
+    /* the program image is complete, so pre-decode it */
+    core_fnDecodeProgram( pCore );
 }
 
 /*============================================================================*/
@@ -774,53 +1455,170 @@ size_t CORE_fnGetProgramSize( tzCore *pCore )
 }
 
 /*============================================================================*/
-/*  CORE_fnDump                                                               */
+/*  CORE_fnSetNativeEndian                                                    */
 /*!
-    Dump the VM Core
+    Select the byte order of the VM core memory
 
-    The CORE_fnDump function dumps the VM core memory, registers and stack
-    into a file called vm.core
+    The CORE_fnSetNativeEndian function selects whether multi-byte values
+    in the VM core memory (instruction literals, data and the stack) are
+    stored in big endian format, or in the host byte order.  Using the
+    host byte order avoids byte swapping on every memory access, and is
+    only supported on little endian hosts.
+
+    CORE_fnLoad selects the byte order from the program image, so this
+    function is only required when a program is written (assembled)
+    directly into the VM core memory.  It must be called before the
+    program is written, and before CORE_fnSetProgramSize.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        nativeEndian
+            true to use the host byte order, false to use big endian format
+
 ==============================================================================*/
-void CORE_fnDump(tzCore *pCore)
+void CORE_fnSetNativeEndian( tzCore *pCore, bool nativeEndian )
 {
-	FILE *fp;
-
-    if( pCore == NULL )
-    {
-        return;
-    }
-
-	fp = fopen("vm.core", "w");
-    if( fp == NULL )
+    if( pCore != NULL )
     {
-        return;
+        pCore->nativeEndian = nativeEndian && core_fnIsLittleEndianHost();
     }
-
-    fprintf(fp, "\ncore:\n");
-    CORE_fnDumpMemory( pCore, 0, 0, fp );
-	CORE_fnDumpRegisters(pCore, fp);
-    CORE_fnDumpStack(pCore, fp);
-	fclose(fp);
 }
 
 /*============================================================================*/
-/*  CORE_fnDumpRegisters                                                      */
+/*  CORE_fnIsNativeEndian                                                     */
 /*!
-    Dump the VM Core Registers
+    Get the byte order of the VM core memory
 
-    The CORE_fnDumpRegisters function dumps the VM core registers and flags
-    to the specified FILE *
+    The CORE_fnIsNativeEndian function indicates whether multi-byte values
+    in the VM core memory are stored in the host byte order.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
-    @param[in]
+    @retval true the VM core memory uses the host byte order
+    @retval false the VM core memory uses big endian format
+
+==============================================================================*/
+bool CORE_fnIsNativeEndian( tzCore *pCore )
+{
+    return ( pCore != NULL ) ? pCore->nativeEndian : false;
+}
+
+/*============================================================================*/
+/*  CORE_fnChecksum                                                           */
+/*!
+    Calculate the checksum of the VM Core Program
+
+    The CORE_fnChecksum function calculates a 32-bit FNV-1a checksum of
+    the program loaded into the VM core memory.  It is used to match
+    a native module to the program image it was generated from.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @retval checksum of the VM core program
+
+==============================================================================*/
+uint32_t CORE_fnChecksum( tzCore *pCore )
+{
+    uint32_t checksum = 2166136261U;
+    size_t i;
+
+    if( pCore != NULL )
+    {
+        for( i = 0; i < PROGRAM_SIZE; i++ )
+        {
+            checksum ^= MEMORY[i];
+            checksum *= 16777619U;
+        }
+    }
+
+    return checksum;
+}
+
+/*============================================================================*/
+/*  CORE_fnInstructionLength                                                  */
+/*!
+    Get the length of a VM instruction
+
+    The CORE_fnInstructionLength function gets the number of bytes used
+    by the VM instruction at the specified address of the VM core program.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        addr
+            address of the instruction in the VM core program
+
+    @retval length of the instruction in bytes
+    @retval 0 the instruction length could not be determined
+
+==============================================================================*/
+size_t CORE_fnInstructionLength( tzCore *pCore, uint32_t addr )
+{
+    if( ( pCore == NULL ) || ( addr >= PROGRAM_SIZE ) )
+    {
+        return 0;
+    }
+
+    return core_fnInstructionLength( pCore, addr );
+}
+
+/*============================================================================*/
+/*  CORE_fnDump                                                               */
+/*!
+    Dump the VM Core
+
+    The CORE_fnDump function dumps the VM core memory, registers and stack
+    into a file called vm.core
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+void CORE_fnDump(tzCore *pCore)
+{
+	FILE *fp;
+
+    if( pCore == NULL )
+    {
+        return;
+    }
+
+	fp = fopen("vm.core", "w");
+    if( fp == NULL )
+    {
+        return;
+    }
+
+    fprintf(fp, "\ncore:\n");
+    CORE_fnDumpMemory( pCore, 0, 0, fp );
+	CORE_fnDumpRegisters(pCore, fp);
+    CORE_fnDumpStack(pCore, fp);
+	fclose(fp);
+}
+
+/*============================================================================*/
+/*  CORE_fnDumpRegisters                                                      */
+/*!
+    Dump the VM Core Registers
+
+    The CORE_fnDumpRegisters function dumps the VM core registers and flags
+    to the specified FILE *
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
         fp
             output FILE * for dumping the register values
 
@@ -834,6 +1632,8 @@ void CORE_fnDumpRegisters(tzCore *pCore, FILE *fp)
 		return;
 	}
 
+	(void)FLAGS;
+
 	fprintf(fp, "\nregisters:\n");
 
 	for (i = 0; (i < 16); i++)
@@ -931,7 +1731,11 @@ void CORE_fnDumpStack(tzCore *pCore, FILE *fp)
     Save the VM Core
 
     The CORE_fnSave function writes the core program memory out to the
-    specified file.
+    specified file.  If the VM core memory uses the host byte order, or
+    the program imports external variables, the program memory is
+    preceded by a tzCoreImageHeader which records it.  The names of the
+    imported external variables follow the header, terminated by an
+    empty name.
 
     @param[in]
         pCore
@@ -948,6 +1752,9 @@ void CORE_fnDumpStack(tzCore *pCore, FILE *fp)
 bool CORE_fnSave( tzCore *pCore, char *outputFile )
 {
     FILE *fp;
+    tzCoreImageHeader header = { .magic = CORE_IMAGE_MAGIC,
+                                 .version = CORE_IMAGE_VERSION,
+                                 .flags = 0 };
 
     if( pCore == NULL )
     {
@@ -960,6 +1767,29 @@ bool CORE_fnSave( tzCore *pCore, char *outputFile )
         return false;
     }
 
+    if( pCore->nativeEndian )
+    {
+        /* identify the byte order of the image */
+        header.flags |= CORE_IMAGE_LITTLE_ENDIAN;
+    }
+
+    if( pCore->numImports > 0 )
+    {
+        header.flags |= CORE_IMAGE_IMPORTS;
+    }
+
+    if( header.flags != 0 )
+    {
+        fwrite( &header, sizeof( header ), 1, fp );
+    }
+
+    if( pCore->numImports > 0 )
+    {
+        /* output the import table and the empty name which ends it */
+        fwrite( pCore->pImportNames, 1, pCore->importNamesLen, fp );
+        fputc( '\0', fp );
+    }
+
     /* output the binary image */
     fwrite(pCore->memory, 1, pCore->programSize, fp );
 
@@ -1053,7 +1883,10 @@ void CORE_fnDumpMemory( tzCore *pCore,
     Load a program into the VM Core Memory
 
     The CORE_fnLoad function reads the program memory from the specified file
-    into the specified core
+    into the specified core.  If the program image has an import table,
+    the imported external variables are resolved when the external
+    variables library is already initialized, so a missing variable
+    stops the program from loading instead of failing while it runs.
 
     @param[in]
         pCore
@@ -1068,6 +1901,8 @@ bool CORE_fnLoad( tzCore *pCore, char *programFile )
 {
     FILE *fp;
     size_t sz;
+    tzCoreImageHeader header;
+    const uint8_t magic[] = CORE_IMAGE_MAGIC;
 
     if( pCore == NULL )
     {
@@ -1084,6 +1919,41 @@ bool CORE_fnLoad( tzCore *pCore, char *programFile )
     sz = ftell(fp);
     fseek(fp, 0L, SEEK_SET);
 
+    /* images without a header are big endian */
+    pCore->nativeEndian = false;
+    core_fnFreeImports( pCore );
+
+    if( ( sz >= sizeof( header ) ) &&
+        ( fread( &header, sizeof( header ), 1, fp ) == 1 ) &&
+        ( memcmp( header.magic, magic, CORE_IMAGE_MAGIC_LEN ) == 0 ) )
+    {
+        if( ( header.version != CORE_IMAGE_VERSION ) ||
+            ( ( header.flags & ~( CORE_IMAGE_LITTLE_ENDIAN |
+                                  CORE_IMAGE_IMPORTS ) ) != 0 ) ||
+            ( ( ( header.flags & CORE_IMAGE_LITTLE_ENDIAN ) != 0 ) &&
+              ( core_fnIsLittleEndianHost() == false ) ) )
+        {
+            fclose(fp);
+            fprintf(stderr, "Unsupported program image format\n");
+            return false;
+        }
+
+        pCore->nativeEndian = ( header.flags & CORE_IMAGE_LITTLE_ENDIAN ) != 0;
+        sz -= sizeof( header );
+
+        if( ( ( header.flags & CORE_IMAGE_IMPORTS ) != 0 ) &&
+            ( core_fnReadImports( pCore, fp, &sz ) == false ) )
+        {
+            fclose(fp);
+            fprintf(stderr, "Invalid program import table\n");
+            return false;
+        }
+    }
+    else
+    {
+        fseek(fp, 0L, SEEK_SET);
+    }
+
     if( sz > ( CORE_SIZE - STACK_SIZE ) )
     {
         fclose(fp);
@@ -1093,11 +1963,198 @@ bool CORE_fnLoad( tzCore *pCore, char *programFile )
 
     /* read the program into memory */
     fread( pCore->memory, sz, 1, fp );
+    fclose( fp );
 
     /* set the program size */
     pCore->programSize = sz;
 
-    return true;
+    /* pre-decode the program image */
+    core_fnDecodeProgram( pCore );
+
+    /* resolve the imported external variables */
+    return ( core_fnResolveImports( pCore ) == EOK );
+}
+
+/*============================================================================*/
+/*  CORE_fnVerify                                                             */
+/*!
+    Verify the VM Core Program
+
+    The CORE_fnVerify function checks the program loaded into the VM core
+    memory before it is executed.  Every instruction reachable from the
+    start of the program, or from the target of a literal jump or call,
+    is checked to ensure that:
+
+    - it is a legal instruction which fits inside the program image
+    - it does not overlap any other reachable instruction
+    - literal jump and call targets are inside the program image
+    - literal LOD and STR addresses are inside the VM core memory
+    - execution cannot run past the end of the program image
+
+    Once the program has been verified, the eCORE_ENGINE_DECODED engine
+    executes it through a fast path which omits the checks proven by the
+    verifier.  Register indirect jumps, returns and writes into the
+    program image are still checked at run time, and fall back to the
+    fully checked execution loop if they leave the verified program.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @retval EOK the program was verified
+    @retval EINVAL the program is malformed, or invalid arguments
+    @retval ENOENT no program has been loaded
+    @retval ENOMEM the verification tables could not be allocated
+
+==============================================================================*/
+int CORE_fnVerify( tzCore *pCore )
+{
+    uint8_t *pMarks;
+    uint32_t *pWork;
+    size_t numWork = 0;
+    uint32_t pc;
+    size_t i;
+    int result;
+
+    if( pCore == NULL )
+    {
+        return EINVAL;
+    }
+
+    pCore->verified = false;
+
+    if( ( PROGRAM_SIZE == 0 ) || ( pCore->pDecodeMap == NULL ) )
+    {
+        return ENOENT;
+    }
+
+    /* each program address is queued at most once */
+    pMarks = calloc( PROGRAM_SIZE, sizeof( uint8_t ) );
+    pWork = malloc( PROGRAM_SIZE * sizeof( uint32_t ) );
+    if( ( pMarks == NULL ) || ( pWork == NULL ) )
+    {
+        free( pMarks );
+        free( pWork );
+        return ENOMEM;
+    }
+
+    /* walk every instruction reachable from the start of the program */
+    result = core_fnVerifyTarget( pCore, 0, 0, pMarks, pWork, &numWork );
+    while( ( result == EOK ) && ( numWork > 0 ) )
+    {
+        pc = pWork[--numWork];
+        result = core_fnVerifyInstruction( pCore,
+                                           pc,
+                                           pMarks,
+                                           pWork,
+                                           &numWork );
+    }
+
+    if( result == EOK )
+    {
+        /* rebuild the decode tables from the verified instructions only */
+        for( i = 0; i < PROGRAM_SIZE; i++ )
+        {
+            pCore->pDecodeMap[i] = DECODE_NONE;
+        }
+
+        pCore->numDecoded = 0;
+        pCore->verified = true;
+
+        for( i = 0; i < PROGRAM_SIZE; i++ )
+        {
+            if( pMarks[i] & VERIFY_START )
+            {
+                (void)core_fnDecodeAt( pCore, (int32_t)i );
+            }
+        }
+    }
+
+    free( pMarks );
+    free( pWork );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  CORE_fnLoadNative                                                         */
+/*!
+    Load a native module for the VM Core Program
+
+    The CORE_fnLoadNative function loads a native module generated by
+    the vaot utility from the program currently loaded into the VM core
+    memory.  The module is only accepted if it was generated from an
+    identical program image.
+
+    Once loaded, the native module is used when the eCORE_ENGINE_NATIVE
+    execution engine is selected with CORE_fnSetEngine.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        filename
+            name of the native module shared object
+
+    @retval EOK the native module was loaded
+    @retval ENOENT the native module could not be opened
+    @retval EINVAL the native module does not match the loaded program
+
+==============================================================================*/
+int CORE_fnLoadNative( tzCore *pCore, char *filename )
+{
+    void *handle;
+    tzVMAOTInfo *pInfo;
+    int (*pfnNative)( tzVMAOTContext *pCtx );
+
+    if( ( pCore == NULL ) || ( filename == NULL ) )
+    {
+        return EINVAL;
+    }
+
+    handle = dlopen( filename, RTLD_NOW | RTLD_LOCAL );
+    if( handle == NULL )
+    {
+        return ENOENT;
+    }
+
+    pInfo = dlsym( handle, VMAOT_INFO_SYMBOL );
+    pfnNative = dlsym( handle, VMAOT_EXECUTE_SYMBOL );
+    if( ( pInfo == NULL ) ||
+        ( pfnNative == NULL ) ||
+        ( pInfo->version != VMAOT_VERSION ) ||
+        ( pInfo->programSize != PROGRAM_SIZE ) ||
+        ( pInfo->checksum != CORE_fnChecksum( pCore ) ) )
+    {
+        fprintf( stderr, "%s does not match the loaded program\n", filename );
+        dlclose( handle );
+        return EINVAL;
+    }
+
+    if( pCore->pNativeLib != NULL )
+    {
+        dlclose( pCore->pNativeLib );
+    }
+
+    pCore->pNativeLib = handle;
+    pCore->pfnNative = pfnNative;
+    pCore->nativeStale = false;
+
+    pCore->native.pCore = pCore;
+    pCore->native.pReg = pCore->registers.reg;
+    pCore->native.pStatus = &pCore->status;
+    pCore->native.pMemory = MEMORY;
+    pCore->native.coreSize = CORE_SIZE;
+    pCore->native.programSize = PROGRAM_SIZE;
+    pCore->native.pRunning = &pCore->running;
+    pCore->native.pError = &pCore->error;
+    pCore->native.pStale = &pCore->nativeStale;
+    pCore->native.pBudgeted = &pCore->budgeted;
+    pCore->native.pBudget = &pCore->budget;
+    pCore->native.pfnStep = core_fnStepInstruction;
+
+    return EOK;
 }
 
 /*============================================================================*/
@@ -1109,6 +2166,14 @@ bool CORE_fnLoad( tzCore *pCore, char *programFile )
     VM Core memory.  Upon successful execution, this function will return
     the value of the VM register R0.
 
+    Instructions are executed from the pre-decoded instruction array
+    where possible.  Program addresses which have not been decoded yet
+    are decoded on first use, and any address outside the program
+    image is executed directly from the VM core memory.
+
+    If the threaded, JIT or native execution engine has been selected
+    using CORE_fnSetEngine, the program is executed by that engine instead.
+
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
@@ -1119,18 +2184,15 @@ bool CORE_fnLoad( tzCore *pCore, char *programFile )
 ==============================================================================*/
 int CORE_fnExecute(tzCore *pCore)
 {
-    uint8_t opcode;
     int result = -1;
 
     if ( pCore != NULL )
     {
-        pCore->running = true;
+        /* run the program to completion on the calling thread */
+        pCore->suspend = false;
+        pCore->budgeted = false;
 
-        while( ( pCore->running ) && !(pCore->error) )
-        {
-            opcode = MEMORY[PC] & 0x1F;
-            instructions0[opcode].exec(pCore);
-        }
+        core_fnExecuteEngine( pCore );
     }
 
     if ( !pCore->error )
@@ -1141,3106 +2203,7933 @@ int CORE_fnExecute(tzCore *pCore)
     return result;
 }
 
-/*==============================================================================
-        Private Function Definitions
-==============================================================================*/
-
 /*============================================================================*/
-/*  core_fnCheckInstructionList                                               */
+/*  CORE_fnRun                                                                */
 /*!
-    Check the VM Core instruction list
+    Run a program until it halts, suspends or is preempted
+
+    The CORE_fnRun function executes the program currently loaded into
+    the VM Core memory using the selected execution engine.  Unlike
+    CORE_fnExecute, the calling thread is never blocked by the program.
+    The WFS and DLY instructions suspend the program and return control
+    to the caller, which is responsible for resuming it when its event
+    arrives:
+
+    eCORE_RUN_BLOCKED_DELAY is returned when the program executes a DLY
+    instruction.  The caller should wait for the number of milliseconds
+    returned by CORE_fnGetDelay before calling CORE_fnRun again.
+
+    eCORE_RUN_BLOCKED_SIGNAL is returned when the program executes a WFS
+    or DSP instruction and none of its timers or notifications is ready.
+    The caller should wait for the file descriptor returned by
+    CORE_fnGetEventFd to become readable before calling CORE_fnRun
+    again, which then completes the WFS or DSP with the received event.
+    Alternatively a signal received by the caller can be passed to
+    CORE_fnDeliverSignal.  CORE_fnRun returns eCORE_RUN_BLOCKED_SIGNAL
+    without executing any instructions until an event is received.
+
+    eCORE_RUN_PREEMPTED is returned when the program has used the
+    instruction budget, and the program continues from where it was
+    preempted the next time CORE_fnRun is called.  The decoded execution
+    engine charges each instruction to the budget.  The threaded, JIT
+    and native engines only charge taken branches, calls and returns
+    (or translated blocks), so every loop is bounded by the budget.
+    A budget of 0 runs the program until it halts or suspends.
 
-    The core_fnCheckInstructionList function checks to see if the opcode
-    instruction list has been entered in the correct order.
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    @retval true opcode instruction list is ok
-    @retval false opcode instruction list order is incorrect
+    @param[in]
+        budget
+            maximum number of instructions to execute, or 0 for no limit
+
+    @retval eCORE_RUN_HALTED the program has halted
+    @retval eCORE_RUN_ERROR the program was stopped by an error
+    @retval eCORE_RUN_PREEMPTED the instruction budget was used up
+    @retval eCORE_RUN_BLOCKED_DELAY the program is suspended in DLY
+    @retval eCORE_RUN_BLOCKED_SIGNAL the program is suspended in WFS or DSP
 
 ==============================================================================*/
-static bool core_fnCheckInstructionList()
+teCoreRunStatus CORE_fnRun( tzCore *pCore, uint32_t budget )
 {
-    uint8_t opcode;
+    teCoreRunStatus result = eCORE_RUN_ERROR;
+    int signum;
+    int id;
 
-    for(opcode=0;opcode<HRMAXINST;opcode++)
+    if( pCore != NULL )
     {
-        if( instructions0[opcode].opcode != opcode )
+        if( ( pCore->runStatus == eCORE_RUN_BLOCKED_SIGNAL ) &&
+            ( EVENT_fnWait( &pCore->events, false, &signum, &id ) == EOK ) )
         {
-            fprintf( stderr, "Instruction0 list order incorrect\n" );
-            return false;
+            /* resume the program with the received event */
+            CORE_fnDeliverSignal( pCore, signum, id );
         }
 
-        if( instructions1[opcode].opcode != opcode )
+        if( ( pCore->runStatus == eCORE_RUN_READY ) ||
+            ( pCore->runStatus == eCORE_RUN_PREEMPTED ) ||
+            ( pCore->runStatus == eCORE_RUN_BLOCKED_DELAY ) )
         {
-            fprintf( stderr,
-                     "Instruction1 list order incorrect: opcode = %d\n",
-                     opcode);
+            pCore->runStatus = eCORE_RUN_READY;
+            pCore->suspend = true;
+            pCore->budgeted = ( budget != 0 );
+            pCore->budget = budget;
 
-            return false;
+            core_fnExecuteEngine( pCore );
+
+            pCore->suspend = false;
+            pCore->budgeted = false;
+
+            if( pCore->error )
+            {
+                pCore->runStatus = eCORE_RUN_ERROR;
+            }
+            else if( pCore->runStatus == eCORE_RUN_READY )
+            {
+                /* the program stopped without suspending */
+                pCore->runStatus = eCORE_RUN_HALTED;
+            }
         }
+
+        result = pCore->runStatus;
     }
 
-    /* instruction list is ok */
-    return true;
+    return result;
 }
 
 /*============================================================================*/
-/*  core_fnGetSignedData                                                      */
+/*  CORE_fnGetDelay                                                           */
 /*!
-    Get a signed 32-bit value from core memory
+    Get the delay time of a suspended program
 
-    The core_fnGetSignedData function retrieves a signed literal value from
-    the core memory from the address specified by memory[pc+offset].
-    The program counter points to the instruction which encodes the
-    size of the value to retrieve.
+    The CORE_fnGetDelay function gets the delay time requested by the DLY
+    instruction which suspended the program.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
-    @param[in]
-        memory
-            pointer to the VM core memory
-
-    @param[in]
-        pc
-            offset in the core memory where the instruction associated
-            with the literal value is stored
-
-    @param[in]
-        offset
-           offset from the instruction address to the start of the literal value
-
-    @retval 32-bit signed value retrieved from the VM core memory
+    @retval delay time in milliseconds
+    @retval 0 the program is not suspended in a DLY instruction
 
 ==============================================================================*/
-static int32_t core_fnGetSignedData( tzCore *pCore,
-                                     uint8_t *memory,
-                                     int32_t pc,
-                                     uint8_t offset )
+uint32_t CORE_fnGetDelay( tzCore *pCore )
 {
-    uint8_t *instr;
-    uint8_t datatype;
-    int32_t val32 = 0;
-    int16_t val16;
-    int8_t val8;
+    uint32_t result = 0;
 
-    instr = (uint8_t *)&memory[pc];
-    datatype = *instr & (BYTE | WORD);
-    switch( datatype )
+    if( ( pCore != NULL ) &&
+        ( pCore->runStatus == eCORE_RUN_BLOCKED_DELAY ) )
     {
-        case BYTE:
-            val8 = (int8_t)instr[offset];
-            val32 = (int32_t)val8;
-            INC_PC(1);
-            break;
-
-        case WORD:
-            val16 = (int16_t)( ( instr[offset] << 8 ) + instr[offset+1] );
-            val32 = (int32_t)val16;
-            INC_PC(2);
-            break;
-
-        case LONG:
-        case FLOAT32:
-            val32 = (int32_t)(( instr[offset] << 24 ) +
-                            ( instr[offset+1] << 16 ) +
-                            ( instr[offset+2] << 8 ) +
-                            ( instr[offset+3] ));
-            INC_PC(4);
-            break;
-
-        default:
-            printf("invalid data size\n");
-            break;
+        result = pCore->delayMS;
     }
 
-    return val32;
+    return result;
 }
 
 /*============================================================================*/
-/*  core_fnGetFloatData                                                       */
+/*  CORE_fnDeliverSignal                                                      */
 /*!
-    Get a float value from core memory
+    Deliver a signal to a suspended program
 
-    The core_fnGetFloatData function retrieves a floating point literal value
-    from the core memory from the address specified by memory[pc+offset].
-    The program counter points to the instruction which encodes the
-    size of the value to retrieve.
+    The CORE_fnDeliverSignal function completes the WFS or DSP
+    instruction which suspended the program, by storing the signal
+    number and signal id into its registers.  The program continues
+    from the instruction after the WFS the next time CORE_fnRun is
+    called.  A DSP continues with the handler of the signal, if the
+    program has set one using the VEC instruction.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
     @param[in]
-        memory
-            pointer to the VM core memory
-
-    @param[in]
-        pc
-            offset in the core memory where the instruction associated
-            with the literal value is stored
+        signum
+            received signal number
 
     @param[in]
-        offset
-           offset from the instruction address to the start of the literal value
+        id
+            received signal id
 
-    @retval 32-bit floating point value retrieved from the VM core memory
+    @retval EOK the signal was delivered
+    @retval EAGAIN the program is not suspended in a WFS or DSP instruction
+    @retval EINVAL invalid arguments
 
 ==============================================================================*/
-static float core_fnGetFloatData( tzCore *pCore,
-                                  uint8_t *memory,
-                                  int32_t pc,
-                                  uint8_t offset)
+int CORE_fnDeliverSignal( tzCore *pCore, int signum, int id )
 {
-    uint8_t *instr;
+    int result = EINVAL;
 
-    union
+    if( pCore != NULL )
     {
-        float fVal;
-        uint8_t uVal[4];
-    } data;
+        if( pCore->runStatus == eCORE_RUN_BLOCKED_SIGNAL )
+        {
+            REG[pCore->signalReg[0]] = signum;
+            REG[pCore->signalReg[1]] = id;
 
-    instr = (uint8_t *)&memory[pc];
+            pCore->runStatus = eCORE_RUN_READY;
+            pCore->running = true;
+            INC_PC(pCore->signalLen);
 
-    data.uVal[3] = instr[offset];
-    data.uVal[2] = instr[offset+1];
-    data.uVal[1] = instr[offset+2];
-    data.uVal[0] = instr[offset+3];
+            if( pCore->signalDispatch )
+            {
+                core_fnDispatch( pCore, signum, id );
+            }
 
-    INC_PC(4);
+            result = EOK;
+        }
+        else
+        {
+            result = EAGAIN;
+        }
+    }
 
-    return data.fVal;
+    return result;
 }
 
 /*============================================================================*/
-/*  core_fnGetUnsignedData                                                    */
+/*  CORE_fnGetEventFd                                                         */
 /*!
-    Get an unsigned 32-bit value from core memory
+    Get the event file descriptor of a VM instance
 
-    The core_fnGetUnsignedData function retrieves an unsigned 23-bit literal
-    value from the core memory from the address specified by memory[pc+offset].
-    The program counter points to the instruction which encodes the
-    size of the value to retrieve.
+    The CORE_fnGetEventFd function gets a file descriptor which becomes
+    readable when one of the program timers has expired, or one of its
+    requested notifications has been received.  A host running many
+    VM instances can wait for it (e.g. using epoll) to find out when a
+    program suspended in WFS or DSP can be resumed by CORE_fnRun.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
-    @param[in]
-        memory
-            pointer to the VM core memory
-
-    @param[in]
-        pc
-            offset in the core memory where the instruction associated
-            with the literal value is stored
-
-    @param[in]
-        offset
-           offset from the instruction address to the start of the literal value
-
-    @retval 32-bit unsigned value retrieved from the VM core memory
+    @retval event file descriptor
+    @retval -1 invalid arguments
 
 ==============================================================================*/
-static uint32_t core_fnGetUnsignedData( tzCore *pCore,
-                                        uint8_t *memory,
-                                        int32_t pc,
-                                        uint8_t offset)
+int CORE_fnGetEventFd( tzCore *pCore )
 {
-    uint8_t *instr;
-    uint8_t datatype;
-    uint32_t val;
-
-    instr = (uint8_t *)&memory[pc];
-    datatype = *instr & (BYTE | WORD);
-    switch( datatype )
-    {
-        case BYTE:
-            val = (uint32_t)instr[offset];
-            INC_PC(1);
-            break;
-
-        case WORD:
-            val = (uint32_t)( instr[offset] << 8 ) + instr[offset+1];
-            INC_PC(2);
-            break;
-
-        case LONG:
-        case FLOAT32:
-            val = (uint32_t)(( instr[offset] << 24 ) +
-                  ( instr[offset+1] << 16 ) +
-                  ( instr[offset+2] << 8 ) +
-                  ( instr[offset+3] ));
-            INC_PC(4);
-            break;
-
-        default:
-            printf("invalid data size\n");
-            break;
-    }
-
-    return val;
+    return ( pCore != NULL ) ? EVENT_fnGetFd( &pCore->events ) : -1;
 }
 
 /*============================================================================*/
-/*  core_fnStoreData                                                          */
+/*  CORE_fnPostEvent                                                          */
 /*!
-    Copy a data value from source to destination
+    Post an event to a VM instance
 
-    The core_fnStoreData function copies a data value from a source to a
-    destination location in the VM core memory.
+    The CORE_fnPostEvent function queues a timer or notification signal
+    for the program, to be received by its next WFS or DSP instruction.
+    It does not take a lock, and may be called from any thread of the
+    host (e.g. a dedicated signal or epoll thread) while the program is
+    running.  A program suspended in WFS or DSP is resumed by the next
+    call to CORE_fnRun.  Events which do not fit in the ready queue are
+    counted and can be read using CORE_fnGetEventOverflow.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
     @param[in]
-        instr
-            pointer to the STR instruction which contains information
-            regarding the length of data to be stored.
+        signum
+            signal number
 
     @param[in]
-        dest
-            pointer to the location to store the data
+        id
+            signal id: the timer identifier or the notification value
 
-    @param[in]
-        src
-           pointer to the location to get the data to be stored
+    @retval EOK the event was queued
+    @retval ENOSPC the ready queue is full
+    @retval EINVAL invalid arguments
 
 ==============================================================================*/
-static void core_fnStoreData( tzCore *pCore,
-                              uint8_t *instr,
-                              uint8_t *dest,
-                              uint8_t *src )
+int CORE_fnPostEvent( tzCore *pCore, int signum, int id )
 {
-    if( ( *instr & BYTE ) == BYTE )
-    {
-        *dest = *src;
-    }
-    else if( ( *instr & WORD ) == WORD )
-    {
-        /* swap endianness */
-        dest[0] = src[1];
-        dest[1] = src[0];
-    }
-    else
-    {
-        /* swap endianness */
-        dest[0] = src[3];
-        dest[1] = src[2];
-        dest[2] = src[1];
-        dest[3] = src[0];
-    }
+    return ( pCore != NULL ) ? EVENT_fnPost( &pCore->events, signum, id )
+                             : EINVAL;
 }
 
 /*============================================================================*/
-/*  core_fnSetStackData                                                       */
+/*  CORE_fnSetSignalRouter                                                    */
 /*!
-    Store a data value on the VM core stack
-
-    The core_fnSetStackData function stores a 32-bit value on the
-    Virtual Machine Core Stack.
+    Route the notification signals of a VM instance through the host
+
+    The CORE_fnSetSignalRouter function is used by a host running many
+    VM instances in one process, which receives all of the notification
+    signals with a single signalfd.  The VM instance does not open its
+    own signalfd, and instead calls the router function before each
+    notification it requests (by the NFY instruction or the extern
+    read-through cache) with the signal number and id which the
+    notification will be sent with.  The host delivers each received
+    notification to the VM instances which requested it using
+    CORE_fnPostEvent.
+
+    The router function is called by the thread running the program.
+    The router must be set before the program is run and before the
+    extern read-through cache is enabled.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
     @param[in]
-        sp
-            index to the location on the stack to store the data
+        pfnRoute
+            pointer to the router function
 
     @param[in]
-        val
-            32-bit data to be stored on the stack
+        pArg
+            argument passed to the router function
+
+    @retval EOK the router was set
+    @retval EINVAL invalid arguments
 
 ==============================================================================*/
-static void core_fnSetStackData( tzCore *pCore, uint32_t sp, uint32_t val )
+int CORE_fnSetSignalRouter( tzCore *pCore,
+                            void (*pfnRoute)( void *pArg,
+                                              tzCore *pCore,
+                                              int signum,
+                                              uint32_t id ),
+                            void *pArg )
 {
-    MEMORY[sp] = (val & 0xFF000000L ) >> 24;
-    MEMORY[sp+1] = ( val & 0x00FF0000L ) >> 16;
-    MEMORY[sp+2] = ( val & 0x0000FF00L ) >> 8;
-    MEMORY[sp+3] = ( val & 0x000000FFL );
+    int result = EINVAL;
+
+    if( ( pCore != NULL ) && ( pfnRoute != NULL ) )
+    {
+        pCore->pfnRoute = pfnRoute;
+        pCore->pRouteArg = pArg;
+        EXTERNVAR_fnSetRequestHook( &pCore->extVars, core_fnRequested, pCore );
+        result = EOK;
+    }
+
+    return result;
 }
 
 /*============================================================================*/
-/*  core_fnGetStackData                                                       */
+/*  CORE_fnGetEventOverflow                                                   */
 /*!
-    Get a data value from the VM core stack
+    Get the number of events lost by a VM instance
 
-    The core_fnGetStackData function gets a 32-bit value from the
-    Virtual Machine Core Stack.
+    The CORE_fnGetEventOverflow function gets the number of timer and
+    notification signals which were not delivered to the program
+    because its ready queue was full.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
-    @param[in]
-        sp
-            index to the location on the stack where the data is located
-
-    @retval value retrieved from the VM core stack
+    @retval number of lost events
 
 ==============================================================================*/
-static uint32_t core_fnGetStackData( tzCore *pCore, uint32_t sp )
+unsigned int CORE_fnGetEventOverflow( tzCore *pCore )
 {
-    uint32_t val;
-
-    val = ( MEMORY[sp] << 24 ) +
-          ( MEMORY[sp+1] << 16 ) +
-          ( MEMORY[sp+2] << 8 ) +
-          MEMORY[sp+3];
-
-    return val;
+    return ( pCore != NULL ) ? EVENT_fnOverflow( &pCore->events ) : 0;
 }
 
-/*==============================================================================
-        VM OP CODES
-==============================================================================*/
-
 /*============================================================================*/
-/*  opNOP                                                                     */
+/*  CORE_fnGetResult                                                          */
 /*!
-    NOP - No Operation
+    Get the result of a program
 
-    The opNOP function implements the VM 'NOP' operation.  This takes
-    no action, it only increments the Program Counter
+    The CORE_fnGetResult function gets the result of a program which
+    was run using CORE_fnRun.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @retval -1 core execution error
+    @retval value of R0 register
+
 ==============================================================================*/
-static void opNOP(tzCore *pCore)
+int CORE_fnGetResult( tzCore *pCore )
 {
-    INC_PC(1);
+    int result = -1;
+
+    if( ( pCore != NULL ) && !(pCore->error) )
+    {
+        result = pCore->registers.reg[0];
+    }
+
+    return result;
 }
 
 /*============================================================================*/
-/*  opLOD                                                                     */
+/*  core_fnExecuteEngine                                                      */
 /*!
-    LOD - Load a Register
+    Execute a program using the selected execution engine
 
-    The opLOD function implements the VM 'LOD' operation.  This loads
-    a register value from another register, or from core memory,
+    The core_fnExecuteEngine function executes the program from the
+    current program counter until the VM core stops running.
+
+    Instructions are executed from the pre-decoded instruction array
+    where possible.  Program addresses which have not been decoded yet
+    are decoded on first use, and any address outside the program
+    image is executed directly from the VM core memory.
+
+    If the threaded, JIT or native execution engine has been selected
+    using CORE_fnSetEngine, the program is executed by that engine instead.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opLOD(tzCore *pCore)
+static void core_fnExecuteEngine( tzCore *pCore )
 {
-    register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register uint32_t addr;
-    register uint32_t val;
+    uint8_t opcode;
+    int32_t idx;
+    tzDecoded *pInst;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    pCore->running = true;
+
+#ifdef VMCORE_THREADED
+    if( pCore->engine == eCORE_ENGINE_THREADED )
     {
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        addr = REG[src];
-        if ( addr > CORE_SIZE )
-        {
-            printf( "LOD R[%d],R[%d]: Illegal Address in R[%d]: 0x%X @ 0x%X\n",
-                    dst,
-                    src,
-                    src,
-                    addr,
-                    PC);
-            STOP;
-            return;
+        core_fnExecuteThreaded( pCore );
+    }
+#endif
+
+    if( pCore->engine == eCORE_ENGINE_JIT )
+    {
+        core_fnExecuteJIT( pCore );
+    }
+    else if( pCore->engine == eCORE_ENGINE_NATIVE )
+    {
+        core_fnExecuteNative( pCore );
+    }
+    else if( ( pCore->engine == eCORE_ENGINE_DECODED ) &&
+             ( pCore->verified ) )
+    {
+        core_fnExecuteVerified( pCore );
+    }
+
+    while( ( pCore->running ) && !(pCore->error) )
+    {
+        if( ( pCore->budgeted ) && ( pCore->budget-- == 0 ) )
+        {
+            /* the instruction budget has been used */
+            core_fnPreempt( pCore );
+        }
+        else if( ( pCore->pDecodeMap != NULL ) &&
+                 ( (uint32_t)PC < PROGRAM_SIZE ) )
+        {
+            idx = pCore->pDecodeMap[PC];
+            if( idx == DECODE_NONE )
+            {
+                idx = core_fnDecodeAt( pCore, PC );
+            }
+
+            pInst = &pCore->pDecoded[idx];
+            pInst->exec( pCore, pInst );
+        }
+        else
+        {
+            opcode = MEMORY[PC] & 0x1F;
+            instructions0[opcode].exec(pCore);
         }
+    }
 
-        /* transfer data from memory to register */
-        core_fnStoreData( pCore,
-                          &MEMORY[PC],
-                          (uint8_t *)&REG[dst],
-                          &MEMORY[addr] );
+    (void)FLAGS;
+}
+
+/*============================================================================*/
+/*  core_fnPreempt                                                            */
+/*!
+    Preempt a program which has used its instruction budget
+
+    The core_fnPreempt function stops the program run by CORE_fnRun
+    when its instruction budget has been used.  CORE_fnRun returns
+    eCORE_RUN_PREEMPTED and the program continues from the current
+    program counter the next time CORE_fnRun is called.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnPreempt( tzCore *pCore )
+{
+    pCore->runStatus = eCORE_RUN_PREEMPTED;
+    STOP;
+}
+
+/*============================================================================*/
+/*  CORE_fnSetEngine                                                          */
+/*!
+    Select the VM core execution engine
+
+    The CORE_fnSetEngine function selects the engine used by CORE_fnExecute
+    to execute the program loaded into the VM core.  Both engines produce
+    the same results, and can be selected to compare their performance.
+
+    eCORE_ENGINE_DECODED executes the pre-decoded program image
+    (this is the default)
+
+    eCORE_ENGINE_THREADED executes the program image directly using
+    computed goto dispatch.  It is only available when libvmcore is
+    built with the VMCORE_THREADED option using a GCC compatible compiler.
+
+    eCORE_ENGINE_JIT translates the program image into x86-64 machine
+    code.  It is only available when libvmcore is built with the
+    VMCORE_JIT option for an x86-64 target.
+
+    eCORE_ENGINE_NATIVE executes the program using the native module
+    loaded by CORE_fnLoadNative.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        engine
+            the execution engine to select
+
+    @retval EOK the execution engine was selected
+    @retval ENOTSUP the execution engine is not available in this build
+    @retval ENOENT no native module has been loaded
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int CORE_fnSetEngine( tzCore *pCore, teCoreEngine engine )
+{
+    int result = EINVAL;
+
+    if( pCore != NULL )
+    {
+        switch( engine )
+        {
+            case eCORE_ENGINE_DECODED:
+                pCore->engine = engine;
+                result = EOK;
+                break;
+
+            case eCORE_ENGINE_THREADED:
+#ifdef VMCORE_THREADED
+                pCore->engine = engine;
+                result = EOK;
+#else
+                result = ENOTSUP;
+#endif
+                break;
+
+            case eCORE_ENGINE_JIT:
+                if( JIT_fnSupported() )
+                {
+                    pCore->engine = engine;
+                    result = EOK;
+                }
+                else
+                {
+                    result = ENOTSUP;
+                }
+                break;
+
+            case eCORE_ENGINE_NATIVE:
+                if( pCore->pfnNative != NULL )
+                {
+                    pCore->engine = engine;
+                    result = EOK;
+                }
+                else
+                {
+                    result = ENOENT;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return result;
+}
+
+/*==============================================================================
+        Private Function Definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  core_fnCheckInstructionList                                               */
+/*!
+    Check the VM Core instruction list
+
+    The core_fnCheckInstructionList function checks to see if the opcode
+    instruction list has been entered in the correct order.
+
+    @retval true opcode instruction list is ok
+    @retval false opcode instruction list order is incorrect
+
+==============================================================================*/
+static bool core_fnCheckInstructionList()
+{
+    uint8_t opcode;
+
+    for(opcode=0;opcode<HRMAXINST;opcode++)
+    {
+        if( instructions0[opcode].opcode != opcode )
+        {
+            fprintf( stderr, "Instruction0 list order incorrect\n" );
+            return false;
+        }
+
+        if( instructions1[opcode].opcode != opcode )
+        {
+            fprintf( stderr,
+                     "Instruction1 list order incorrect: opcode = %d\n",
+                     opcode);
+
+            return false;
+        }
+    }
+
+    /* instruction list is ok */
+    return true;
+}
+
+/*============================================================================*/
+/*  core_fnIsLittleEndianHost                                                 */
+/*!
+    Check the byte order of the host
+
+    The core_fnIsLittleEndianHost function checks whether the host stores
+    multi-byte values in little endian format.  The VM core registers are
+    accessed as little endian bytes, so a native endian VM core memory is
+    only supported on little endian hosts.
+
+    @retval true the host is little endian
+    @retval false the host is big endian
+
+==============================================================================*/
+static bool core_fnIsLittleEndianHost( void )
+{
+    const uint16_t val = 1;
+
+    return ( *(const uint8_t *)&val == 1 );
+}
+
+/*============================================================================*/
+/*  core_fnGetSignedData                                                      */
+/*!
+    Get a signed 32-bit value from core memory
+
+    The core_fnGetSignedData function retrieves a signed literal value from
+    the core memory from the address specified by memory[pc+offset].
+    The program counter points to the instruction which encodes the
+    size of the value to retrieve.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        memory
+            pointer to the VM core memory
+
+    @param[in]
+        pc
+            offset in the core memory where the instruction associated
+            with the literal value is stored
+
+    @param[in]
+        offset
+           offset from the instruction address to the start of the literal value
+
+    @retval 32-bit signed value retrieved from the VM core memory
+
+==============================================================================*/
+static int32_t core_fnGetSignedData( tzCore *pCore,
+                                     uint8_t *memory,
+                                     int32_t pc,
+                                     uint8_t offset )
+{
+    uint8_t *instr;
+    uint8_t datatype;
+    int32_t val32 = 0;
+    int16_t val16;
+    int8_t val8;
+
+    instr = (uint8_t *)&memory[pc];
+    datatype = *instr & (BYTE | WORD);
+    switch( datatype )
+    {
+        case BYTE:
+            val8 = (int8_t)instr[offset];
+            val32 = (int32_t)val8;
+            INC_PC(1);
+            break;
+
+        case WORD:
+            if( pCore->nativeEndian )
+            {
+                memcpy( &val16, &instr[offset], sizeof( val16 ) );
+            }
+            else
+            {
+                val16 = (int16_t)( ( instr[offset] << 8 ) + instr[offset+1] );
+            }
+            val32 = (int32_t)val16;
+            INC_PC(2);
+            break;
+
+        case LONG:
+        case FLOAT32:
+            if( pCore->nativeEndian )
+            {
+                memcpy( &val32, &instr[offset], sizeof( val32 ) );
+            }
+            else
+            {
+                val32 = (int32_t)(( instr[offset] << 24 ) +
+                                ( instr[offset+1] << 16 ) +
+                                ( instr[offset+2] << 8 ) +
+                                ( instr[offset+3] ));
+            }
+            INC_PC(4);
+            break;
+
+        default:
+            printf("invalid data size\n");
+            break;
+    }
+
+    return val32;
+}
+
+/*============================================================================*/
+/*  core_fnGetFloatData                                                       */
+/*!
+    Get a float value from core memory
+
+    The core_fnGetFloatData function retrieves a floating point literal value
+    from the core memory from the address specified by memory[pc+offset].
+    The program counter points to the instruction which encodes the
+    size of the value to retrieve.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        memory
+            pointer to the VM core memory
+
+    @param[in]
+        pc
+            offset in the core memory where the instruction associated
+            with the literal value is stored
+
+    @param[in]
+        offset
+           offset from the instruction address to the start of the literal value
+
+    @retval 32-bit floating point value retrieved from the VM core memory
+
+==============================================================================*/
+static float core_fnGetFloatData( tzCore *pCore,
+                                  uint8_t *memory,
+                                  int32_t pc,
+                                  uint8_t offset)
+{
+    uint8_t *instr;
+
+    union
+    {
+        float fVal;
+        uint8_t uVal[4];
+    } data;
+
+    instr = (uint8_t *)&memory[pc];
+
+    if( pCore->nativeEndian )
+    {
+        memcpy( data.uVal, &instr[offset], sizeof( data.uVal ) );
+    }
+    else
+    {
+        data.uVal[3] = instr[offset];
+        data.uVal[2] = instr[offset+1];
+        data.uVal[1] = instr[offset+2];
+        data.uVal[0] = instr[offset+3];
+    }
+
+    INC_PC(4);
+
+    return data.fVal;
+}
+
+/*============================================================================*/
+/*  core_fnGetUnsignedData                                                    */
+/*!
+    Get an unsigned 32-bit value from core memory
+
+    The core_fnGetUnsignedData function retrieves an unsigned 23-bit literal
+    value from the core memory from the address specified by memory[pc+offset].
+    The program counter points to the instruction which encodes the
+    size of the value to retrieve.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        memory
+            pointer to the VM core memory
+
+    @param[in]
+        pc
+            offset in the core memory where the instruction associated
+            with the literal value is stored
+
+    @param[in]
+        offset
+           offset from the instruction address to the start of the literal value
+
+    @retval 32-bit unsigned value retrieved from the VM core memory
+
+==============================================================================*/
+static uint32_t core_fnGetUnsignedData( tzCore *pCore,
+                                        uint8_t *memory,
+                                        int32_t pc,
+                                        uint8_t offset)
+{
+    uint8_t *instr;
+    uint8_t datatype;
+    uint32_t val;
+    uint16_t val16;
+
+    instr = (uint8_t *)&memory[pc];
+    datatype = *instr & (BYTE | WORD);
+    switch( datatype )
+    {
+        case BYTE:
+            val = (uint32_t)instr[offset];
+            INC_PC(1);
+            break;
+
+        case WORD:
+            if( pCore->nativeEndian )
+            {
+                memcpy( &val16, &instr[offset], sizeof( val16 ) );
+                val = val16;
+            }
+            else
+            {
+                val = (uint32_t)( instr[offset] << 8 ) + instr[offset+1];
+            }
+            INC_PC(2);
+            break;
+
+        case LONG:
+        case FLOAT32:
+            if( pCore->nativeEndian )
+            {
+                memcpy( &val, &instr[offset], sizeof( val ) );
+            }
+            else
+            {
+                val = (uint32_t)(( instr[offset] << 24 ) +
+                      ( instr[offset+1] << 16 ) +
+                      ( instr[offset+2] << 8 ) +
+                      ( instr[offset+3] ));
+            }
+            INC_PC(4);
+            break;
+
+        default:
+            printf("invalid data size\n");
+            break;
+    }
+
+    return val;
+}
+
+/*============================================================================*/
+/*  core_fnStoreData                                                          */
+/*!
+    Copy a data value from source to destination
+
+    The core_fnStoreData function copies a data value from a source to a
+    destination location in the VM core memory.  Multi-byte values are
+    byte swapped unless the VM core memory uses the host byte order.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        instr
+            pointer to the STR instruction which contains information
+            regarding the length of data to be stored.
+
+    @param[in]
+        dest
+            pointer to the location to store the data
+
+    @param[in]
+        src
+           pointer to the location to get the data to be stored
+
+==============================================================================*/
+static void core_fnStoreData( tzCore *pCore,
+                              uint8_t *instr,
+                              uint8_t *dest,
+                              uint8_t *src )
+{
+    if( ( *instr & BYTE ) == BYTE )
+    {
+        *dest = *src;
+    }
+    else if( pCore->nativeEndian )
+    {
+        /* registers and memory have the same byte order */
+        memcpy( dest,
+                src,
+                ( ( *instr & WORD ) == WORD ) ? sizeof( uint16_t )
+                                              : sizeof( uint32_t ) );
+    }
+    else if( ( *instr & WORD ) == WORD )
+    {
+        /* swap endianness */
+        dest[0] = src[1];
+        dest[1] = src[0];
+    }
+    else
+    {
+        /* swap endianness */
+        dest[0] = src[3];
+        dest[1] = src[2];
+        dest[2] = src[1];
+        dest[3] = src[0];
+    }
+}
+
+/*============================================================================*/
+/*  core_fnSetStackData                                                       */
+/*!
+    Store a data value on the VM core stack
+
+    The core_fnSetStackData function stores a 32-bit value on the
+    Virtual Machine Core Stack.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        sp
+            index to the location on the stack to store the data
+
+    @param[in]
+        val
+            32-bit data to be stored on the stack
+
+==============================================================================*/
+static void core_fnSetStackData( tzCore *pCore, uint32_t sp, uint32_t val )
+{
+    if( pCore->nativeEndian )
+    {
+        memcpy( &MEMORY[sp], &val, sizeof( val ) );
+        return;
+    }
+
+    MEMORY[sp] = (val & 0xFF000000L ) >> 24;
+    MEMORY[sp+1] = ( val & 0x00FF0000L ) >> 16;
+    MEMORY[sp+2] = ( val & 0x0000FF00L ) >> 8;
+    MEMORY[sp+3] = ( val & 0x000000FFL );
+}
+
+/*============================================================================*/
+/*  core_fnGetStackData                                                       */
+/*!
+    Get a data value from the VM core stack
+
+    The core_fnGetStackData function gets a 32-bit value from the
+    Virtual Machine Core Stack.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        sp
+            index to the location on the stack where the data is located
+
+    @retval value retrieved from the VM core stack
+
+==============================================================================*/
+static uint32_t core_fnGetStackData( tzCore *pCore, uint32_t sp )
+{
+    uint32_t val;
+
+    if( pCore->nativeEndian )
+    {
+        memcpy( &val, &MEMORY[sp], sizeof( val ) );
+        return val;
+    }
+
+    val = ( MEMORY[sp] << 24 ) +
+          ( MEMORY[sp+1] << 16 ) +
+          ( MEMORY[sp+2] << 8 ) +
+          MEMORY[sp+3];
+
+    return val;
+}
+
+/*============================================================================*/
+/*  core_fnCall                                                               */
+/*!
+    Call a subroutine
+
+    The core_fnCall function pushes the program counter onto the stack
+    as the return address, loads the program counter with the subroutine
+    address, and updates the call depth and string buffer scope level.
+
+    Stack overflow will terminate the virtual machine
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        target
+            address of the subroutine
+
+==============================================================================*/
+static void core_fnCall( tzCore *pCore, uint32_t target )
+{
+    SP -= sizeof( uint32_t );
+    if ( SP < ( CORE_SIZE - STACK_SIZE ) )
+    {
+        printf("Stack Overflow\n");
+        STOP;
+        return;
+    }
+
+    /* set return address */
+    core_fnSetStackData( pCore, SP, PC );
+
+    /* set CALL target */
+    PC = target;
+
+    /* increment the call depth */
+    pCore->call_depth++;
+
+    /* set the new call depth level on the string buffers */
+    STRINGBUFFER_fnSetLevel( &pCore->strbufs, pCore->call_depth );
+}
+
+/*============================================================================*/
+/*  core_fnDispatch                                                           */
+/*!
+    Call the handler of a received signal
+
+    The core_fnDispatch function completes a DSP instruction by calling
+    the handler set by the VEC instruction for the received signal.
+    The handler returns to the instruction after the DSP.  If the signal
+    has no handler, the program simply continues after the DSP.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        signum
+            received signal number
+
+    @param[in]
+        id
+            received signal id
+
+==============================================================================*/
+static void core_fnDispatch( tzCore *pCore, int signum, int id )
+{
+    uint32_t address;
+
+    if( EVENT_fnGetHandler( &pCore->events, signum, id, &address ) == EOK )
+    {
+        core_fnCall( pCore, address );
+    }
+}
+
+/*============================================================================*/
+/*  core_fnFilterEvent                                                        */
+/*!
+    Filter a received notification signal
+
+    The core_fnFilterEvent function invalidates the cached value of an
+    external variable when its MODIFIED notification is received, and
+    discards the notification if it was only requested by the extern
+    read-through cache.
+
+    @param[in]
+        pArg
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        signum
+            received signal number
+
+    @param[in]
+        id
+            received signal id
+
+    @retval true the signal is passed on to the program
+    @retval false the signal is discarded
+
+==============================================================================*/
+static bool core_fnFilterEvent( void *pArg, int signum, int id )
+{
+    tzCore *pCore = (tzCore *)pArg;
+    bool result = true;
+
+    if( signum == EVENT_SIG_FIRST )
+    {
+        result = EXTERNVAR_fnInvalidate( &pCore->extVars, (uint32_t)id );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  core_fnSyncExterns                                                        */
+/*!
+    Receive the pending extern invalidations
+
+    The core_fnSyncExterns function is called by the extern read-through
+    cache before it serves a cached value.  It passes the newly received
+    and posted notification signals to the event filter, which
+    invalidates the cached values of the modified external variables.
+    If any events were lost since the last sync, every cached value is
+    invalidated.
+
+    @param[in]
+        pArg
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnSyncExterns( void *pArg )
+{
+    tzCore *pCore = (tzCore *)pArg;
+    unsigned int overflow;
+
+    EVENT_fnSync( &pCore->events );
+
+    overflow = EVENT_fnOverflow( &pCore->events );
+    if( overflow != pCore->overflow )
+    {
+        /* a lost notification may have been a MODIFIED notification */
+        pCore->overflow = overflow;
+        EXTERNVAR_fnInvalidateAll( &pCore->extVars );
+    }
+}
+
+/*============================================================================*/
+/*  core_fnEnableSignals                                                      */
+/*!
+    Enable the notification signals of a VM instance
+
+    The core_fnEnableSignals function opens the signalfd of the VM
+    instance, unless its notification signals are routed to it by the
+    host (see CORE_fnSetSignalRouter).
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @retval EOK the notification signals are enabled
+    @retval other the signalfd could not be created
+
+==============================================================================*/
+static int core_fnEnableSignals( tzCore *pCore )
+{
+    return ( pCore->pfnRoute != NULL ) ? EOK
+                                       : EVENT_fnEnableSignals( &pCore->events );
+}
+
+/*============================================================================*/
+/*  core_fnRequested                                                          */
+/*!
+    Route a notification request
+
+    The core_fnRequested function is called by the external variables
+    before each notification is requested from the externals library.
+    It tells the signal router of the VM instance which signal number
+    and id the notification will be sent with.
+
+    @param[in]
+        pArg
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @param[in]
+        request
+            notification request type
+
+==============================================================================*/
+static void core_fnRequested( void *pArg, uint32_t handle, uint32_t request )
+{
+    tzCore *pCore = (tzCore *)pArg;
+    int signum;
+
+    /* each request type is sent with its own signal number, starting
+       with the MODIFIED notification */
+    signum = EVENT_SIG_FIRST + (int)request - EXTERNVAR_NOTIFY_MODIFIED;
+
+    if( ( pCore->pfnRoute != NULL ) &&
+        ( request >= EXTERNVAR_NOTIFY_MODIFIED ) &&
+        ( signum <= EVENT_SIG_LAST ) )
+    {
+        pCore->pfnRoute( pCore->pRouteArg, pCore, signum, handle );
+    }
+}
+
+/*============================================================================*/
+/*  core_fnExternTable                                                        */
+/*!
+    Get or set the external variables of an extern table
+
+    The core_fnExternTable function implements the MGT and MST
+    instructions.  The extern table in core memory at the address in Ra
+    holds Rb entries of three 32-bit words: the handle of an external
+    variable, its value type (0 = integer, 1 = float), and its value.
+    The entries are passed to the externals library EXTERN_BATCH at a
+    time using its batched get or set operation.  Rb receives the result
+    of the operation (0 on success, otherwise an errno value).
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        set
+            true to set the external variables (MST), false to get them (MGT)
+
+==============================================================================*/
+static void core_fnExternTable( tzCore *pCore, bool set )
+{
+    tzExternValue values[EXTERN_BATCH];
+    register uint8_t regs;
+    register uint8_t r1;
+    register uint8_t r2;
+    uint32_t table;
+    uint32_t count;
+    uint32_t addr;
+    uint32_t i;
+    uint32_t j;
+    uint32_t n;
+    int rc;
+    int result = EOK;
+
+    regs = MEMORY[PC+3];
+    r1 = (regs & 0xF0) >> 4;
+    r2 = regs & 0x0F;
+    table = (uint32_t)REG[r1];
+    count = (uint32_t)REG[r2];
+
+    if( ( table > CORE_SIZE ) ||
+        ( count > ( CORE_SIZE - table ) / EXTERN_ENTRY_SIZE ) )
+    {
+        printf( "%s R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                set ? "MST" : "MGT",
+                r1,
+                table,
+                PC );
+        STOP;
+        return;
+    }
+
+    for( i = 0; i < count; i += n )
+    {
+        n = ( count - i < EXTERN_BATCH ) ? count - i : EXTERN_BATCH;
+
+        for( j = 0; j < n; j++ )
+        {
+            addr = table + ( i + j ) * EXTERN_ENTRY_SIZE;
+            values[j].handle = core_fnGetStackData( pCore, addr );
+            values[j].type = core_fnGetStackData( pCore, addr + 4 );
+            values[j].val.ul = set ? core_fnGetStackData( pCore, addr + 8 )
+                                   : 0;
+        }
+
+        if( set )
+        {
+            rc = EXTERNVAR_fnSetMany( &pCore->extVars, values, n );
+        }
+        else
+        {
+            rc = EXTERNVAR_fnGetMany( &pCore->extVars, values, n );
+            for( j = 0; j < n; j++ )
+            {
+                addr = table + ( i + j ) * EXTERN_ENTRY_SIZE;
+                core_fnSetStackData( pCore, addr + 8, values[j].val.ul );
+            }
+
+            /* discard any pre-decoded instructions which were overwritten */
+            core_fnInvalidateDecode( pCore,
+                                     table + i * EXTERN_ENTRY_SIZE,
+                                     n * EXTERN_ENTRY_SIZE );
+        }
+
+        if( rc != EOK )
+        {
+            result = rc;
+        }
+    }
+
+    REG[r2] = result;
+
+    INC_PC(4);
+}
+
+/*============================================================================*/
+/*  core_fnBuildImports                                                       */
+/*!
+    Build the import table
+
+    The core_fnBuildImports function replaces the import table of the
+    VM core with the specified block of NUL terminated external variable
+    names.  The VM core takes ownership of the block, and each name in
+    it is assigned the next import slot.  The import slots are not
+    resolved until core_fnResolveImports is called.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pNames
+            pointer to an allocated block of NUL terminated names
+
+    @param[in]
+        len
+            length of the block of names
+
+    @retval EOK the import table was built
+    @retval ENOMEM memory allocation failed
+
+==============================================================================*/
+static int core_fnBuildImports( tzCore *pCore, char *pNames, size_t len )
+{
+    size_t i;
+    size_t n = 0;
+    int result = EOK;
+
+    core_fnFreeImports( pCore );
+
+    for( i = 0; i < len; i++ )
+    {
+        if( pNames[i] == '\0' )
+        {
+            n++;
+        }
+    }
+
+    pCore->pImportNames = pNames;
+    pCore->importNamesLen = len;
+
+    if( n > 0 )
+    {
+        pCore->ppImports = calloc( n, sizeof( char * ) );
+        pCore->pImportHandles = calloc( n, sizeof( uint32_t ) );
+        if( ( pCore->ppImports != NULL ) &&
+            ( pCore->pImportHandles != NULL ) )
+        {
+            for( i = 0; i < len; i += strlen( &pNames[i] ) + 1 )
+            {
+                pCore->ppImports[pCore->numImports++] = &pNames[i];
+            }
+        }
+        else
+        {
+            core_fnFreeImports( pCore );
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  core_fnFreeImports                                                        */
+/*!
+    Release the import table
+
+    The core_fnFreeImports function releases the import table of the
+    VM core.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnFreeImports( tzCore *pCore )
+{
+    free( pCore->pImportNames );
+    free( pCore->ppImports );
+    free( pCore->pImportHandles );
+
+    pCore->pImportNames = NULL;
+    pCore->importNamesLen = 0;
+    pCore->ppImports = NULL;
+    pCore->pImportHandles = NULL;
+    pCore->numImports = 0;
+    pCore->importsResolved = false;
+}
+
+/*============================================================================*/
+/*  core_fnResolveImports                                                     */
+/*!
+    Resolve the import table
+
+    The core_fnResolveImports function looks up the handles of all of
+    the external variables imported by the program with a single call
+    to the external variables library, so the IMP instruction can get
+    a handle from its import slot without a name lookup.  The import
+    table is resolved once an external variables library is initialized.
+    Each external variable which cannot be found is reported on stderr.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @retval EOK the import table is resolved, or will be resolved once
+                an external variables library is initialized
+    @retval ENOENT one or more of the imported variables was not found
+    @retval other result of EXTERNVAR_fnGetHandles
+
+==============================================================================*/
+static int core_fnResolveImports( tzCore *pCore )
+{
+    size_t i;
+    int result = EOK;
+
+    if( ( pCore->numImports > 0 ) &&
+        ( pCore->importsResolved == false ) &&
+        ( pCore->extVars.pAPI != NULL ) )
+    {
+        result = EXTERNVAR_fnGetHandles( &pCore->extVars,
+                                         pCore->ppImports,
+                                         pCore->pImportHandles,
+                                         pCore->numImports );
+        if( result == EOK )
+        {
+            pCore->importsResolved = true;
+        }
+        else if( result == ENOENT )
+        {
+            for( i = 0; i < pCore->numImports; i++ )
+            {
+                if( pCore->pImportHandles[i] == 0 )
+                {
+                    fprintf( stderr,
+                             "Unresolved extern variable: %s\n",
+                             pCore->ppImports[i] );
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  core_fnReadImports                                                        */
+/*!
+    Read the import table of a program image
+
+    The core_fnReadImports function reads the import table which follows
+    the header of a program image, and builds the import table of the
+    VM core from it.  The import table is a list of NUL terminated
+    external variable names terminated by an empty name.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        fp
+            program image positioned at the start of the import table
+
+    @param[in,out]
+        pSize
+            on entry, the number of bytes remaining in the image.  On exit,
+            the number of bytes remaining after the import table
+
+    @retval true the import table was read
+    @retval false the import table is malformed or memory allocation failed
+
+==============================================================================*/
+static bool core_fnReadImports( tzCore *pCore, FILE *fp, size_t *pSize )
+{
+    char *pNames = NULL;
+    char *p;
+    size_t len = 0;
+    size_t size = 0;
+    int c = EOF;
+    bool result = true;
+
+    /* read up to and including the empty name which ends the table */
+    while( ( result == true ) && ( len < *pSize ) &&
+           ( ( c = fgetc( fp ) ) != EOF ) &&
+           ( ( c != '\0' ) || ( ( len > 0 ) && ( pNames[len-1] != '\0' ) ) ) )
+    {
+        if( len == size )
+        {
+            size = ( size == 0 ) ? BUFSIZ : size * 2;
+            p = realloc( pNames, size );
+            if( p != NULL )
+            {
+                pNames = p;
+            }
+            else
+            {
+                result = false;
+            }
+        }
+
+        if( result == true )
+        {
+            pNames[len++] = (char)c;
+        }
+    }
+
+    if( ( result == true ) && ( c == '\0' ) && ( len < *pSize ) )
+    {
+        /* the names and the empty name which ends the table */
+        *pSize -= len + 1;
+        if( len == 0 )
+        {
+            free( pNames );
+            pNames = NULL;
+        }
+
+        result = ( core_fnBuildImports( pCore, pNames, len ) == EOK );
+    }
+    else
+    {
+        free( pNames );
+        result = false;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  core_fnDecodeProgram                                                      */
+/*!
+    Pre-decode the program image
+
+    The core_fnDecodeProgram function allocates the pre-decoded instruction
+    array and the program address map for the program currently loaded
+    into the VM core memory, and decodes the program image by walking
+    it sequentially from address 0.
+
+    Addresses which are not reached by the sequential walk (for example
+    code following inline data) are decoded on demand by the
+    CORE_fnExecute function.
+
+    If the decode tables cannot be allocated, the program will be
+    executed directly from the VM core memory.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnDecodeProgram( tzCore *pCore )
+{
+    int32_t pc;
+    int32_t idx;
+    size_t i;
+
+    if( pCore == NULL )
+    {
+        return;
+    }
+
+    /* discard the decode tables from any previous program */
+    free( pCore->pDecoded );
+    free( pCore->pDecodeMap );
+    pCore->pDecoded = NULL;
+    pCore->pDecodeMap = NULL;
+    pCore->numDecoded = 0;
+    pCore->maxDecoded = 0;
+
+    /* discard the translations from any previous program */
+    if( pCore->pJIT != NULL )
+    {
+        JIT_fnReset( pCore->pJIT, PROGRAM_SIZE );
+    }
+
+    /* a native module must be loaded again for the new program */
+    pCore->nativeStale = true;
+
+    /* the new program must be verified again */
+    pCore->verified = false;
+
+    if( PROGRAM_SIZE == 0 )
+    {
+        return;
+    }
+
+    /* there can never be more instructions than bytes in the program */
+    pCore->pDecoded = calloc( PROGRAM_SIZE, sizeof( tzDecoded ) );
+    pCore->pDecodeMap = malloc( PROGRAM_SIZE * sizeof( int32_t ) );
+    if( ( pCore->pDecoded == NULL ) ||
+        ( pCore->pDecodeMap == NULL ) )
+    {
+        free( pCore->pDecoded );
+        free( pCore->pDecodeMap );
+        pCore->pDecoded = NULL;
+        pCore->pDecodeMap = NULL;
+        return;
+    }
+
+    pCore->maxDecoded = PROGRAM_SIZE;
+
+    for( i = 0; i < PROGRAM_SIZE; i++ )
+    {
+        pCore->pDecodeMap[i] = DECODE_NONE;
+    }
+
+    /* walk the program image */
+    pc = 0;
+    while( (uint32_t)pc < PROGRAM_SIZE )
+    {
+        idx = core_fnDecodeAt( pCore, pc );
+        if( pCore->pDecoded[idx].next > pc )
+        {
+            pc = pCore->pDecoded[idx].next;
+        }
+        else
+        {
+            pc++;
+        }
+    }
+}
+
+/*============================================================================*/
+/*  core_fnDecodeAt                                                           */
+/*!
+    Decode the instruction at the specified program address
+
+    The core_fnDecodeAt function decodes the instruction at the specified
+    program address into the next free entry of the pre-decoded
+    instruction array, and updates the program address map to refer
+    to it.
+
+    If the pre-decoded instruction array is full (which can only happen
+    after instructions have been invalidated by writes into the program
+    image), all decoded instructions are discarded and decoding starts
+    again from an empty array.
+
+    The decode tables must have been allocated by core_fnDecodeProgram,
+    and the program address must be inside the program image.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pc
+            address of the instruction to decode
+
+    @retval index of the decoded instruction
+
+==============================================================================*/
+static int32_t core_fnDecodeAt( tzCore *pCore, int32_t pc )
+{
+    int32_t idx;
+    size_t i;
+
+    if( pCore->numDecoded >= pCore->maxDecoded )
+    {
+        /* start again with an empty decode cache */
+        for( i = 0; i < PROGRAM_SIZE; i++ )
+        {
+            pCore->pDecodeMap[i] = DECODE_NONE;
+        }
+
+        pCore->numDecoded = 0;
+    }
+
+    idx = (int32_t)pCore->numDecoded++;
+    core_fnDecode( pCore, pc, &pCore->pDecoded[idx] );
+    pCore->pDecodeMap[pc] = idx;
+
+    return idx;
+}
+
+/*============================================================================*/
+/*  core_fnDecode                                                             */
+/*!
+    Decode a single instruction
+
+    The core_fnDecode function extracts the registers, immediate operand
+    and the address of the next instruction from the instruction at the
+    specified program address, and selects the function used to execute
+    it.
+
+    The decoding mirrors exactly how the opXXX functions interpret the
+    instruction bytes.  Instructions which have no pre-decoded
+    implementation, and instructions which would run past the end of the
+    program image, are executed through their opXXX function via decINST.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pc
+            address of the instruction to decode
+
+    @param[out]
+        pInst
+            pointer to the tzDecoded object to populate
+
+==============================================================================*/
+static void core_fnDecode( tzCore *pCore, int32_t pc, tzDecoded *pInst )
+{
+    uint8_t *instr;
+    uint8_t op;
+    uint8_t regs;
+    bool isReg;
+    bool isFloat;
+    size_t len;
+    int32_t val = 0;
+
+    instr = &MEMORY[pc];
+    op = instr[0];
+    regs = instr[1];
+    isReg = ( ( op & MODE_REG ) == MODE_REG );
+    isFloat = ( ( op & FLOAT32 ) == FLOAT32 );
+
+    pInst->pc = pc;
+    pInst->opcode = op;
+    pInst->dst = ( regs >> 4 ) & 0x0F;
+    pInst->src = regs & 0x0F;
+    pInst->imm.val = 0;
+    pInst->exec = decINST;
+
+    len = core_fnInstructionLength( pCore, pc );
+    pInst->next = pc + len;
+
+    if( ( len == 0 ) || ( pc + len > PROGRAM_SIZE ) )
+    {
+        /* let the opXXX function deal with the malformed instruction */
+        pInst->next = pc + 1;
+        return;
+    }
+
+    switch( op & 0x1F )
+    {
+        case HNOP:
+            pInst->exec = decNOP;
+            break;
+
+        case HLOD:
+        case HSTR:
+            if( isReg == false )
+            {
+                /* register in the low nibble, address as a literal */
+                pInst->dst = regs & 0x0F;
+                pInst->src = regs & 0x0F;
+                (void)core_fnDecodeData( pCore, instr, 2, false, &val );
+                pInst->imm.val = val;
+            }
+
+            pInst->exec = ( ( op & 0x1F ) == HLOD ) ? decLOD : decSTR;
+            break;
+
+        case HMOV:
+        case HADD:
+        case HSUB:
+        case HMUL:
+        case HDIV:
+        case HCMP:
+        case HAND:
+        case HOR:
+            if( isReg == false )
+            {
+                /* destination register and a literal value */
+                pInst->dst = regs & 0x0F;
+                (void)core_fnDecodeData( pCore, instr, 2, true, &val );
+                pInst->imm.val = val;
+            }
+
+            switch( op & 0x1F )
+            {
+                case HMOV:
+                    pInst->exec = decMOV;
+                    break;
+
+                case HADD:
+                    pInst->exec = isFloat ? decADDF : decADD;
+                    break;
+
+                case HSUB:
+                    pInst->exec = isFloat ? decSUBF : decSUB;
+                    break;
+
+                case HMUL:
+                    pInst->exec = isFloat ? decMULF : decMUL;
+                    break;
+
+                case HDIV:
+                    pInst->exec = isFloat ? decDIVF : decDIV;
+                    break;
+
+                case HCMP:
+                    pInst->exec = isFloat ? decCMPF : decCMP;
+                    break;
+
+                case HAND:
+                    pInst->exec = decAND;
+                    break;
+
+                case HOR:
+                    pInst->exec = decOR;
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        case HNOT:
+        case HTOF:
+        case HTOI:
+        case HPSH:
+        case HPOP:
+            /* single register operand in the low nibble */
+            pInst->dst = regs & 0x0F;
+            pInst->src = regs & 0x0F;
+
+            switch( op & 0x1F )
+            {
+                case HNOT:
+                    pInst->exec = decNOT;
+                    break;
+
+                case HTOF:
+                    pInst->exec = decTOF;
+                    break;
+
+                case HTOI:
+                    pInst->exec = decTOI;
+                    break;
+
+                case HPSH:
+                    pInst->exec = decPSH;
+                    break;
+
+                default:
+                    pInst->exec = decPOP;
+                    break;
+            }
+            break;
+
+        case HSHR:
+            pInst->dst = regs & 0x0F;
+            pInst->imm.val = instr[2] & 0x1F;
+            pInst->exec = decSHR;
+            break;
+
+        case HJMP:
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            /* the jump target always follows the opcode */
+            (void)core_fnDecodeData( pCore, instr, 1, false, &val );
+            pInst->imm.val = val;
+
+            /* src holds the flag to test, dst is 1 to jump if it is set */
+            switch( op & 0x1F )
+            {
+                case HJZR:
+                    pInst->src = ZFLAG;
+                    pInst->dst = 1;
+                    break;
+
+                case HJNZ:
+                    pInst->src = ZFLAG;
+                    pInst->dst = 0;
+                    break;
+
+                case HJNE:
+                    pInst->src = NFLAG;
+                    pInst->dst = 1;
+                    break;
+
+                case HJPO:
+                    pInst->src = NFLAG;
+                    pInst->dst = 0;
+                    break;
+
+                case HJCA:
+                    pInst->src = CFLAG;
+                    pInst->dst = 1;
+                    break;
+
+                case HJNC:
+                    /* matches the flag tested by opJNC */
+                    pInst->src = ZFLAG;
+                    pInst->dst = 0;
+                    break;
+
+                default:
+                    break;
+            }
+
+            pInst->exec = ( ( op & 0x1F ) == HJMP ) ? decJMP : decJMPIF;
+            break;
+
+        case HCAL:
+            pInst->src = regs & 0x0F;
+            if( isReg == false )
+            {
+                (void)core_fnDecodeData( pCore, instr, 1, false, &val );
+                pInst->imm.val = val;
+            }
+
+            pInst->exec = decCAL;
+            break;
+
+        case HRET:
+            pInst->exec = decRET;
+            break;
+
+        case HHLT:
+            pInst->exec = decHLT;
+            break;
+
+        case HNEXT:
+            if( ( ( instr[1] & 0x1F ) == HNEXT ) &&
+                ( ( ( instr[2] & 0x1F ) == HLDL ) ||
+                  ( ( instr[2] & 0x1F ) == HSTL ) ) )
+            {
+                /* local variable register and frame displacement */
+                pInst->dst = instr[3] & 0x0F;
+                pInst->src = instr[3] & 0x0F;
+                (void)core_fnDecodeData( pCore, &instr[1], 3, true, &val );
+                pInst->imm.val = val;
+                pInst->exec = ( ( instr[2] & 0x1F ) == HLDL ) ? decLDL
+                                                              : decSTL;
+            }
+            else if( ( ( instr[1] & 0x1F ) == HNEXT ) &&
+                     ( ( instr[2] & 0x1F ) >= HBLT ) &&
+                     ( ( instr[2] & 0x1F ) <= HBNE ) )
+            {
+                /* registers to compare and the branch target */
+                pInst->opcode = instr[2];
+                pInst->dst = ( instr[3] >> 4 ) & 0x0F;
+                pInst->src = instr[3] & 0x0F;
+                (void)core_fnDecodeData( pCore, &instr[1], 3, false, &val );
+                pInst->imm.val = val;
+
+                switch( instr[2] & ( 0x1F | FLOAT32 ) )
+                {
+                    case HBLT:
+                        pInst->exec = decBLT;
+                        break;
+
+                    case HBLE:
+                        pInst->exec = decBLE;
+                        break;
+
+                    case HBEQ:
+                        pInst->exec = decBEQ;
+                        break;
+
+                    case HBNE:
+                        pInst->exec = decBNE;
+                        break;
+
+                    default:
+                        pInst->exec = decBCCF;
+                        break;
+                }
+            }
+            else if( ( ( instr[1] & 0x1F ) == HNEXT ) &&
+                     ( ( ( instr[2] & 0x1F ) == HLDX ) ||
+                       ( ( instr[2] & 0x1F ) == HSTX ) ) )
+            {
+                /* data and base registers, index register and scale,
+                   followed by the displacement */
+                pInst->opcode = instr[2];
+                pInst->dst = ( instr[3] >> 4 ) & 0x0F;
+                pInst->src = instr[3] & 0x0F;
+                pInst->index = ( instr[4] >> 4 ) & 0x0F;
+                pInst->scale = INDEX_SCALE( instr[4] );
+                (void)core_fnDecodeData( pCore, &instr[1], 4, true, &val );
+                pInst->imm.val = val;
+                pInst->exec = ( ( instr[2] & 0x1F ) == HLDX ) ? decLDX
+                                                              : decSTX;
+            }
+            break;
+
+        default:
+            /* SHL, EXT, GET, SET and the other extended instructions */
+            break;
+    }
+
+    if( pCore->verified )
+    {
+        if( ( isReg == false ) && ( pInst->exec == decLOD ) )
+        {
+            /* the literal address was checked by CORE_fnVerify */
+            pInst->exec = decLODA;
+        }
+        else if( ( isReg == false ) && ( pInst->exec == decSTR ) )
+        {
+            pInst->exec = decSTRA;
+        }
+        else if( ( pInst->exec == decINST ) ||
+                 ( pInst->exec == decRET ) ||
+                 ( ( isReg == true ) && ( pInst->exec == decCAL ) ) )
+        {
+            /* the destination must be checked at run time */
+            pInst->exec = decINSTV;
+        }
+    }
+}
+
+/*============================================================================*/
+/*  core_fnDecodeData                                                         */
+/*!
+    Decode a literal value from an instruction
+
+    The core_fnDecodeData function reads a literal value from the
+    instruction at the specified offset, in the byte order of the VM core
+    memory.  The size of the literal is encoded in the width flags of the
+    first instruction byte, exactly as read by core_fnGetSignedData and
+    core_fnGetUnsignedData.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        instr
+            pointer to the instruction in the VM core memory
+
+    @param[in]
+        offset
+            offset from the instruction address to the start of the literal
+
+    @param[in]
+        isSigned
+            true if BYTE and WORD literals are to be sign extended
+
+    @param[out]
+        pValue
+            pointer to the location to store the literal value
+
+    @retval size of the literal value in bytes
+
+==============================================================================*/
+static size_t core_fnDecodeData( tzCore *pCore,
+                                 uint8_t *instr,
+                                 uint8_t offset,
+                                 bool isSigned,
+                                 int32_t *pValue )
+{
+    size_t size;
+    uint16_t val16;
+
+    switch( instr[0] & ( BYTE | WORD ) )
+    {
+        case BYTE:
+            *pValue = isSigned ? (int32_t)(int8_t)instr[offset]
+                               : (int32_t)instr[offset];
+            size = 1;
+            break;
+
+        case WORD:
+            if( pCore->nativeEndian )
+            {
+                memcpy( &val16, &instr[offset], sizeof( val16 ) );
+            }
+            else
+            {
+                val16 = (uint16_t)( ( instr[offset] << 8 ) + instr[offset+1] );
+            }
+
+            *pValue = isSigned ? (int32_t)(int16_t)val16 : (int32_t)val16;
+            size = 2;
+            break;
+
+        default:
+            if( pCore->nativeEndian )
+            {
+                memcpy( pValue, &instr[offset], sizeof( int32_t ) );
+            }
+            else
+            {
+                *pValue = (int32_t)( ( (uint32_t)instr[offset] << 24 ) +
+                                     ( instr[offset+1] << 16 ) +
+                                     ( instr[offset+2] << 8 ) +
+                                     ( instr[offset+3] ) );
+            }
+            size = 4;
+            break;
+    }
+
+    return size;
+}
+
+/*============================================================================*/
+/*  core_fnInstructionLength                                                  */
+/*!
+    Get the length of an instruction
+
+    The core_fnInstructionLength function calculates the number of bytes
+    the program counter advances by when the instruction at the specified
+    address is executed without branching.  The calculation follows the
+    INC_PC operations performed by the corresponding opXXX function.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pc
+            address of the instruction
+
+    @retval length of the instruction in bytes
+    @retval 0 illegal instruction
+
+==============================================================================*/
+static size_t core_fnInstructionLength( tzCore *pCore, int32_t pc )
+{
+    uint8_t *instr;
+    uint8_t op;
+    uint8_t op1;
+    size_t size;
+    int32_t val;
+
+    instr = &MEMORY[pc];
+    op = instr[0];
+
+    /* size of a literal value encoded by the width flags */
+    size = core_fnDecodeData( pCore, instr, 0, false, &val );
+
+    switch( op & 0x1F )
+    {
+        case HNOP:
+        case HRET:
+        case HHLT:
+            return 1;
+
+        case HLOD:
+        case HSTR:
+        case HMOV:
+        case HADD:
+        case HSUB:
+        case HMUL:
+        case HDIV:
+        case HAND:
+        case HOR:
+        case HCMP:
+            return ( ( op & MODE_REG ) == MODE_REG ) ? 2 : 2 + size;
+
+        case HNOT:
+        case HTOF:
+        case HTOI:
+        case HPSH:
+        case HPOP:
+        case HEXT:
+        case HGET:
+        case HSET:
+            return 2;
+
+        case HSHR:
+            return 3;
+
+        case HSHL:
+            return 3 + size;
+
+        case HJMP:
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            return 3;
+
+        case HCAL:
+            return ( ( op & MODE_REG ) == MODE_REG ) ? 2 : 1 + size;
+
+        default:
+            break;
+    }
+
+    /* extended instruction set 1 */
+    op1 = instr[1];
+    switch( op1 & 0x1F )
+    {
+        case HWRN:
+        case HWRF:
+        case HDLY:
+            /* literal width is taken from the HNEXT byte */
+            return ( ( op1 & MODE_REG ) == MODE_REG ) ? 3 : 2 + size;
+
+        case HWRC:
+            return 3;
+
+        case HSCO:
+        case HOFD:
+            return ( ( op1 & MODE_REG ) == MODE_REG ) ? 3 : 4;
+
+        case HNEXT:
+            break;
+
+        default:
+            return 3;
+    }
+
+    /* extended instruction set 2 */
+    switch( instr[2] & 0x1F )
+    {
+        case HMDUMP:
+            return 4 + core_fnDecodeData( pCore, &instr[1], 0, false, &val );
+
+        case HRDUMP:
+        case HTXB:
+            return 3;
+
+        case HLDL:
+        case HSTL:
+            /* displacement width is taken from the second HNEXT byte */
+            return 4 + core_fnDecodeData( pCore, &instr[1], 0, false, &val );
+
+        case HBLT:
+        case HBLE:
+        case HBEQ:
+        case HBNE:
+            /* branch target width is taken from the second HNEXT byte */
+            return 4 + core_fnDecodeData( pCore, &instr[1], 0, false, &val );
+
+        case HIMP:
+            /* import slot width is taken from the second HNEXT byte */
+            return 4 + core_fnDecodeData( pCore, &instr[1], 0, false, &val );
+
+        case HLDX:
+        case HSTX:
+            /* displacement width is taken from the second HNEXT byte */
+            return 5 + core_fnDecodeData( pCore, &instr[1], 0, false, &val );
+
+        case HEVQ:
+        case HDSP:
+        case HMGT:
+        case HMST:
+        case HTXC:
+            return 4;
+
+        case HVEC:
+            return 5;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/*============================================================================*/
+/*  core_fnInvalidateDecode                                                   */
+/*!
+    Invalidate pre-decoded instructions
+
+    The core_fnInvalidateDecode function discards any pre-decoded
+    instructions which overlap the specified range of the VM core
+    memory, so they are decoded again the next time they are executed.
+    It is called whenever the program writes into its own program image.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        addr
+            start address of the modified memory
+
+    @param[in]
+        len
+            length of the modified memory
+
+==============================================================================*/
+static void core_fnInvalidateDecode( tzCore *pCore,
+                                     uint32_t addr,
+                                     size_t len )
+{
+    size_t start;
+    size_t end;
+    size_t i;
+
+    /* the translated code must also see the modified program */
+    JIT_fnInvalidate( pCore->pJIT, addr, len );
+
+    if( addr < PROGRAM_SIZE )
+    {
+        /* the native module no longer matches the program */
+        pCore->nativeStale = true;
+
+        /* the modified program is no longer verified */
+        core_fnLeaveFastPath( pCore );
+    }
+
+    if( ( pCore->pDecodeMap == NULL ) ||
+        ( addr >= PROGRAM_SIZE ) )
+    {
+        return;
+    }
+
+    /* an instruction starting before addr may include the modified bytes */
+    start = ( addr >= MAX_INSTRUCTION_LENGTH - 1 )
+            ? addr - ( MAX_INSTRUCTION_LENGTH - 1 )
+            : 0;
+
+    end = addr + len;
+    if( end > PROGRAM_SIZE )
+    {
+        end = PROGRAM_SIZE;
+    }
+
+    for( i = start; i < end; i++ )
+    {
+        pCore->pDecodeMap[i] = DECODE_NONE;
+    }
+}
+
+/*==============================================================================
+        PROGRAM VERIFICATION
+==============================================================================*/
+
+/*============================================================================*/
+/*  core_fnVerifyInstruction                                                  */
+/*!
+    Verify a single instruction
+
+    The core_fnVerifyInstruction function checks the instruction at the
+    specified program address on behalf of CORE_fnVerify, marks the
+    program bytes it occupies, and queues every instruction which can
+    be executed after it.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pc
+            address of the instruction to verify
+
+    @param[in,out]
+        pMarks
+            pointer to the verifier marks for each program address
+
+    @param[in,out]
+        pWork
+            pointer to the list of instruction addresses waiting to be checked
+
+    @param[in,out]
+        pNumWork
+            pointer to the number of instruction addresses waiting to be checked
+
+    @retval EOK the instruction is valid
+    @retval EINVAL the instruction is invalid
+
+==============================================================================*/
+static int core_fnVerifyInstruction( tzCore *pCore,
+                                     uint32_t pc,
+                                     uint8_t *pMarks,
+                                     uint32_t *pWork,
+                                     size_t *pNumWork )
+{
+    uint8_t *instr;
+    uint8_t op;
+    size_t len;
+    size_t width;
+    size_t i;
+    int32_t val = 0;
+
+    instr = &MEMORY[pc];
+    op = instr[0];
+
+    len = core_fnInstructionLength( pCore, pc );
+    if( len == 0 )
+    {
+        fprintf( stderr, "Illegal instruction 0x%02X @ 0x%X\n", op, pc );
+        return EINVAL;
+    }
+
+    if( pc + len > PROGRAM_SIZE )
+    {
+        fprintf( stderr, "Truncated instruction @ 0x%X\n", pc );
+        return EINVAL;
+    }
+
+    for( i = 1; i < len; i++ )
+    {
+        if( pMarks[pc + i] & ( VERIFY_START | VERIFY_BODY | VERIFY_QUEUED ) )
+        {
+            fprintf( stderr, "Overlapping instruction @ 0x%X\n", pc );
+            return EINVAL;
+        }
+
+        pMarks[pc + i] = VERIFY_BODY;
+    }
+
+    pMarks[pc] = VERIFY_START;
+
+    switch( op & 0x1F )
+    {
+        case HLOD:
+        case HSTR:
+            if( ( op & MODE_REG ) != MODE_REG )
+            {
+                (void)core_fnDecodeData( pCore, instr, 2, false, &val );
+                width = ( op & BYTE ) ? 1 : ( op & WORD ) ? 2 : 4;
+                if( (uint32_t)val > CORE_SIZE - width )
+                {
+                    fprintf( stderr,
+                             "Illegal Address: 0x%X @ 0x%X\n",
+                             (uint32_t)val,
+                             pc );
+                    return EINVAL;
+                }
+            }
+            break;
+
+        case HJMP:
+            (void)core_fnDecodeData( pCore, instr, 1, false, &val );
+            return core_fnVerifyTarget( pCore,
+                                        pc,
+                                        (uint32_t)val,
+                                        pMarks,
+                                        pWork,
+                                        pNumWork );
+
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            (void)core_fnDecodeData( pCore, instr, 1, false, &val );
+            if( core_fnVerifyTarget( pCore,
+                                     pc,
+                                     (uint32_t)val,
+                                     pMarks,
+                                     pWork,
+                                     pNumWork ) != EOK )
+            {
+                return EINVAL;
+            }
+            break;
+
+        case HCAL:
+            if( ( op & MODE_REG ) != MODE_REG )
+            {
+                (void)core_fnDecodeData( pCore, instr, 1, false, &val );
+                if( core_fnVerifyTarget( pCore,
+                                         pc,
+                                         (uint32_t)val,
+                                         pMarks,
+                                         pWork,
+                                         pNumWork ) != EOK )
+                {
+                    return EINVAL;
+                }
+            }
+            break;
+
+        case HRET:
+        case HHLT:
+            /* execution does not continue with the next instruction */
+            return EOK;
+
+        case HNEXT:
+            if( ( ( instr[1] & 0x1F ) == HNEXT ) &&
+                ( ( instr[2] & 0x1F ) >= HBLT ) &&
+                ( ( instr[2] & 0x1F ) <= HBNE ) )
+            {
+                /* compare and branch */
+                (void)core_fnDecodeData( pCore, &instr[1], 3, false, &val );
+                if( core_fnVerifyTarget( pCore,
+                                         pc,
+                                         (uint32_t)val,
+                                         pMarks,
+                                         pWork,
+                                         pNumWork ) != EOK )
+                {
+                    return EINVAL;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if( pc + len >= PROGRAM_SIZE )
+    {
+        fprintf( stderr,
+                 "Execution runs past the end of the program @ 0x%X\n",
+                 pc );
+        return EINVAL;
+    }
+
+    return core_fnVerifyTarget( pCore,
+                                pc,
+                                (uint32_t)( pc + len ),
+                                pMarks,
+                                pWork,
+                                pNumWork );
+}
+
+/*============================================================================*/
+/*  core_fnVerifyTarget                                                       */
+/*!
+    Verify the target of a control transfer
+
+    The core_fnVerifyTarget function checks that execution can continue
+    at the specified target address, and queues the instruction at the
+    target address to be checked if it has not been seen before.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pc
+            address of the instruction which transfers control
+
+    @param[in]
+        target
+            address where execution continues
+
+    @param[in,out]
+        pMarks
+            pointer to the verifier marks for each program address
+
+    @param[in,out]
+        pWork
+            pointer to the list of instruction addresses waiting to be checked
+
+    @param[in,out]
+        pNumWork
+            pointer to the number of instruction addresses waiting to be checked
+
+    @retval EOK the target is valid
+    @retval EINVAL the target is invalid
+
+==============================================================================*/
+static int core_fnVerifyTarget( tzCore *pCore,
+                                uint32_t pc,
+                                uint32_t target,
+                                uint8_t *pMarks,
+                                uint32_t *pWork,
+                                size_t *pNumWork )
+{
+    if( target >= PROGRAM_SIZE )
+    {
+        fprintf( stderr, "Illegal target address: 0x%X @ 0x%X\n", target, pc );
+        return EINVAL;
+    }
+
+    if( pMarks[target] & VERIFY_BODY )
+    {
+        fprintf( stderr,
+                 "Target 0x%X is inside an instruction @ 0x%X\n",
+                 target,
+                 pc );
+        return EINVAL;
+    }
+
+    if( ( pMarks[target] & ( VERIFY_START | VERIFY_QUEUED ) ) == 0 )
+    {
+        pMarks[target] = VERIFY_QUEUED;
+        pWork[(*pNumWork)++] = target;
+    }
+
+    return EOK;
+}
+
+/*============================================================================*/
+/*  core_fnExecuteVerified                                                    */
+/*!
+    Execute a verified program
+
+    The core_fnExecuteVerified function executes the pre-decoded program
+    after it has been accepted by CORE_fnVerify.  Every instruction in
+    the decode tables has been verified, so the loop does not check the
+    program counter or decode instructions on demand.
+
+    Instructions which transfer control to a computed address check
+    their destination, and together with writes into the program image
+    leave the fast path via core_fnLeaveFastPath.  The caller then
+    continues execution in the fully checked loop.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnExecuteVerified( tzCore *pCore )
+{
+    tzDecoded *pInst;
+
+    if( ( (uint32_t)PC >= PROGRAM_SIZE ) ||
+        ( pCore->pDecodeMap[PC] == DECODE_NONE ) )
+    {
+        /* execution does not start at a verified instruction */
+        pCore->verified = false;
+        return;
+    }
+
+    pCore->fastPath = true;
+
+    while( ( pCore->running ) && !(pCore->error) )
+    {
+        if( ( pCore->budgeted ) && ( pCore->budget-- == 0 ) )
+        {
+            /* the instruction budget has been used */
+            core_fnPreempt( pCore );
+        }
+        else
+        {
+            pInst = &pCore->pDecoded[pCore->pDecodeMap[PC]];
+            pInst->exec( pCore, pInst );
+        }
+    }
+
+    if( pCore->fastPath == false )
+    {
+        /* left the fast path, so continue in the checked loop */
+        pCore->running = true;
+    }
+
+    pCore->fastPath = false;
+}
+
+/*============================================================================*/
+/*  core_fnLeaveFastPath                                                      */
+/*!
+    Leave the verified fast path
+
+    The core_fnLeaveFastPath function is called when execution can no
+    longer rely on the program verification, either because the program
+    image has been modified or because control has been transferred to
+    an address which was not verified.  The program is marked as
+    unverified, and the verified fast path (if it is executing) is
+    stopped so the remainder of the program runs in the checked loop.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnLeaveFastPath( tzCore *pCore )
+{
+    pCore->verified = false;
+
+    if( ( pCore->fastPath ) && ( pCore->running ) )
+    {
+        pCore->fastPath = false;
+        STOP;
+    }
+}
+
+/*==============================================================================
+        CONDITION EVALUATION
+==============================================================================*/
+
+/*============================================================================*/
+/*  core_fnEvalFlags                                                          */
+/*!
+    Evaluate the pending status flags
+
+    Instructions which set all the flags only record their result and the
+    previous value of their destination register.  The core_fnEvalFlags
+    function computes the zero, negative and carry flags from the recorded
+    values when the status register is read by a conditional jump, a
+    register dump, or an execution engine which accesses it directly.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @retval the evaluated status register
+
+==============================================================================*/
+static uint32_t core_fnEvalFlags( tzCore *pCore )
+{
+    int32_t oldvalue = pCore->flagOld;
+    int32_t result = pCore->flagResult;
+
+    ZSET(result);
+    NSET(result);
+    CSET(result);
+
+    pCore->flagsPending = false;
+
+    return STATUS;
+}
+
+/*============================================================================*/
+/*  core_fnCompare                                                            */
+/*!
+    Evaluate the condition of a compare and branch instruction
+
+    The core_fnCompare function compares two register values for the
+    BLT, BLE, BEQ and BNE instructions.  Integer values are compared as
+    signed values, and floating point values are compared as IEEE754
+    single precision values when the FLOAT32 flag is set in the
+    operation byte.  The status flags are not used or modified.
+
+    @param[in]
+        op
+            operation byte of the compare and branch instruction
+
+    @param[in]
+        a
+            value of the first register
+
+    @param[in]
+        b
+            value of the second register
+
+    @retval true the branch is taken
+    @retval false the branch is not taken
+
+==============================================================================*/
+static inline bool core_fnCompare( uint8_t op, int32_t a, int32_t b )
+{
+    float fa;
+    float fb;
+
+    if( ( op & FLOAT32 ) == FLOAT32 )
+    {
+        memcpy( &fa, &a, sizeof( float ) );
+        memcpy( &fb, &b, sizeof( float ) );
+
+        switch( op & 0x1F )
+        {
+            case HBLT:
+                return fa < fb;
+
+            case HBLE:
+                return fa <= fb;
+
+            case HBEQ:
+                return fa == fb;
+
+            default:
+                return fa != fb;
+        }
+    }
+
+    switch( op & 0x1F )
+    {
+        case HBLT:
+            return a < b;
+
+        case HBLE:
+            return a <= b;
+
+        case HBEQ:
+            return a == b;
+
+        default:
+            return a != b;
+    }
+}
+
+#ifdef VMCORE_THREADED
+/*==============================================================================
+        THREADED EXECUTION ENGINE
+==============================================================================*/
+
+/*============================================================================*/
+/*  core_fnExecuteThreaded                                                    */
+/*!
+    Execute a program using threaded dispatch
+
+    The core_fnExecuteThreaded function executes the program loaded into
+    the VM core memory until the virtual machine is stopped.  Each
+    instruction handler jumps directly to the handler of the next
+    instruction through a single label table which flattens the
+    instructions0, instructions1 and instructions2 operation maps.
+
+    The program counter, stack pointer and status flags are held in
+    local variables while the program executes.  They are written back
+    to the core before any instruction which is executed through its
+    opXXX function, and reloaded afterwards.
+
+    The data movement, integer arithmetic, branch, call and stack
+    operations are implemented directly in the engine.  All other
+    operations, including the floating point arithmetic, are executed
+    through their opXXX functions.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnExecuteThreaded( tzCore *pCore )
+{
+    static const void *dispatch[THREADED_TABLE_SIZE] =
+    {
+        /* instruction set 0 */
+        &&t_NOP,  &&t_LOD,  &&t_STR,  &&t_MOV,    // 0x00
+        &&t_ADD,  &&t_SUB,  &&t_MUL,  &&t_DIV,    // 0x04
+        &&t_AND,  &&t_OR,   &&t_NOT,  &&t_SHR,    // 0x08
+        &&t_SHL,  &&t_JMP,  &&t_JZR,  &&t_JNZ,    // 0x0C
+        &&t_JNE,  &&t_JPO,  &&t_JCA,  &&t_JNC,    // 0x10
+        &&t_CAL,  &&t_RET,  &&t_CMP,  &&t_TOF,    // 0x14
+        &&t_TOI,  &&t_PSH,  &&t_POP,  &&t_HLT,    // 0x18
+        &&t_EXT,  &&t_GET,  &&t_SET,  &&t_INST1,  // 0x1C
+
+        /* instruction set 1 */
+        &&t_OPS,  &&t_CPS,  &&t_WRS,  &&t_CSB,    // 0x00
+        &&t_ZSB,  &&t_WSB,  &&t_ASS,  &&t_ASB,    // 0x04
+        &&t_ASN,  &&t_ASC,  &&t_ASF,  &&t_RDC,    // 0x08
+        &&t_RDN,  &&t_WRF,  &&t_WRN,  &&t_WRC,    // 0x0C
+        &&t_DLY,  &&t_STM,  &&t_CTM,  &&t_NFY,    // 0x10
+        &&t_WFS,  &&t_EVS,  &&t_EVE,  &&t_SBL,    // 0x14
+        &&t_SBO,  &&t_SCO,  &&t_GCO,  &&t_OFD,    // 0x18
+        &&t_CFD,  &&t_SFD,  &&t_EXE,  &&t_INST2,  // 0x1C
+
+        /* instruction set 2 */
+        &&t_MDUMP,   &&t_RDUMP,   &&t_LDL,     &&t_STL,     // 0x00
+        &&t_BCC,     &&t_BCC,     &&t_BCC,     &&t_BCC,     // 0x04
+        &&t_LDX,     &&t_STX,     &&t_EVQ,     &&t_VEC,     // 0x08
+        &&t_DSP,     &&t_MGT,     &&t_MST,     &&t_TXB,     // 0x0C
+        &&t_TXC,     &&t_IMP,     &&t_ILLEGAL, &&t_ILLEGAL, // 0x10
+        &&t_ILLEGAL, &&t_ILLEGAL, &&t_ILLEGAL, &&t_ILLEGAL, // 0x14
+        &&t_ILLEGAL, &&t_ILLEGAL, &&t_ILLEGAL, &&t_ILLEGAL, // 0x18
+        &&t_ILLEGAL, &&t_ILLEGAL, &&t_ILLEGAL, &&t_ILLEGAL  // 0x1C
+    };
+
+    register int32_t pc;
+    register int32_t sp;
+    register uint32_t status;
+    uint8_t *mem;
+    int32_t *reg;
+    size_t progsize;
+    uint8_t *instr;
+    uint8_t dst;
+    uint32_t addr;
+    uint32_t uval;
+    int32_t val;
+    int32_t oldvalue;
+    int32_t result;
+    size_t n;
+
+    mem = MEMORY;
+    reg = REG;
+    progsize = PROGRAM_SIZE;
+
+    T_RELOAD;
+
+    if( ( pCore->running == false ) || ( pCore->error ) )
+    {
+        return;
+    }
+
+    T_DISPATCH;
+
+t_NOP:
+    T_NEXT(1);
+
+t_LOD:
+    instr = &mem[pc];
+    if( ( instr[0] & MODE_REG ) == MODE_REG )
+    {
+        dst = ( instr[1] >> 4 ) & 0x0F;
+        addr = T_GET( instr[1] & 0x0F );
+        if ( addr > CORE_SIZE )
+        {
+            printf( "LOD R[%d],R[%d]: Illegal Address in R[%d]: 0x%X @ 0x%X\n",
+                    dst,
+                    instr[1] & 0x0F,
+                    instr[1] & 0x0F,
+                    addr,
+                    pc);
+            goto t_stop;
+        }
+
+        n = 2;
+    }
+    else
+    {
+        dst = instr[1] & 0x0F;
+        n = 2 + core_fnDecodeData( pCore, instr, 2, false, &val );
+        addr = val;
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Address: 0x%X @ 0x%p\n", addr, mem);
+            goto t_stop;
+        }
+    }
+
+    /* transfer data from memory to register */
+    val = T_GET( dst );
+    core_fnStoreData( pCore, instr, (uint8_t *)&val, &mem[addr] );
+    T_SET( dst, val );
+    T_NEXT(n);
+
+t_STR:
+    instr = &mem[pc];
+    if( ( instr[0] & MODE_REG ) == MODE_REG )
+    {
+        addr = T_GET( ( instr[1] >> 4 ) & 0x0F );
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Address: 0x%X\n", addr);
+            goto t_stop;
+        }
+
+        n = 2;
+    }
+    else
+    {
+        n = 2 + core_fnDecodeData( pCore, instr, 2, false, &val );
+        addr = val;
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Program Address: 0x%X\n", addr);
+            goto t_stop;
+        }
+    }
+
+    /* store the data in big endian format */
+    val = T_GET( instr[1] & 0x0F );
+    core_fnStoreData( pCore, instr, &mem[addr], (uint8_t *)&val );
+
+    if( addr < progsize )
+    {
+        /* keep the pre-decoded program consistent with the core memory */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+    }
+
+    T_NEXT(n);
+
+t_LDL:
+    /* load a local variable at a displacement from the frame pointer,
+       leaving its address in R2 */
+    instr = &mem[pc];
+    dst = instr[3] & 0x0F;
+    n = 4 + core_fnDecodeData( pCore, &instr[1], 3, true, &val );
+    addr = (uint32_t)( reg[1] + val );
+    reg[2] = addr;
+    if ( addr > CORE_SIZE - sizeof( uint32_t ) )
+    {
+        printf( "LDL R[%d],%d: Illegal Address: 0x%X @ 0x%X\n",
+                dst,
+                val,
+                addr,
+                pc );
+        goto t_stop;
+    }
+
+    T_SET( dst, core_fnGetStackData( pCore, addr ) );
+    T_NEXT(n);
+
+t_STL:
+    /* store a local variable at a displacement from the frame pointer,
+       leaving its address in R2 */
+    instr = &mem[pc];
+    n = 4 + core_fnDecodeData( pCore, &instr[1], 3, true, &val );
+    addr = (uint32_t)( reg[1] + val );
+    reg[2] = addr;
+    if ( addr > CORE_SIZE - sizeof( uint32_t ) )
+    {
+        printf( "STL R[%d],%d: Illegal Address: 0x%X @ 0x%X\n",
+                instr[3] & 0x0F,
+                val,
+                addr,
+                pc );
+        goto t_stop;
+    }
+
+    core_fnSetStackData( pCore, addr, T_GET( instr[3] & 0x0F ) );
+
+    if( addr < progsize )
+    {
+        /* keep the pre-decoded program consistent with the core memory */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+    }
+
+    T_NEXT(n);
+
+t_LDX:
+    /* load from a base register plus a scaled index register and a
+       displacement, leaving the effective address in R2 */
+    instr = &mem[pc];
+    dst = ( instr[3] >> 4 ) & 0x0F;
+    n = 5 + core_fnDecodeData( pCore, &instr[1], 4, true, &val );
+    addr = (uint32_t)( T_GET( instr[3] & 0x0F ) +
+                       T_GET( ( instr[4] >> 4 ) & 0x0F ) *
+                       INDEX_SCALE( instr[4] ) +
+                       val );
+    reg[2] = addr;
+    if ( addr > CORE_SIZE - DATA_WIDTH( instr[2] ) )
+    {
+        printf( "LDX R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                dst,
+                addr,
+                pc );
+        goto t_stop;
+    }
+
+    val = T_GET( dst );
+    core_fnStoreData( pCore, &instr[2], (uint8_t *)&val, &mem[addr] );
+    T_SET( dst, val );
+    T_NEXT(n);
+
+t_STX:
+    /* store to a base register plus a scaled index register and a
+       displacement, leaving the effective address in R2 */
+    instr = &mem[pc];
+    n = 5 + core_fnDecodeData( pCore, &instr[1], 4, true, &val );
+    addr = (uint32_t)( T_GET( instr[3] & 0x0F ) +
+                       T_GET( ( instr[4] >> 4 ) & 0x0F ) *
+                       INDEX_SCALE( instr[4] ) +
+                       val );
+    reg[2] = addr;
+    if ( addr > CORE_SIZE - DATA_WIDTH( instr[2] ) )
+    {
+        printf( "STX R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                ( instr[3] >> 4 ) & 0x0F,
+                addr,
+                pc );
+        goto t_stop;
+    }
+
+    val = T_GET( ( instr[3] >> 4 ) & 0x0F );
+    core_fnStoreData( pCore, &instr[2], &mem[addr], (uint8_t *)&val );
+
+    if( addr < progsize )
+    {
+        /* keep the pre-decoded program consistent with the core memory */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+    }
+
+    T_NEXT(n);
+
+t_MOV:
+    /* integer and floating point values are moved as 32-bit values */
+    instr = &mem[pc];
+    if( ( instr[0] & MODE_REG ) == MODE_REG )
+    {
+        dst = ( instr[1] >> 4 ) & 0x0F;
+        val = T_GET( instr[1] & 0x0F );
+        n = 2;
+    }
+    else
+    {
+        dst = instr[1] & 0x0F;
+        n = 2 + core_fnDecodeData( pCore, instr, 2, true, &val );
+    }
+
+    T_SET( dst, val );
+    T_NEXT(n);
+
+t_ADD:
+    if( ( mem[pc] & FLOAT32 ) == FLOAT32 )
+    {
+        T_CALL( opADD );
+    }
+
+    goto t_ALU;
+
+t_SUB:
+    if( ( mem[pc] & FLOAT32 ) == FLOAT32 )
+    {
+        T_CALL( opSUB );
+    }
+
+    goto t_ALU;
+
+t_MUL:
+    if( ( mem[pc] & FLOAT32 ) == FLOAT32 )
+    {
+        T_CALL( opMUL );
+    }
+
+    goto t_ALU;
+
+t_DIV:
+    if( ( mem[pc] & FLOAT32 ) == FLOAT32 )
+    {
+        T_CALL( opDIV );
+    }
+
+    goto t_ALU;
+
+t_CMP:
+    if( ( mem[pc] & FLOAT32 ) == FLOAT32 )
+    {
+        T_CALL( opCMP );
+    }
+
+    goto t_ALU;
+
+t_AND:
+t_OR:
+t_ALU:
+    /* integer operation between two registers or a register and a literal */
+    instr = &mem[pc];
+    if( ( instr[0] & MODE_REG ) == MODE_REG )
+    {
+        dst = ( instr[1] >> 4 ) & 0x0F;
+        val = T_GET( instr[1] & 0x0F );
+        n = 2;
+    }
+    else
+    {
+        dst = instr[1] & 0x0F;
+        n = 2 + core_fnDecodeData( pCore, instr, 2, true, &val );
+    }
+
+    oldvalue = T_GET( dst );
+
+    switch( instr[0] & 0x1F )
+    {
+        case HADD:
+            result = oldvalue + val;
+            break;
+
+        case HSUB:
+        case HCMP:
+            result = oldvalue - val;
+            break;
+
+        case HMUL:
+            result = oldvalue * val;
+            break;
+
+        case HDIV:
+            result = oldvalue / val;
+            break;
+
+        case HAND:
+            result = oldvalue & val;
+            break;
+
+        default:
+            result = oldvalue | val;
+            break;
+    }
+
+    T_SETFLAGS( result );
+
+    if( ( instr[0] & 0x1F ) != HCMP )
+    {
+        T_SET( dst, result );
+    }
+
+    T_NEXT(n);
+
+t_NOT:
+    dst = mem[pc+1] & 0x0F;
+    T_SET( dst, ~T_GET( dst ) );
+    T_NEXT(2);
+
+t_SHR:
+    /* shift data as unsigned type so the sign bit is not preserved */
+    dst = mem[pc+1] & 0x0F;
+    uval = T_GET( dst );
+    if ( mem[pc] & BYTE_MASK )
+    {
+        /*  byte operation */
+        uval &= 0xFF;
+    }
+    else if ( mem[pc] & WORD_MASK )
+    {
+        /* word operation */
+        uval &= 0xFFFF;
+    }
+
+    uval >>= ( mem[pc+2] & 0x1F );
+    T_SET( dst, uval );
+    T_NEXT(3);
+
+t_JMP:
+    T_BRANCH( true );
+
+t_JZR:
+    T_BRANCH( status & ZFLAG );
+
+t_JNZ:
+    T_BRANCH( !( status & ZFLAG ) );
+
+t_JNE:
+    T_BRANCH( status & NFLAG );
+
+t_JPO:
+    T_BRANCH( !( status & NFLAG ) );
+
+t_JCA:
+    T_BRANCH( status & CFLAG );
+
+t_JNC:
+    /* matches the flag tested by opJNC */
+    T_BRANCH( !( status & ZFLAG ) );
+
+t_BCC:
+    /* compare two registers and branch.  The branch target width is
+       taken from the second HNEXT byte */
+    instr = &mem[pc];
+    n = 4 + core_fnDecodeData( pCore, &instr[1], 3, false, &val );
+    if( core_fnCompare( instr[2],
+                        T_GET( ( instr[3] >> 4 ) & 0x0F ),
+                        T_GET( instr[3] & 0x0F ) ) )
+    {
+        pc = val;
+        T_JUMP;
+    }
+
+    T_NEXT(n);
+
+t_CAL:
+    instr = &mem[pc];
+    if( ( instr[0] & MODE_REG ) == MODE_REG )
+    {
+        addr = T_GET( instr[1] & 0x0F );
+        n = 2;
+    }
+    else
+    {
+        n = 1 + core_fnDecodeData( pCore, instr, 1, false, &val );
+        addr = val;
+    }
+
+    sp -= sizeof( uint32_t );
+    if ( sp < ( CORE_SIZE - STACK_SIZE ) )
+    {
+        printf("Stack Overflow\n");
+        goto t_stop;
+    }
+
+    /* set return address */
+    core_fnSetStackData( pCore, sp, pc + n );
+
+    /* set CALL target */
+    pc = addr;
+
+    /* increment the call depth */
+    pCore->call_depth++;
+
+    /* set the new call depth level on the string buffers */
+    STRINGBUFFER_fnSetLevel( &pCore->strbufs, pCore->call_depth );
+
+    T_JUMP;
+
+t_RET:
+    pc = core_fnGetStackData( pCore, sp ); /* get return address */
+    sp += sizeof(uint32_t);
+
+    /* free any string buffers at this level */
+    STRINGBUFFER_fnFree( &pCore->strbufs, pCore->call_depth );
+
+    if( pCore->call_depth )
+    {
+        pCore->call_depth--;
+    }
+
+    if( sp > CORE_SIZE )
+    {
+        printf("Stack Underflow\n");
+        goto t_stop;
+    }
+
+    T_JUMP;
+
+t_PSH:
+    sp -= sizeof( uint32_t );
+    if ( sp < ( CORE_SIZE - STACK_SIZE ))
+    {
+        printf("Stack Overflow\n");
+        goto t_stop;
+    }
+
+    core_fnSetStackData( pCore, sp, T_GET( mem[pc+1] & 0x0F ) );
+    T_NEXT(2);
+
+t_POP:
+    dst = mem[pc+1] & 0x0F;
+    val = core_fnGetStackData( pCore, sp );
+    T_SET( dst, val );    /* pop to register */
+    sp += sizeof(uint32_t);
+    if( sp > CORE_SIZE )
+    {
+        /* stop after the POP, where opPOP leaves the program counter */
+        pc += 2;
+        printf("Stack Underflow\n");
+        goto t_stop;
+    }
+
+    T_NEXT(2);
+
+t_HLT:
+    pc++;
+    if( (size_t)pc > progsize )
+    {
+        printf("Illegal PC address\n");
+    }
+
+    goto t_stop;
+
+t_INST1:
+    goto *dispatch[( HRMAXINST + 1 ) + ( mem[pc+1] & 0x1F )];
+
+t_INST2:
+    goto *dispatch[2 * ( HRMAXINST + 1 ) + ( mem[pc+2] & 0x1F )];
+
+    /* instructions executed through their opXXX functions */
+t_SHL:      T_CALL( opSHL );
+t_TOF:      T_CALL( opTOF );
+t_TOI:      T_CALL( opTOI );
+t_EXT:      T_CALL( opEXT );
+t_GET:      T_CALL( opGET );
+t_SET:      T_CALL( opSET );
+t_OPS:      T_CALL( opOPS );
+t_CPS:      T_CALL( opCPS );
+t_WRS:      T_CALL( opWRS );
+t_CSB:      T_CALL( opCSB );
+t_ZSB:      T_CALL( opZSB );
+t_WSB:      T_CALL( opWSB );
+t_ASS:      T_CALL( opASS );
+t_ASB:      T_CALL( opASB );
+t_ASN:      T_CALL( opASN );
+t_ASC:      T_CALL( opASC );
+t_ASF:      T_CALL( opASF );
+t_RDC:      T_CALL( opRDC );
+t_RDN:      T_CALL( opRDN );
+t_WRF:      T_CALL( opWRF );
+t_WRN:      T_CALL( opWRN );
+t_WRC:      T_CALL( opWRC );
+t_DLY:      T_CALL( opDLY );
+t_STM:      T_CALL( opSTM );
+t_CTM:      T_CALL( opCTM );
+t_NFY:      T_CALL( opNFY );
+t_WFS:      T_CALL( opWFS );
+t_EVS:      T_CALL( opEVS );
+t_EVE:      T_CALL( opEVE );
+t_SBL:      T_CALL( opSBL );
+t_SBO:      T_CALL( opSBO );
+t_SCO:      T_CALL( opSCO );
+t_GCO:      T_CALL( opGCO );
+t_OFD:      T_CALL( opOFD );
+t_CFD:      T_CALL( opCFD );
+t_SFD:      T_CALL( opSFD );
+t_EXE:      T_CALL( opEXE );
+t_MDUMP:    T_CALL( opMDUMP );
+t_RDUMP:    T_CALL( opRDUMP );
+t_EVQ:      T_CALL( opEVQ );
+t_VEC:      T_CALL( opVEC );
+t_DSP:      T_CALL( opDSP );
+t_MGT:      T_CALL( opMGT );
+t_MST:      T_CALL( opMST );
+t_TXB:      T_CALL( opTXB );
+t_TXC:      T_CALL( opTXC );
+t_IMP:      T_CALL( opIMP );
+t_ILLEGAL:  T_CALL( opILLEGAL );
+
+t_stop:
+    STOP;
+
+t_exit:
+    T_SPILL;
+}
+
+#endif
+
+/*==============================================================================
+        JIT AND NATIVE EXECUTION ENGINES
+==============================================================================*/
+
+/*============================================================================*/
+/*  core_fnExecuteJIT                                                         */
+/*!
+    Execute the program using the JIT compiler
+
+    The core_fnExecuteJIT function executes the program loaded into the
+    VM core by running translated x86-64 machine code.  Instructions
+    which cannot be translated are executed one at a time by the
+    interpreter.
+
+    The JIT compiler is created the first time the JIT engine is used.
+    If it cannot be created, this function returns immediately with the
+    VM core still running, and CORE_fnExecute continues executing the
+    program using the pre-decoded program image.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnExecuteJIT( tzCore *pCore )
+{
+    tzJITConfig config;
+
+    /* translated code reads the status register directly */
+    (void)FLAGS;
+
+    if( pCore->pJIT == NULL )
+    {
+        config.pCore = pCore;
+        config.pReg = pCore->registers.reg;
+        config.pStatus = &pCore->status;
+        config.pMemory = MEMORY;
+        config.coreSize = CORE_SIZE;
+        config.programSize = PROGRAM_SIZE;
+        config.pRunning = &pCore->running;
+        config.pError = &pCore->error;
+        config.pNativeEndian = &pCore->nativeEndian;
+        config.pBudgeted = &pCore->budgeted;
+        config.pBudget = &pCore->budget;
+        config.pfnStep = core_fnStepInstruction;
+
+        pCore->pJIT = JIT_fnCreate( &config );
+        if( pCore->pJIT == NULL )
+        {
+            return;
+        }
+    }
+
+    while( ( pCore->running ) && !(pCore->error) )
+    {
+        if( ( pCore->budgeted ) && ( pCore->budget-- == 0 ) )
+        {
+            /* the instruction budget has been used */
+            core_fnPreempt( pCore );
+        }
+        else if( JIT_fnExecute( pCore->pJIT ) != EOK )
+        {
+            /* execute the instruction at the PC in the interpreter */
+            core_fnStepInstruction( pCore );
+        }
+    }
+}
+
+/*============================================================================*/
+/*  core_fnExecuteNative                                                      */
+/*!
+    Execute the program using a native module
+
+    The core_fnExecuteNative function executes the program loaded into the
+    VM core by calling the native module loaded by CORE_fnLoadNative.
+    Addresses the native module does not handle are executed one
+    instruction at a time by the interpreter.
+
+    If the program image is modified while it is running, this function
+    returns with the VM core still running, and CORE_fnExecute continues
+    executing the program using the pre-decoded program image.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnExecuteNative( tzCore *pCore )
+{
+    /* the native module reads the status register directly */
+    (void)FLAGS;
+
+    while( ( pCore->running ) &&
+           !(pCore->error) &&
+           !(pCore->nativeStale) )
+    {
+        if( ( pCore->budgeted ) && ( pCore->budget-- == 0 ) )
+        {
+            /* the instruction budget has been used */
+            core_fnPreempt( pCore );
+        }
+        else if( pCore->pfnNative( &pCore->native ) != 0 )
+        {
+            /* execute the instruction at the PC in the interpreter */
+            core_fnStepInstruction( pCore );
+        }
+    }
+}
+
+/*============================================================================*/
+/*  core_fnStepInstruction                                                    */
+/*!
+    Execute a single instruction in the interpreter
+
+    The core_fnStepInstruction function executes the instruction at the
+    program counter using the interpreter.  It is called from JIT
+    translated code and native modules for instructions which are not
+    translated into machine code.
+
+    @param[in]
+        p
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void core_fnStepInstruction( void *p )
+{
+    tzCore *pCore = (tzCore *)p;
+    uint8_t opcode;
+
+    opcode = MEMORY[PC] & 0x1F;
+    instructions0[opcode].exec(pCore);
+
+    /* translated code reads the status register directly */
+    (void)FLAGS;
+}
+
+/*==============================================================================
+        VM OP CODES
+==============================================================================*/
+
+/*============================================================================*/
+/*  opNOP                                                                     */
+/*!
+    NOP - No Operation
+
+    The opNOP function implements the VM 'NOP' operation.  This takes
+    no action, it only increments the Program Counter
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opNOP(tzCore *pCore)
+{
+    INC_PC(1);
+}
+
+/*============================================================================*/
+/*  opLOD                                                                     */
+/*!
+    LOD - Load a Register
+
+    The opLOD function implements the VM 'LOD' operation.  This loads
+    a register value from another register, or from core memory,
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opLOD(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register uint32_t addr;
+    register uint32_t val;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        addr = REG[src];
+        if ( addr > CORE_SIZE )
+        {
+            printf( "LOD R[%d],R[%d]: Illegal Address in R[%d]: 0x%X @ 0x%X\n",
+                    dst,
+                    src,
+                    src,
+                    addr,
+                    PC);
+            STOP;
+            return;
+        }
+
+        /* transfer data from memory to register */
+        core_fnStoreData( pCore,
+                          &MEMORY[PC],
+                          (uint8_t *)&REG[dst],
+                          &MEMORY[addr] );
+
+        INC_PC(2);
+    }
+    else
+    {
+        dst = MEMORY[PC+1] & 0x0F;
+        addr = core_fnGetUnsignedData( pCore, MEMORY, PC, 2);
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Address: 0x%X @ 0x%p\n", addr, MEMORY);
+            STOP;
+            return;
+        }
+
+        /* transfer data from memory to register */
+        core_fnStoreData( pCore,
+                          &MEMORY[PC],
+                          (uint8_t *)&REG[dst],
+                          &MEMORY[addr] );
+
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opSTR                                                                     */
+/*!
+    STR - Store data from a register to memory
+
+    The opSTR function implements the VM 'STR' operation.  This stores
+    a register value to memory from a register.  The memory location
+    can be specified in a register or as a literal.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSTR(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register uint32_t addr;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* store data from a register to an address specified in a register */
+
+        /* get register containing source address */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+
+        /* get register containing destination address */
+        dst = (( regs >> 4 ) & 0x0F );
+        addr = REG[dst];
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Address: 0x%X\n", addr);
+            STOP;
+            return;
+        }
+
+        /* store the data in big endian format */
+        core_fnStoreData( pCore,
+                          &MEMORY[PC],
+                          &MEMORY[addr],
+                          (uint8_t *)&REG[src] );
+
+        /* discard any pre-decoded instructions which were overwritten */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+
+        INC_PC(2);
+    }
+    else
+    {
+        /* store data from a register to an address specified as a literal */
+
+        /* get source register */
+        src = MEMORY[PC+1] & 0x0F;
+
+        /* get destination address from a literal in memory */
+        addr = core_fnGetUnsignedData( pCore, MEMORY, PC, 2);
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Program Address: 0x%X\n", addr);
+            STOP;
+            return;
+        }
+
+        /* store the data in big endian format */
+        core_fnStoreData( pCore,
+                          &MEMORY[PC],
+                          &MEMORY[addr],
+                          (uint8_t *)&REG[src] );
+
+        /* discard any pre-decoded instructions which were overwritten */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opMOV                                                                     */
+/*!
+    MOV - Move data from register to register or from memory to register
+
+    The opMOV function implements the VM 'MOV' operation.  This moves data
+    from one register to another, or from a memory literal into a register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opMOV(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* move data from one register to another */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] = REGF[src];
+        }
+        else
+        {
+            REG[dst] = REG[src];
+        }
+        INC_PC(2);
+    }
+    else
+    {
+        /* move data from a memory literal to a register */
+        dst = MEMORY[PC+1] & 0x0F;
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] = core_fnGetFloatData( pCore, MEMORY, PC, 2 );
+        }
+        else
+        {
+            REG[dst] = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+        }
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opADD                                                                     */
+/*!
+    ADD - Add data from register to register or from memory to register
+
+    The opADD function implements the VM 'ADD' operation.  This adds data from
+    one register to another or from a memory literal to a register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opADD(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+    register float fvalue;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* add data from one register to another */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] += REGF[src];
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            oldvalue = REG[dst];
+            REG[dst] += REG[src];
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+    else
+    {
+        /* add data from a memory literal to a register */
+        dst = MEMORY[PC+1] & 0x0F;
+
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] += core_fnGetFloatData( pCore, MEMORY, PC, 2 );
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+            oldvalue = REG[dst];
+            REG[dst] += val;
+            SETFLAGS(REG[dst]);
+
+        }
+
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opSUB                                                                     */
+/*!
+    SUB - Subtract data from register to register or from memory to register
+
+    The opSUB function implements the VM 'SUB' operation.  This subtracts data
+    in one register from another or in a memory literal from a register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSUB(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* subtract data in one register from another */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] -= REGF[src];
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            oldvalue = REG[dst];
+            REG[dst] -= REG[src];
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+    else
+    {
+        /* subtract data in memory from a register */
+        dst = MEMORY[PC+1] & 0x0F;
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] -= core_fnGetFloatData( pCore, MEMORY, PC, 2 );
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+            oldvalue = REG[dst];
+            REG[dst] -= val;
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opMUL                                                                     */
+/*!
+    MUL - Multiply data from register to register or from memory to register
+
+    The opMUL function implements the VM 'MUL' operation.  This multiplies data
+    in one register with another, or data in a register with a memory literal.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opMUL(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* multiply data in one register with data in another register */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] *= REGF[src];
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            oldvalue = REG[dst];
+            REG[dst] *= REG[src];
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+    else
+    {
+        /* multiply data in a register with a memory literal */
+        dst = MEMORY[PC+1] & 0x0F;
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] *= core_fnGetFloatData( pCore, MEMORY, PC, 2 );
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+            oldvalue = REG[dst];
+            REG[dst] *= val;
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opDIV                                                                     */
+/*!
+    DIV - Divide data from register to register or from memory to register
+
+    The opDIV function implements the VM 'DIV' operation.  This divides data
+    in one register with another, or data in a register with a memory literal.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opDIV(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* divide data in one register with data in another register */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] /= REGF[src];
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            oldvalue = REG[dst];
+            REG[dst] /= REG[src];
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+    else
+    {
+        /* divide data in one register with data from a memory literal */
+        dst = MEMORY[PC+1] & 0x0F;
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            REGF[dst] /= core_fnGetFloatData( pCore, MEMORY, PC, 2 );
+            SETFFLAGS(REGF[dst]);
+        }
+        else
+        {
+            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+            oldvalue = REG[dst];
+            REG[dst] /= val;
+            SETFLAGS(REG[dst]);
+        }
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opTOF                                                                     */
+/*!
+    TOF - Convert an integer to a float
+
+    The opTOF function implements the VM 'TOF' operation.  This converts
+    register data from a 32-bit signed integer to an IEEE754 floating point
+    value.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opTOF(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t reg;
+
+    regs = MEMORY[PC+1];
+    reg = regs & 0x0F;
+
+    REGF[reg] = (float)REG[reg];
+
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opTOI                                                                     */
+/*!
+    TOI - Convert a float to an integer
+
+    The opTOI function implements the VM 'TOI' operation.  This converts
+    register data from a 32-bit IEEE754 floating point value into a
+    32-bit signed integer value.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opTOI(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t reg;
+    float offset;
+
+    regs = MEMORY[PC+1];
+    reg = regs & 0x0F;
+
+    REG[reg] = (int32_t)REGF[reg];
+
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opAND                                                                     */
+/*!
+    AND - Bitwise AND
+
+    The opAND function implements the VM 'AND' operation.  This performs
+    a bitwise AND between two registers, or between a register and a literal
+    memory value.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opAND(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* perform bitwise AND between source and destination registers */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        oldvalue = REG[dst];
+        REG[dst] &= REG[src];
+        INC_PC(2);
+    }
+    else
+    {
+        /* perform bitwise AND between dest register and memory literal */
+        dst = MEMORY[PC+1] & 0x0F;
+        val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+        oldvalue = REG[dst];
+        REG[dst] &= val;
+        INC_PC(2);
+    }
+
+    SETFLAGS(REG[dst]);
+
+}
+
+/*============================================================================*/
+/*  opOR                                                                      */
+/*!
+    OR - Bitwise OR
+
+    The opOR function implements the VM 'OR' operation.  This performs
+    a bitwise OR between two registers, or between a register and a literal
+    memory value.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opOR(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        /* perform bitwise OR between source and destination registers */
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        oldvalue = REG[dst];
+        REG[dst] |= REG[src];
+        INC_PC(2);
+    }
+    else
+    {
+        /* perform bitwise OR between dest register and memory literal */
+        dst = MEMORY[PC+1] & 0x0F;
+        val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+        oldvalue = REG[dst];
+        REG[dst] |= val;
+        INC_PC(2);
+    }
+
+    SETFLAGS(REG[dst]);
+}
+
+/*============================================================================*/
+/*  opNOT                                                                     */
+/*!
+    NOT - Bitwise Negation
+
+    The opNOT function implements the VM 'NOT' operation.  This performs
+    a bitwise NOT on a register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opNOT(tzCore *pCore)
+{
+    register uint32_t reg;
+
+    reg = MEMORY[PC+1] & 0x0F;
+    REG[reg] = ~REG[reg];
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opSHR                                                                     */
+/*!
+    SHR - Right Shift
+
+    The opSHR function implements the VM 'SHR' operation.  This performs
+    a right shift on a register.  The number of bits to shift is read from
+    an 8-bit memory literal.  The data is shifted as an unsigned type and
+    the sign bit is not preserved.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSHR(tzCore *pCore)
+{
+    register uint32_t reg;
+    register uint32_t shift;
+    register uint32_t val;
+
+    /* shift data as unsigned type so the sign bit is not preserved */
+    reg = MEMORY[PC+1] & 0x0F;
+    shift = MEMORY[PC+2] & 0x1F;
+    val = REG[reg];
+    if ( MEMORY[PC] & BYTE_MASK )
+    {
+        /*  byte operation */
+        val &= 0xFF;
+    }
+    else if ( MEMORY[PC] & WORD_MASK )
+    {
+        /* word operation */
+        val &= 0xFFFF;
+    }
+    val >>= shift;
+    REG[reg] = val;
+    INC_PC(3);
+}
+
+/*============================================================================*/
+/*  opSHL                                                                     */
+/*!
+    SHL - Left Shift
+
+    The opSHL function implements the VM 'SHL' operation.  This performs
+    a left shift on a register.  The number of bits to shift is read from
+    an 8-bit memory literal.  The data is shifted as an unsigned type and
+    the sign bit is not preserved.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSHL(tzCore *pCore)
+{
+    register uint32_t reg;
+    register uint32_t val;
+    register uint32_t shift;
+
+    reg = MEMORY[PC+1] & 0x0F;
+    shift = core_fnGetUnsignedData( pCore, MEMORY, PC, 2);
+    val = REG[reg];
+    if ( MEMORY[PC] & BYTE_MASK )
+    {
+        /*  byte operation */
+        val &= 0xFF;
+    }
+    else if ( MEMORY[PC] & WORD_MASK )
+    {
+        /* word operation */
+        val &= 0xFFFF;
+    }
+    val <<= shift;
+    REG[reg] = val;
+    INC_PC(3);
+}
+
+/*============================================================================*/
+/*  opJMP                                                                     */
+/*!
+    JMP - Jump to Memory Location
+
+    The opJMP function implements the VM 'JMP' operation.  This loads the
+    program counter with the memory literal.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJMP(tzCore *pCore)
+{
+    register uint32_t val;
+
+    val = core_fnGetUnsignedData( pCore, MEMORY, PC, 1);
+    PC = val;
+}
+
+/*============================================================================*/
+/*  opJZR                                                                     */
+/*!
+    JZR - Jump to Memory Location if Z Flag is set
+
+    The opJZR function implements the VM 'JZR' operation.  This loads the
+    program counter with the memory literal if the Z flag is set.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJZR(tzCore *pCore)
+{
+    if (FLAGS & ZFLAG)
+    {
+        opJMP(pCore);
+    }
+    else
+    {
+        INC_PC(3);
+    }
+}
+
+/*============================================================================*/
+/*  opJNZ                                                                     */
+/*!
+    JNZ - Jump to Memory Location if Z Flag is not set
+
+    The opJNZ function implements the VM 'JNZ' operation.  This loads the
+    program counter with the memory literal if the Z flag is not set.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJNZ(tzCore *pCore)
+{
+    if (!(FLAGS & ZFLAG))
+    {
+        opJMP(pCore);
+    }
+    else
+    {
+        INC_PC(3);
+    }
+}
+
+/*============================================================================*/
+/*  opJNE                                                                     */
+/*!
+    JNE - Jump to Memory Location if N Flag is set
+
+    The opJNE function implements the VM 'JNE' operation.  This loads the
+    program counter with the memory literal if the N flag is set.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJNE(tzCore *pCore)
+{
+    if (FLAGS & NFLAG)
+    {
+        opJMP(pCore);
+    }
+    else
+    {
+        INC_PC(3);
+    }
+}
+
+/*============================================================================*/
+/*  opJPO                                                                     */
+/*!
+    JPO - Jump to Memory Location if N Flag is not set
+
+    The opJPO function implements the VM 'JPO' operation.  This loads the
+    program counter with the memory literal if the N flag is not set.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJPO(tzCore *pCore)
+{
+    if (!(FLAGS & NFLAG))
+    {
+        opJMP(pCore);
+    }
+    else
+    {
+        INC_PC(3);
+    }
+}
+
+/*============================================================================*/
+/*  opJCA                                                                     */
+/*!
+    JCA - Jump to Memory Location if C Flag is set
+
+    The opJCA function implements the VM 'JCA' operation.  This loads the
+    program counter with the memory literal if the C flag is set.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJCA(tzCore *pCore)
+{
+    if (FLAGS & CFLAG)
+    {
+        opJMP(pCore);
+    }
+    else
+    {
+        INC_PC(3);
+    }
+}
+
+/*============================================================================*/
+/*  opJNC                                                                     */
+/*!
+    JNC - Jump to Memory Location if C Flag is not set
+
+    The opJNC function implements the VM 'JNC' operation.  This loads the
+    program counter with the memory literal if the C flag is not set.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opJNC(tzCore *pCore)
+{
+    if (!(FLAGS & ZFLAG))
+    {
+        opJMP(pCore);
+    }
+    else
+    {
+        INC_PC(3);
+    }
+}
+
+/*============================================================================*/
+/*  opCAL                                                                     */
+/*!
+    CAL - Call a subroutine
+
+    The opCAL function implements the VM 'CAL' operation.  This calls a
+    subroutine whose address is specified in a register or as a memory literal.
+    The Program Counter is pushed onto the stack so execution can continue
+    from this point after the subroutine returns. The program counter is
+    loaded with the new subroutine's address.  The call depth and
+    scope levels are updated.
+
+    Stack overflow will terminate the virtual machine
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opCAL(tzCore *pCore)
+{
+    register uint32_t val;
+    register uint32_t dst;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        dst = MEMORY[PC+1] & 0x0F;
+        val = REG[dst];
+        INC_PC(2);
+    }
+    else
+    {
+        val = core_fnGetUnsignedData( pCore, MEMORY, PC, 1);
+        INC_PC(1);
+    }
+
+    core_fnCall( pCore, val );
+}
+
+/*============================================================================*/
+/*  opRET                                                                     */
+/*!
+    RET - Return from a subroutine
+
+    The opRET function implements the VM 'RET' operation.  This updates
+    the scope level and call depth, loads the program counter from the
+    stack and resumes execution from the point the subroutine call was made.
+
+    Stack underflow will terminate the Virtual Machine
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opRET(tzCore *pCore)
+{
+    PC = core_fnGetStackData( pCore, SP ); /* get return address */
+    SP += sizeof(uint32_t);
+    if( SP > CORE_SIZE )
+    {
+        printf("Stack Underflow\n");
+        STOP;
+    }
+
+    /* free any string buffers at this level */
+    STRINGBUFFER_fnFree( &pCore->strbufs, pCore->call_depth );
+
+    if( pCore->call_depth )
+    {
+        pCore->call_depth--;
+    }
+}
+
+/*============================================================================*/
+/*  opCMP                                                                     */
+/*!
+    CMP - Compare two values
+
+    The opCMP function implements the VM 'CMP' operation.  This compares
+    two registers or one register and a memory literal, and updates
+    the VM status flags.
+
+    Stack underflow will terminate the Virtual Machine
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opCMP(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register int32_t val;
+    register int32_t oldvalue;
+    register float fval;
+
+    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    {
+        regs = MEMORY[PC+1];
+        src = regs & 0x0F;
+        dst = (( regs >> 4 ) & 0x0F );
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            fval = REGF[dst] - REGF[src];
+            SETFFLAGS(fval);
+        }
+        else
+        {
+            oldvalue = REG[dst];
+            val = oldvalue - REG[src];
+            SETFLAGS(val);
+        }
+        INC_PC(2);
+    }
+    else
+    {
+        dst = MEMORY[PC+1] & 0x0F;
+        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
+        {
+            fval = REGF[dst] - core_fnGetFloatData( pCore, MEMORY, PC, 2 );
+            SETFFLAGS(fval);
+        }
+        else
+        {
+            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
+            oldvalue = REG[dst];
+            val = oldvalue - val;
+            SETFLAGS(val);
+        }
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opRDN                                                                     */
+/*!
+    RDN - Read a number from a file
+
+    The opRDN function implements the VM 'RDN' operation.  This reads a
+    32-bit integer from the active input file descriptor into a destination
+    register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static  void opRDN(tzCore *pCore)
+{
+    int userNum;
+    register uint8_t dest;
+    FILE *fp;
+
+    ReadNum( &pCore->files, &userNum );
+    dest = MEMORY[PC+2] & 0x0F;
+    REG[dest] = userNum;
+    INC_PC(3);
+}
+
+/*============================================================================*/
+/*  opRDC                                                                     */
+/*!
+    RDC - Read a character from a file
+
+    The opRDC function implements the VM 'RDC' operation.  This reads a
+    character from the active input file descriptor into a destination
+    register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opRDC(tzCore *pCore)
+{
+    char userChar;
+    register uint8_t dest;
+    FILE *fp;
+
+    ReadChar( &pCore->files, &userChar );
+    dest = MEMORY[PC+2] & 0x0F;
+    REG[dest] = userChar;
+    INC_PC(3);
+}
+
+/*============================================================================*/
+/*  opWRN                                                                     */
+/*!
+    WRN - Write a number to a file
+
+    The opWRN function implements the VM 'WRN' operation.  This writes a
+    number from a register or from a memory literal to the file associated
+    with the active output file descriptor.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opWRN(tzCore *pCore)
+{
+    uint32_t src;
+    int32_t val;
+    FILE *fp;
+
+    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
+    {
+        /* write a number from a register */
+        src = MEMORY[PC+2] & 0x0F;
+
+        WriteNum( &pCore->files, REG[src] );
+
+        INC_PC(3);
+    }
+    else
+    {
+        /* write a number from a memory literal */
+        val = core_fnGetSignedData( pCore, MEMORY, PC, 1);
+        WriteNum( &pCore->files, val );
+
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opWRC                                                                     */
+/*!
+    WRC - Write a character to a file
+
+    The opWRC function implements the VM 'WRC' operation.  This writes a
+    character from a register or from a memory literal to the file associated
+    with the active output file descriptor.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opWRC(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register uint32_t val;
+    int idx;
+    FILE *fp;
+    char c;
+
+    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
+    {
+        /* write a character from a register */
+        idx = MEMORY[PC+2] & 0x0F;
+
+        c = (char)(REG[MEMORY[PC+2] & 0x0F] & 0xFF);
+        WriteChar( &pCore->files, c );
+        INC_PC(3);
+    }
+    else
+    {
+        /* write a character from a memory literal */
+        val = core_fnGetSignedData( pCore, MEMORY, PC+1, 1);
+        c =  (char)( val & 0xFF );
+        WriteChar( &pCore->files, c );
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opWRF                                                                     */
+/*!
+    WRF - Write a floating point number to a file
+
+    The opWRF function implements the VM 'WRF' operation.  This writes a
+    32-bit IEEE754 floating point number from a register or from a memory
+    literal to the file associated with the active output file descriptor.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opWRF(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register float val;
+    FILE *fp;
+    int idx;
+
+    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
+    {
+        /* write a float from a register */
+        idx = MEMORY[PC+2] & 0x0F;
+        val = REGF[MEMORY[PC+2] & 0x0F];
+        WriteFloat( &pCore->files, val );
+        INC_PC(3);
+    }
+    else
+    {
+        /* write a float from a memory literal */
+        val = core_fnGetFloatData( pCore, MEMORY, PC+1, 1);
+        WriteFloat( &pCore->files, val );
+        INC_PC(2);
+    }
+}
+
+/*============================================================================*/
+/*  opPSH                                                                     */
+/*!
+    PSH - Push a register value onto the stack
+
+    The opPSH function implements the VM 'PSH' operation.  This pushes
+    a register value onto the stack.
+
+    If a stack overflow occurs, the virtual machine will terminate.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opPSH(tzCore *pCore)
+{
+    uint32_t val;
+
+    SP -= sizeof( uint32_t );
+    if ( SP < ( CORE_SIZE - STACK_SIZE ))
+    {
+        printf("Stack Overflow\n");
+        STOP;
+        return;
+    }
+
+    val = REG[MEMORY[PC+1] & 0x0F];
+    core_fnSetStackData( pCore, SP, val );
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opPOP                                                                     */
+/*!
+    POP - Pop a register value off the stack
+
+    The opPOP function implements the VM 'POP' operation.  This pops a value
+    off the stack and into a register.
+
+    If a stack underflow occurs, the virtual machine will terminate.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opPOP(tzCore *pCore)
+{
+    register uint32_t dst;
+    register uint32_t val;
+
+    val = core_fnGetStackData( pCore, SP );
+    dst = MEMORY[PC+1] & 0x0F;
+    REG[dst] = val;        /* pop to register */
+    SP += sizeof(uint32_t);
+    if( SP > CORE_SIZE )
+    {
+        STOP;
+        printf("Stack Underflow\n");
+    }
+
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opHLT                                                                     */
+/*!
+    HLT - Halt the Virtual Machine
+
+    The opHLT function implements the VM 'HLT' operation.  This terminates
+    the virtual machine.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opHLT(tzCore *pCore)
+{
+    INC_PC(1);
+    STOP;
+}
+
+/*============================================================================*/
+/*  opEXT                                                                     */
+/*!
+    EXT - Get External Variable Handle
+
+    The opEXT function implements the VM 'EXT' operation.  This is a register
+    operation which references the name of an external variable stored in
+    the VM core memory via a register. It then gets the handle to the
+    external variable and stores it in register.
+
+    i.e.
+
+    Rx = Handle( memory[Rx] )
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opEXT(tzCore *pCore)
+{
+    register uint32_t reg;
+    char *name;
+    tzExternVars *pExtVars = NULL;
+
+    if( pCore != NULL )
+    {
+        pExtVars = &pCore->extVars;
+    }
+
+    reg = MEMORY[PC+1] & 0x0F;
+    name = (char *)&MEMORY[REG[reg]];
+
+    REG[reg] = EXTERNVAR_fnGetHandle(pExtVars, name);
+
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opGET                                                                     */
+/*!
+    GET - Get External Variable Value
+
+    The opGET function implements the VM 'GET' operation.  This is a register
+    operation which gets the value of an external variable using a handle
+    specified in the source register, and stores the external variable
+    value into the destination register.
+
+    i.e
+
+    Rd = GetVariable ( Rs )
+
+    In the case the external variable is a string, the destination register
+    references a string buffer which will have the external variable string
+    appended to it.
+
+    i.e
+        StringBuffer(Rd) += GetVariable( Rs )
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opGET(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register uint8_t datatype;
+    tzExternVars *pExtVars = NULL;
+    char *pStr;
+    int stringbufferID;
+
+    if( pCore != NULL )
+    {
+        pExtVars = &pCore->extVars;
+    }
+
+    datatype = MEMORY[PC] & (BYTE | WORD);
+
+    regs = MEMORY[PC+1];
+    src = regs & 0x0F;
+    dst = (( regs >> 4 ) & 0x0F );
+
+    switch( datatype )
+    {
+        case BYTE:
+            pStr = EXTERNVAR_fnGetString( pExtVars, REG[ src ]);
+            stringbufferID = REG[dst];
+            STRINGBUFFER_fnClear( &pCore->strbufs, stringbufferID );
+            STRINGBUFFER_fnAppendString( &pCore->strbufs,
+                                         stringbufferID,
+                                         pStr );
+            break;
+
+        case FLOAT32:
+            REGF[dst] = EXTERNVAR_fnGetFloat( pExtVars, REG[src] );
+            break;
+
+        default:
+            REG[dst] = EXTERNVAR_fnGet( pExtVars, REG[src] );
+            break;
+    }
+
+    INC_PC(2);
+}
+
+/*============================================================================*/
+/*  opSET                                                                     */
+/*!
+    SET - Set External Variable Value
+
+    The opSET function implements the VM 'SET' operation.  This is a register
+    operation which sets the value of an external variable using a handle
+    specified in the destination register from the data referenced
+    by the source register.
+
+    i.e
+
+        SetVariable ( Rd, Rs )
+
+    In the case the external variable is a string, the source register
+    references a string buffer which will contain the string to write.
+
+    i.e
+        SetVariable ( Rd, StringBuffer(Rs) )
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSET(tzCore *pCore)
+{
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    register uint8_t stringbuf_id;
+    uint32_t handle;
+
+    tzExternVars *pExtVars = NULL;
+
+    if( pCore != NULL )
+    {
+        pExtVars = &pCore->extVars;
+    }
+
+    regs = MEMORY[PC+1];
+    src = regs & 0x0F;
+    dst = (( regs >> 4 ) & 0x0F );
+
+    register uint8_t datatype;
+
+    datatype = MEMORY[PC] & (BYTE | WORD);
+    switch( datatype )
+    {
+        case HANDLE:
+        case BYTE:
+            stringbuf_id = REG[src];
+            handle = REG[dst];
+            EXTERNVAR_fnSetString( pExtVars,
+                                   handle,
+                                   STRINGBUFFER_fnGet( &pCore->strbufs,
+                                                       stringbuf_id ) );
+            break;
+
+        case FLOAT32:
+            EXTERNVAR_fnSetFloat( pExtVars,
+                                  REG[dst],
+                                  REGF[src] );
+            break;
+
+        default:
+            EXTERNVAR_fnSet( pExtVars,
+                             REG[dst],
+                             REG[src] );
+            break;
+    }
+
+    INC_PC(2);
+
+}
+
+/*============================================================================*/
+/*  opRDUMP                                                                   */
+/*!
+    RDUMP - Register Dump
+
+    The opRDUMP function will dump the VM core registers using the
+    CORE_fnDumpRegisters utility function.  It will then prompt the operator
+    to continue.  If the operator elects not to continue, the Virtual
+    Machine will be stopped.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opRDUMP(tzCore *pCore)
+{
+    CORE_fnDumpRegisters(pCore, stdout);
+    INC_PC(3);
+}
+
+/*============================================================================*/
+/*  opDLY                                                                     */
+/*!
+    DLY - Delay (millisconds)
+
+    The opDLY function implements the VM 'DLY' operation.  This operation
+    will delay execution by the specified number of milliseconds.  The
+    delay time can be specified in a register, or via a memory literal.
+
+    When the program is run by CORE_fnRun, the program is suspended
+    instead of blocking the calling thread for the delay time.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opDLY(tzCore *pCore)
+{
+    uint32_t src;
+    int32_t val;
+    uint32_t delay_ms;
+
+    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
+    {
+        /* delay time specified in a register */
+        src = MEMORY[PC+2] & 0x0F;
+        delay_ms = REG[src];
+        INC_PC(3);
+    }
+    else
+    {
+        /* delay time specified in a memory literal */
+        val = core_fnGetUnsignedData( pCore, MEMORY, PC, 1);
+        delay_ms = val;
+        INC_PC(2);
+    }
+
+    if( pCore->suspend )
+    {
+        /* suspend the program until the caller of CORE_fnRun has
+           waited for the delay time */
+        pCore->delayMS = delay_ms;
+        pCore->runStatus = eCORE_RUN_BLOCKED_DELAY;
+        STOP;
+    }
+    else
+    {
+        usleep( delay_ms * 1000 );
+    }
+}
+
+/*============================================================================*/
+/*  opMDUMP                                                                   */
+/*!
+    MDUMP - Memory Dump
+
+    The opMDUMP function implements the VM 'MDUMP' operation.  This operation
+    will dump the VM core memory at the address specified in the register
+    with length specified in the following memory literal.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-        INC_PC(2);
-    }
-    else
-    {
-        dst = MEMORY[PC+1] & 0x0F;
-        addr = core_fnGetUnsignedData( pCore, MEMORY, PC, 2);
-        if ( addr > CORE_SIZE )
-        {
-            printf("Illegal Address: 0x%X @ 0x%p\n", addr, MEMORY);
-            STOP;
-            return;
-        }
+==============================================================================*/
+static void opMDUMP( tzCore *pCore )
+{
+    register uint8_t src;
+    register uint32_t addr;
+    register uint32_t len;
 
-        /* transfer data from memory to register */
-        core_fnStoreData( pCore,
-                          &MEMORY[PC],
-                          (uint8_t *)&REG[dst],
-                          &MEMORY[addr] );
+    src = MEMORY[PC+2] & 0x0F;
+    addr = REG[src];
+    len = core_fnGetUnsignedData( pCore, MEMORY, PC+1, 2 );
+    CORE_fnDumpMemory( pCore, addr, len, stdout );
 
-        INC_PC(2);
-    }
+    INC_PC(4);
 }
 
 /*============================================================================*/
-/*  opSTR                                                                     */
+/*  opLDL                                                                     */
 /*!
-    STR - Store data from a register to memory
+    LDL - Load Local variable
 
-    The opSTR function implements the VM 'STR' operation.  This stores
-    a register value to memory from a register.  The memory location
-    can be specified in a register or as a literal.
+    The opLDL function implements the VM 'LDL' operation.  This loads a
+    32-bit value into a register from the core memory at a signed 8-bit or
+    16-bit displacement from the frame pointer (R1).  It is equivalent to
+    the sequence MOV R2,R1 / ADD R2,disp / LOD Rn,R2, and like that
+    sequence it leaves the address of the local variable in R2, but it
+    does not modify the status flags.
+
+    LDL Rn, disp
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opSTR(tzCore *pCore)
+static void opLDL( tzCore *pCore )
 {
-    register uint8_t regs;
-    register uint8_t src;
     register uint8_t dst;
     register uint32_t addr;
+    int32_t disp;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    dst = MEMORY[PC+3] & 0x0F;
+    disp = core_fnGetSignedData( pCore, MEMORY, PC+1, 3 );
+    addr = (uint32_t)( REG[1] + disp );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - sizeof( uint32_t ) )
     {
-        /* store data from a register to an address specified in a register */
+        printf( "LDL R[%d],%d: Illegal Address: 0x%X @ 0x%X\n",
+                dst,
+                disp,
+                addr,
+                PC );
+        STOP;
+        return;
+    }
 
-        /* get register containing source address */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
+    REG[dst] = core_fnGetStackData( pCore, addr );
 
-        /* get register containing destination address */
-        dst = (( regs >> 4 ) & 0x0F );
-        addr = REG[dst];
-        if ( addr > CORE_SIZE )
-        {
-            printf("Illegal Address: 0x%X\n", addr);
-            STOP;
-            return;
-        }
+    INC_PC(4);
+}
 
-        /* store the data in big endian format */
-        core_fnStoreData( pCore,
-                          &MEMORY[PC],
-                          &MEMORY[addr],
-                          (uint8_t *)&REG[src] );
-        INC_PC(2);
-    }
-    else
-    {
-        /* store data from a register to an address specified as a literal */
+/*============================================================================*/
+/*  opSTL                                                                     */
+/*!
+    STL - Store Local variable
 
-        /* get source register */
-        src = MEMORY[PC+1] & 0x0F;
+    The opSTL function implements the VM 'STL' operation.  This stores a
+    register as a 32-bit value into the core memory at a signed 8-bit or
+    16-bit displacement from the frame pointer (R1).  It is equivalent to
+    the sequence MOV R2,R1 / ADD R2,disp / STR R2,Rn, and like that
+    sequence it leaves the address of the local variable in R2, but it
+    does not modify the status flags.
 
-        /* get destination address from a literal in memory */
-        addr = core_fnGetUnsignedData( pCore, MEMORY, PC, 2);
-        if ( addr > CORE_SIZE )
-        {
-            printf("Illegal Program Address: 0x%X\n", addr);
-            STOP;
-            return;
-        }
+    STL Rn, disp
 
-        /* store the data in big endian format */
-        core_fnStoreData( pCore,
-                          &MEMORY[PC],
-                          &MEMORY[addr],
-                          (uint8_t *)&REG[src] );
-        INC_PC(2);
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSTL( tzCore *pCore )
+{
+    register uint8_t src;
+    register uint32_t addr;
+    int32_t disp;
+
+    src = MEMORY[PC+3] & 0x0F;
+    disp = core_fnGetSignedData( pCore, MEMORY, PC+1, 3 );
+    addr = (uint32_t)( REG[1] + disp );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - sizeof( uint32_t ) )
+    {
+        printf( "STL R[%d],%d: Illegal Address: 0x%X @ 0x%X\n",
+                src,
+                disp,
+                addr,
+                PC );
+        STOP;
+        return;
     }
+
+    /* store the data in big endian format */
+    core_fnSetStackData( pCore, addr, REG[src] );
+
+    /* discard any pre-decoded instructions which were overwritten */
+    core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+
+    INC_PC(4);
 }
 
 /*============================================================================*/
-/*  opMOV                                                                     */
+/*  opBCC                                                                     */
 /*!
-    MOV - Move data from register to register or from memory to register
+    BLT, BLE, BEQ, BNE - Compare two registers and branch
 
-    The opMOV function implements the VM 'MOV' operation.  This moves data
-    from one register to another, or from a memory literal into a register.
+    The opBCC function implements the VM 'BLT', 'BLE', 'BEQ' and 'BNE'
+    operations.  These compare two registers and load the program counter
+    with the memory literal if the first register is less than, less than
+    or equal to, equal to, or not equal to the second register.  The
+    floating point variants (BLT.F etc) compare the registers as floating
+    point values.  The status flags are not modified.
+
+    BLT Ra, Rb, addr
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opMOV(tzCore *pCore)
+static void opBCC( tzCore *pCore )
 {
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register int32_t val;
+    int32_t target;
+    size_t n;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    regs = MEMORY[PC+3];
+
+    /* the branch target width is taken from the second HNEXT byte */
+    n = 4 + core_fnDecodeData( pCore, &MEMORY[PC+1], 3, false, &target );
+
+    if( core_fnCompare( MEMORY[PC+2],
+                        REG[( regs >> 4 ) & 0x0F],
+                        REG[regs & 0x0F] ) )
     {
-        /* move data from one register to another */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] = REGF[src];
-        }
-        else
-        {
-            REG[dst] = REG[src];
-        }
-        INC_PC(2);
+        PC = target;
     }
     else
     {
-        /* move data from a memory literal to a register */
-        dst = MEMORY[PC+1] & 0x0F;
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] = core_fnGetFloatData( pCore, MEMORY, PC, 2 );
-        }
-        else
-        {
-            REG[dst] = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-        }
-        INC_PC(2);
+        INC_PC(n);
     }
 }
 
 /*============================================================================*/
-/*  opADD                                                                     */
+/*  opLDX                                                                     */
 /*!
-    ADD - Add data from register to register or from memory to register
+    LDX - Load a register from an indexed memory address
 
-    The opADD function implements the VM 'ADD' operation.  This adds data from
-    one register to another or from a memory literal to a register.
+    The opLDX function implements the indexed form of the VM 'LOD'
+    operation.  This loads a register from the core memory at the
+    address calculated from a base register, plus an index register
+    multiplied by a signed scale, plus a signed 8-bit, 16-bit or
+    32-bit displacement.  A scale of zero selects the base plus displacement
+    form.  Like LDL, the effective address is left in R2 so it can be
+    used by a following STR, and the status flags are not modified.
+
+    LOD Rn, [Rb+Ri*scale+disp]
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opADD(tzCore *pCore)
+static void opLDX( tzCore *pCore )
 {
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
-    register float fvalue;
-
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    register uint8_t index;
+    register uint32_t addr;
+    int32_t disp;
+    size_t n;
+
+    regs = MEMORY[PC+3];
+    index = MEMORY[PC+4];
+
+    /* the displacement width is taken from the second HNEXT byte, and
+       the data width from the opcode byte, so PC is not advanced until
+       the instruction is complete */
+    n = 5 + core_fnDecodeData( pCore, &MEMORY[PC+1], 4, true, &disp );
+    addr = (uint32_t)( REG[regs & 0x0F] +
+                       REG[( index >> 4 ) & 0x0F] * INDEX_SCALE( index ) +
+                       disp );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - DATA_WIDTH( MEMORY[PC+2] ) )
     {
-        /* add data from one register to another */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] += REGF[src];
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            oldvalue = REG[dst];
-            REG[dst] += REG[src];
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
+        printf( "LDX R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                ( regs >> 4 ) & 0x0F,
+                addr,
+                PC );
+        STOP;
+        return;
     }
-    else
+
+    /* transfer data from memory to register */
+    core_fnStoreData( pCore,
+                      &MEMORY[PC+2],
+                      (uint8_t *)&REG[( regs >> 4 ) & 0x0F],
+                      &MEMORY[addr] );
+
+    INC_PC(n);
+}
+
+/*============================================================================*/
+/*  opSTX                                                                     */
+/*!
+    STX - Store a register to an indexed memory address
+
+    The opSTX function implements the indexed form of the VM 'STR'
+    operation.  This stores a register into the core memory at the
+    address calculated from a base register, plus an index register
+    multiplied by a signed scale, plus a signed 8-bit, 16-bit or
+    32-bit displacement.  A scale of zero selects the base plus displacement
+    form.  Like STL, the effective address is left in R2, and the status
+    flags are not modified.
+
+    STR [Rb+Ri*scale+disp], Rn
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opSTX( tzCore *pCore )
+{
+    register uint8_t regs;
+    register uint8_t index;
+    register uint32_t addr;
+    int32_t disp;
+    size_t n;
+
+    regs = MEMORY[PC+3];
+    index = MEMORY[PC+4];
+
+    /* the displacement width is taken from the second HNEXT byte, and
+       the data width from the opcode byte, so PC is not advanced until
+       the instruction is complete */
+    n = 5 + core_fnDecodeData( pCore, &MEMORY[PC+1], 4, true, &disp );
+    addr = (uint32_t)( REG[regs & 0x0F] +
+                       REG[( index >> 4 ) & 0x0F] * INDEX_SCALE( index ) +
+                       disp );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - DATA_WIDTH( MEMORY[PC+2] ) )
     {
-        /* add data from a memory literal to a register */
-        dst = MEMORY[PC+1] & 0x0F;
+        printf( "STX R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                ( regs >> 4 ) & 0x0F,
+                addr,
+                PC );
+        STOP;
+        return;
+    }
 
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] += core_fnGetFloatData( pCore, MEMORY, PC, 2 );
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-            oldvalue = REG[dst];
-            REG[dst] += val;
-            SETFLAGS(REG[dst]);
+    /* store the data in big endian format */
+    core_fnStoreData( pCore,
+                      &MEMORY[PC+2],
+                      &MEMORY[addr],
+                      (uint8_t *)&REG[( regs >> 4 ) & 0x0F] );
 
-        }
+    /* discard any pre-decoded instructions which were overwritten */
+    core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+
+    INC_PC(n);
+}
+
+/*============================================================================*/
+/*  opWRS                                                                     */
+/*!
+    WRS - Write String
+
+    The opWRS function implements the VM 'WRS' operation.  This operation
+    will dump the string in the VM core memory at the address specified
+    in the source register.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opWRS( tzCore *pCore )
+{
+    register uint8_t src;
+    register char *addr;
+    FILE *fp = NULL;
+
+    src = MEMORY[PC+2] & 0x0F;
+
+    addr = (char *)&MEMORY[REG[src]];
+
+    WriteString( &pCore->files, addr );
+
+    INC_PC(3);
+}
+
+/*============================================================================*/
+/*  opCSB                                                                     */
+/*!
+    CSB - Create String Buffer
+
+    The opCSB function implements the VM 'CSB' operation.  This operation
+    will create a string buffer with the id specified in the source register.
+
+    CSB Rs
+    [in] Rs - string buffer identifier
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+==============================================================================*/
+static void opCSB( tzCore *pCore )
+{
+    register uint8_t stringbuf_id;
 
-        INC_PC(2);
-    }
+    stringbuf_id = REG[MEMORY[PC+2] & 0x0F];
+    (void)STRINGBUFFER_fnCreate( &pCore->strbufs, stringbuf_id );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opSUB                                                                     */
+/*  opWSB                                                                     */
 /*!
-    SUB - Subtract data from register to register or from memory to register
+    WSB - Write String Buffer
 
-    The opSUB function implements the VM 'SUB' operation.  This subtracts data
-    in one register from another or in a memory literal from a register.
+    The opWSB function implements the VM 'WSB' operation.  This operation
+    will write the string buffer with the id specified to the standard
+    output.
+
+    WSB Rs
+    [in] Rs - string buffer identifier
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opSUB(tzCore *pCore)
+static void opWSB( tzCore *pCore )
 {
-    register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
+    register uint8_t stringbuf_id;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
-    {
-        /* subtract data in one register from another */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] -= REGF[src];
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            oldvalue = REG[dst];
-            REG[dst] -= REG[src];
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
-    }
-    else
-    {
-        /* subtract data in memory from a register */
-        dst = MEMORY[PC+1] & 0x0F;
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] -= core_fnGetFloatData( pCore, MEMORY, PC, 2 );
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-            oldvalue = REG[dst];
-            REG[dst] -= val;
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
-    }
+    stringbuf_id = REG[MEMORY[PC+2] & 0x0F];
+    STRINGBUFFER_fnWrite( &pCore->strbufs, &pCore->files, stringbuf_id );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opMUL                                                                     */
+/*  opEXE                                                                     */
 /*!
-    MUL - Multiply data from register to register or from memory to register
+    EXE - Execute String Buffer
 
-    The opMUL function implements the VM 'MUL' operation.  This multiplies data
-    in one register with another, or data in a register with a memory literal.
+    The opEXE function implements the VM 'EXE' operation.  This operation
+    will execute the contents of the specified string buffer via a
+    system() call.
+
+    EXE Ra,Rb
+    [in] Rb - string buffer identifier
+    [out] Ra - command result
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opMUL(tzCore *pCore)
+static void opEXE( tzCore *pCore )
 {
+    char *pCmd;
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
+    register uint8_t Ra;
+    register uint8_t Rb;
+    register uint8_t stringbuf_id;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
-    {
-        /* multiply data in one register with data in another register */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] *= REGF[src];
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            oldvalue = REG[dst];
-            REG[dst] *= REG[src];
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
-    }
-    else
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
+
+    stringbuf_id = REG[Rb];
+
+    pCmd = STRINGBUFFER_fnGet( &pCore->strbufs, stringbuf_id);
+    if( pCmd != NULL )
     {
-        /* multiply data in a register with a memory literal */
-        dst = MEMORY[PC+1] & 0x0F;
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] *= core_fnGetFloatData( pCore, MEMORY, PC, 2 );
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-            oldvalue = REG[dst];
-            REG[dst] *= val;
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
+        REG[Ra] = system( pCmd );
     }
+
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opDIV                                                                     */
+/*  opASN                                                                     */
 /*!
-    DIV - Divide data from register to register or from memory to register
+    ASN - Append Number to String Buffer
 
-    The opDIV function implements the VM 'DIV' operation.  This divides data
-    in one register with another, or data in a register with a memory literal.
+    The opASN function implements the VM 'ASN' operation.  This operation
+    will append a number from the source register to the string buffer
+    specified in the destination register.
+
+    ASN Ra,Rb
+    [in] Ra - destination string buffer identifier
+    [in] Rb - number
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opDIV(tzCore *pCore)
+static void opASN( tzCore *pCore )
 {
-    register uint8_t regs;
-    register uint8_t src;
+    register uint8_t stringbuf_id;
     register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
+    register uint8_t src;
+    register uint8_t regs;
+    register int32_t value;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
-    {
-        /* divide data in one register with data in another register */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] /= REGF[src];
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            oldvalue = REG[dst];
-            REG[dst] /= REG[src];
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
-    }
-    else
-    {
-        /* divide data in one register with data from a memory literal */
-        dst = MEMORY[PC+1] & 0x0F;
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            REGF[dst] /= core_fnGetFloatData( pCore, MEMORY, PC, 2 );
-            SETFFLAGS(REGF[dst]);
-        }
-        else
-        {
-            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-            oldvalue = REG[dst];
-            REG[dst] /= val;
-            SETFLAGS(REG[dst]);
-        }
-        INC_PC(2);
-    }
+    regs = MEMORY[PC+2];
+    dst = (regs & 0xF0) >> 4;
+    stringbuf_id = REG[dst];
+    src = regs & 0x0F;
+    value = REG[src];
+    STRINGBUFFER_fnAppendNumber( &pCore->strbufs, stringbuf_id, value );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opTOF                                                                     */
+/*  opASC                                                                     */
 /*!
-    TOF - Convert an integer to a float
+    ASC - Append Character to String Buffer
 
-    The opTOF function implements the VM 'TOF' operation.  This converts
-    register data from a 32-bit signed integer to an IEEE754 floating point
-    value.
+    The opASC function implements the VM 'ASC' operation.  This operation
+    will append a character from the source register to the string buffer
+    specified in the destination register.
+
+    ASC Ra,Rb
+    [in] Ra - destination string buffer identifier
+    [in] Rb - character
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opTOF(tzCore *pCore)
+static void opASC( tzCore *pCore )
 {
+    register uint8_t stringbuf_id;
+    register uint8_t dst;
+    register uint8_t src;
     register uint8_t regs;
-    register uint8_t reg;
-
-    regs = MEMORY[PC+1];
-    reg = regs & 0x0F;
-
-    REGF[reg] = (float)REG[reg];
+    register int32_t value;
 
-    INC_PC(2);
+    regs = MEMORY[PC+2];
+    dst = (regs & 0xF0) >> 4;
+    stringbuf_id = REG[dst];
+    src = regs & 0x0F;
+    value = REG[src];
+    STRINGBUFFER_fnAppendChar( &pCore->strbufs, stringbuf_id, value );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opTOI                                                                     */
+/*  opASS                                                                     */
 /*!
-    TOI - Convert a float to an integer
+    ASS - Append String to String Buffer
 
-    The opTOI function implements the VM 'TOI' operation.  This converts
-    register data from a 32-bit IEEE754 floating point value into a
-    32-bit signed integer value.
+    The opASS function implements the VM 'ASS' operation.  This operation
+    will append a string in memory pointed to by the source register to
+    to the string buffer specified in the destination register.
+
+    ASS Ra,Rb
+    [in] Ra - destination string buffer identifier
+    [in] Rb - pointer to source string in memory
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opTOI(tzCore *pCore)
+static void opASS( tzCore *pCore )
 {
+    register uint8_t stringbuf_id;
+    register uint8_t dst;
+    register uint8_t src;
     register uint8_t regs;
-    register uint8_t reg;
-    float offset;
-
-    regs = MEMORY[PC+1];
-    reg = regs & 0x0F;
-
-    REG[reg] = (int32_t)REGF[reg];
+    register char *value;
 
-    INC_PC(2);
+    regs = MEMORY[PC+2];
+    dst = (regs & 0xF0) >> 4;
+    stringbuf_id = REG[dst];
+    src = regs & 0x0F;
+    value = (char *)&MEMORY[REG[src]];
+    STRINGBUFFER_fnAppendString( &pCore->strbufs, stringbuf_id, value );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opAND                                                                     */
+/*  opASB                                                                     */
 /*!
-    AND - Bitwise AND
+    ASB - Append String Buffer to String Buffer
 
-    The opAND function implements the VM 'AND' operation.  This performs
-    a bitwise AND between two registers, or between a register and a literal
-    memory value.
+    The opASB function implements the VM 'ASB' operation.  This operation
+    will append a source string buffer to a destination string buffer.
+
+    ASB Ra,Rb
+    [in] Ra - destination string buffer identifier
+    [in] Rb - source string buffer identifer
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opAND(tzCore *pCore)
+static void opASB( tzCore *pCore )
 {
-    register uint8_t regs;
-    register uint8_t src;
     register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
-
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
-    {
-        /* perform bitwise AND between source and destination registers */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        oldvalue = REG[dst];
-        REG[dst] &= REG[src];
-        INC_PC(2);
-    }
-    else
-    {
-        /* perform bitwise AND between dest register and memory literal */
-        dst = MEMORY[PC+1] & 0x0F;
-        val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-        oldvalue = REG[dst];
-        REG[dst] &= val;
-        INC_PC(2);
-    }
-
-    SETFLAGS(REG[dst]);
+    register uint8_t src;
+    register uint8_t regs;
 
+    regs = MEMORY[PC+2];
+    dst= REG[((regs & 0xF0) >> 4)];
+    src = REG[(regs & 0x0F)];
+    STRINGBUFFER_fnAppendBuffer( &pCore->strbufs, dst, src );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opOR                                                                      */
+/*  opZSB                                                                     */
 /*!
-    OR - Bitwise OR
+    ZSB - Zero String Buffer
 
-    The opOR function implements the VM 'OR' operation.  This performs
-    a bitwise OR between two registers, or between a register and a literal
-    memory value.
+    The opZSB function implements the VM 'ZSB' operation.  This operation
+    will zero (or clear) the specified string buffer
+
+    ZSB Rs
+    [in] Rs - string buffer id
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opOR(tzCore *pCore)
+static void opZSB( tzCore *pCore )
 {
-    register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
-
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
-    {
-        /* perform bitwise OR between source and destination registers */
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        oldvalue = REG[dst];
-        REG[dst] |= REG[src];
-        INC_PC(2);
-    }
-    else
-    {
-        /* perform bitwise OR between dest register and memory literal */
-        dst = MEMORY[PC+1] & 0x0F;
-        val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-        oldvalue = REG[dst];
-        REG[dst] |= val;
-        INC_PC(2);
-    }
+    register uint8_t stringbuf_id;
 
-    SETFLAGS(REG[dst]);
+    stringbuf_id = REG[MEMORY[PC+2] & 0x0F];
+    STRINGBUFFER_fnClear( &pCore->strbufs, stringbuf_id );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opNOT                                                                     */
+/*  opASF                                                                     */
 /*!
-    NOT - Bitwise Negation
+    ASF - Append Float to String Buffer
 
-    The opNOT function implements the VM 'NOT' operation.  This performs
-    a bitwise NOT on a register.
+    The opASF function implements the VM 'ASF' operation.  This operation
+    will append the floating point value in the source register to the
+    destination string buffer specified by the destination register
+
+    ASF Ra, Rb
+    [in] Ra - destination string buffer identifier
+    [in] Rb - floating point register value
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opNOT(tzCore *pCore)
+static void opASF( tzCore *pCore )
 {
-    register uint32_t reg;
+    register uint8_t stringbuf_id;
+    register uint8_t dst;
+    register uint8_t src;
+    register uint8_t regs;
+    register float value;
 
-    reg = MEMORY[PC+1] & 0x0F;
-    REG[reg] = ~REG[reg];
-    INC_PC(2);
+    regs = MEMORY[PC+2];
+    dst = (regs & 0xF0) >> 4;
+    stringbuf_id = REG[dst];
+    src = regs & 0x0F;
+    value = REGF[src];
+    STRINGBUFFER_fnAppendFloat( &pCore->strbufs, stringbuf_id, value );
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opSHR                                                                     */
+/*  opSTM                                                                     */
 /*!
-    SHR - Right Shift
+    STM - Set Timer
 
-    The opSHR function implements the VM 'SHR' operation.  This performs
-    a right shift on a register.  The number of bits to shift is read from
-    an 8-bit memory literal.  The data is shifted as an unsigned type and
-    the sign bit is not preserved.
+    The opSTM function implements the VM 'STM' operation.  This operation
+    will set up the timer specified in the destination register with the
+    delay specified in the source register.  The timer expires
+    periodically, or only once if the CORE_TIMER_ONESHOT flag is set in
+    the source register.
+
+    STM Rd, Rs
+    [in] Rd - timer identifier
+    [in] Rs - timer delay, optionally with CORE_TIMER_ONESHOT
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opSHR(tzCore *pCore)
+static void opSTM( tzCore *pCore )
 {
-    register uint32_t reg;
-    register uint32_t shift;
-    register uint32_t val;
+    int timer_id;
+    register uint32_t timer_ms;
+    register uint8_t dst;
+    register uint8_t src;
+    register uint8_t regs;
 
-    /* shift data as unsigned type so the sign bit is not preserved */
-    reg = MEMORY[PC+1] & 0x0F;
-    shift = MEMORY[PC+2] & 0x1F;
-    val = REG[reg];
-    if ( MEMORY[PC] & BYTE_MASK )
-    {
-        /*  byte operation */
-        val &= 0xFF;
-    }
-    else if ( MEMORY[PC] & WORD_MASK )
+    regs = MEMORY[PC+2];
+    dst = (regs & 0xF0) >> 4;
+    src = regs & 0x0F;
+    timer_ms = REG[src];
+    timer_id = REG[dst];
+
+    if( EVENT_fnStartTimer( &pCore->events,
+                            timer_id,
+                            timer_ms & CORE_TIMER_INTERVAL,
+                            ( timer_ms & CORE_TIMER_ONESHOT ) == 0 ) != EOK )
     {
-        /* word operation */
-        val &= 0xFFFF;
+        fprintf(stderr, "Illegal timer\n");
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
     }
-    val >>= shift;
-    REG[reg] = val;
+
     INC_PC(3);
+
 }
 
 /*============================================================================*/
-/*  opSHL                                                                     */
+/*  opCTM                                                                     */
 /*!
-    SHL - Left Shift
+    CTM - Clear Timer
 
-    The opSHL function implements the VM 'SHL' operation.  This performs
-    a left shift on a register.  The number of bits to shift is read from
-    an 8-bit memory literal.  The data is shifted as an unsigned type and
-    the sign bit is not preserved.
+    The opCTM function implements the VM 'CTM' operation.  This operation
+    will clear the timer specified in the source register.
+
+    If an invalid timer ID is specified the virtual machine will stop
+    and throw an error.
+
+    CTM Rs
+    [in] Rs - timer delay
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opSHL(tzCore *pCore)
+static void opCTM( tzCore *pCore )
 {
-    register uint32_t reg;
-    register uint32_t val;
-    register uint32_t shift;
+    register uint8_t src;
+    int timer_id;
 
-    reg = MEMORY[PC+1] & 0x0F;
-    shift = core_fnGetUnsignedData( pCore, MEMORY, PC, 2);
-    val = REG[reg];
-    if ( MEMORY[PC] & BYTE_MASK )
+    src = MEMORY[PC+2] & 0x0F;
+    timer_id = REG[src];
+
+    if( EVENT_fnStopTimer( &pCore->events, timer_id ) == EOK )
     {
-        /*  byte operation */
-        val &= 0xFF;
+        printf("deleting timer %d\n", timer_id);
+        INC_PC(3);
     }
-    else if ( MEMORY[PC] & WORD_MASK )
+    else
     {
-        /* word operation */
-        val &= 0xFFFF;
+        fprintf(stderr, "Illegal timer\n");
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
     }
-    val <<= shift;
-    REG[reg] = val;
-    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opJMP                                                                     */
+/*  opNFY                                                                     */
 /*!
-    JMP - Jump to Memory Location
+    NFY - Request Notification
 
-    The opJMP function implements the VM 'JMP' operation.  This loads the
-    program counter with the memory literal.
+    The opNFY function implements the VM 'NFY' operation.  This operation
+    will request an external variable notification for the external
+    variable specified in the destination register, with the request type
+    in the source register.
+
+    NFY Rd, Rs
+    [in] Rd - external variable handle
+    [in] Rs - notification type
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJMP(tzCore *pCore)
+static void opNFY( tzCore *pCore )
 {
-    register uint32_t val;
+    register uint8_t regs;
+    register uint8_t src;
+    register uint8_t dst;
+    uint32_t request;
+    uint32_t handle;
+    int rc;
+
+    tzExternVars *pExtVars = NULL;
+
+    if( pCore != NULL )
+    {
+        pExtVars = &pCore->extVars;
+    }
+
+    regs = MEMORY[PC+2];
+    src = regs & 0x0F;
+    dst = (( regs >> 4 ) & 0x0F );
+
+    handle = REG[dst];
+    request = REG[src];
+
+    /* receive the notification signals before they can be sent */
+    rc = core_fnEnableSignals( pCore );
+    if( rc == EOK )
+    {
+        rc = EXTERNVAR_fnNotify( pExtVars, handle, request );
+    }
 
-    val = core_fnGetUnsignedData( pCore, MEMORY, PC, 1);
-    PC = val;
+    if( rc != 0 )
+    {
+        fprintf( stderr, "Notification Request Failure\n" );
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
+    }
+
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opJZR                                                                     */
+/*  opWFS                                                                     */
 /*!
-    JZR - Jump to Memory Location if Z Flag is set
+    WFS - Wait For Signal
 
-    The opJZR function implements the VM 'JZR' operation.  This loads the
-    program counter with the memory literal if the Z flag is set.
+    The opWFS function implements the VM 'WFS' operation.  This operation
+    will wait for a timer expiration or an external variable notification
+    from the event backend, and store the received signal number in Ra
+    and the signal id in Rb.
+
+    When the program is run by CORE_fnRun and no event is ready, the
+    program is suspended instead of blocking the calling thread.  The
+    registers are set when the program is resumed after an event is
+    received, or when a signal is passed to CORE_fnDeliverSignal.
+
+    WFS Ra, Rb
+    [out] Ra - received signal number
+    [out] Rb - received signal id
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJZR(tzCore *pCore)
+static void opWFS( tzCore *pCore )
 {
-    if (STATUS & ZFLAG)
+    register uint8_t r1;
+    register uint8_t r2;
+    register uint8_t regs;
+    int signum;
+    int id;
+
+    regs = MEMORY[PC+2];
+    r1 = (regs & 0xF0) >> 4;
+    r2 = regs & 0x0F;
+
+    if( EVENT_fnWait( &pCore->events,
+                      !pCore->suspend,
+                      &signum,
+                      &id ) == EOK )
     {
-        opJMP(pCore);
+        REG[r1] = signum;
+        REG[r2] = id;
+
+        INC_PC(3);
+    }
+    else if( pCore->suspend )
+    {
+        /* suspend the program until an event is received */
+        pCore->signalReg[0] = r1;
+        pCore->signalReg[1] = r2;
+        pCore->signalLen = 3;
+        pCore->signalDispatch = false;
+        pCore->runStatus = eCORE_RUN_BLOCKED_SIGNAL;
+        STOP;
     }
     else
     {
-        INC_PC(3);
+        fprintf( stderr, "Wait For Signal Failure\n" );
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
     }
 }
 
 /*============================================================================*/
-/*  opJNZ                                                                     */
+/*  opEVQ                                                                     */
 /*!
-    JNZ - Jump to Memory Location if Z Flag is not set
+    EVQ - Event Queue length
 
-    The opJNZ function implements the VM 'JNZ' operation.  This loads the
-    program counter with the memory literal if the Z flag is not set.
+    The opEVQ function implements the VM 'EVQ' operation.  This operation
+    drains the expired timers and received notifications into the event
+    queue of the VM core without blocking, and stores the number of
+    queued events in Ra.  This many WFS instructions can be executed
+    without waiting, so a handler can receive a burst of notifications
+    and coalesce duplicate events before processing them.
+
+    EVQ Ra
+    [out] Ra - number of queued events
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJNZ(tzCore *pCore)
+static void opEVQ( tzCore *pCore )
 {
-    if (!(STATUS & ZFLAG))
-    {
-        opJMP(pCore);
-    }
-    else
-    {
-        INC_PC(3);
-    }
+    register uint8_t dst;
+
+    dst = MEMORY[PC+3] & 0x0F;
+    REG[dst] = (int32_t)EVENT_fnPending( &pCore->events );
+
+    INC_PC(4);
 }
 
 /*============================================================================*/
-/*  opJNE                                                                     */
+/*  opVEC                                                                     */
 /*!
-    JNE - Jump to Memory Location if N Flag is set
+    VEC - set signal handler Vector
 
-    The opJNE function implements the VM 'JNE' operation.  This loads the
-    program counter with the memory literal if the N flag is set.
+    The opVEC function implements the VM 'VEC' operation.  This operation
+    sets the address in Rc as the handler of the signal number in Ra
+    with the signal id in Rb.  A signal id of 0 sets the handler for
+    every id of the signal number which does not have its own handler,
+    and a handler address of 0 removes the handler.  The handlers are
+    called by the DSP instruction.
+
+    VEC Ra, Rb, Rc
+    [in] Ra - signal number
+    [in] Rb - signal id, or 0 for every id
+    [in] Rc - handler address, or 0 to remove the handler
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJNE(tzCore *pCore)
+static void opVEC( tzCore *pCore )
 {
-    if (STATUS & NFLAG)
+    register uint8_t regs;
+    register uint8_t r1;
+    register uint8_t r2;
+    register uint8_t r3;
+
+    regs = MEMORY[PC+3];
+    r1 = (regs & 0xF0) >> 4;
+    r2 = regs & 0x0F;
+    r3 = MEMORY[PC+4] & 0x0F;
+
+    if( EVENT_fnSetHandler( &pCore->events,
+                            REG[r1],
+                            REG[r2],
+                            (uint32_t)REG[r3] ) == EOK )
     {
-        opJMP(pCore);
+        INC_PC(5);
     }
     else
     {
-        INC_PC(3);
+        fprintf( stderr, "Illegal signal handler\n" );
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
     }
 }
 
 /*============================================================================*/
-/*  opJPO                                                                     */
+/*  opDSP                                                                     */
 /*!
-    JPO - Jump to Memory Location if N Flag is not set
+    DSP - DiSPatch signal
 
-    The opJPO function implements the VM 'JPO' operation.  This loads the
-    program counter with the memory literal if the N flag is not set.
+    The opDSP function implements the VM 'DSP' operation.  This operation
+    waits for a signal in the same way as WFS, stores the received signal
+    number in Ra and the signal id in Rb, and then calls the handler set
+    for the signal by the VEC instruction.  The handler receives the
+    signal number and signal id in Ra and Rb, and returns to the
+    instruction after the DSP using RET.  If the signal has no handler,
+    the program continues after the DSP as it would after a WFS.
+
+    DSP Ra, Rb
+    [out] Ra - received signal number
+    [out] Rb - received signal id
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJPO(tzCore *pCore)
+static void opDSP( tzCore *pCore )
 {
-    if (!(STATUS & NFLAG))
+    register uint8_t r1;
+    register uint8_t r2;
+    register uint8_t regs;
+    int signum;
+    int id;
+
+    regs = MEMORY[PC+3];
+    r1 = (regs & 0xF0) >> 4;
+    r2 = regs & 0x0F;
+
+    if( EVENT_fnWait( &pCore->events,
+                      !pCore->suspend,
+                      &signum,
+                      &id ) == EOK )
     {
-        opJMP(pCore);
+        REG[r1] = signum;
+        REG[r2] = id;
+
+        INC_PC(4);
+        core_fnDispatch( pCore, signum, id );
+    }
+    else if( pCore->suspend )
+    {
+        /* suspend the program until an event is received */
+        pCore->signalReg[0] = r1;
+        pCore->signalReg[1] = r2;
+        pCore->signalLen = 4;
+        pCore->signalDispatch = true;
+        pCore->runStatus = eCORE_RUN_BLOCKED_SIGNAL;
+        STOP;
     }
     else
     {
-        INC_PC(3);
+        fprintf( stderr, "Dispatch Signal Failure\n" );
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
     }
 }
 
 /*============================================================================*/
-/*  opJCA                                                                     */
+/*  opMGT                                                                     */
 /*!
-    JCA - Jump to Memory Location if C Flag is set
+    MGT - Multiple GeT external variables
 
-    The opJCA function implements the VM 'JCA' operation.  This loads the
-    program counter with the memory literal if the C flag is set.
+    The opMGT function implements the VM 'MGT' operation.  This operation
+    gets the values of all of the external variables in an extern table
+    with batched calls to the externals library, so a handler can fetch
+    its whole working set at once instead of using one GET per variable.
+    Each table entry is three 32-bit words: the external variable handle,
+    the value type (0 = integer, 1 = float), and the value, which is
+    written by MGT.
+
+    MGT Ra, Rb
+    [in] Ra - address of the extern table
+    [in] Rb - number of table entries
+    [out] Rb - result: 0 on success, otherwise an errno value
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJCA(tzCore *pCore)
+static void opMGT( tzCore *pCore )
 {
-    if (STATUS & CFLAG)
-    {
-        opJMP(pCore);
-    }
-    else
-    {
-        INC_PC(3);
-    }
+    core_fnExternTable( pCore, false );
 }
 
 /*============================================================================*/
-/*  opJNC                                                                     */
+/*  opMST                                                                     */
 /*!
-    JNC - Jump to Memory Location if C Flag is not set
+    MST - Multiple SeT external variables
 
-    The opJNC function implements the VM 'JNC' operation.  This loads the
-    program counter with the memory literal if the C flag is not set.
+    The opMST function implements the VM 'MST' operation.  This operation
+    sets all of the external variables in an extern table to the values
+    in the table with batched calls to the externals library.  The table
+    has the same layout as for MGT.
+
+    MST Ra, Rb
+    [in] Ra - address of the extern table
+    [in] Rb - number of table entries
+    [out] Rb - result: 0 on success, otherwise an errno value
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opJNC(tzCore *pCore)
+static void opMST( tzCore *pCore )
 {
-    if (!(STATUS & ZFLAG))
-    {
-        opJMP(pCore);
-    }
-    else
-    {
-        INC_PC(3);
-    }
+    core_fnExternTable( pCore, true );
 }
 
 /*============================================================================*/
-/*  opCAL                                                                     */
+/*  opTXB                                                                     */
 /*!
-    CAL - Call a subroutine
+    TXB - Transaction Begin
 
-    The opCAL function implements the VM 'CAL' operation.  This calls a
-    subroutine whose address is specified in a register or as a memory literal.
-    The Program Counter is pushed onto the stack so execution can continue
-    from this point after the subroutine returns. The program counter is
-    loaded with the new subroutine's address.  The call depth and
-    scope levels are updated.
+    The opTXB function implements the VM 'TXB' operation.  This operation
+    opens an external variable transaction.  Until the transaction is
+    committed by TXC, SET instructions only buffer their values, and
+    the last value set for each external variable is sent to the
+    externals library when the transaction is committed.  Transactions
+    may be nested.
 
-    Stack overflow will terminate the virtual machine
+    TXB
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opCAL(tzCore *pCore)
+static void opTXB( tzCore *pCore )
 {
-    register uint32_t val;
-    register uint32_t dst;
+    (void)EXTERNVAR_fnBegin( &pCore->extVars );
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
-    {
-        dst = MEMORY[PC+1] & 0x0F;
-        val = REG[dst];
-        INC_PC(2);
-    }
-    else
-    {
-        val = core_fnGetUnsignedData( pCore, MEMORY, PC, 1);
-        INC_PC(1);
-    }
+    INC_PC(3);
+}
 
-    SP -= sizeof( uint32_t );
-    if ( SP < ( CORE_SIZE - STACK_SIZE ) )
-    {
-        printf("Stack Overflow\n");
-        STOP;
-        return;
-    }
+/*============================================================================*/
+/*  opTXC                                                                     */
+/*!
+    TXC - Transaction Commit
 
-    /* set return address */
-    core_fnSetStackData( pCore, SP, PC );
+    The opTXC function implements the VM 'TXC' operation.  This operation
+    closes the transaction opened by TXB.  Closing the outermost
+    transaction sends the buffered external variable values to the
+    externals library in one batch.
 
-    /* set CALL target */
-    PC = val;
+    TXC Ra
+    [out] Ra - result: 0 on success, otherwise an errno value
 
-    /* increment the call depth */
-    pCore->call_depth++;
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    /* set the new call depth level on the string buffers */
-    STRINGBUFFER_fnSetLevel( pCore->call_depth );
+==============================================================================*/
+static void opTXC( tzCore *pCore )
+{
+    register uint8_t dst;
+
+    dst = MEMORY[PC+3] & 0x0F;
+    REG[dst] = EXTERNVAR_fnCommit( &pCore->extVars );
+
+    INC_PC(4);
 }
 
 /*============================================================================*/
-/*  opRET                                                                     */
+/*  opIMP                                                                     */
 /*!
-    RET - Return from a subroutine
+    IMP - Get Imported External Variable Handle
 
-    The opRET function implements the VM 'RET' operation.  This updates
-    the scope level and call depth, loads the program counter from the
-    stack and resumes execution from the point the subroutine call was made.
+    The opIMP function implements the VM 'IMP' operation.  This operation
+    gets the handle of an external variable from the program import table.
+    The import table is resolved once when the program is loaded, so
+    unlike EXT no name lookup is performed when the instruction executes.
 
-    Stack underflow will terminate the Virtual Machine
+    IMP Ra, slot
+    [out] Ra - handle of the imported external variable
+    [in] slot - import table slot of the external variable
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opRET(tzCore *pCore)
+static void opIMP( tzCore *pCore )
 {
-    PC = core_fnGetStackData( pCore, SP ); /* get return address */
-    SP += sizeof(uint32_t);
-    if( SP > CORE_SIZE )
+    register uint8_t dst;
+    uint32_t slot;
+
+    dst = MEMORY[PC+3] & 0x0F;
+    slot = core_fnGetUnsignedData( pCore, MEMORY, PC+1, 3 );
+
+    if( slot >= pCore->numImports )
     {
-        printf("Stack Underflow\n");
+        printf( "IMP R[%d]: Illegal import slot %u @ 0x%X\n",
+                dst,
+                slot,
+                PC );
         STOP;
+        return;
     }
 
-    /* free any string buffers at this level */
-    STRINGBUFFER_fnFree( pCore->call_depth );
-
-    if( pCore->call_depth )
+    if( pCore->importsResolved == false )
     {
-        pCore->call_depth--;
+        /* the external variables library was not initialized at load */
+        (void)core_fnResolveImports( pCore );
     }
+
+    REG[dst] = pCore->pImportHandles[slot];
+
+    INC_PC(4);
 }
 
 /*============================================================================*/
-/*  opCMP                                                                     */
+/*  opEVS                                                                     */
 /*!
-    CMP - Compare two values
+    EVS - External Validation Start
 
-    The opCMP function implements the VM 'CMP' operation.  This compares
-    two registers or one register and a memory literal, and updates
-    the VM status flags.
+    The opEVS function implements the VM 'EVS' operation.  This operation
+    will start an external variable validation using a received validation
+    notification reference in Rb, and will return the handle of the
+    variable being validated in Ra.
 
-    Stack underflow will terminate the Virtual Machine
+    EVS Ra, Rb
+    [out] Ra - handle of the variable being validated
+    [in] Rb - validation notification reference
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opCMP(tzCore *pCore)
+static void opEVS( tzCore *pCore )
 {
+    register uint8_t Ra;
+    register uint8_t Rb;
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register int32_t val;
-    register int32_t oldvalue;
-    register float fval;
+    tzExternVars *pExtVars = NULL;
+    int rc;
+    uint32_t handle;
+    uint32_t hVar;
 
-    if( ( MEMORY[PC] & MODE_REG ) == MODE_REG )
+    if( pCore != NULL )
     {
-        regs = MEMORY[PC+1];
-        src = regs & 0x0F;
-        dst = (( regs >> 4 ) & 0x0F );
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            fval = REGF[dst] - REGF[src];
-            SETFFLAGS(fval);
-        }
-        else
-        {
-            oldvalue = REG[dst];
-            val = oldvalue - REG[src];
-            SETFLAGS(val);
-        }
-        INC_PC(2);
+        pExtVars = &pCore->extVars;
+    }
+
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
+
+    handle = REG[Rb];
+    rc = EXTERNVAR_fnValidateStart( pExtVars, handle, &hVar );
+    if( rc == 0 )
+    {
+        REG[Ra] = hVar;
     }
     else
     {
-        dst = MEMORY[PC+1] & 0x0F;
-        if(( MEMORY[PC] & FLOAT32 ) == FLOAT32 )
-        {
-            fval = REGF[dst] - core_fnGetFloatData( pCore, MEMORY, PC, 2 );
-            SETFFLAGS(fval);
-        }
-        else
-        {
-            val = core_fnGetSignedData( pCore, MEMORY, PC, 2);
-            oldvalue = REG[dst];
-            val = oldvalue - val;
-            SETFLAGS(val);
-        }
-        INC_PC(2);
+        fprintf( stderr, "Notification Start Failure\n" );
+        CORE_fnDumpRegisters( pCore, stderr );
+        STOP;
     }
+
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opRDN                                                                     */
+/*  opEVE                                                                     */
 /*!
-    RDN - Read a number from a file
+    EVE - External Validation End
 
-    The opRDN function implements the VM 'RDN' operation.  This reads a
-    32-bit integer from the active input file descriptor into a destination
-    register.
+    The opEVE function implements the VM 'EVE' operation.  This operation
+    will end an external variable validation using a received validation
+    notification reference in Rb, and will return the handle of the
+    variable being validated in Ra.
+
+    EVE Ra, Rb
+    [in] Ra - validation notification reference
+    [in] Rb - validation result (0 = ok, or non-zero = errno)
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static  void opRDN(tzCore *pCore)
+static void opEVE( tzCore *pCore )
 {
-    int userNum;
-    register uint8_t dest;
-    FILE *fp;
+    register uint8_t Ra;
+    register uint8_t Rb;
+    register uint8_t regs;
+    tzExternVars *pExtVars = NULL;
+    uint32_t handle;
+    uint32_t response;
+
+    if( pCore != NULL )
+    {
+        pExtVars = &pCore->extVars;
+    }
+
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
+
+    handle = REG[Ra];
+    response = REG[Rb];
+
+    EXTERNVAR_fnValidateEnd( pExtVars, handle, response );
 
-    ReadNum( &userNum );
-    dest = MEMORY[PC+2] & 0x0F;
-    REG[dest] = userNum;
     INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opRDC                                                                     */
+/*  opSBL                                                                     */
 /*!
-    RDC - Read a character from a file
+    SBL - String Buffer Length
 
-    The opRDC function implements the VM 'RDC' operation.  This reads a
-    character from the active input file descriptor into a destination
-    register.
+    The opSBL function implements the VM 'SBL' operation.  This operation
+    will get the length of the string buffer specified in Rb and put the
+    length into Ra.
+
+    SBL Ra, Rb
+    [out] Ra - string buffer length
+    [in] Rb - string buffer id
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opRDC(tzCore *pCore)
+static void opSBL( tzCore *pCore )
 {
-    char userChar;
-    register uint8_t dest;
-    FILE *fp;
+    register uint8_t Ra;
+    register uint8_t Rb;
+    register uint8_t regs;
+    uint32_t stringbuf_id;
+    size_t len;
+
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
+
+    stringbuf_id = REG[Rb];
+
+    len = STRINGBUFFER_fnGetLength( &pCore->strbufs, stringbuf_id );
+
+    REG[Ra] = len;
 
-    ReadChar( &userChar );
-    dest = MEMORY[PC+2] & 0x0F;
-    REG[dest] = userChar;
     INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opWRN                                                                     */
+/*  opSBO                                                                     */
 /*!
-    WRN - Write a number to a file
+    SBO - String Buffer Offset
 
-    The opWRN function implements the VM 'WRN' operation.  This writes a
-    number from a register or from a memory literal to the file associated
-    with the active output file descriptor.
+    The opSBO function implements the VM 'SBO' operation.  This operation
+    will set the read/write offset of the string buffer specified in
+    Ra with the offset specified in Rb.
+
+    SBO Ra, Rb
+    [in] Ra - string buffer id
+    [in] Rb - read/write offset
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opWRN(tzCore *pCore)
+static void opSBO( tzCore *pCore )
 {
-    uint32_t src;
-    int32_t val;
-    FILE *fp;
+    register uint8_t Ra;
+    register uint8_t Rb;
+    register uint8_t regs;
+    uint32_t stringbuf_id;
+    uint32_t offset;
+    size_t len;
+    char c;
 
-    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
-    {
-        /* write a number from a register */
-        src = MEMORY[PC+2] & 0x0F;
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
 
-        WriteNum( REG[src] );
+    stringbuf_id = REG[Ra];
+    offset = REG[Rb];
 
-        INC_PC(3);
-    }
-    else
-    {
-        /* write a number from a memory literal */
-        val = core_fnGetSignedData( pCore, MEMORY, PC, 1);
-        WriteNum( val );
+    STRINGBUFFER_fnSetRWOffset( &pCore->strbufs, stringbuf_id, offset );
 
-        INC_PC(2);
-    }
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opWRC                                                                     */
+/*  opGCO                                                                     */
 /*!
-    WRC - Write a character to a file
+    GCO - Get Character at Offset
 
-    The opWRC function implements the VM 'WRC' operation.  This writes a
-    character from a register or from a memory literal to the file associated
-    with the active output file descriptor.
+    The opGCO function implements the VM 'GCO' operation.  This operation
+    will get the character at the current read/write offset of the string buffer
+    specified in Rb.  The character will be stored in Ra
+
+    GCO Ra, Rb
+    [out] Ra - character at current read/write offset in stringbuffer
+    [in] Rb - string buffer id
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opWRC(tzCore *pCore)
+static void opGCO( tzCore *pCore )
 {
+    register uint8_t Ra;
+    register uint8_t Rb;
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register uint32_t val;
-    int idx;
-    FILE *fp;
+    uint32_t stringbuf_id;
+    uint32_t offset;
+    size_t len;
     char c;
 
-    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
-    {
-        /* write a character from a register */
-        idx = MEMORY[PC+2] & 0x0F;
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
 
-        c = (char)(REG[MEMORY[PC+2] & 0x0F] & 0xFF);
-        WriteChar( c );
-        INC_PC(3);
-    }
-    else
-    {
-        /* write a character from a memory literal */
-        val = core_fnGetSignedData( pCore, MEMORY, PC+1, 1);
-        c =  (char)( val & 0xFF );
-        WriteChar( c );
-        INC_PC(2);
-    }
+    stringbuf_id = REG[Rb];
+
+    c = STRINGBUFFER_fnGetCharAtOffset( &pCore->strbufs, stringbuf_id );
+
+    REG[Ra] = c;
+
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opWRF                                                                     */
+/*  opSCO                                                                     */
 /*!
-    WRF - Write a floating point number to a file
+    SCO - Set Character at Offset
 
-    The opWRF function implements the VM 'WRF' operation.  This writes a
-    32-bit IEEE754 floating point number from a register or from a memory
-    literal to the file associated with the active output file descriptor.
+    The opSCO function implements the VM 'SCO' operation.  This operation
+    will set the character at the current read/write offset of the string buffer
+    specified in Ra with the character specified in Rb or a character literal
+    from the memory core.
+
+    Character from register
+
+    SCO Ra, Rb
+    [in] Ra - string buffer id
+    [in] Rb - character to write
+
+    Literal character from memory core
+
+    SCO Ra, n
+    [in] Ra - string buffer id
+    [in] n - literal character
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opWRF(tzCore *pCore)
+static void opSCO( tzCore *pCore )
 {
+    register uint8_t Ra;
+    register uint8_t Rb;
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register float val;
-    FILE *fp;
-    int idx;
+    uint32_t stringbuf_id;
+    uint32_t offset;
+    size_t len;
+    char c;
 
     if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
     {
-        /* write a float from a register */
-        idx = MEMORY[PC+2] & 0x0F;
-        val = REGF[MEMORY[PC+2] & 0x0F];
-        WriteFloat( val );
-        INC_PC(3);
-    }
-    else
-    {
-        /* write a float from a memory literal */
-        val = core_fnGetFloatData( pCore, MEMORY, PC+1, 1);
-        WriteFloat( val );
-        INC_PC(2);
-    }
-}
-
-/*============================================================================*/
-/*  opPSH                                                                     */
-/*!
-    PSH - Push a register value onto the stack
+        regs = MEMORY[PC+2];
+        Ra = (regs & 0xF0) >> 4;
+        Rb = regs & 0x0F;
 
-    The opPSH function implements the VM 'PSH' operation.  This pushes
-    a register value onto the stack.
+        stringbuf_id = REG[Ra];
 
-    If a stack overflow occurs, the virtual machine will terminate.
+        c = REG[Rb];
 
-    @param[in]
-        pCore
-            pointer to the tzCore object representing the virtual memory core
+        INC_PC( 3 );
+        STRINGBUFFER_fnSetCharAtOffset( &pCore->strbufs, stringbuf_id, c );
+    }
+    else
+    {
+        regs = MEMORY[PC+2];
+        Ra = regs & 0x0F;
 
-==============================================================================*/
-static void opPSH(tzCore *pCore)
-{
-    uint32_t val;
+        stringbuf_id = REG[Ra];
 
-    SP -= sizeof( uint32_t );
-    if ( SP < ( CORE_SIZE - STACK_SIZE ))
-    {
-        printf("Stack Overflow\n");
-        STOP;
-        return;
+        c = MEMORY[PC+3];
+
+        INC_PC(4);
     }
 
-    val = REG[MEMORY[PC+1] & 0x0F];
-    core_fnSetStackData( pCore, SP, val );
-    INC_PC(2);
+    STRINGBUFFER_fnSetCharAtOffset( &pCore->strbufs, stringbuf_id, c );
 }
 
 /*============================================================================*/
-/*  opPOP                                                                     */
+/*  opOFD                                                                     */
 /*!
-    POP - Pop a register value off the stack
+    OFD - Open File Descriptor
 
-    The opPOP function implements the VM 'POP' operation.  This pops a value
-    off the stack and into a register.
+    The opOFD function implements the VM 'OFD' operation.  This operation
+    will open a file and assign a file descriptor. The file can be opened
+    either in read ('r' or 'R') or write ('w' or 'W') mode.
+    Ra specifies a stringbuffer id of a string buffer which contains the name
+    of the file to open. Rb contains the read/write open mode.
+    The read/write mode can also be specified as a character literal.
+    The file descriptor of the open file is written back to Ra.  If the
+    file fails to open then -1 is written back to Ra.
 
-    If a stack underflow occurs, the virtual machine will terminate.
+    Open mode from register
+
+    OFD Ra, Rb
+    [in] Ra - id of string buffer containing file name
+    [in] Rb - open mode: one of 'r', 'w', 'R', or 'W'
+    [out] Ra - file descriptor of open file
+
+    Open mode from literal
+
+    SCO Ra, n
+    [in] Ra - id of string buffer containing file name
+    [in] n - open mode literal character:  one of: 'r', 'R', 'w', 'W'
+    [out] Ra - file descriptor of open file
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opPOP(tzCore *pCore)
+static void opOFD( tzCore *pCore )
 {
-    register uint32_t dst;
-    register uint32_t val;
+    register uint8_t Ra;
+    register uint8_t Rb;
+    register uint8_t regs;
+    uint32_t stringbuf_id;
+    char mode;
+    uint32_t fd;
 
-    val = core_fnGetStackData( pCore, SP );
-    dst = MEMORY[PC+1] & 0x0F;
-    REG[dst] = val;        /* pop to register */
-    SP += sizeof(uint32_t);
-    if( SP > CORE_SIZE )
+    regs = MEMORY[PC+2];
+
+    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
     {
-        STOP;
-        printf("Stack Underflow\n");
-    }
+        Ra = (regs & 0xF0) >> 4;
+        Rb = regs & 0x0F;
 
-    INC_PC(2);
-}
+        stringbuf_id = REG[Ra];
+        mode = REG[Rb];
+        INC_PC(3);
 
-/*============================================================================*/
-/*  opHLT                                                                     */
-/*!
-    HLT - Halt the Virtual Machine
+    }
+    else
+    {
+        Ra = regs & 0x0F;
 
-    The opHLT function implements the VM 'HLT' operation.  This terminates
-    the virtual machine.
+        stringbuf_id = REG[Ra];
 
-    @param[in]
-        pCore
-            pointer to the tzCore object representing the virtual memory core
+        mode = MEMORY[PC+3];
 
-==============================================================================*/
-static void opHLT(tzCore *pCore)
-{
-    INC_PC(1);
-    STOP;
+        INC_PC(4);
+    }
+
+    if( OpenFileDescriptor( &pCore->files,
+                            STRINGBUFFER_fnGet( &pCore->strbufs,
+                                                stringbuf_id ),
+                            mode,
+                            &fd ) == EOK )
+    {
+        REG[Ra] = fd;
+    }
+    else
+    {
+        REG[Ra] = -1;
+    }
 }
 
 /*============================================================================*/
-/*  opEXT                                                                     */
+/*  opCFD                                                                     */
 /*!
-    EXT - Get External Variable Handle
-
-    The opEXT function implements the VM 'EXT' operation.  This is a register
-    operation which references the name of an external variable stored in
-    the VM core memory via a register. It then gets the handle to the
-    external variable and stores it in register.
+    CFD - Close File Descriptor
 
-    i.e.
+    The opCFD function implements the VM 'CFD' operation.  This operation
+    will close the file with the file descriptor specified in Ra.
 
-    Rx = Handle( memory[Rx] )
+    CFD Ra,
+    [in] Ra - file descriptor of open file
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opEXT(tzCore *pCore)
+static void opCFD( tzCore *pCore )
 {
-    register uint32_t reg;
-    char *name;
-    void *pExt = NULL;
-
-    if( pCore != NULL )
-    {
-        pExt = pCore->pExt;
-    }
+    register uint8_t src;
+    uint32_t fd;
 
-    reg = MEMORY[PC+1] & 0x0F;
-    name = (char *)&MEMORY[REG[reg]];
+    src = MEMORY[PC+2] & 0x0F;
+    fd = REG[src];
 
-    REG[reg] = EXTERNVAR_fnGetHandle(pExt, name);
+    INC_PC(3);
 
-    INC_PC(2);
+    CloseFileDescriptor( &pCore->files, fd );
 }
 
 /*============================================================================*/
-/*  opGET                                                                     */
+/*  opSFD                                                                     */
 /*!
-    GET - Get External Variable Value
-
-    The opGET function implements the VM 'GET' operation.  This is a register
-    operation which gets the value of an external variable using a handle
-    specified in the source register, and stores the external variable
-    value into the destination register.
-
-    i.e
-
-    Rd = GetVariable ( Rs )
+    SFD - Select File Descriptor
 
-    In the case the external variable is a string, the destination register
-    references a string buffer which will have the external variable string
-    appended to it.
+    The opSFD function implements the VM 'SFD' operation.  This operation
+    will set the active file descriptor used by the I/O operations to the
+    file descriptor specfied in Ra.
 
-    i.e
-        StringBuffer(Rd) += GetVariable( Rs )
+    SFD Ra,
+    [in] Ra - file descriptor of open file
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opGET(tzCore *pCore)
+static void opSFD( tzCore *pCore )
 {
-    register uint8_t regs;
     register uint8_t src;
-    register uint8_t dst;
-    register uint8_t datatype;
-    void *pExt = NULL;
-    char *pStr;
-    int stringbufferID;
-
-    if( pCore != NULL )
-    {
-        pExt = pCore->pExt;
-    }
-
-    datatype = MEMORY[PC] & (BYTE | WORD);
-
-    regs = MEMORY[PC+1];
-    src = regs & 0x0F;
-    dst = (( regs >> 4 ) & 0x0F );
-
-    switch( datatype )
-    {
-        case BYTE:
-            pStr = EXTERNVAR_fnGetString( pExt, REG[ src ]);
-            stringbufferID = REG[dst];
-            STRINGBUFFER_fnClear( stringbufferID );
-            STRINGBUFFER_fnAppendString( stringbufferID, pStr );
-            break;
+    uint32_t fd;
 
-        case FLOAT32:
-            REGF[dst] = EXTERNVAR_fnGetFloat( pExt, REG[src] );
-            break;
+    src = MEMORY[PC+2] & 0x0F;
+    fd = REG[src];
 
-        default:
-            REG[dst] = EXTERNVAR_fnGet( pExt, REG[src] );
-            break;
-    }
+    INC_PC(3);
 
-    INC_PC(2);
+    SetActiveFileDescriptor( &pCore->files, fd );
 }
 
 /*============================================================================*/
-/*  opSET                                                                     */
+/*  opOPS                                                                     */
 /*!
-    SET - Set External Variable Value
-
-    The opSET function implements the VM 'SET' operation.  This is a register
-    operation which sets the value of an external variable using a handle
-    specified in the destination register from the data referenced
-    by the source register.
-
-    i.e
-
-        SetVariable ( Rd, Rs )
+    OPS - Open Print Session
 
-    In the case the external variable is a string, the source register
-    references a string buffer which will contain the string to write.
+    The opOPS function implements the VM 'OPS' operation.  This operation
+    is used to open a print session in response to a PRINT notification.
+    Ra specifies the print notifcation handle (id recevied from WFS)
+    The output file descriptor is returned in Ra, and the external variable
+    handle is returned in Rb
 
-    i.e
-        SetVariable ( Rd, StringBuffer(Rs) )
+    OPS Ra, Rb
+    [in] Ra - print notification handle
+    [out] Ra - output file descriptor
+    [out] Rb - external variable handle
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opSET(tzCore *pCore)
+static void opOPS( tzCore *pCore )
 {
+    register uint8_t Ra;
+    register uint8_t Rb;
     register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    register uint8_t stringbuf_id;
+    tzExternVars *pExtVars = NULL;
     uint32_t handle;
-
-    void *pExt = NULL;
+    uint32_t hVar;
+    FILE *fp;
+    int fd;
 
     if( pCore != NULL )
     {
-        pExt = pCore->pExt;
+        pExtVars = &pCore->extVars;
     }
 
-    regs = MEMORY[PC+1];
-    src = regs & 0x0F;
-    dst = (( regs >> 4 ) & 0x0F );
-
-    register uint8_t datatype;
-
-    datatype = MEMORY[PC] & (BYTE | WORD);
-    switch( datatype )
-    {
-        case HANDLE:
-        case BYTE:
-            stringbuf_id = REG[src];
-            handle = REG[dst];
-            EXTERNVAR_fnSetString( pExt,
-                                   handle,
-                                   STRINGBUFFER_fnGet( stringbuf_id ) );
-
-        case FLOAT32:
-            EXTERNVAR_fnSetFloat( pExt,
-                                  REG[dst],
-                                  REGF[src] );
-            break;
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
 
-        default:
-            EXTERNVAR_fnSet( pExt,
-                             REG[dst],
-                             REG[src] );
-            break;
-    }
+    handle = REG[Ra];
 
-    INC_PC(2);
+    if ( EXTERNVAR_fnOpenPrintSession( pExtVars, handle, &hVar, &fd ) == EOK )
+    {
+        SetExternWriteFileDescriptor( &pCore->files, fd, 'w' );
+        SetActiveFileDescriptor( &pCore->files, fd );
+        REG[Rb] = hVar;
+        REG[Ra] = fd;
+    }
+    else
+    {
+        REG[Ra] = 0;
+        REG[Rb] = 0;
+    }
 
+    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opRDUMP                                                                   */
+/*  opCPS                                                                     */
 /*!
-    RDUMP - Register Dump
+    CPS - Close Print Session
 
-    The opRDUMP function will dump the VM core registers using the
-    CORE_fnDumpRegisters utility function.  It will then prompt the operator
-    to continue.  If the operator elects not to continue, the Virtual
-    Machine will be stopped.
+    The opCPS function implements the VM 'CPS' operation.  This operation
+    is used to close or terminate a print session.
+    Ra specifies the print notifcation handle (id recevied from WFS)
+    Rb specifies the output file descriptor
+
+    CPS Ra, Rb
+    [in] Ra - notification handle
+    [in] Rb - output file descriptor
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opRDUMP(tzCore *pCore)
+static void opCPS( tzCore *pCore )
 {
-    CORE_fnDumpRegisters(pCore, stdout);
+    register uint8_t Ra;
+    register uint8_t Rb;
+    register uint8_t regs;
+    tzExternVars *pExtVars = NULL;
+    uint32_t handle;
+    int fd;
+
+    if( pCore != NULL )
+    {
+        pExtVars = &pCore->extVars;
+    }
+
+    regs = MEMORY[PC+2];
+    Ra = (regs & 0xF0) >> 4;
+    Rb = regs & 0x0F;
+
+    handle = REG[Ra];
+    fd = REG[Rb];
+
+    EXTERNVAR_fnClosePrintSession( pExtVars, handle, fd );
+
+    ClearExternFileDescriptor( &pCore->files, fd );
+
     INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opDLY                                                                     */
+/*  opINST1                                                                   */
 /*!
-    DLY - Delay (millisconds)
+    Instruction Set 1
 
-    The opDLY function implements the VM 'DLY' operation.  This operation
-    will delay execution by the specified number of milliseconds.  The
-    delay time can be specified in a register, or via a memory literal.
+    The opINST1 function selects the first set of extension operations
+    The opcode for the extension operation is obtained from MEMORY[PC+1]
+    and executed via the instructions1 operation map.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opDLY(tzCore *pCore)
+static void opINST1(tzCore *pCore)
 {
-    uint32_t src;
-    int32_t val;
-    uint32_t delay_us;
+    uint8_t opcode;
 
-    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
-    {
-        /* delay time specified in a register */
-        src = MEMORY[PC+2] & 0x0F;
-        delay_us = REG[src] * 1000;
-        usleep( delay_us );
-        INC_PC(3);
-    }
-    else
-    {
-        /* delay time specified in a memory literal */
-        val = core_fnGetUnsignedData( pCore, MEMORY, PC, 1);
-        delay_us = val * 1000;
-        usleep( delay_us );
-        INC_PC(2);
-    }
+    opcode = MEMORY[PC+1] & 0x1F;
+    instructions1[opcode].exec(pCore);
 }
 
 /*============================================================================*/
-/*  opMDUMP                                                                   */
+/*  opINST2                                                                   */
 /*!
-    MDUMP - Memory Dump
+    Instruction Set 2
 
-    The opMDUMP function implements the VM 'MDUMP' operation.  This operation
-    will dump the VM core memory at the address specified in the register
-    with length specified in the following memory literal.
+    The opINST2 function selects the second set of extension operations
+    The opcode for the extension operation is obtained from MEMORY[PC+2]
+    and executed via the instructions2 operation map.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opMDUMP( tzCore *pCore )
+static void opINST2(tzCore *pCore)
 {
-    register uint8_t src;
-    register uint32_t addr;
-    register uint32_t len;
-
-    src = MEMORY[PC+2] & 0x0F;
-    addr = REG[src];
-    len = core_fnGetUnsignedData( pCore, MEMORY, PC+1, 2 );
-    CORE_fnDumpMemory( pCore, addr, len, stdout );
+    uint8_t opcode;
 
-    INC_PC(4);
+    opcode = MEMORY[PC+2] & 0x1F;
+    instructions2[opcode].exec(pCore);
 }
 
 /*============================================================================*/
-/*  opWRS                                                                     */
+/*  opILLEGAL                                                                 */
 /*!
-    WRS - Write String
+    Illegal Operation
 
-    The opWRS function implements the VM 'WRS' operation.  This operation
-    will dump the string in the VM core memory at the address specified
-    in the source register.
+    The opILLEGAL function is triggered for any illegal operation.
+    It outputs an error message and stops the virtual machine.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
 ==============================================================================*/
-static void opWRS( tzCore *pCore )
+static void opILLEGAL(tzCore *pCore)
 {
-    register uint8_t src;
-    register char *addr;
-    FILE *fp = NULL;
-
-    src = MEMORY[PC+2] & 0x0F;
-
-    addr = (char *)&MEMORY[REG[src]];
-
-    WriteString( addr );
-
-    INC_PC(3);
+    printf("Illegal operation\n");
+    CORE_fnDumpRegisters( pCore, stderr );
+    STOP;
 }
 
+/*==============================================================================
+        PRE-DECODED OP CODES
+==============================================================================*/
+
 /*============================================================================*/
-/*  opCSB                                                                     */
+/*  decNOP                                                                    */
 /*!
-    CSB - Create String Buffer
-
-    The opCSB function implements the VM 'CSB' operation.  This operation
-    will create a string buffer with the id specified in the source register.
+    Pre-decoded NOP - No Operation
 
-    CSB Rs
-    [in] Rs - string buffer identifier
+    The decNOP function implements the pre-decoded 'NOP' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opCSB( tzCore *pCore )
+static void decNOP( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
-
-    stringbuf_id = REG[MEMORY[PC+2] & 0x0F];
-    (void)STRINGBUFFER_fnCreate( stringbuf_id );
-    INC_PC(3);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opWSB                                                                     */
+/*  decLOD                                                                    */
 /*!
-    WSB - Write String Buffer
-
-    The opWSB function implements the VM 'WSB' operation.  This operation
-    will write the string buffer with the id specified to the standard
-    output.
+    Pre-decoded LOD - Load a Register
 
-    WSB Rs
-    [in] Rs - string buffer identifier
+    The decLOD function implements the pre-decoded 'LOD' operation.  This
+    loads a register value from the core memory address specified in a
+    register or as a literal.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opWSB( tzCore *pCore )
+static void decLOD( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
+    register uint32_t addr;
 
-    stringbuf_id = REG[MEMORY[PC+2] & 0x0F];
-    STRINGBUFFER_fnWrite( stdout, stringbuf_id );
-    INC_PC(3);
+    if( ( pInst->opcode & MODE_REG ) == MODE_REG )
+    {
+        addr = REG[pInst->src];
+        if ( addr > CORE_SIZE )
+        {
+            printf( "LOD R[%d],R[%d]: Illegal Address in R[%d]: 0x%X @ 0x%X\n",
+                    pInst->dst,
+                    pInst->src,
+                    pInst->src,
+                    addr,
+                    PC);
+            STOP;
+            return;
+        }
+    }
+    else
+    {
+        addr = pInst->imm.addr;
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Address: 0x%X @ 0x%p\n", addr, MEMORY);
+            STOP;
+            return;
+        }
+    }
+
+    /* transfer data from memory to register */
+    core_fnStoreData( pCore,
+                      (uint8_t *)&pInst->opcode,
+                      (uint8_t *)&REG[pInst->dst],
+                      &MEMORY[addr] );
+
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opEXE                                                                     */
+/*  decSTR                                                                    */
 /*!
-    EXE - Execute String Buffer
-
-    The opEXE function implements the VM 'EXE' operation.  This operation
-    will execute the contents of the specified string buffer via a
-    system() call.
+    Pre-decoded STR - Store data from a register to memory
 
-    EXE Ra,Rb
-    [in] Rb - string buffer identifier
-    [out] Ra - command result
+    The decSTR function implements the pre-decoded 'STR' operation.  This
+    stores a register value to the core memory address specified in a
+    register or as a literal.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opEXE( tzCore *pCore )
+static void decSTR( tzCore *pCore, const tzDecoded *pInst )
 {
-    char *pCmd;
-    register uint8_t regs;
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t stringbuf_id;
+    register uint32_t addr;
 
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
+    if( ( pInst->opcode & MODE_REG ) == MODE_REG )
+    {
+        addr = REG[pInst->dst];
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Address: 0x%X\n", addr);
+            STOP;
+            return;
+        }
+    }
+    else
+    {
+        addr = pInst->imm.addr;
+        if ( addr > CORE_SIZE )
+        {
+            printf("Illegal Program Address: 0x%X\n", addr);
+            STOP;
+            return;
+        }
+    }
 
-    stringbuf_id = REG[Rb];
+    /* store the data in big endian format */
+    core_fnStoreData( pCore,
+                      (uint8_t *)&pInst->opcode,
+                      &MEMORY[addr],
+                      (uint8_t *)&REG[pInst->src] );
 
-    pCmd = STRINGBUFFER_fnGet(stringbuf_id);
-    if( pCmd != NULL )
+    if( addr < PROGRAM_SIZE )
     {
-        REG[Ra] = system( pCmd );
+        /* discard any pre-decoded instructions which were overwritten */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
     }
 
-    INC_PC(3);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opASN                                                                     */
+/*  decMOV                                                                    */
 /*!
-    ASN - Append Number to String Buffer
-
-    The opASN function implements the VM 'ASN' operation.  This operation
-    will append a number from the source register to the string buffer
-    specified in the destination register.
+    Pre-decoded MOV - Move data into a register
 
-    ASN Ra,Rb
-    [in] Ra - destination string buffer identifier
-    [in] Rb - number
+    The decMOV function implements the pre-decoded 'MOV' operation.  This
+    moves data from one register to another, or from a literal into a
+    register.  Integer and floating point values are moved as their
+    32-bit representation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opASN( tzCore *pCore )
+static void decMOV( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
-    register uint8_t dst;
-    register uint8_t src;
-    register uint8_t regs;
-    register int32_t value;
-
-    regs = MEMORY[PC+2];
-    dst = (regs & 0xF0) >> 4;
-    stringbuf_id = REG[dst];
-    src = regs & 0x0F;
-    value = REG[src];
-    STRINGBUFFER_fnAppendNumber( stringbuf_id, value );
-    INC_PC(3);
+    REG[pInst->dst] = DEC_OPERAND( pInst );
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opASC                                                                     */
+/*  decADD                                                                    */
 /*!
-    ASC - Append Character to String Buffer
-
-    The opASC function implements the VM 'ASC' operation.  This operation
-    will append a character from the source register to the string buffer
-    specified in the destination register.
+    Pre-decoded ADD - Integer addition
 
-    ASC Ra,Rb
-    [in] Ra - destination string buffer identifier
-    [in] Rb - character
+    The decADD function implements the pre-decoded integer 'ADD' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opASC( tzCore *pCore )
+static void decADD( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
-    register uint8_t dst;
-    register uint8_t src;
-    register uint8_t regs;
-    register int32_t value;
+    register int32_t oldvalue;
 
-    regs = MEMORY[PC+2];
-    dst = (regs & 0xF0) >> 4;
-    stringbuf_id = REG[dst];
-    src = regs & 0x0F;
-    value = REG[src];
-    STRINGBUFFER_fnAppendChar( stringbuf_id, value );
-    INC_PC(3);
+    oldvalue = REG[pInst->dst];
+    REG[pInst->dst] += DEC_OPERAND( pInst );
+    SETFLAGS(REG[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opASS                                                                     */
+/*  decADDF                                                                   */
 /*!
-    ASS - Append String to String Buffer
-
-    The opASS function implements the VM 'ASS' operation.  This operation
-    will append a string in memory pointed to by the source register to
-    to the string buffer specified in the destination register.
+    Pre-decoded ADD.F - Floating point addition
 
-    ASS Ra,Rb
-    [in] Ra - destination string buffer identifier
-    [in] Rb - pointer to source string in memory
+    The decADDF function implements the pre-decoded floating point
+    'ADD' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opASS( tzCore *pCore )
+static void decADDF( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
-    register uint8_t dst;
-    register uint8_t src;
-    register uint8_t regs;
-    register char *value;
-
-    regs = MEMORY[PC+2];
-    dst = (regs & 0xF0) >> 4;
-    stringbuf_id = REG[dst];
-    src = regs & 0x0F;
-    value = (char *)&MEMORY[REG[src]];
-    STRINGBUFFER_fnAppendString( stringbuf_id, value );
-    INC_PC(3);
+    REGF[pInst->dst] += DEC_FOPERAND( pInst );
+    SETFFLAGS(REGF[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opASB                                                                     */
+/*  decSUB                                                                    */
 /*!
-    ASB - Append String Buffer to String Buffer
-
-    The opASB function implements the VM 'ASB' operation.  This operation
-    will append a source string buffer to a destination string buffer.
+    Pre-decoded SUB - Integer subtraction
 
-    ASB Ra,Rb
-    [in] Ra - destination string buffer identifier
-    [in] Rb - source string buffer identifer
+    The decSUB function implements the pre-decoded integer 'SUB' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opASB( tzCore *pCore )
+static void decSUB( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t dst;
-    register uint8_t src;
-    register uint8_t regs;
+    register int32_t oldvalue;
 
-    regs = MEMORY[PC+2];
-    dst= REG[((regs & 0xF0) >> 4)];
-    src = REG[(regs & 0x0F)];
-    STRINGBUFFER_fnAppendBuffer( dst, src );
-    INC_PC(3);
+    oldvalue = REG[pInst->dst];
+    REG[pInst->dst] -= DEC_OPERAND( pInst );
+    SETFLAGS(REG[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opZSB                                                                     */
+/*  decSUBF                                                                   */
 /*!
-    ZSB - Zero String Buffer
-
-    The opZSB function implements the VM 'ZSB' operation.  This operation
-    will zero (or clear) the specified string buffer
+    Pre-decoded SUB.F - Floating point subtraction
 
-    ZSB Rs
-    [in] Rs - string buffer id
+    The decSUBF function implements the pre-decoded floating point
+    'SUB' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opZSB( tzCore *pCore )
+static void decSUBF( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
-
-    stringbuf_id = REG[MEMORY[PC+2] & 0x0F];
-    STRINGBUFFER_fnClear( stringbuf_id );
-    INC_PC(3);
+    REGF[pInst->dst] -= DEC_FOPERAND( pInst );
+    SETFFLAGS(REGF[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opASF                                                                     */
+/*  decMUL                                                                    */
 /*!
-    ASF - Append Float to String Buffer
+    Pre-decoded MUL - Integer multiplication
 
-    The opASF function implements the VM 'ASF' operation.  This operation
-    will append the floating point value in the source register to the
-    destination string buffer specified by the destination register
-
-    ASF Ra, Rb
-    [in] Ra - destination string buffer identifier
-    [in] Rb - floating point register value
+    The decMUL function implements the pre-decoded integer 'MUL' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opASF( tzCore *pCore )
+static void decMUL( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t stringbuf_id;
-    register uint8_t dst;
-    register uint8_t src;
-    register uint8_t regs;
-    register float value;
+    register int32_t oldvalue;
 
-    regs = MEMORY[PC+2];
-    dst = (regs & 0xF0) >> 4;
-    stringbuf_id = REG[dst];
-    src = regs & 0x0F;
-    value = REGF[src];
-    STRINGBUFFER_fnAppendFloat( stringbuf_id, value );
-    INC_PC(3);
+    oldvalue = REG[pInst->dst];
+    REG[pInst->dst] *= DEC_OPERAND( pInst );
+    SETFLAGS(REG[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  setupTimer                                                                */
+/*  decMULF                                                                   */
 /*!
-    set up a timer
+    Pre-decoded MUL.F - Floating point multiplication
 
-    The setupTimer function sets up the specified timer to fire at
-    the specified interval in milliseconds.
+    The decMULF function implements the pre-decoded floating point
+    'MUL' operation.
 
     @param[in]
-        id
-            timer identifier
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
     @param[in]
-        intervalMS
-            timer interval in milliseconds
-
-    @retval 0 timer set ok
-    @retval -1 error setting timer
+        pInst
+            pointer to the pre-decoded instruction
 
 ==============================================================================*/
-static int setupTimer( int id, int intervalMS )
+static void decMULF( tzCore *pCore, const tzDecoded *pInst )
 {
-    struct sigevent         te;
-    struct itimerspec       its;
-    int                     sigNo = SIGRTMIN+5;
-    long                    secs;
-    long                    msecs;
-    timer_t                 *timerID;
-    int                     result = -1;
+    REGF[pInst->dst] *= DEC_FOPERAND( pInst );
+    SETFFLAGS(REGF[pInst->dst]);
+    PC = pInst->next;
+}
 
-    secs = intervalMS / 1000;
-    msecs = intervalMS % 1000;
+/*============================================================================*/
+/*  decDIV                                                                    */
+/*!
+    Pre-decoded DIV - Integer division
 
-    if( ( id > 0 ) && ( id < MAX_TIMERS ) )
-    {
-        timerID = &timers[id];
+    The decDIV function implements the pre-decoded integer 'DIV' operation.
 
-        /* Set and enable alarm */
-        te.sigev_notify = SIGEV_SIGNAL;
-        te.sigev_signo = sigNo;
-        te.sigev_value.sival_int = id;
-        timer_create(CLOCK_REALTIME, &te, timerID);
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-        its.it_interval.tv_sec = secs;
-        its.it_interval.tv_nsec = msecs * 1000000L;
-        its.it_value.tv_sec = secs;
-        its.it_value.tv_nsec = msecs * 1000000L;
-        timer_settime(*timerID, 0, &its, NULL);
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
 
-        result = 0;
-    }
+==============================================================================*/
+static void decDIV( tzCore *pCore, const tzDecoded *pInst )
+{
+    register int32_t oldvalue;
 
-    return result;
+    oldvalue = REG[pInst->dst];
+    REG[pInst->dst] /= DEC_OPERAND( pInst );
+    SETFLAGS(REG[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  waitSignal                                                                */
+/*  decDIVF                                                                   */
 /*!
-    wait for a realtime signal
-
-    The waitSignal function waits for one of the system real-time
-    signals: [SIGRTMIN+5 .. SIGRTMIN+9]
+    Pre-decoded DIV.F - Floating point division
 
-    The function blocks until one of these signals is received.
-
-    When the signal is received the signal id and signal value are
-    returned to the caller.
+    The decDIVF function implements the pre-decoded floating point
+    'DIV' operation.
 
     @param[in]
-        signum
-            pointer to the location to store the received signal number
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
     @param[in]
-        id
-            pointer to the location to store the received signal id
-
-    @retval 0 signal received ok
-    @retval -1 error receiving signal
+        pInst
+            pointer to the pre-decoded instruction
 
 ==============================================================================*/
-static int waitSignal( int *signum, int *id )
+static void decDIVF( tzCore *pCore, const tzDecoded *pInst )
 {
-    sigset_t mask;
-    siginfo_t info;
-    int result = -1;
-    int timer_id = 0;
-    int sig;
+    REGF[pInst->dst] /= DEC_FOPERAND( pInst );
+    SETFFLAGS(REGF[pInst->dst]);
+    PC = pInst->next;
+}
 
-    if( ( signum != NULL ) &&
-        ( id != NULL ) )
-    {
-        sigemptyset( &mask );
-        /* timer notification */
-        sigaddset( &mask, SIGRTMIN+5 );
-        /* modified notification */
-        sigaddset( &mask, SIGRTMIN+6 );
-        /* calc notification */
-        sigaddset( &mask, SIGRTMIN+7 );
-        /* validate notification */
-        sigaddset( &mask, SIGRTMIN+8 );
-        /* print notification */
-        sigaddset( &mask, SIGRTMIN+9 );
+/*============================================================================*/
+/*  decAND                                                                    */
+/*!
+    Pre-decoded AND - Bitwise AND
 
-        sigprocmask( SIG_BLOCK, &mask, NULL );
+    The decAND function implements the pre-decoded 'AND' operation.
 
-        sig = sigwaitinfo( &mask, &info );
-        *signum = sig;
-        *id = info.si_value.sival_int;
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-        result = 0;
-    }
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
 
-    return result;
+==============================================================================*/
+static void decAND( tzCore *pCore, const tzDecoded *pInst )
+{
+    register int32_t oldvalue;
+
+    oldvalue = REG[pInst->dst];
+    REG[pInst->dst] &= DEC_OPERAND( pInst );
+    SETFLAGS(REG[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opSTM                                                                     */
+/*  decOR                                                                     */
 /*!
-    STM - Set Timer
-
-    The opSTM function implements the VM 'STM' operation.  This operation
-    will set up the timer specified in the destination register with the
-    delay specified in the source register
+    Pre-decoded OR - Bitwise OR
 
-    STM Rd, Rs
-    [in] Rd - timer identifier
-    [in] Rs - timer delay
+    The decOR function implements the pre-decoded 'OR' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opSTM( tzCore *pCore )
+static void decOR( tzCore *pCore, const tzDecoded *pInst )
 {
-    int timer_id;
-    register uint32_t timer_ms;
-    register uint8_t dst;
-    register uint8_t src;
-    register uint8_t regs;
-
-    regs = MEMORY[PC+2];
-    dst = (regs & 0xF0) >> 4;
-    src = regs & 0x0F;
-    timer_ms = REG[src];
-    timer_id = REG[dst];
-
-    if ( setupTimer( timer_id, timer_ms ) == -1 )
-    {
-        fprintf(stderr, "Illegal timer\n");
-        CORE_fnDumpRegisters( pCore, stderr );
-        STOP;
-    }
-
-    INC_PC(3);
+    register int32_t oldvalue;
 
+    oldvalue = REG[pInst->dst];
+    REG[pInst->dst] |= DEC_OPERAND( pInst );
+    SETFLAGS(REG[pInst->dst]);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opCTM                                                                     */
+/*  decNOT                                                                    */
 /*!
-    CTM - Clear Timer
-
-    The opCTM function implements the VM 'CTM' operation.  This operation
-    will clear the timer specified in the source register.
-
-    If an invalid timer ID is specified the virtual machine will stop
-    and throw an error.
+    Pre-decoded NOT - Bitwise Negation
 
-    CTM Rs
-    [in] Rs - timer delay
+    The decNOT function implements the pre-decoded 'NOT' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opCTM( tzCore *pCore )
+static void decNOT( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t src;
-    int timer_id;
-
-    src = MEMORY[PC+2] & 0x0F;
-    timer_id = REG[src];
-
-    if( ( timer_id > 0 ) && ( timer_id < MAX_TIMERS ) )
-    {
-        printf("deleting timer %d\n", timer_id);
-        timer_delete( timers[timer_id] );
-
-        INC_PC(3);
-    }
-    else
-    {
-        fprintf(stderr, "Illegal timer\n");
-        CORE_fnDumpRegisters( pCore, stderr );
-        STOP;
-    }
+    REG[pInst->dst] = ~REG[pInst->dst];
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opNFY                                                                     */
+/*  decSHR                                                                    */
 /*!
-    NFY - Request Notification
-
-    The opNFY function implements the VM 'NFY' operation.  This operation
-    will request an external variable notification for the external
-    variable specified in the destination register, with the request type
-    in the source register.
+    Pre-decoded SHR - Right Shift
 
-    NFY Rd, Rs
-    [in] Rd - external variable handle
-    [in] Rs - notification type
+    The decSHR function implements the pre-decoded 'SHR' operation.  The
+    data is shifted as an unsigned type and the sign bit is not preserved.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opNFY( tzCore *pCore )
+static void decSHR( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t regs;
-    register uint8_t src;
-    register uint8_t dst;
-    uint32_t request;
-    uint32_t handle;
-    int rc;
-
-    void *pExt = NULL;
+    register uint32_t val;
 
-    if( pCore != NULL )
+    val = REG[pInst->dst];
+    if ( pInst->opcode & BYTE_MASK )
     {
-        pExt = pCore->pExt;
+        /*  byte operation */
+        val &= 0xFF;
     }
-
-    regs = MEMORY[PC+2];
-    src = regs & 0x0F;
-    dst = (( regs >> 4 ) & 0x0F );
-
-    handle = REG[dst];
-    request = REG[src];
-
-    rc = EXTERNVAR_fnNotify( pExt, handle, request );
-    if( rc != 0 )
+    else if ( pInst->opcode & WORD_MASK )
     {
-        fprintf( stderr, "Notification Request Failure\n" );
-        CORE_fnDumpRegisters( pCore, stderr );
-        STOP;
+        /* word operation */
+        val &= 0xFFFF;
     }
 
-    INC_PC(3);
+    REG[pInst->dst] = val >> pInst->imm.val;
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opWFS                                                                     */
+/*  decJMP                                                                    */
 /*!
-    WFS - Wait For Signal
-
-    The opWFS function implements the VM 'WFS' operation.  This operation
-    will wait for a real time signal via the waitSignal function and
-    store the received signal number in Ra and the signal id in Rb.
+    Pre-decoded JMP - Jump to Memory Location
 
-    WFS Ra, Rb
-    [out] Ra - received signal number
-    [out] Rb - received signal id
+    The decJMP function implements the pre-decoded 'JMP' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opWFS( tzCore *pCore )
+static void decJMP( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t r1;
-    register uint8_t r2;
-    register uint8_t regs;
-    register uint32_t signal;
-    int signum;
-    int id;
-
-    regs = MEMORY[PC+2];
-    r1 = (regs & 0xF0) >> 4;
-    r2 = regs & 0x0F;
-
-    waitSignal( &signum, &id );
-
-    REG[r1] = signum;
-    REG[r2] = id;
-
-    INC_PC(3);
+    PC = pInst->imm.val;
 }
 
 /*============================================================================*/
-/*  opEVS                                                                     */
+/*  decJMPIF                                                                  */
 /*!
-    EVS - External Validation Start
-
-    The opEVS function implements the VM 'EVS' operation.  This operation
-    will start an external variable validation using a received validation
-    notification reference in Rb, and will return the handle of the
-    variable being validated in Ra.
+    Pre-decoded conditional jump
 
-    EVS Ra, Rb
-    [out] Ra - handle of the variable being validated
-    [in] Rb - validation notification reference
+    The decJMPIF function implements the pre-decoded 'JZR', 'JNZ', 'JNE',
+    'JPO', 'JCA' and 'JNC' operations.  The decoder stores the status
+    flag to test in the src field, and stores 1 in the dst field if the
+    jump is taken when the flag is set, or 0 if the jump is taken when
+    the flag is clear.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opEVS( tzCore *pCore )
+static void decJMPIF( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    void *pExt = NULL;
-    int rc;
-    uint32_t handle;
-    uint32_t hVar;
-
-    if( pCore != NULL )
-    {
-        pExt = pCore->pExt;
-    }
-
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
-
-    handle = REG[Rb];
-    rc = EXTERNVAR_fnValidateStart( pExt, handle, &hVar );
-    if( rc == 0 )
+    if( ( ( FLAGS & pInst->src ) != 0 ) == pInst->dst )
     {
-        REG[Ra] = hVar;
+        PC = pInst->imm.val;
     }
     else
     {
-        fprintf( stderr, "Notification Start Failure\n" );
-        CORE_fnDumpRegisters( pCore, stderr );
-        STOP;
+        PC = pInst->next;
     }
-
-    INC_PC(3);
 }
 
 /*============================================================================*/
-/*  opEVE                                                                     */
+/*  decCAL                                                                    */
 /*!
-    EVE - External Validation End
+    Pre-decoded CAL - Call a subroutine
 
-    The opEVE function implements the VM 'EVE' operation.  This operation
-    will end an external variable validation using a received validation
-    notification reference in Rb, and will return the handle of the
-    variable being validated in Ra.
+    The decCAL function implements the pre-decoded 'CAL' operation.  The
+    subroutine address is specified in a register or as a literal.
 
-    EVE Ra, Rb
-    [in] Ra - validation notification reference
-    [in] Rb - validation result (0 = ok, or non-zero = errno)
+    Stack overflow will terminate the virtual machine
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opEVE( tzCore *pCore )
+static void decCAL( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    void *pExt = NULL;
-    uint32_t handle;
-    uint32_t response;
+    register uint32_t val;
 
-    if( pCore != NULL )
+    if( ( pInst->opcode & MODE_REG ) == MODE_REG )
     {
-        pExt = pCore->pExt;
+        val = REG[pInst->src];
+    }
+    else
+    {
+        val = pInst->imm.addr;
     }
 
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
+    PC = pInst->next;
 
-    handle = REG[Ra];
-    response = REG[Rb];
+    SP -= sizeof( uint32_t );
+    if ( SP < ( CORE_SIZE - STACK_SIZE ) )
+    {
+        printf("Stack Overflow\n");
+        STOP;
+        return;
+    }
+
+    /* set return address */
+    core_fnSetStackData( pCore, SP, PC );
+
+    /* set CALL target */
+    PC = val;
 
-    EXTERNVAR_fnValidateEnd( pExt, handle, response );
+    /* increment the call depth */
+    pCore->call_depth++;
 
-    INC_PC(3);
+    /* set the new call depth level on the string buffers */
+    STRINGBUFFER_fnSetLevel( &pCore->strbufs, pCore->call_depth );
 }
 
 /*============================================================================*/
-/*  opSBL                                                                     */
+/*  decRET                                                                    */
 /*!
-    SBL - String Buffer Length
-
-    The opSBL function implements the VM 'SBL' operation.  This operation
-    will get the length of the string buffer specified in Rb and put the
-    length into Ra.
+    Pre-decoded RET - Return from a subroutine
 
-    SBL Ra, Rb
-    [out] Ra - string buffer length
-    [in] Rb - string buffer id
+    The decRET function implements the pre-decoded 'RET' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opSBL( tzCore *pCore )
+static void decRET( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    uint32_t stringbuf_id;
-    size_t len;
+    (void)pInst;
 
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
+    opRET( pCore );
+}
 
-    stringbuf_id = REG[Rb];
+/*============================================================================*/
+/*  decCMP                                                                    */
+/*!
+    Pre-decoded CMP - Compare two integer values
 
-    len = STRINGBUFFER_fnGetLength( stringbuf_id );
+    The decCMP function implements the pre-decoded integer 'CMP' operation.
 
-    REG[Ra] = len;
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    INC_PC(3);
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
+==============================================================================*/
+static void decCMP( tzCore *pCore, const tzDecoded *pInst )
+{
+    register int32_t oldvalue;
+    register int32_t val;
+
+    oldvalue = REG[pInst->dst];
+    val = oldvalue - DEC_OPERAND( pInst );
+    SETFLAGS(val);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opSBO                                                                     */
+/*  decCMPF                                                                   */
 /*!
-    SBO - String Buffer Offset
-
-    The opSBO function implements the VM 'SBO' operation.  This operation
-    will set the read/write offset of the string buffer specified in
-    Ra with the offset specified in Rb.
+    Pre-decoded CMP.F - Compare two floating point values
 
-    SBO Ra, Rb
-    [in] Ra - string buffer id
-    [in] Rb - read/write offset
+    The decCMPF function implements the pre-decoded floating point
+    'CMP' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opSBO( tzCore *pCore )
+static void decCMPF( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    uint32_t stringbuf_id;
-    uint32_t offset;
-    size_t len;
-    char c;
-
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
-
-    stringbuf_id = REG[Ra];
-    offset = REG[Rb];
-
-    STRINGBUFFER_fnSetRWOffset( stringbuf_id, offset );
+    register float fval;
 
-    INC_PC(3);
+    fval = REGF[pInst->dst] - DEC_FOPERAND( pInst );
+    SETFFLAGS(fval);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opGCO                                                                     */
+/*  decTOF                                                                    */
 /*!
-    GCO - Get Character at Offset
-
-    The opGCO function implements the VM 'GCO' operation.  This operation
-    will get the character at the current read/write offset of the string buffer
-    specified in Rb.  The character will be stored in Ra
+    Pre-decoded TOF - Convert an integer to a float
 
-    GCO Ra, Rb
-    [out] Ra - character at current read/write offset in stringbuffer
-    [in] Rb - string buffer id
+    The decTOF function implements the pre-decoded 'TOF' operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opGCO( tzCore *pCore )
+static void decTOF( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    uint32_t stringbuf_id;
-    uint32_t offset;
-    size_t len;
-    char c;
+    REGF[pInst->dst] = (float)REG[pInst->dst];
+    PC = pInst->next;
+}
 
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
+/*============================================================================*/
+/*  decTOI                                                                    */
+/*!
+    Pre-decoded TOI - Convert a float to an integer
 
-    stringbuf_id = REG[Rb];
+    The decTOI function implements the pre-decoded 'TOI' operation.
 
-    c = STRINGBUFFER_fnGetCharAtOffset( stringbuf_id );
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    REG[Ra] = c;
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
 
-    INC_PC(3);
+==============================================================================*/
+static void decTOI( tzCore *pCore, const tzDecoded *pInst )
+{
+    REG[pInst->dst] = (int32_t)REGF[pInst->dst];
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opSCO                                                                     */
+/*  decPSH                                                                    */
 /*!
-    SCO - Set Character at Offset
-
-    The opSCO function implements the VM 'SCO' operation.  This operation
-    will set the character at the current read/write offset of the string buffer
-    specified in Ra with the character specified in Rb or a character literal
-    from the memory core.
-
-    Character from register
-
-    SCO Ra, Rb
-    [in] Ra - string buffer id
-    [in] Rb - character to write
+    Pre-decoded PSH - Push a register value onto the stack
 
-    Literal character from memory core
+    The decPSH function implements the pre-decoded 'PSH' operation.
 
-    SCO Ra, n
-    [in] Ra - string buffer id
-    [in] n - literal character
+    If a stack overflow occurs, the virtual machine will terminate.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opSCO( tzCore *pCore )
+static void decPSH( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    uint32_t stringbuf_id;
-    uint32_t offset;
-    size_t len;
-    char c;
-
-    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
+    SP -= sizeof( uint32_t );
+    if ( SP < ( CORE_SIZE - STACK_SIZE ))
     {
-        regs = MEMORY[PC+2];
-        Ra = (regs & 0xF0) >> 4;
-        Rb = regs & 0x0F;
+        printf("Stack Overflow\n");
+        STOP;
+        return;
+    }
 
-        stringbuf_id = REG[Ra];
+    core_fnSetStackData( pCore, SP, REG[pInst->src] );
+    PC = pInst->next;
+}
 
-        c = REG[Rb];
+/*============================================================================*/
+/*  decPOP                                                                    */
+/*!
+    Pre-decoded POP - Pop a register value off the stack
 
-        INC_PC( 3 );
-        STRINGBUFFER_fnSetCharAtOffset( stringbuf_id, c );
-    }
-    else
-    {
-        regs = MEMORY[PC+2];
-        Ra = regs & 0x0F;
+    The decPOP function implements the pre-decoded 'POP' operation.
 
-        stringbuf_id = REG[Ra];
+    If a stack underflow occurs, the virtual machine will terminate.
 
-        c = MEMORY[PC+3];
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-        INC_PC(4);
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
+==============================================================================*/
+static void decPOP( tzCore *pCore, const tzDecoded *pInst )
+{
+    REG[pInst->dst] = core_fnGetStackData( pCore, SP );
+    SP += sizeof(uint32_t);
+    if( SP > CORE_SIZE )
+    {
+        STOP;
+        printf("Stack Underflow\n");
     }
 
-    STRINGBUFFER_fnSetCharAtOffset( stringbuf_id, c );
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opOFD                                                                     */
+/*  decHLT                                                                    */
 /*!
-    OFD - Open File Descriptor
+    Pre-decoded HLT - Halt the Virtual Machine
 
-    The opOFD function implements the VM 'OFD' operation.  This operation
-    will open a file and assign a file descriptor. The file can be opened
-    either in read ('r' or 'R') or write ('w' or 'W') mode.
-    Ra specifies a stringbuffer id of a string buffer which contains the name
-    of the file to open. Rb contains the read/write open mode.
-    The read/write mode can also be specified as a character literal.
-    The file descriptor of the open file is written back to Ra.  If the
-    file fails to open then -1 is written back to Ra.
+    The decHLT function implements the pre-decoded 'HLT' operation.
 
-    Open mode from register
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    OFD Ra, Rb
-    [in] Ra - id of string buffer containing file name
-    [in] Rb - open mode: one of 'r', 'w', 'R', or 'W'
-    [out] Ra - file descriptor of open file
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
 
-    Open mode from literal
+==============================================================================*/
+static void decHLT( tzCore *pCore, const tzDecoded *pInst )
+{
+    PC = pInst->next;
+    STOP;
+}
 
-    SCO Ra, n
-    [in] Ra - id of string buffer containing file name
-    [in] n - open mode literal character:  one of: 'r', 'R', 'w', 'W'
-    [out] Ra - file descriptor of open file
+/*============================================================================*/
+/*  decLDL                                                                    */
+/*!
+    Pre-decoded LDL - Load Local variable
+
+    The decLDL function implements the pre-decoded 'LDL' operation.  This
+    loads a register from the local variable at the pre-decoded
+    displacement from the frame pointer (R1), leaving the address of the
+    local variable in R2.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opOFD( tzCore *pCore )
+static void decLDL( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    uint32_t stringbuf_id;
-    char mode;
-    uint32_t fd;
-
-    regs = MEMORY[PC+2];
+    register uint32_t addr;
 
-    if( ( MEMORY[PC+1] & MODE_REG ) == MODE_REG )
+    addr = (uint32_t)( REG[1] + pInst->imm.val );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - sizeof( uint32_t ) )
     {
-        Ra = (regs & 0xF0) >> 4;
-        Rb = regs & 0x0F;
+        printf( "LDL R[%d],%d: Illegal Address: 0x%X @ 0x%X\n",
+                pInst->dst,
+                pInst->imm.val,
+                addr,
+                PC );
+        STOP;
+        return;
+    }
 
-        stringbuf_id = REG[Ra];
-        mode = REG[Rb];
-        INC_PC(3);
+    REG[pInst->dst] = core_fnGetStackData( pCore, addr );
 
-    }
-    else
-    {
-        Ra = regs & 0x0F;
+    PC = pInst->next;
+}
 
-        stringbuf_id = REG[Ra];
+/*============================================================================*/
+/*  decSTL                                                                    */
+/*!
+    Pre-decoded STL - Store Local variable
 
-        mode = MEMORY[PC+3];
+    The decSTL function implements the pre-decoded 'STL' operation.  This
+    stores a register into the local variable at the pre-decoded
+    displacement from the frame pointer (R1), leaving the address of the
+    local variable in R2.
 
-        INC_PC(4);
-    }
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    if( OpenFileDescriptor( stringbuf_id, mode, &fd ) == EOK )
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
+==============================================================================*/
+static void decSTL( tzCore *pCore, const tzDecoded *pInst )
+{
+    register uint32_t addr;
+
+    addr = (uint32_t)( REG[1] + pInst->imm.val );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - sizeof( uint32_t ) )
     {
-        REG[Ra] = fd;
+        printf( "STL R[%d],%d: Illegal Address: 0x%X @ 0x%X\n",
+                pInst->src,
+                pInst->imm.val,
+                addr,
+                PC );
+        STOP;
+        return;
     }
-    else
+
+    /* store the data in big endian format */
+    core_fnSetStackData( pCore, addr, REG[pInst->src] );
+
+    if( addr < PROGRAM_SIZE )
     {
-        REG[Ra] = -1;
+        /* discard any pre-decoded instructions which were overwritten */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
     }
+
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opCFD                                                                     */
+/*  decBLT                                                                    */
 /*!
-    CFD - Close File Descriptor
+    Pre-decoded BLT - Branch if less than
 
-    The opCFD function implements the VM 'CFD' operation.  This operation
-    will close the file with the file descriptor specified in Ra.
-
-    CFD Ra,
-    [in] Ra - file descriptor of open file
+    The decBLT function implements the pre-decoded integer 'BLT'
+    operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opCFD( tzCore *pCore )
+static void decBLT( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t src;
-    uint32_t fd;
+    PC = ( REG[pInst->dst] < REG[pInst->src] ) ? pInst->imm.val
+                                               : pInst->next;
+}
 
-    src = MEMORY[PC+2] & 0x0F;
-    fd = REG[src];
+/*============================================================================*/
+/*  decBLE                                                                    */
+/*!
+    Pre-decoded BLE - Branch if less than or equal
 
-    INC_PC(3);
+    The decBLE function implements the pre-decoded integer 'BLE'
+    operation.
 
-    CloseFileDescriptor( fd );
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
+==============================================================================*/
+static void decBLE( tzCore *pCore, const tzDecoded *pInst )
+{
+    PC = ( REG[pInst->dst] <= REG[pInst->src] ) ? pInst->imm.val
+                                                : pInst->next;
 }
 
 /*============================================================================*/
-/*  opSFD                                                                     */
+/*  decBEQ                                                                    */
 /*!
-    SFD - Select File Descriptor
-
-    The opSFD function implements the VM 'SFD' operation.  This operation
-    will set the active file descriptor used by the I/O operations to the
-    file descriptor specfied in Ra.
+    Pre-decoded BEQ - Branch if equal
 
-    SFD Ra,
-    [in] Ra - file descriptor of open file
+    The decBEQ function implements the pre-decoded integer 'BEQ'
+    operation.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opSFD( tzCore *pCore )
+static void decBEQ( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t src;
-    uint32_t fd;
+    PC = ( REG[pInst->dst] == REG[pInst->src] ) ? pInst->imm.val
+                                                : pInst->next;
+}
 
-    src = MEMORY[PC+2] & 0x0F;
-    fd = REG[src];
+/*============================================================================*/
+/*  decBNE                                                                    */
+/*!
+    Pre-decoded BNE - Branch if not equal
 
-    INC_PC(3);
+    The decBNE function implements the pre-decoded integer 'BNE'
+    operation.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
 
-    SetActiveFileDescriptor( fd );
+==============================================================================*/
+static void decBNE( tzCore *pCore, const tzDecoded *pInst )
+{
+    PC = ( REG[pInst->dst] != REG[pInst->src] ) ? pInst->imm.val
+                                                : pInst->next;
 }
 
 /*============================================================================*/
-/*  opOPS                                                                     */
+/*  decBCCF                                                                   */
 /*!
-    OPS - Open Print Session
-
-    The opOPS function implements the VM 'OPS' operation.  This operation
-    is used to open a print session in response to a PRINT notification.
-    Ra specifies the print notifcation handle (id recevied from WFS)
-    The output file descriptor is returned in Ra, and the external variable
-    handle is returned in Rb
+    Pre-decoded BLT.F, BLE.F, BEQ.F, BNE.F - Floating point compare and
+    branch
 
-    OPS Ra, Rb
-    [in] Ra - print notification handle
-    [out] Ra - output file descriptor
-    [out] Rb - external variable handle
+    The decBCCF function implements the pre-decoded floating point
+    compare and branch operations.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opOPS( tzCore *pCore )
+static void decBCCF( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    void *pExt = NULL;
-    uint32_t handle;
-    uint32_t hVar;
-    FILE *fp;
-    int fd;
+    PC = core_fnCompare( pInst->opcode,
+                         REG[pInst->dst],
+                         REG[pInst->src] ) ? pInst->imm.val : pInst->next;
+}
 
-    if( pCore != NULL )
-    {
-        pExt = pCore->pExt;
-    }
+/*============================================================================*/
+/*  decLDX                                                                    */
+/*!
+    Pre-decoded LDX - Load a register from an indexed memory address
 
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
+    The decLDX function implements the pre-decoded indexed 'LOD'
+    operation.  This loads a register from the address calculated from
+    the base register, the scaled index register and the pre-decoded
+    displacement, leaving the address in R2.
 
-    handle = REG[Ra];
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
 
-    if ( EXTERNVAR_fnOpenPrintSession( pExt, handle, &hVar, &fd ) == EOK )
-    {
-        SetExternWriteFileDescriptor( fd, 'w' );
-        SetActiveFileDescriptor( fd );
-        REG[Rb] = hVar;
-        REG[Ra] = fd;
-    }
-    else
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
+==============================================================================*/
+static void decLDX( tzCore *pCore, const tzDecoded *pInst )
+{
+    register uint32_t addr;
+
+    addr = (uint32_t)( REG[pInst->src] +
+                       REG[pInst->index] * pInst->scale +
+                       pInst->imm.val );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - DATA_WIDTH( pInst->opcode ) )
     {
-        REG[Ra] = 0;
-        REG[Rb] = 0;
+        printf( "LDX R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                pInst->dst,
+                addr,
+                PC );
+        STOP;
+        return;
     }
 
-    INC_PC(3);
+    /* transfer data from memory to register */
+    core_fnStoreData( pCore,
+                      (uint8_t *)&pInst->opcode,
+                      (uint8_t *)&REG[pInst->dst],
+                      &MEMORY[addr] );
+
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opCPS                                                                     */
+/*  decSTX                                                                    */
 /*!
-    CPS - Close Print Session
-
-    The opCPS function implements the VM 'CPS' operation.  This operation
-    is used to close or terminate a print session.
-    Ra specifies the print notifcation handle (id recevied from WFS)
-    Rb specifies the output file descriptor
+    Pre-decoded STX - Store a register to an indexed memory address
 
-    CPS Ra, Rb
-    [in] Ra - notification handle
-    [in] Rb - output file descriptor
+    The decSTX function implements the pre-decoded indexed 'STR'
+    operation.  This stores a register to the address calculated from
+    the base register, the scaled index register and the pre-decoded
+    displacement, leaving the address in R2.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opCPS( tzCore *pCore )
+static void decSTX( tzCore *pCore, const tzDecoded *pInst )
 {
-    register uint8_t Ra;
-    register uint8_t Rb;
-    register uint8_t regs;
-    void *pExt = NULL;
-    uint32_t handle;
-    int fd;
+    register uint32_t addr;
 
-    if( pCore != NULL )
+    addr = (uint32_t)( REG[pInst->src] +
+                       REG[pInst->index] * pInst->scale +
+                       pInst->imm.val );
+    REG[2] = addr;
+    if ( addr > CORE_SIZE - DATA_WIDTH( pInst->opcode ) )
     {
-        pExt = pCore->pExt;
+        printf( "STX R[%d]: Illegal Address: 0x%X @ 0x%X\n",
+                pInst->dst,
+                addr,
+                PC );
+        STOP;
+        return;
     }
 
-    regs = MEMORY[PC+2];
-    Ra = (regs & 0xF0) >> 4;
-    Rb = regs & 0x0F;
+    /* store the data in big endian format */
+    core_fnStoreData( pCore,
+                      (uint8_t *)&pInst->opcode,
+                      &MEMORY[addr],
+                      (uint8_t *)&REG[pInst->dst] );
 
-    handle = REG[Ra];
-    fd = REG[Rb];
+    if( addr < PROGRAM_SIZE )
+    {
+        /* discard any pre-decoded instructions which were overwritten */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+    }
 
-    EXTERNVAR_fnClosePrintSession( pExt, handle, fd );
+    PC = pInst->next;
+}
 
-    ClearExternFileDescriptor( fd );
+/*============================================================================*/
+/*  decINST                                                                   */
+/*!
+    Execute an instruction which has no pre-decoded implementation
 
-    INC_PC(3);
+    The decINST function executes the instruction via its opXXX function
+    from the instructions0 operation map.  The Program Counter already
+    refers to the instruction.
+
+    @param[in]
+        pCore
+            pointer to the tzCore object representing the virtual memory core
+
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
+==============================================================================*/
+static void decINST( tzCore *pCore, const tzDecoded *pInst )
+{
+    instructions0[pInst->opcode & 0x1F].exec( pCore );
 }
 
 /*============================================================================*/
-/*  opINST1                                                                   */
+/*  decLODA                                                                   */
 /*!
-    Instruction Set 1
+    Pre-decoded LOD - Load a Register from a verified address
 
-    The opINST1 function selects the first set of extension operations
-    The opcode for the extension operation is obtained from MEMORY[PC+1]
-    and executed via the instructions1 operation map.
+    The decLODA function implements the pre-decoded 'LOD' operation for
+    a literal address which has been checked by CORE_fnVerify.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opINST1(tzCore *pCore)
+static void decLODA( tzCore *pCore, const tzDecoded *pInst )
 {
-    uint8_t opcode;
+    /* transfer data from memory to register */
+    core_fnStoreData( pCore,
+                      (uint8_t *)&pInst->opcode,
+                      (uint8_t *)&REG[pInst->dst],
+                      &MEMORY[pInst->imm.addr] );
 
-    opcode = MEMORY[PC+1] & 0x1F;
-    instructions1[opcode].exec(pCore);
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opINST2                                                                   */
+/*  decSTRA                                                                   */
 /*!
-    Instruction Set 2
+    Pre-decoded STR - Store a Register to a verified address
 
-    The opINST2 function selects the second set of extension operations
-    The opcode for the extension operation is obtained from MEMORY[PC+2]
-    and executed via the instructions2 operation map.
+    The decSTRA function implements the pre-decoded 'STR' operation for
+    a literal address which has been checked by CORE_fnVerify.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opINST2(tzCore *pCore)
+static void decSTRA( tzCore *pCore, const tzDecoded *pInst )
 {
-    uint8_t opcode;
+    register uint32_t addr = pInst->imm.addr;
 
-    opcode = MEMORY[PC+2] & 0x1F;
-    instructions2[opcode].exec(pCore);
+    /* store the data in big endian format */
+    core_fnStoreData( pCore,
+                      (uint8_t *)&pInst->opcode,
+                      &MEMORY[addr],
+                      (uint8_t *)&REG[pInst->src] );
+
+    if( addr < PROGRAM_SIZE )
+    {
+        /* discard any pre-decoded instructions which were overwritten */
+        core_fnInvalidateDecode( pCore, addr, sizeof( uint32_t ) );
+    }
+
+    PC = pInst->next;
 }
 
 /*============================================================================*/
-/*  opILLEGAL                                                                 */
+/*  decINSTV                                                                  */
 /*!
-    Illegal Operation
+    Execute an instruction of a verified program
 
-    The opILLEGAL function is triggered for any illegal operation.
-    It outputs an error message and stops the virtual machine.
+    The decINSTV function executes the instruction via its opXXX function
+    from the instructions0 operation map, in the same way as decINST.
+    It is used in a verified program for instructions which can transfer
+    control to a computed address, so it leaves the verified fast path
+    if the new Program Counter does not refer to a verified instruction.
 
     @param[in]
         pCore
             pointer to the tzCore object representing the virtual memory core
 
+    @param[in]
+        pInst
+            pointer to the pre-decoded instruction
+
 ==============================================================================*/
-static void opILLEGAL(tzCore *pCore)
+static void decINSTV( tzCore *pCore, const tzDecoded *pInst )
 {
-    printf("Illegal operation\n");
-    CORE_fnDumpRegisters( pCore, stderr );
-    STOP;
+    instructions0[pInst->opcode & 0x1F].exec( pCore );
+
+    if( ( (uint32_t)PC >= PROGRAM_SIZE ) ||
+        ( pCore->pDecodeMap[PC] == DECODE_NONE ) )
+    {
+        core_fnLeaveFastPath( pCore );
+    }
 }
 
 /*! @}
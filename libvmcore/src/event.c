@@ -0,0 +1,1734 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @defgroup event Event Backend
+ * @brief Timer and signal event backend for the Virtual Machine
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file event.c
+
+    Event Backend
+
+    The Event Backend delivers the timer expirations and external
+    variable notification signals which a VM program waits for using
+    the WFS instruction.
+
+    Program timers are kept in a hashed timer wheel with one slot per
+    tick, so starting and stopping a timer is a constant time list
+    operation, and thousands of timers can be used.  A single timerfd
+    on the monotonic clock is armed for the next occupied slot of the
+    wheel.  All timers expiring in the same tick are handled by one
+    wakeup, and a timer which expires again before the program has
+    received its previous expiration is only delivered once.
+
+    The notification signals are received through a signalfd.  The
+    timerfd and signalfd are registered with a single epoll instance.
+    Whenever the signalfd is ready, all of the pending notifications are
+    drained into an in-core ready queue using batched reads, so waiting
+    for a signal only needs a system call when there are no expired
+    timers or received signals, and bursts of notifications do not
+    overflow the kernel signal queue.
+
+    The ready queue is a bounded lock-free multi-producer single-consumer
+    ring.  Other threads of the host (e.g. a dedicated signal or epoll
+    thread) can post events to a program with EVENT_fnPost without
+    taking a lock, while the program takes them in WFS.  An eventfd
+    registered with the epoll instance wakes the program, and is only
+    written by the first post after the program last read it.  Events
+    which do not fit in the ready queue are counted rather than being
+    silently dropped.
+
+    Received and posted signals are passed to the filter function by
+    the program thread once they are in the ready queue, so a host
+    which routes notifications to its programs does not need a
+    signalfd per program.  Signals rejected by the filter are discarded
+    without being received.
+
+    The epoll instance can itself be watched by a host running many
+    VM instances, to find out when a suspended program has an event.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <sys/eventfd.h>
+#include "event.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+#ifndef EOK
+/*! success response */
+#define EOK 0
+#endif
+
+/*! epoll data identifying the notification signalfd */
+#define EVENT_SIGNALS ( 0 )
+
+/*! epoll data identifying the timer wheel timerfd */
+#define EVENT_TIMERS ( 1 )
+
+/*! epoll data identifying the posted event eventfd */
+#define EVENT_POSTED ( 2 )
+
+/*! number of file descriptors registered with the epoll instance */
+#define EVENT_NUM_FDS ( 3 )
+
+/*! initial number of entries in the timer array */
+#define EVENT_MIN_TIMERS ( 16 )
+
+/*! wheel slot of a tick */
+#define EVENT_SLOT(T) ( (T) % EVENT_WHEEL_SIZE )
+
+/*! initial number of entries in the signal handler table */
+#define EVENT_MIN_HANDLERS ( 16 )
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int event_fnPoll( tzEvents *pEvents, int timeout );
+static void event_fnReadSignals( tzEvents *pEvents );
+static void event_fnExpire( tzEvents *pEvents );
+static void event_fnExpireSlot( tzEvents *pEvents,
+                                uint32_t slot,
+                                uint64_t now );
+static void event_fnArm( tzEvents *pEvents, uint64_t now );
+static void event_fnSetTimer( tzEvents *pEvents, uint64_t tick );
+static uint64_t event_fnNow( tzEvents *pEvents );
+static void event_fnLink( tzEvents *pEvents, uint32_t id );
+static void event_fnUnlink( tzEvents *pEvents, uint32_t id );
+static int event_fnGrowTimers( tzEvents *pEvents, uint32_t id );
+static tzEventHandler *event_fnFindHandler( tzEventHandler *pHandlers,
+                                            size_t numHandlers,
+                                            int signum,
+                                            int id );
+static int event_fnGrowHandlers( tzEvents *pEvents );
+static int event_fnPush( tzEvents *pEvents, int signum, int id );
+static bool event_fnPop( tzEvents *pEvents, tzEvent *pEvent );
+static bool event_fnReady( tzEvents *pEvents );
+static size_t event_fnQueued( tzEvents *pEvents );
+static void event_fnFilter( tzEvents *pEvents );
+static size_t event_fnCount( tzEvents *pEvents );
+
+/*==============================================================================
+        Public function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  EVENT_fnInit                                                              */
+/*!
+    Initialize the event backend
+
+    The EVENT_fnInit function creates the epoll instance of the event
+    backend of a VM instance, the timerfd of its timer wheel and the
+    eventfd used to wake the program when an event is posted.
+    No signals are registered until they are used by the program.
+
+    @param[in]
+        pEvents
+            pointer to the event backend to initialize
+
+    @retval EOK the event backend was initialized
+    @retval EINVAL invalid arguments
+    @retval other the epoll instance, timerfd or eventfd could not be
+            created
+
+==============================================================================*/
+int EVENT_fnInit( tzEvents *pEvents )
+{
+    struct epoll_event ev;
+    struct epoll_event post;
+    struct timespec ts;
+    unsigned int i;
+    int result = EINVAL;
+
+    if( pEvents != NULL )
+    {
+        memset( pEvents, 0, sizeof( tzEvents ) );
+        pEvents->sigfd = -1;
+
+        /* each slot of the ready queue is free for the producer which
+           claims its position */
+        for( i = 0; i < EVENT_QUEUE_SIZE; i++ )
+        {
+            atomic_init( &pEvents->queue[i].seq, i );
+        }
+
+        atomic_init( &pEvents->tail, 0 );
+        atomic_init( &pEvents->overflow, 0 );
+        atomic_init( &pEvents->posted, false );
+
+        /* ticks are counted from the creation of the event backend */
+        clock_gettime( CLOCK_MONOTONIC, &ts );
+        pEvents->base = ( (uint64_t)ts.tv_sec * 1000 ) +
+                        ( ts.tv_nsec / 1000000L );
+
+        pEvents->epfd = epoll_create1( EPOLL_CLOEXEC );
+        pEvents->timerfd = timerfd_create( CLOCK_MONOTONIC,
+                                           TFD_NONBLOCK | TFD_CLOEXEC );
+        pEvents->postfd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+
+        ev.events = EPOLLIN;
+        ev.data.u64 = EVENT_TIMERS;
+
+        post.events = EPOLLIN;
+        post.data.u64 = EVENT_POSTED;
+
+        if( ( pEvents->epfd == -1 ) ||
+            ( pEvents->timerfd == -1 ) ||
+            ( pEvents->postfd == -1 ) ||
+            ( epoll_ctl( pEvents->epfd,
+                         EPOLL_CTL_ADD,
+                         pEvents->timerfd,
+                         &ev ) == -1 ) ||
+            ( epoll_ctl( pEvents->epfd,
+                         EPOLL_CTL_ADD,
+                         pEvents->postfd,
+                         &post ) == -1 ) )
+        {
+            result = errno;
+            EVENT_fnDestroy( pEvents );
+        }
+        else
+        {
+            result = EOK;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnDestroy                                                           */
+/*!
+    Destroy the event backend
+
+    The EVENT_fnDestroy function releases the program timers and signal
+    handlers, and closes the timerfd, the posted event eventfd, the
+    notification signalfd and the epoll instance of the event backend.
+    No events may be posted to the event backend once it is destroyed.
+
+    @param[in]
+        pEvents
+            pointer to the event backend to destroy
+
+==============================================================================*/
+void EVENT_fnDestroy( tzEvents *pEvents )
+{
+    if( pEvents != NULL )
+    {
+        free( pEvents->pTimers );
+        pEvents->pTimers = NULL;
+        pEvents->numTimers = 0;
+
+        free( pEvents->pHandlers );
+        pEvents->pHandlers = NULL;
+        pEvents->numHandlers = 0;
+        pEvents->usedHandlers = 0;
+
+        if( pEvents->timerfd != -1 )
+        {
+            close( pEvents->timerfd );
+            pEvents->timerfd = -1;
+        }
+
+        if( pEvents->postfd != -1 )
+        {
+            close( pEvents->postfd );
+            pEvents->postfd = -1;
+        }
+
+        if( pEvents->sigfd != -1 )
+        {
+            close( pEvents->sigfd );
+            pEvents->sigfd = -1;
+        }
+
+        if( pEvents->epfd != -1 )
+        {
+            close( pEvents->epfd );
+            pEvents->epfd = -1;
+        }
+
+        memset( pEvents->wheel, 0, sizeof( pEvents->wheel ) );
+        pEvents->expiredHead = 0;
+        pEvents->expiredTail = 0;
+        pEvents->expired = 0;
+    }
+}
+
+/*============================================================================*/
+/*  EVENT_fnStartTimer                                                        */
+/*!
+    Start a program timer
+
+    The EVENT_fnStartTimer function starts the specified program timer
+    to expire once, or periodically, after the specified interval.
+    A timer which is already running is restarted with the new interval,
+    and an interval of zero stops the timer.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        id
+            timer identifier [1 .. EVENT_MAX_TIMERS-1]
+
+    @param[in]
+        intervalMS
+            timer interval in milliseconds
+
+    @param[in]
+        periodic
+            true to restart the timer each time it expires
+
+    @retval EOK the timer was started
+    @retval EINVAL invalid timer identifier
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+int EVENT_fnStartTimer( tzEvents *pEvents,
+                        uint32_t id,
+                        uint32_t intervalMS,
+                        bool periodic )
+{
+    tzEventTimer *pTimer;
+    uint32_t ticks;
+    uint64_t now;
+    int result = EINVAL;
+
+    if( ( pEvents != NULL ) && ( id > 0 ) && ( id < EVENT_MAX_TIMERS ) )
+    {
+        result = event_fnGrowTimers( pEvents, id );
+        if( result == EOK )
+        {
+            pTimer = &pEvents->pTimers[id];
+            if( pTimer->active == true )
+            {
+                event_fnUnlink( pEvents, id );
+            }
+
+            if( intervalMS > 0 )
+            {
+                ticks = ( intervalMS + EVENT_TICK_MS - 1 ) / EVENT_TICK_MS;
+                now = event_fnNow( pEvents );
+
+                pTimer->expiry = now + ticks;
+                pTimer->interval = periodic ? ticks : 0;
+                event_fnLink( pEvents, id );
+
+                if( ( pEvents->armed == 0 ) ||
+                    ( pTimer->expiry < pEvents->armed ) )
+                {
+                    event_fnSetTimer( pEvents, pTimer->expiry );
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnStopTimer                                                         */
+/*!
+    Stop a program timer
+
+    The EVENT_fnStopTimer function removes the specified program timer
+    from the timer wheel.  An expiration which has already occurred is
+    still delivered.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        id
+            timer identifier [1 .. EVENT_MAX_TIMERS-1]
+
+    @retval EOK the timer was stopped
+    @retval EINVAL invalid timer identifier
+
+==============================================================================*/
+int EVENT_fnStopTimer( tzEvents *pEvents, uint32_t id )
+{
+    int result = EINVAL;
+
+    if( ( pEvents != NULL ) && ( id > 0 ) && ( id < EVENT_MAX_TIMERS ) )
+    {
+        if( ( id < pEvents->numTimers ) &&
+            ( pEvents->pTimers[id].active == true ) )
+        {
+            /* the timerfd is left armed, and is re-armed for the next
+               occupied slot when it expires */
+            event_fnUnlink( pEvents, id );
+        }
+
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnEnableSignals                                                     */
+/*!
+    Receive the external variable notification signals
+
+    The EVENT_fnEnableSignals function blocks the external variable
+    notification signals [SIGRTMIN+6 .. SIGRTMIN+9] in the calling
+    thread, and registers a signalfd for them with the epoll instance.
+    It is called when the program first requests a notification, and
+    does nothing if the signals are already enabled.
+
+    Threads which do not wait for the signals must also block them,
+    so they are received through the signalfd.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval EOK the notification signals are enabled
+    @retval EINVAL invalid arguments
+    @retval other the signalfd could not be created
+
+==============================================================================*/
+int EVENT_fnEnableSignals( tzEvents *pEvents )
+{
+    struct epoll_event ev;
+    sigset_t mask;
+    int sig;
+    int fd;
+    int result = EINVAL;
+
+    if( pEvents != NULL )
+    {
+        result = EOK;
+
+        if( pEvents->sigfd == -1 )
+        {
+            sigemptyset( &mask );
+            for( sig = EVENT_SIG_FIRST; sig <= EVENT_SIG_LAST; sig++ )
+            {
+                sigaddset( &mask, sig );
+            }
+
+            pthread_sigmask( SIG_BLOCK, &mask, NULL );
+
+            fd = signalfd( -1, &mask, SFD_NONBLOCK | SFD_CLOEXEC );
+            if( fd != -1 )
+            {
+                ev.events = EPOLLIN;
+                ev.data.u64 = EVENT_SIGNALS;
+                if( epoll_ctl( pEvents->epfd, EPOLL_CTL_ADD, fd, &ev ) == 0 )
+                {
+                    pEvents->sigfd = fd;
+                    pEvents->synced = UINT64_MAX;
+                }
+                else
+                {
+                    result = errno;
+                    close( fd );
+                }
+            }
+            else
+            {
+                result = errno;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnWait                                                              */
+/*!
+    Wait for an event
+
+    The EVENT_fnWait function takes the next received or posted signal
+    from the ready queue, or the next timer from the expired list.
+    If both are empty, the expired timers and received signals are
+    collected first.  It must only be called by the thread running the
+    program.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        block
+            true to wait until an event is received, false to return
+            immediately if no event is ready
+
+    @param[out]
+        signum
+            pointer to the location to store the received signal number
+
+    @param[out]
+        id
+            pointer to the location to store the received signal id
+
+    @retval EOK an event was received
+    @retval EAGAIN no event is ready
+    @retval EINVAL invalid arguments
+    @retval other the events could not be read
+
+==============================================================================*/
+int EVENT_fnWait( tzEvents *pEvents, bool block, int *signum, int *id )
+{
+    tzEvent event;
+    tzEventTimer *pTimer;
+    int result = EINVAL;
+
+    if( ( pEvents != NULL ) && ( signum != NULL ) && ( id != NULL ) )
+    {
+        result = EOK;
+
+        if( ( event_fnReady( pEvents ) == false ) &&
+            ( pEvents->expiredHead == 0 ) )
+        {
+            result = event_fnPoll( pEvents, block ? -1 : 0 );
+            while( ( result == EOK ) &&
+                   ( block == true ) &&
+                   ( event_fnReady( pEvents ) == false ) &&
+                   ( pEvents->expiredHead == 0 ) )
+            {
+                /* the ready descriptors had no events to deliver */
+                result = event_fnPoll( pEvents, -1 );
+            }
+        }
+
+        if( result == EOK )
+        {
+            if( event_fnPop( pEvents, &event ) == true )
+            {
+                *signum = event.signum;
+                *id = event.id;
+            }
+            else if( pEvents->expiredHead != 0 )
+            {
+                *signum = EVENT_SIG_TIMER;
+                *id = pEvents->expiredHead;
+
+                pTimer = &pEvents->pTimers[pEvents->expiredHead];
+                pEvents->expiredHead = pTimer->nextExpired;
+                if( pEvents->expiredHead == 0 )
+                {
+                    pEvents->expiredTail = 0;
+                }
+
+                pTimer->nextExpired = 0;
+                pTimer->pending = false;
+                pEvents->expired--;
+            }
+            else
+            {
+                result = EAGAIN;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnGetFd                                                             */
+/*!
+    Get the file descriptor of the event backend
+
+    The EVENT_fnGetFd function gets the epoll file descriptor of the
+    event backend.  It becomes readable when a timer has expired or
+    a notification signal has been received.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval epoll file descriptor
+    @retval -1 invalid arguments
+
+==============================================================================*/
+int EVENT_fnGetFd( tzEvents *pEvents )
+{
+    return ( pEvents != NULL ) ? pEvents->epfd : -1;
+}
+
+/*============================================================================*/
+/*  EVENT_fnPending                                                           */
+/*!
+    Get the number of queued events
+
+    The EVENT_fnPending function collects the expired timers and received
+    signals without blocking, and gets the number of events which can be
+    received by EVENT_fnWait without waiting.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval number of queued events
+
+==============================================================================*/
+size_t EVENT_fnPending( tzEvents *pEvents )
+{
+    size_t result = 0;
+
+    if( pEvents != NULL )
+    {
+        (void)event_fnPoll( pEvents, 0 );
+        event_fnFilter( pEvents );
+        result = event_fnCount( pEvents ) + pEvents->expired;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnSync                                                              */
+/*!
+    Pass the newly queued signals to the filter
+
+    The EVENT_fnSync function passes the signals posted since it was
+    last called to the filter function, without waiting and without a
+    system call.  If the event backend has its own signalfd, it is read
+    at most once per tick, so the filter sees a received signal within
+    one tick.  It must only be called by the thread running the program.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+==============================================================================*/
+void EVENT_fnSync( tzEvents *pEvents )
+{
+    uint64_t now;
+
+    if( pEvents != NULL )
+    {
+        if( pEvents->sigfd != -1 )
+        {
+            now = event_fnNow( pEvents );
+            if( now != pEvents->synced )
+            {
+                pEvents->synced = now;
+                event_fnReadSignals( pEvents );
+            }
+        }
+
+        event_fnFilter( pEvents );
+    }
+}
+
+/*============================================================================*/
+/*  EVENT_fnPost                                                              */
+/*!
+    Post an event to a program
+
+    The EVENT_fnPost function adds a signal to the ready queue of the
+    event backend, to be received by the program with WFS or DSP.
+    It may be called from any thread, and does not take a lock.
+    The program is woken up if it is waiting for an event.  If the
+    ready queue is full the signal is not queued, and the overflow
+    counter of the event backend is incremented.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        signum
+            signal number (e.g. EVENT_SIG_TIMER)
+
+    @param[in]
+        id
+            signal id: the timer identifier or the notification value
+
+    @retval EOK the signal was queued
+    @retval ENOSPC the ready queue is full
+    @retval EINVAL invalid arguments
+    @retval other the program could not be woken up
+
+==============================================================================*/
+int EVENT_fnPost( tzEvents *pEvents, int signum, int id )
+{
+    uint64_t value = 1;
+    int result = EINVAL;
+
+    if( ( pEvents != NULL ) && ( signum > 0 ) )
+    {
+        result = event_fnPush( pEvents, signum, id );
+
+        /* only the first post since the program last woke up needs to
+           write the eventfd */
+        if( ( result == EOK ) &&
+            ( atomic_exchange( &pEvents->posted, true ) == false ) &&
+            ( write( pEvents->postfd, &value, sizeof( value ) ) == -1 ) )
+        {
+            result = errno;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnOverflow                                                          */
+/*!
+    Get the number of lost events
+
+    The EVENT_fnOverflow function gets the number of signals which
+    could not be added to the ready queue because it was full.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval number of lost events
+
+==============================================================================*/
+unsigned int EVENT_fnOverflow( tzEvents *pEvents )
+{
+    return ( pEvents != NULL ) ? atomic_load( &pEvents->overflow ) : 0;
+}
+
+/*============================================================================*/
+/*  EVENT_fnSetFilter                                                         */
+/*!
+    Set the received signal filter
+
+    The EVENT_fnSetFilter function sets a function which is called once
+    for each signal read from the signalfd or posted with EVENT_fnPost,
+    after it is added to the ready queue and before it can be received.
+    The signal is discarded if the function returns false.  The filter
+    is called by the thread running the program.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        pfnFilter
+            pointer to the filter function, or NULL to queue every signal
+
+    @param[in]
+        pArg
+            argument passed to the filter function
+
+==============================================================================*/
+void EVENT_fnSetFilter( tzEvents *pEvents,
+                        bool (*pfnFilter)( void *pArg, int signum, int id ),
+                        void *pArg )
+{
+    if( pEvents != NULL )
+    {
+        pEvents->pfnFilter = pfnFilter;
+        pEvents->pFilterArg = pArg;
+    }
+}
+
+/*============================================================================*/
+/*  EVENT_fnSetHandler                                                        */
+/*!
+    Set the handler of a signal
+
+    The EVENT_fnSetHandler function sets the program address which
+    handles the specified signal number and signal id.  A signal id of 0
+    sets the handler for every id of the signal number which does not
+    have its own handler, and a handler address of 0 removes the handler.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        signum
+            signal number
+
+    @param[in]
+        id
+            signal id, or 0 for every id of the signal number
+
+    @param[in]
+        address
+            program address of the handler, or 0 to remove the handler
+
+    @retval EOK the handler was set
+    @retval EINVAL invalid arguments
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+int EVENT_fnSetHandler( tzEvents *pEvents,
+                        int signum,
+                        int id,
+                        uint32_t address )
+{
+    tzEventHandler *pHandler;
+    int result = EINVAL;
+
+    if( ( pEvents != NULL ) && ( signum > 0 ) )
+    {
+        result = EOK;
+
+        /* keep the table at most three quarters full */
+        if( ( pEvents->usedHandlers + 1 ) * 4 > pEvents->numHandlers * 3 )
+        {
+            result = event_fnGrowHandlers( pEvents );
+        }
+
+        if( result == EOK )
+        {
+            pHandler = event_fnFindHandler( pEvents->pHandlers,
+                                            pEvents->numHandlers,
+                                            signum,
+                                            id );
+            if( pHandler->signum == 0 )
+            {
+                pHandler->signum = signum;
+                pHandler->id = id;
+                pEvents->usedHandlers++;
+            }
+
+            pHandler->address = address;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EVENT_fnGetHandler                                                        */
+/*!
+    Get the handler of a signal
+
+    The EVENT_fnGetHandler function gets the program address which
+    handles the specified signal number and signal id.  The handler set
+    for the signal id is used in preference to the handler set for every
+    id of the signal number.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        signum
+            signal number
+
+    @param[in]
+        id
+            signal id
+
+    @param[out]
+        pAddress
+            pointer to the location to store the handler address
+
+    @retval EOK the signal has a handler
+    @retval ENOENT the signal does not have a handler
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int EVENT_fnGetHandler( tzEvents *pEvents,
+                        int signum,
+                        int id,
+                        uint32_t *pAddress )
+{
+    tzEventHandler *pHandler;
+    int result = EINVAL;
+
+    if( ( pEvents != NULL ) && ( pAddress != NULL ) )
+    {
+        result = ENOENT;
+
+        if( pEvents->usedHandlers > 0 )
+        {
+            pHandler = event_fnFindHandler( pEvents->pHandlers,
+                                            pEvents->numHandlers,
+                                            signum,
+                                            id );
+            if( ( pHandler->address == 0 ) && ( id != 0 ) )
+            {
+                /* fall back to the handler for every signal id */
+                pHandler = event_fnFindHandler( pEvents->pHandlers,
+                                                pEvents->numHandlers,
+                                                signum,
+                                                0 );
+            }
+
+            if( pHandler->address != 0 )
+            {
+                *pAddress = pHandler->address;
+                result = EOK;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*==============================================================================
+        Private function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  event_fnPoll                                                              */
+/*!
+    Collect the ready events
+
+    The event_fnPoll function waits for the timer wheel timerfd and the
+    notification signalfd to become ready.  Expired timers are moved to
+    the expired list, and received signals are read into the ready
+    queue.  Signals which do not fit in the ready queue are left to be
+    read by a later call.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        timeout
+            maximum time to wait in milliseconds, 0 to return immediately,
+            or -1 to wait until an event is ready
+
+    @retval EOK the ready events were collected
+    @retval other the epoll instance could not be waited on
+
+==============================================================================*/
+static int event_fnPoll( tzEvents *pEvents, int timeout )
+{
+    struct epoll_event evs[EVENT_NUM_FDS];
+    uint64_t value;
+    int n;
+    int i;
+    int result = EOK;
+
+    do
+    {
+        n = epoll_wait( pEvents->epfd, evs, EVENT_NUM_FDS, timeout );
+    } while( ( n == -1 ) && ( errno == EINTR ) );
+
+    if( n == -1 )
+    {
+        result = errno;
+    }
+
+    for( i = 0; i < n; i++ )
+    {
+        if( evs[i].data.u64 == EVENT_SIGNALS )
+        {
+            event_fnReadSignals( pEvents );
+        }
+        else if( evs[i].data.u64 == EVENT_POSTED )
+        {
+            /* the posted events are already in the ready queue.
+               The next post after this must wake the program again */
+            (void)read( pEvents->postfd, &value, sizeof( value ) );
+            (void)atomic_exchange( &pEvents->posted, false );
+        }
+        else
+        {
+            event_fnExpire( pEvents );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  event_fnReadSignals                                                       */
+/*!
+    Read the received notification signals
+
+    The event_fnReadSignals function drains the received notification
+    signals from the signalfd into the ready queue, reading up to
+    EVENT_READ_BATCH signals with each read, until there are no more
+    signals or the ready queue is full.  Each batch is passed to the
+    filter function, so the discarded signals do not take up the ready
+    queue.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+==============================================================================*/
+static void event_fnReadSignals( tzEvents *pEvents )
+{
+    struct signalfd_siginfo info[EVENT_READ_BATCH];
+    size_t space;
+    ssize_t rc;
+    size_t n;
+    size_t i;
+
+    do
+    {
+        space = EVENT_QUEUE_SIZE - event_fnQueued( pEvents );
+        n = ( space < EVENT_READ_BATCH ) ? space : EVENT_READ_BATCH;
+        rc = ( n > 0 ) ? read( pEvents->sigfd, info, n * sizeof( info[0] ) )
+                       : 0;
+
+        /* the signalfd only returns whole signals */
+        n = ( rc > 0 ) ? (size_t)rc / sizeof( info[0] ) : 0;
+        for( i = 0; i < n; i++ )
+        {
+            /* a concurrent post may have taken the space, in which case
+               the signal is counted as an overflow */
+            (void)event_fnPush( pEvents, info[i].ssi_signo, info[i].ssi_int );
+        }
+
+        event_fnFilter( pEvents );
+    } while( n == EVENT_READ_BATCH );
+}
+
+/*============================================================================*/
+/*  event_fnExpire                                                            */
+/*!
+    Advance the timer wheel
+
+    The event_fnExpire function acknowledges the timer wheel timerfd,
+    expires the timers in each wheel slot from the last processed tick
+    up to the current tick, and re-arms the timerfd for the next
+    occupied slot.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+==============================================================================*/
+static void event_fnExpire( tzEvents *pEvents )
+{
+    uint64_t expirations;
+    uint64_t now;
+    uint64_t n;
+    uint64_t i;
+
+    if( read( pEvents->timerfd, &expirations, sizeof( expirations ) ) == -1 )
+    {
+        /* the timerfd was re-armed before it was read */
+        expirations = 0;
+    }
+
+    now = event_fnNow( pEvents );
+
+    /* every slot is visited at most once, however long ago the wheel
+       was last processed */
+    n = now - pEvents->tick;
+    if( n > EVENT_WHEEL_SIZE )
+    {
+        n = EVENT_WHEEL_SIZE;
+    }
+
+    for( i = 1; i <= n; i++ )
+    {
+        event_fnExpireSlot( pEvents, EVENT_SLOT( pEvents->tick + i ), now );
+    }
+
+    pEvents->tick = now;
+    event_fnArm( pEvents, now );
+}
+
+/*============================================================================*/
+/*  event_fnExpireSlot                                                        */
+/*!
+    Expire the timers of a wheel slot
+
+    The event_fnExpireSlot function moves each timer in the wheel slot
+    which has expired to the expired list, unless it is already there.
+    Periodic timers are returned to the wheel at their next expiry,
+    skipping any periods which were missed.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        slot
+            index of the wheel slot
+
+    @param[in]
+        now
+            current tick
+
+==============================================================================*/
+static void event_fnExpireSlot( tzEvents *pEvents,
+                                uint32_t slot,
+                                uint64_t now )
+{
+    tzEventTimer *pTimer;
+    uint32_t id;
+    uint32_t next;
+
+    for( id = pEvents->wheel[slot]; id != 0; id = next )
+    {
+        pTimer = &pEvents->pTimers[id];
+        next = pTimer->next;
+
+        if( pTimer->expiry <= now )
+        {
+            event_fnUnlink( pEvents, id );
+
+            if( pTimer->pending == false )
+            {
+                pTimer->pending = true;
+                pTimer->nextExpired = 0;
+                if( pEvents->expiredTail == 0 )
+                {
+                    pEvents->expiredHead = id;
+                }
+                else
+                {
+                    pEvents->pTimers[pEvents->expiredTail].nextExpired = id;
+                }
+
+                pEvents->expiredTail = id;
+                pEvents->expired++;
+            }
+
+            if( pTimer->interval > 0 )
+            {
+                pTimer->expiry += ( ( ( now - pTimer->expiry ) /
+                                      pTimer->interval ) + 1 ) *
+                                  pTimer->interval;
+
+                /* a timer returned to this slot is linked ahead of
+                   next, so it is not visited again */
+                event_fnLink( pEvents, id );
+            }
+        }
+    }
+}
+
+/*============================================================================*/
+/*  event_fnArm                                                               */
+/*!
+    Arm the timerfd for the next occupied wheel slot
+
+    The event_fnArm function searches the timer wheel for the first
+    occupied slot after the current tick, and arms the timerfd to
+    expire at that tick.  The timerfd is disarmed if no timers are
+    running.  A slot may only contain timers for a later revolution of
+    the wheel, in which case the timerfd expires without expiring any
+    timers, and is re-armed.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        now
+            current tick
+
+==============================================================================*/
+static void event_fnArm( tzEvents *pEvents, uint64_t now )
+{
+    uint64_t tick = 0;
+    uint64_t i;
+
+    for( i = 1; ( tick == 0 ) && ( i <= EVENT_WHEEL_SIZE ); i++ )
+    {
+        if( pEvents->wheel[EVENT_SLOT( now + i )] != 0 )
+        {
+            tick = now + i;
+        }
+    }
+
+    event_fnSetTimer( pEvents, tick );
+}
+
+/*============================================================================*/
+/*  event_fnSetTimer                                                          */
+/*!
+    Set the timerfd expiry
+
+    The event_fnSetTimer function arms the timer wheel timerfd to expire
+    at the specified tick, or disarms it.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        tick
+            tick when the timerfd expires, or 0 to disarm it
+
+==============================================================================*/
+static void event_fnSetTimer( tzEvents *pEvents, uint64_t tick )
+{
+    struct itimerspec its;
+    uint64_t ms;
+
+    memset( &its, 0, sizeof( its ) );
+    if( tick != 0 )
+    {
+        ms = pEvents->base + ( tick * EVENT_TICK_MS );
+        its.it_value.tv_sec = ms / 1000;
+        its.it_value.tv_nsec = ( ms % 1000 ) * 1000000L;
+    }
+
+    timerfd_settime( pEvents->timerfd, TFD_TIMER_ABSTIME, &its, NULL );
+    pEvents->armed = tick;
+}
+
+/*============================================================================*/
+/*  event_fnNow                                                               */
+/*!
+    Get the current tick
+
+    The event_fnNow function gets the number of ticks of the monotonic
+    clock since the event backend was initialized.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval current tick
+
+==============================================================================*/
+static uint64_t event_fnNow( tzEvents *pEvents )
+{
+    struct timespec ts;
+    uint64_t ms;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    ms = ( (uint64_t)ts.tv_sec * 1000 ) + ( ts.tv_nsec / 1000000L );
+
+    return ( ms - pEvents->base ) / EVENT_TICK_MS;
+}
+
+/*============================================================================*/
+/*  event_fnLink                                                              */
+/*!
+    Add a timer to the timer wheel
+
+    The event_fnLink function adds a timer to the head of the wheel slot
+    of its expiry tick.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        id
+            timer identifier
+
+==============================================================================*/
+static void event_fnLink( tzEvents *pEvents, uint32_t id )
+{
+    tzEventTimer *pTimer = &pEvents->pTimers[id];
+    uint32_t *pSlot = &pEvents->wheel[EVENT_SLOT( pTimer->expiry )];
+
+    pTimer->prev = 0;
+    pTimer->next = *pSlot;
+    if( *pSlot != 0 )
+    {
+        pEvents->pTimers[*pSlot].prev = id;
+    }
+
+    *pSlot = id;
+    pTimer->active = true;
+}
+
+/*============================================================================*/
+/*  event_fnUnlink                                                            */
+/*!
+    Remove a timer from the timer wheel
+
+    The event_fnUnlink function removes a timer from its wheel slot.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        id
+            timer identifier
+
+==============================================================================*/
+static void event_fnUnlink( tzEvents *pEvents, uint32_t id )
+{
+    tzEventTimer *pTimer = &pEvents->pTimers[id];
+
+    if( pTimer->prev != 0 )
+    {
+        pEvents->pTimers[pTimer->prev].next = pTimer->next;
+    }
+    else
+    {
+        pEvents->wheel[EVENT_SLOT( pTimer->expiry )] = pTimer->next;
+    }
+
+    if( pTimer->next != 0 )
+    {
+        pEvents->pTimers[pTimer->next].prev = pTimer->prev;
+    }
+
+    pTimer->next = 0;
+    pTimer->prev = 0;
+    pTimer->active = false;
+}
+
+/*============================================================================*/
+/*  event_fnGrowTimers                                                        */
+/*!
+    Make space for a timer in the timer array
+
+    The event_fnGrowTimers function enlarges the timer array so it
+    contains an entry for the specified timer identifier.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        id
+            timer identifier
+
+    @retval EOK the timer array contains the timer identifier
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int event_fnGrowTimers( tzEvents *pEvents, uint32_t id )
+{
+    tzEventTimer *pTimers;
+    size_t n;
+    int result = EOK;
+
+    if( id >= pEvents->numTimers )
+    {
+        n = ( pEvents->numTimers < EVENT_MIN_TIMERS )
+            ? EVENT_MIN_TIMERS
+            : pEvents->numTimers * 2;
+        while( n <= id )
+        {
+            n *= 2;
+        }
+
+        pTimers = realloc( pEvents->pTimers, n * sizeof( tzEventTimer ) );
+        if( pTimers != NULL )
+        {
+            memset( &pTimers[pEvents->numTimers],
+                    0,
+                    ( n - pEvents->numTimers ) * sizeof( tzEventTimer ) );
+
+            pEvents->pTimers = pTimers;
+            pEvents->numTimers = n;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  event_fnFindHandler                                                       */
+/*!
+    Find a signal handler table entry
+
+    The event_fnFindHandler function finds the entry of the specified
+    signal number and signal id in the signal handler table using linear
+    probing.  The table must contain at least one unused entry.
+
+    @param[in]
+        pHandlers
+            pointer to the signal handler table
+
+    @param[in]
+        numHandlers
+            number of entries in the table, which is a power of 2
+
+    @param[in]
+        signum
+            signal number
+
+    @param[in]
+        id
+            signal id
+
+    @retval pointer to the matching entry, or to the unused entry where
+            it would be inserted
+
+==============================================================================*/
+static tzEventHandler *event_fnFindHandler( tzEventHandler *pHandlers,
+                                            size_t numHandlers,
+                                            int signum,
+                                            int id )
+{
+    tzEventHandler *pHandler;
+    uint32_t hash;
+    size_t i;
+
+    hash = ( (uint32_t)signum * 0x9E3779B1U ) ^
+           ( (uint32_t)id * 0x85EBCA77U );
+    hash ^= hash >> 16;
+    i = hash & ( numHandlers - 1 );
+
+    pHandler = &pHandlers[i];
+    while( ( pHandler->signum != 0 ) &&
+           ( ( pHandler->signum != signum ) || ( pHandler->id != id ) ) )
+    {
+        i = ( i + 1 ) & ( numHandlers - 1 );
+        pHandler = &pHandlers[i];
+    }
+
+    return pHandler;
+}
+
+/*============================================================================*/
+/*  event_fnGrowHandlers                                                      */
+/*!
+    Enlarge the signal handler table
+
+    The event_fnGrowHandlers function doubles the size of the signal
+    handler table and re-inserts its entries.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval EOK the signal handler table was enlarged
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int event_fnGrowHandlers( tzEvents *pEvents )
+{
+    tzEventHandler *pHandlers;
+    tzEventHandler *pOld;
+    size_t n;
+    size_t i;
+    int result = ENOMEM;
+
+    n = ( pEvents->numHandlers < EVENT_MIN_HANDLERS )
+        ? EVENT_MIN_HANDLERS
+        : pEvents->numHandlers * 2;
+
+    pHandlers = calloc( n, sizeof( tzEventHandler ) );
+    if( pHandlers != NULL )
+    {
+        for( i = 0; i < pEvents->numHandlers; i++ )
+        {
+            pOld = &pEvents->pHandlers[i];
+            if( pOld->signum != 0 )
+            {
+                *event_fnFindHandler( pHandlers,
+                                      n,
+                                      pOld->signum,
+                                      pOld->id ) = *pOld;
+            }
+        }
+
+        free( pEvents->pHandlers );
+        pEvents->pHandlers = pHandlers;
+        pEvents->numHandlers = n;
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  event_fnPush                                                              */
+/*!
+    Add a signal to the ready queue
+
+    The event_fnPush function claims the next position of the ready
+    queue by advancing its tail, writes the signal into the slot, and
+    then publishes it by advancing the sequence number of the slot.
+    Producers only contend on the tail, and a producer which is
+    interrupted after claiming a slot does not block the others.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[in]
+        signum
+            signal number
+
+    @param[in]
+        id
+            signal id
+
+    @retval EOK the signal was queued
+    @retval ENOSPC the ready queue is full
+
+==============================================================================*/
+static int event_fnPush( tzEvents *pEvents, int signum, int id )
+{
+    tzEventSlot *pSlot = NULL;
+    unsigned int pos;
+    unsigned int seq;
+    int diff;
+    int result = EOK;
+
+    pos = atomic_load_explicit( &pEvents->tail, memory_order_relaxed );
+    while( ( pSlot == NULL ) && ( result == EOK ) )
+    {
+        pSlot = &pEvents->queue[pos & ( EVENT_QUEUE_SIZE - 1 )];
+        seq = atomic_load_explicit( &pSlot->seq, memory_order_acquire );
+        diff = (int)( seq - pos );
+
+        if( diff == 0 )
+        {
+            /* the slot is free: try to claim its position */
+            if( atomic_compare_exchange_weak_explicit(
+                        &pEvents->tail,
+                        &pos,
+                        pos + 1,
+                        memory_order_relaxed,
+                        memory_order_relaxed ) == false )
+            {
+                pSlot = NULL;
+            }
+        }
+        else if( diff < 0 )
+        {
+            /* the slot still holds the event from the previous lap */
+            atomic_fetch_add( &pEvents->overflow, 1 );
+            pSlot = NULL;
+            result = ENOSPC;
+        }
+        else
+        {
+            /* another producer claimed the position */
+            pos = atomic_load_explicit( &pEvents->tail,
+                                        memory_order_relaxed );
+            pSlot = NULL;
+        }
+    }
+
+    if( result == EOK )
+    {
+        pSlot->event.signum = signum;
+        pSlot->event.id = id;
+        atomic_store_explicit( &pSlot->seq, pos + 1, memory_order_release );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  event_fnPop                                                               */
+/*!
+    Take a signal from the ready queue
+
+    The event_fnPop function takes the signal at the head of the ready
+    queue once its producer has published it and it has passed the
+    filter, and frees its slot for the next lap of the ring.  It must
+    only be called by the thread running the program.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @param[out]
+        pEvent
+            pointer to the location to store the signal
+
+    @retval true a signal was taken from the ready queue
+    @retval false no signal is ready
+
+==============================================================================*/
+static bool event_fnPop( tzEvents *pEvents, tzEvent *pEvent )
+{
+    tzEventSlot *pSlot;
+    bool result = false;
+
+    if( event_fnReady( pEvents ) == true )
+    {
+        pSlot = &pEvents->queue[pEvents->head & ( EVENT_QUEUE_SIZE - 1 )];
+        *pEvent = pSlot->event;
+
+        atomic_store_explicit( &pSlot->seq,
+                               pEvents->head + EVENT_QUEUE_SIZE,
+                               memory_order_release );
+        pEvents->head++;
+        result = true;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  event_fnReady                                                             */
+/*!
+    Check for a signal at the head of the ready queue
+
+    The event_fnReady function passes the newly published signals to
+    the filter, and checks if the signal at the head of the ready queue
+    has been filtered.  A signal published after the filter has run is
+    left in the ready queue until the next call, so every signal taken
+    from the ready queue has been seen by the filter.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval true a signal can be taken from the ready queue
+    @retval false no signal is ready
+
+==============================================================================*/
+static bool event_fnReady( tzEvents *pEvents )
+{
+    /* the filter frees the discarded signals at the head of the ready
+       queue, so any filtered signal left there was accepted */
+    event_fnFilter( pEvents );
+
+    return pEvents->head != pEvents->filtered;
+}
+
+/*============================================================================*/
+/*  event_fnQueued                                                            */
+/*!
+    Get the number of signals in the ready queue
+
+    The event_fnQueued function gets the number of positions of the
+    ready queue which have been claimed by producers and not yet taken
+    by the program.  Signals still being written by their producer are
+    included.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval number of signals in the ready queue
+
+==============================================================================*/
+static size_t event_fnQueued( tzEvents *pEvents )
+{
+    unsigned int tail;
+
+    tail = atomic_load_explicit( &pEvents->tail, memory_order_acquire );
+
+    return (size_t)( tail - pEvents->head );
+}
+
+/*============================================================================*/
+/*  event_fnFilter                                                            */
+/*!
+    Filter the newly published signals
+
+    The event_fnFilter function passes each signal published since it
+    was last called to the filter function, and marks the rejected
+    signals as discarded.  The slots of the discarded signals at the
+    head of the ready queue are freed.  Only the slot after the last
+    filtered signal is checked when nothing has been published, so it
+    is cheap enough to call on every cached external variable access.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+==============================================================================*/
+static void event_fnFilter( tzEvents *pEvents )
+{
+    tzEventSlot *pSlot;
+    unsigned int pos = pEvents->filtered;
+
+    pSlot = &pEvents->queue[pos & ( EVENT_QUEUE_SIZE - 1 )];
+    while( atomic_load_explicit( &pSlot->seq, memory_order_acquire ) ==
+           pos + 1 )
+    {
+        if( ( pEvents->pfnFilter != NULL ) &&
+            ( pEvents->pfnFilter( pEvents->pFilterArg,
+                                  pSlot->event.signum,
+                                  pSlot->event.id ) == false ) )
+        {
+            pSlot->event.signum = 0;
+        }
+
+        pos++;
+        pSlot = &pEvents->queue[pos & ( EVENT_QUEUE_SIZE - 1 )];
+    }
+
+    pEvents->filtered = pos;
+
+    pSlot = &pEvents->queue[pEvents->head & ( EVENT_QUEUE_SIZE - 1 )];
+    while( ( pEvents->head != pEvents->filtered ) &&
+           ( pSlot->event.signum == 0 ) )
+    {
+        atomic_store_explicit( &pSlot->seq,
+                               pEvents->head + EVENT_QUEUE_SIZE,
+                               memory_order_release );
+        pEvents->head++;
+        pSlot = &pEvents->queue[pEvents->head & ( EVENT_QUEUE_SIZE - 1 )];
+    }
+}
+
+/*============================================================================*/
+/*  event_fnCount                                                             */
+/*!
+    Count the signals which can be received
+
+    The event_fnCount function counts the filtered signals in the ready
+    queue which were not discarded.
+
+    @param[in]
+        pEvents
+            pointer to the event backend
+
+    @retval number of signals which can be received
+
+==============================================================================*/
+static size_t event_fnCount( tzEvents *pEvents )
+{
+    unsigned int pos;
+    size_t count = 0;
+
+    for( pos = pEvents->head; pos != pEvents->filtered; pos++ )
+    {
+        if( pEvents->queue[pos & ( EVENT_QUEUE_SIZE - 1 )].event.signum != 0 )
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*! @}
+ * end of event group */
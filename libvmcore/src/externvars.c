@@ -42,6 +42,20 @@ SOFTWARE.
         Private Definitions
 ==============================================================================*/
 
+#ifndef EOK
+/*! success response */
+#define EOK 0
+#endif
+
+/*! initial number of entries in the read-through cache table */
+#define EXTERNVAR_MIN_CACHE ( 16 )
+
+/*! initial number of values in the transaction buffer */
+#define EXTERNVAR_MIN_TX ( 16 )
+
+/*! initial number of variables in the internal external variable store */
+#define EXTERNVAR_MIN_VARS ( 16 )
+
 /*! The ExtVar object is used to represent a variable which is held
     externally to the Virtual Machine */
 struct ExtVar
@@ -64,8 +78,30 @@ struct ExtVar
     /*! length of the external variable */
 	size_t len;
 
-    /*! pointer to the next external variable in the Virtual Machine */
-	struct ExtVar *pNext;
+    /*! hash of the external variable name */
+    uint32_t hash;
+};
+
+/*! The ExtVarList object holds the external variables of the internal
+    external variable implementation for one VM instance.  The variables
+    are stored in an array indexed by their handle, and are found by name
+    through an open addressed hash table of their handles */
+struct ExtVarList
+{
+    /*! array of external variables, where pVars[i] has handle i+1 */
+    struct ExtVar *pVars;
+
+    /*! number of external variables, which is also the last handle */
+    uint32_t numVars;
+
+    /*! capacity of the external variable array */
+    uint32_t maxVars;
+
+    /*! name hash table of external variable handles (0=unused) */
+    uint32_t *pIndex;
+
+    /*! number of entries in the name hash table (a power of 2) */
+    size_t indexSize;
 };
 
 /*==============================================================================
@@ -82,6 +118,35 @@ static char *extvar_fnGetString( void *pExt, uint32_t handle );
 static struct ExtVar *extvar_fnFindByName( void *pExt, char *name );
 static struct ExtVar *extvar_fnFindByHandle( void *pExt, uint32_t handle );
 static uint32_t extvar_fnNew( void *pExt, char *name );
+static uint32_t extvar_fnHash( char *name );
+static uint32_t *extvar_fnFindIndex( struct ExtVarList *pList,
+                                     char *name,
+                                     uint32_t hash );
+static int extvar_fnGrowIndex( struct ExtVarList *pList );
+static int extvar_fnGetMany( void *pExt, tzExternValue *pValues, size_t n );
+static int extvar_fnSetMany( void *pExt, tzExternValue *pValues, size_t n );
+static tzExternCacheEntry *extvar_fnFindCache( tzExternCacheEntry *pCache,
+                                               size_t cacheSize,
+                                               uint32_t handle );
+static tzExternCacheEntry *extvar_fnCacheEntry( tzExternVars *pExtVars,
+                                                uint32_t handle );
+static int extvar_fnGrowCache( tzExternVars *pExtVars );
+static uint32_t *extvar_fnFindTx( uint32_t *pIndex,
+                                  size_t indexSize,
+                                  tzExternValue *pTx,
+                                  uint32_t handle );
+static tzExternValue *extvar_fnTxGet( tzExternVars *pExtVars,
+                                      uint32_t handle,
+                                      uint32_t type );
+static tzExternValue *extvar_fnTxSet( tzExternVars *pExtVars,
+                                      uint32_t handle,
+                                      uint32_t type );
+static int extvar_fnGrowTx( tzExternVars *pExtVars );
+static int extvar_fnFlushTx( tzExternVars *pExtVars );
+static void extvar_fnDiscardTx( tzExternVars *pExtVars );
+static int extvar_fnRequest( tzExternVars *pExtVars,
+                             uint32_t handle,
+                             uint32_t request );
 
 /*==============================================================================
         File Scoped Variables
@@ -99,15 +164,12 @@ tzEXTVARAPI defaultAPI = {
         NULL,  /* extvar_fnValidateStart */
         NULL, /* extvar_fnValidateEnd */
         NULL, /* extvar_fnOpenPrintSession */
-        NULL /* extvar_fnClosePrintSession */
+        NULL, /* extvar_fnClosePrintSession */
+        extvar_fnGetMany,
+        extvar_fnSetMany,
+        NULL  /* extvar_fnGetHandles */
 };
 
-/*! default (local) API */
-static tzEXTVARAPI *API = &defaultAPI;
-
-/*! handle incremented for each created external variable */
-static uint32_t handle = 0;
-
 /*==============================================================================
         Public Function Definitions
 ==============================================================================*/
@@ -117,19 +179,39 @@ static uint32_t handle = 0;
 /*!
     Initialize the external vars API
 
-    The EXTERNVAR_Init function initializes the external vars API set
-    to the default API set as defined in this module.
+    The EXTERNVAR_Init function initializes the external vars of a VM
+    instance to use the default API set as defined in this module.
+    Each VM instance gets its own external variable list.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
 
-    @retval pointer to the initialized ExtVar object
+    @retval EOK the external variables were initialized
+    @retval ENOMEM memory allocation failure
+    @retval EINVAL invalid arguments
 
 ==============================================================================*/
-void *EXTERNVAR_Init( void )
+int EXTERNVAR_Init( tzExternVars *pExtVars )
 {
-    static struct ExtVar *pExtVars = NULL;
+    int result = EINVAL;
+    struct ExtVarList *pList;
 
-    EXTERNVAR_fnSetAPI( &defaultAPI );
+    if( pExtVars != NULL )
+    {
+        pList = calloc( 1, sizeof( struct ExtVarList ) );
+        if( pList != NULL )
+        {
+            EXTERNVAR_fnSetAPI( pExtVars, &defaultAPI, pList );
+            result = EOK;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
 
-    return &pExtVars;
+    return result;
 }
 
 /*============================================================================*/
@@ -138,12 +220,82 @@ void *EXTERNVAR_Init( void )
     Set the external APIs
 
     The EXTERNVAR_fnSetAPI function initializes the external vars API set
-    to the specified API set
+    of a VM instance to the specified API set and its instance state
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        pEXTVARAPI
+            pointer to the external variable API set
+
+    @param[in]
+        pExt
+            opaque pointer to the instance state used by the API set
+
+==============================================================================*/
+void EXTERNVAR_fnSetAPI( tzExternVars *pExtVars,
+                         tzEXTVARAPI *pEXTVARAPI,
+                         void *pExt )
+{
+    if( pExtVars != NULL )
+    {
+        pExtVars->pAPI = pEXTVARAPI;
+        pExtVars->pExt = pExt;
+    }
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnShutdown                                                      */
+/*!
+    Release the external variables of a VM instance
+
+    The EXTERNVAR_fnShutdown function releases the external variable list
+    created by EXTERNVAR_Init, the read-through cache, and the values of
+    a transaction which was never committed.  Instance state belonging
+    to an external variable library is not touched since it is released
+    by the library.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
 
 ==============================================================================*/
-void EXTERNVAR_fnSetAPI( tzEXTVARAPI *pEXTVARAPI )
+void EXTERNVAR_fnShutdown( tzExternVars *pExtVars )
 {
-    API = pEXTVARAPI;
+    struct ExtVarList *pList;
+    uint32_t i;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI == &defaultAPI ) )
+    {
+        pList = (struct ExtVarList *)pExtVars->pExt;
+        if( pList != NULL )
+        {
+            for( i = 0; i < pList->numVars; i++ )
+            {
+                free( pList->pVars[i].name );
+                free( pList->pVars[i].sval );
+            }
+
+            free( pList->pVars );
+            free( pList->pIndex );
+            free( pList );
+        }
+    }
+
+    if( pExtVars != NULL )
+    {
+        free( pExtVars->pCache );
+        pExtVars->pCache = NULL;
+        pExtVars->cacheSize = 0;
+        pExtVars->cacheUsed = 0;
+
+        extvar_fnDiscardTx( pExtVars );
+    }
+
+    EXTERNVAR_fnSetAPI( pExtVars, NULL, NULL );
 }
 
 /*============================================================================*/
@@ -155,8 +307,8 @@ void EXTERNVAR_fnSetAPI( tzEXTVARAPI *pEXTVARAPI )
     external variable.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         name
@@ -165,17 +317,93 @@ void EXTERNVAR_fnSetAPI( tzEXTVARAPI *pEXTVARAPI )
     @retval handle to the specified variable
 
 ==============================================================================*/
-uint32_t EXTERNVAR_fnGetHandle( void *pExt, char *name )
+uint32_t EXTERNVAR_fnGetHandle( tzExternVars *pExtVars, char *name )
 {
     uint32_t handle = 0L;
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        handle = API->pfnGetHandle( pExt, name );
+        handle = pExtVars->pAPI->pfnGetHandle( pExtVars->pExt, name );
     }
 
     return handle;
 }
 
+/*============================================================================*/
+/*  EXTERNVAR_fnGetHandles                                                    */
+/*!
+    Get the handles of several external variables
+
+    The EXTERNVAR_fnGetHandles function gets the handles of an array of
+    external variable names with a single call to the external variable
+    library.  Libraries without a batched lookup have the handles looked
+    up one at a time.  The handle of a variable which cannot be found
+    is set to 0.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        ppNames
+            array of external variable names
+
+    @param[out]
+        pHandles
+            array which receives the handle of each variable
+
+    @param[in]
+        n
+            number of elements in the arrays
+
+    @retval EOK the handles of all of the variables were found
+    @retval ENOENT one or more of the variables was not found
+    @retval EINVAL invalid arguments
+    @retval other result of the ExtVar GetHandles function
+
+==============================================================================*/
+int EXTERNVAR_fnGetHandles( tzExternVars *pExtVars,
+                            char **ppNames,
+                            uint32_t *pHandles,
+                            size_t n )
+{
+    size_t i;
+    int result = EINVAL;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) &&
+        ( ( ( ppNames != NULL ) && ( pHandles != NULL ) ) || ( n == 0 ) ) )
+    {
+        if( pExtVars->pAPI->pfnGetHandles != NULL )
+        {
+            result = pExtVars->pAPI->pfnGetHandles( pExtVars->pExt,
+                                                    ppNames,
+                                                    pHandles,
+                                                    n );
+        }
+        else
+        {
+            result = EOK;
+
+            for( i = 0; i < n; i++ )
+            {
+                pHandles[i] = pExtVars->pAPI->pfnGetHandle( pExtVars->pExt,
+                                                            ppNames[i] );
+            }
+        }
+
+        for( i = 0; ( result == EOK ) && ( i < n ); i++ )
+        {
+            if( pHandles[i] == 0 )
+            {
+                result = ENOENT;
+            }
+        }
+    }
+
+    return result;
+}
+
 /*============================================================================*/
 /*  EXTERNVAR_fnNotify                                                        */
 /*!
@@ -185,8 +413,8 @@ uint32_t EXTERNVAR_fnGetHandle( void *pExt, char *name )
     specified external variable handle.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -196,20 +424,41 @@ uint32_t EXTERNVAR_fnGetHandle( void *pExt, char *name )
         request
             notification request type
 
+    When the read-through cache is enabled, a MODIFIED notification
+    which the cache has already requested is not requested again, and
+    the notifications for the variable are passed on to the program.
+
     @retval result of ExtVar Notify function
 
 ==============================================================================*/
-int EXTERNVAR_fnNotify( void *pExt, uint32_t handle, uint32_t request )
+int EXTERNVAR_fnNotify( tzExternVars *pExtVars,
+                        uint32_t handle,
+                        uint32_t request )
 {
+    tzExternCacheEntry *pEntry = NULL;
     int result = EINVAL;
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        result = ENOTSUP;
+        if( request == EXTERNVAR_NOTIFY_MODIFIED )
+        {
+            pEntry = extvar_fnCacheEntry( pExtVars, handle );
+        }
 
-        if( API->pfnNotify != NULL )
+        if( ( pEntry != NULL ) && ( pEntry->subscribed == true ) )
+        {
+            pEntry->notify = true;
+            result = EOK;
+        }
+        else
         {
-            result = API->pfnNotify( pExt, handle, request );
+            result = extvar_fnRequest( pExtVars, handle, request );
+            if( ( pEntry != NULL ) && ( result == EOK ) )
+            {
+                pEntry->subscribed = true;
+                pEntry->notify = true;
+            }
         }
     }
 
@@ -225,8 +474,8 @@ int EXTERNVAR_fnNotify( void *pExt, uint32_t handle, uint32_t request )
     validation for the specified external variable validation context.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -239,17 +488,29 @@ int EXTERNVAR_fnNotify( void *pExt, uint32_t handle, uint32_t request )
     @retval result of ExtVar ValidateStart function
 
 ==============================================================================*/
-int EXTERNVAR_fnValidateStart( void *pExt, uint32_t handle, uint32_t *hVar )
+int EXTERNVAR_fnValidateStart( tzExternVars *pExtVars,
+                               uint32_t handle,
+                               uint32_t *hVar )
 {
     int result = EINVAL;
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
         result = ENOTSUP;
 
-        if( API->pfnValidateStart != NULL )
+        if( pExtVars->pAPI->pfnValidateStart != NULL )
         {
-            result = API->pfnValidateStart( pExt, handle, hVar );
+            result = pExtVars->pAPI->pfnValidateStart( pExtVars->pExt,
+                                                       handle,
+                                                       hVar );
+            if( ( result == EOK ) && ( hVar != NULL ) )
+            {
+                /* the variable reads the value being validated until
+                   the validation ends */
+                pExtVars->validating = true;
+                pExtVars->hValidating = *hVar;
+            }
         }
     }
 
@@ -265,8 +526,8 @@ int EXTERNVAR_fnValidateStart( void *pExt, uint32_t handle, uint32_t *hVar )
     validation for the specified external variable handle.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -279,17 +540,23 @@ int EXTERNVAR_fnValidateStart( void *pExt, uint32_t handle, uint32_t *hVar )
     @retval result of ExtVar ValidateEnd function
 
 ==============================================================================*/
-int EXTERNVAR_fnValidateEnd( void *pExt, uint32_t handle, int response )
+int EXTERNVAR_fnValidateEnd( tzExternVars *pExtVars,
+                             uint32_t handle,
+                             int response )
 {
     int result = EINVAL;
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
         result = ENOTSUP;
 
-        if( API->pfnValidateEnd != NULL )
+        if( pExtVars->pAPI->pfnValidateEnd != NULL )
         {
-            result = API->pfnValidateEnd( pExt, handle, response );
+            result = pExtVars->pAPI->pfnValidateEnd( pExtVars->pExt,
+                                                     handle,
+                                                     response );
+            pExtVars->validating = false;
         }
     }
 
@@ -305,8 +572,8 @@ int EXTERNVAR_fnValidateEnd( void *pExt, uint32_t handle, int response )
     print session for the specified external variable print session context.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -323,22 +590,26 @@ int EXTERNVAR_fnValidateEnd( void *pExt, uint32_t handle, int response )
     @retval result of ExtVar OpenPrintSession function
 
 ==============================================================================*/
-int EXTERNVAR_fnOpenPrintSession( void *pExt,
+int EXTERNVAR_fnOpenPrintSession( tzExternVars *pExtVars,
                                   uint32_t handle,
                                   uint32_t *hVar,
                                   int *fd )
 {
     int result = EINVAL;
 
-    if( ( API != NULL ) &&
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) &&
         ( hVar != NULL ) &&
         ( fd != NULL ) )
     {
         result = ENOTSUP;
 
-        if( API->pfnOpenPrintSession != NULL )
+        if( pExtVars->pAPI->pfnOpenPrintSession != NULL )
         {
-            result = API->pfnOpenPrintSession( pExt, handle, hVar, fd );
+            result = pExtVars->pAPI->pfnOpenPrintSession( pExtVars->pExt,
+                                                          handle,
+                                                          hVar,
+                                                          fd );
         }
     }
 
@@ -354,8 +625,8 @@ int EXTERNVAR_fnOpenPrintSession( void *pExt,
     print session for the specified external variable print session context.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -368,17 +639,22 @@ int EXTERNVAR_fnOpenPrintSession( void *pExt,
     @retval result of ExtVar ClosePrintSession function
 
 ==============================================================================*/
-int EXTERNVAR_fnClosePrintSession( void *pExt, uint32_t handle, int fd )
+int EXTERNVAR_fnClosePrintSession( tzExternVars *pExtVars,
+                                   uint32_t handle,
+                                   int fd )
 {
     int result = EINVAL;
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
         result = ENOTSUP;
 
-        if( API->pfnClosePrintSession != NULL )
+        if( pExtVars->pAPI->pfnClosePrintSession != NULL )
         {
-            result = API->pfnClosePrintSession( pExt, handle, fd );
+            result = pExtVars->pAPI->pfnClosePrintSession( pExtVars->pExt,
+                                                           handle,
+                                                           fd );
         }
     }
 
@@ -390,11 +666,14 @@ int EXTERNVAR_fnClosePrintSession( void *pExt, uint32_t handle, int fd )
 /*!
     Set the value of an external variable
 
-    The EXTERNVAR_fnSet function sets the value of an external variable
+    The EXTERNVAR_fnSet function sets the value of an external variable.
+    The cached value of the variable is invalidated, since the external
+    variable library may reject or transform the new value.  Inside a
+    transaction the value is buffered until the transaction is committed.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -407,11 +686,23 @@ int EXTERNVAR_fnClosePrintSession( void *pExt, uint32_t handle, int fd )
     @retval result of ExtVar Set function
 
 ==============================================================================*/
-void EXTERNVAR_fnSet( void *pExt, uint32_t handle, uint32_t val )
+void EXTERNVAR_fnSet( tzExternVars *pExtVars, uint32_t handle, uint32_t val )
 {
-    if( API != NULL )
+    tzExternValue *pValue;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        API->pfnSet( pExt, handle, val );
+        pValue = extvar_fnTxSet( pExtVars, handle, EXTERNVAR_TYPE_UINT32 );
+        if( pValue != NULL )
+        {
+            pValue->val.ul = val;
+        }
+        else
+        {
+            (void)EXTERNVAR_fnInvalidate( pExtVars, handle );
+            pExtVars->pAPI->pfnSet( pExtVars->pExt, handle, val );
+        }
     }
 }
 
@@ -421,11 +712,12 @@ void EXTERNVAR_fnSet( void *pExt, uint32_t handle, uint32_t val )
     Set the value of a floating point external variable
 
     The EXTERNVAR_fnSetFloat function sets the value of a 32-bit IEEE754
-    floating point external variable
+    floating point external variable.  Inside a transaction the value is
+    buffered until the transaction is committed.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -438,11 +730,23 @@ void EXTERNVAR_fnSet( void *pExt, uint32_t handle, uint32_t val )
     @retval result of ExtVar SetFloat function
 
 ==============================================================================*/
-void EXTERNVAR_fnSetFloat( void *pExt, uint32_t handle, float val )
+void EXTERNVAR_fnSetFloat( tzExternVars *pExtVars, uint32_t handle, float val )
 {
-    if( API != NULL )
+    tzExternValue *pValue;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        API->pfnSetFloat( pExt, handle, val );
+        pValue = extvar_fnTxSet( pExtVars, handle, EXTERNVAR_TYPE_FLOAT );
+        if( pValue != NULL )
+        {
+            pValue->val.f = val;
+        }
+        else
+        {
+            (void)EXTERNVAR_fnInvalidate( pExtVars, handle );
+            pExtVars->pAPI->pfnSetFloat( pExtVars->pExt, handle, val );
+        }
     }
 }
 
@@ -452,11 +756,12 @@ void EXTERNVAR_fnSetFloat( void *pExt, uint32_t handle, float val )
     Set the value of a string external variable
 
     The EXTERNVAR_fnSetString function sets the value of a string
-    external variable
+    external variable.  Inside a transaction a copy of the value is
+    buffered until the transaction is committed.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -469,11 +774,33 @@ void EXTERNVAR_fnSetFloat( void *pExt, uint32_t handle, float val )
     @retval result of ExtVar SetString function
 
 ==============================================================================*/
-void EXTERNVAR_fnSetString( void *pExt, uint32_t handle, char * val )
+void EXTERNVAR_fnSetString( tzExternVars *pExtVars,
+                            uint32_t handle,
+                            char * val )
 {
-    if( API != NULL )
+    tzExternValue *pValue = NULL;
+    char *pStr = NULL;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        API->pfnSetString( pExt, handle, val );
+        if( val != NULL )
+        {
+            pValue = extvar_fnTxSet( pExtVars, handle, EXTERNVAR_TYPE_STRING );
+        }
+
+        if( pValue != NULL )
+        {
+            /* a buffered string without a copy is skipped by the commit */
+            pStr = strdup( val );
+            pExtVars->ppTxStr[pValue - pExtVars->pTx] = pStr;
+        }
+
+        if( pStr == NULL )
+        {
+            (void)EXTERNVAR_fnInvalidate( pExtVars, handle );
+            pExtVars->pAPI->pfnSetString( pExtVars->pExt, handle, val );
+        }
     }
 }
 
@@ -482,12 +809,22 @@ void EXTERNVAR_fnSetString( void *pExt, uint32_t handle, char * val )
 /*!
     Get the value of a 32-bit integer external variable
 
-    The EXTERNVAR_fnGet function gets the value of a 32-bit string
-    external variable
+    The EXTERNVAR_fnGet function gets the value of a 32-bit integer
+    external variable.
+
+    When the read-through cache is enabled, the pending notifications
+    are received first, and the value is served from the cache until a
+    MODIFIED notification for the variable arrives.  On a miss, MODIFIED
+    notifications are requested for the variable before its value is
+    read from the external variable library, so no change can be
+    missed.  A variable whose notifications cannot be requested, or
+    which is being validated, is never served from the cache.  Inside a
+    transaction, a variable set by the transaction reads as the value
+    buffered for it.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -496,13 +833,63 @@ void EXTERNVAR_fnSetString( void *pExt, uint32_t handle, char * val )
     @retval result of ExtVar Get function
 
 ==============================================================================*/
-uint32_t EXTERNVAR_fnGet( void *pExt, uint32_t handle )
+uint32_t EXTERNVAR_fnGet( tzExternVars *pExtVars, uint32_t handle )
 {
+    tzExternCacheEntry *pEntry = NULL;
+    tzExternValue *pValue;
     uint32_t result = 0L;
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        result = API->pfnGet( pExt, handle );
+        pValue = extvar_fnTxGet( pExtVars, handle, EXTERNVAR_TYPE_UINT32 );
+
+        if( ( pValue == NULL ) &&
+            ( pExtVars->pCache != NULL ) &&
+            ( ( pExtVars->validating == false ) ||
+              ( pExtVars->hValidating != handle ) ) )
+        {
+            if( pExtVars->pfnSync != NULL )
+            {
+                /* receive the pending invalidations */
+                pExtVars->pfnSync( pExtVars->pSyncArg );
+            }
+
+            pEntry = extvar_fnCacheEntry( pExtVars, handle );
+        }
+
+        if( pValue != NULL )
+        {
+            result = pValue->val.ul;
+        }
+        else if( ( pEntry != NULL ) && ( pEntry->valid == true ) )
+        {
+            pEntry->hits++;
+            result = pEntry->val;
+        }
+        else
+        {
+            if( pEntry != NULL )
+            {
+                pEntry->misses++;
+
+                if( ( pEntry->subscribed == false ) &&
+                    ( extvar_fnRequest( pExtVars,
+                                        handle,
+                                        EXTERNVAR_NOTIFY_MODIFIED ) == EOK ) )
+                {
+                    pEntry->subscribed = true;
+                }
+            }
+
+            result = pExtVars->pAPI->pfnGet( pExtVars->pExt, handle );
+
+            if( ( pEntry != NULL ) && ( pEntry->subscribed == true ) )
+            {
+                pEntry->val = result;
+                pEntry->valid = true;
+            }
+        }
     }
 
     return result;
@@ -514,11 +901,12 @@ uint32_t EXTERNVAR_fnGet( void *pExt, uint32_t handle )
     Get the value of a floating point external variable
 
     The EXTERNVAR_fnGetFloat function gets the value of a 32-bit IEEE754
-    floating point external variable
+    floating point external variable.  Inside a transaction, a variable
+    set by the transaction reads as the value buffered for it.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -527,13 +915,23 @@ uint32_t EXTERNVAR_fnGet( void *pExt, uint32_t handle )
     @retval result of ExtVar GetFloat function
 
 ==============================================================================*/
-float EXTERNVAR_fnGetFloat( void *pExt, uint32_t handle )
+float EXTERNVAR_fnGetFloat( tzExternVars *pExtVars, uint32_t handle )
 {
+    tzExternValue *pValue;
     float result = 0.0;
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        result = API->pfnGetFloat( pExt, handle );
+        pValue = extvar_fnTxGet( pExtVars, handle, EXTERNVAR_TYPE_FLOAT );
+        if( pValue != NULL )
+        {
+            result = pValue->val.f;
+        }
+        else
+        {
+            result = pExtVars->pAPI->pfnGetFloat( pExtVars->pExt, handle );
+        }
     }
 
     return result;
@@ -545,11 +943,12 @@ float EXTERNVAR_fnGetFloat( void *pExt, uint32_t handle )
     Get the value of a string external variable
 
     The EXTERNVAR_fnGetString function gets the value of a string
-    external variable
+    external variable.  Inside a transaction, a variable set by the
+    transaction reads as the value buffered for it.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
         handle
@@ -558,133 +957,637 @@ float EXTERNVAR_fnGetFloat( void *pExt, uint32_t handle )
     @retval result of ExtVar GetString function
 
 ==============================================================================*/
-char *EXTERNVAR_fnGetString( void *pExt, uint32_t handle )
+char *EXTERNVAR_fnGetString( tzExternVars *pExtVars, uint32_t handle )
 {
+    tzExternValue *pValue;
     char *pStr = "";
 
-    if( API != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) )
     {
-        pStr = API->pfnGetString( pExt, handle );
+        pValue = extvar_fnTxGet( pExtVars, handle, EXTERNVAR_TYPE_STRING );
+        if( ( pValue != NULL ) &&
+            ( pExtVars->ppTxStr[pValue - pExtVars->pTx] != NULL ) )
+        {
+            pStr = pExtVars->ppTxStr[pValue - pExtVars->pTx];
+        }
+        else
+        {
+            pStr = pExtVars->pAPI->pfnGetString( pExtVars->pExt, handle );
+        }
     }
 
     return pStr;
 }
 
-/*==============================================================================
-        Private Function Definitions
-==============================================================================*/
-
 /*============================================================================*/
-/*  extvar_fnGetHandle                                                        */
+/*  EXTERNVAR_fnGetMany                                                       */
 /*!
-    Get the handle of an external variable
+    Get the values of several external variables
 
-    The extvar_fnGetHandle function gets the handle of an external variable
-    given its name.  If the variable is not found, one will be allocated.
+    The EXTERNVAR_fnGetMany function gets the values of an array of
+    32-bit integer and floating point external variables with a single
+    call to the external variable library, so a handler can fetch its
+    whole working set at once.  Libraries without a batched get, and
+    VM instances using the read-through cache or inside a transaction,
+    get the variables one at a time.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in,out]
+        pValues
+            array of handles and value types, which receives the values
 
     @param[in]
-        name
-            name of the external variable
+        n
+            number of elements in the array
 
-    @retval handle to the external variable
+    @retval EOK the values were retrieved
+    @retval ENOTSUP an element has an unsupported value type
+    @retval EINVAL invalid arguments
+    @retval other result of the ExtVar GetMany function
 
 ==============================================================================*/
-static uint32_t extvar_fnGetHandle( void *pExt, char *name )
+int EXTERNVAR_fnGetMany( tzExternVars *pExtVars,
+                         tzExternValue *pValues,
+                         size_t n )
 {
-    struct ExtVar **ppExtVars = (struct ExtVar **)pExt;
-    struct ExtVar *pExtVar;
+    tzExternValue *pValue;
+    size_t i;
+    int result = EINVAL;
 
-    if( pExt != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) &&
+        ( ( pValues != NULL ) || ( n == 0 ) ) )
     {
-        if( *ppExtVars == NULL )
+        if( ( pExtVars->pCache == NULL ) &&
+            ( pExtVars->txDepth == 0 ) &&
+            ( pExtVars->pAPI->pfnGetMany != NULL ) )
         {
-            return extvar_fnNew( pExt, name );
+            result = pExtVars->pAPI->pfnGetMany( pExtVars->pExt,
+                                                 pValues,
+                                                 n );
         }
         else
         {
-            pExtVar = extvar_fnFindByName( pExt, name );
-            if( pExtVar == NULL )
-            {
-                return extvar_fnNew( pExt, name );
-            }
-            else
+            result = EOK;
+
+            for( i = 0; i < n; i++ )
             {
-                return pExtVar->handle;
+                pValue = &pValues[i];
+                switch( pValue->type )
+                {
+                    case EXTERNVAR_TYPE_UINT32:
+                        pValue->val.ul = EXTERNVAR_fnGet( pExtVars,
+                                                          pValue->handle );
+                        break;
+
+                    case EXTERNVAR_TYPE_FLOAT:
+                        pValue->val.f = EXTERNVAR_fnGetFloat( pExtVars,
+                                                              pValue->handle );
+                        break;
+
+                    default:
+                        result = ENOTSUP;
+                        break;
+                }
             }
         }
     }
 
-    return 0;
+    return result;
 }
 
 /*============================================================================*/
-/*  extvar_fnSet                                                              */
+/*  EXTERNVAR_fnSetMany                                                       */
 /*!
-    Set the value of an external variable
+    Set the values of several external variables
 
-    The extvar_fnSet function sets the value of an external variable
+    The EXTERNVAR_fnSetMany function sets the values of an array of
+    32-bit integer and floating point external variables with a single
+    call to the external variable library.  Libraries without a batched
+    set have the variables set one at a time.  The cached values of the
+    variables are invalidated.  Inside a transaction the values are
+    buffered until the transaction is committed.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
-        handle
-            external variable handle
+        pValues
+            array of handles, value types and values to set
 
     @param[in]
-        val
-            32-bit integer value to set
+        n
+            number of elements in the array
+
+    @retval EOK the values were set
+    @retval ENOTSUP an element has an unsupported value type
+    @retval EINVAL invalid arguments
+    @retval other result of the ExtVar SetMany function
 
 ==============================================================================*/
-static void extvar_fnSet( void *pExt, uint32_t handle, uint32_t val )
+int EXTERNVAR_fnSetMany( tzExternVars *pExtVars,
+                         tzExternValue *pValues,
+                         size_t n )
 {
-    struct ExtVar *pExtVar;
+    tzExternValue *pValue;
+    size_t i;
+    int result = EINVAL;
 
-    pExtVar = extvar_fnFindByHandle( pExt, handle );
-    if( pExtVar != NULL )
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pAPI != NULL ) &&
+        ( ( pValues != NULL ) || ( n == 0 ) ) )
     {
-        pExtVar->val = val;
+        if( ( pExtVars->txDepth == 0 ) &&
+            ( pExtVars->pAPI->pfnSetMany != NULL ) )
+        {
+            for( i = 0; i < n; i++ )
+            {
+                (void)EXTERNVAR_fnInvalidate( pExtVars, pValues[i].handle );
+            }
+
+            result = pExtVars->pAPI->pfnSetMany( pExtVars->pExt,
+                                                 pValues,
+                                                 n );
+        }
+        else
+        {
+            result = EOK;
+
+            for( i = 0; i < n; i++ )
+            {
+                pValue = &pValues[i];
+                switch( pValue->type )
+                {
+                    case EXTERNVAR_TYPE_UINT32:
+                        EXTERNVAR_fnSet( pExtVars,
+                                         pValue->handle,
+                                         pValue->val.ul );
+                        break;
+
+                    case EXTERNVAR_TYPE_FLOAT:
+                        EXTERNVAR_fnSetFloat( pExtVars,
+                                              pValue->handle,
+                                              pValue->val.f );
+                        break;
+
+                    default:
+                        result = ENOTSUP;
+                        break;
+                }
+            }
+        }
     }
+
+    return result;
 }
 
 /*============================================================================*/
-/*  extvar_fnSetFloat                                                         */
+/*  EXTERNVAR_fnEnableCache                                                   */
 /*!
-    Set the floating point value of an external variable
+    Enable the read-through cache
 
-    The extvar_fnSetFloat function sets the 32-bit IEEE754 floating point
-    value of an external variable
+    The EXTERNVAR_fnEnableCache function enables the read-through cache
+    of 32-bit integer external variables.  The cache keeps the last
+    value read from each variable, and serves further reads locally
+    until the variable is invalidated by a MODIFIED notification
+    (see EXTERNVAR_fnInvalidate) or set by the VM instance.
+
+    The MODIFIED notifications are received outside of the cache, so
+    the caller provides a function which is called before each cached
+    read to receive them.
 
     @param[in]
-        pExt
-            opaque pointer to the external variable list
+        pExtVars
+            pointer to the external variables of the VM instance
 
     @param[in]
-        handle
-            external variable handle
+        pfnSync
+            function which receives the pending MODIFIED notifications,
+            or NULL
 
     @param[in]
-        val
-            32-bit IEEE743 floating point value to set
+        pSyncArg
+            argument passed to the pfnSync function
+
+    @retval EOK the cache was enabled
+    @retval ENOMEM memory allocation failure
+    @retval EINVAL invalid arguments
 
 ==============================================================================*/
-static void extvar_fnSetFloat( void *pExt, uint32_t handle, float val )
+int EXTERNVAR_fnEnableCache( tzExternVars *pExtVars,
+                             void (*pfnSync)( void *pArg ),
+                             void *pSyncArg )
 {
-    struct ExtVar *pExtVar;
+    int result = EINVAL;
 
-    pExtVar = extvar_fnFindByHandle( pExt, handle );
-    if( pExtVar != NULL )
+    if( pExtVars != NULL )
     {
-        pExtVar->fval = val;
-    }
-}
+        result = EOK;
 
-/*============================================================================*/
+        if( pExtVars->pCache == NULL )
+        {
+            result = extvar_fnGrowCache( pExtVars );
+        }
+
+        pExtVars->pfnSync = pfnSync;
+        pExtVars->pSyncArg = pSyncArg;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnInvalidate                                                    */
+/*!
+    Invalidate a cached external variable
+
+    The EXTERNVAR_fnInvalidate function discards the cached value of
+    an external variable when a MODIFIED notification for it has been
+    received, and reports if the notification should be passed on to
+    the program.  Notifications which were only requested by the cache
+    are not passed on.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        handle
+            handle of the modified external variable
+
+    @retval true the program requested the notification
+    @retval false the notification was only requested by the cache
+
+==============================================================================*/
+bool EXTERNVAR_fnInvalidate( tzExternVars *pExtVars, uint32_t handle )
+{
+    tzExternCacheEntry *pEntry;
+    bool result = true;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pCache != NULL ) &&
+        ( handle != 0 ) )
+    {
+        pEntry = extvar_fnFindCache( pExtVars->pCache,
+                                     pExtVars->cacheSize,
+                                     handle );
+        if( pEntry->handle == handle )
+        {
+            pEntry->valid = false;
+            result = ( pEntry->subscribed == false ) ||
+                     ( pEntry->notify == true );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnInvalidateAll                                                 */
+/*!
+    Invalidate every cached external variable
+
+    The EXTERNVAR_fnInvalidateAll function discards all of the cached
+    values, for when MODIFIED notifications may have been lost.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+==============================================================================*/
+void EXTERNVAR_fnInvalidateAll( tzExternVars *pExtVars )
+{
+    size_t i;
+
+    if( ( pExtVars != NULL ) && ( pExtVars->pCache != NULL ) )
+    {
+        for( i = 0; i < pExtVars->cacheSize; i++ )
+        {
+            pExtVars->pCache[i].valid = false;
+        }
+    }
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnSetRequestHook                                                */
+/*!
+    Set the notification request hook
+
+    The EXTERNVAR_fnSetRequestHook function sets a function which is
+    called before each notification is requested from the external
+    variable library, whether by the program or by the read-through
+    cache.  A host which receives the notification signals for its VM
+    instances uses it to find out which instance each signal is for.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        pfnRequest
+            function called with the handle and request type of each
+            notification request, or NULL
+
+    @param[in]
+        pRequestArg
+            argument passed to the pfnRequest function
+
+==============================================================================*/
+void EXTERNVAR_fnSetRequestHook( tzExternVars *pExtVars,
+                                 void (*pfnRequest)( void *pArg,
+                                                     uint32_t handle,
+                                                     uint32_t request ),
+                                 void *pRequestArg )
+{
+    if( pExtVars != NULL )
+    {
+        pExtVars->pfnRequest = pfnRequest;
+        pExtVars->pRequestArg = pRequestArg;
+    }
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnGetCacheStats                                                 */
+/*!
+    Get the read-through cache counters of an external variable
+
+    The EXTERNVAR_fnGetCacheStats function gets the number of reads of
+    an external variable which were served from the cache (hits), and
+    the number which were passed to the external variable library
+    (misses).
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @param[out]
+        pHits
+            pointer to the location to store the number of cache hits
+
+    @param[out]
+        pMisses
+            pointer to the location to store the number of cache misses
+
+    @retval EOK the counters were retrieved
+    @retval ENOENT the variable has not been read through the cache
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int EXTERNVAR_fnGetCacheStats( tzExternVars *pExtVars,
+                               uint32_t handle,
+                               uint32_t *pHits,
+                               uint32_t *pMisses )
+{
+    tzExternCacheEntry *pEntry;
+    int result = EINVAL;
+
+    if( ( pExtVars != NULL ) &&
+        ( pHits != NULL ) &&
+        ( pMisses != NULL ) )
+    {
+        result = ENOENT;
+
+        if( ( pExtVars->pCache != NULL ) && ( handle != 0 ) )
+        {
+            pEntry = extvar_fnFindCache( pExtVars->pCache,
+                                         pExtVars->cacheSize,
+                                         handle );
+            if( pEntry->handle == handle )
+            {
+                *pHits = pEntry->hits;
+                *pMisses = pEntry->misses;
+                result = EOK;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnDumpCache                                                     */
+/*!
+    Output the read-through cache counters
+
+    The EXTERNVAR_fnDumpCache function outputs the handle, cache hits
+    and cache misses of each external variable read through the cache.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        fp
+            output stream
+
+==============================================================================*/
+void EXTERNVAR_fnDumpCache( tzExternVars *pExtVars, FILE *fp )
+{
+    tzExternCacheEntry *pEntry;
+    size_t i;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->pCache != NULL ) &&
+        ( fp != NULL ) )
+    {
+        fprintf( fp, "handle     hits     misses\n" );
+        for( i = 0; i < pExtVars->cacheSize; i++ )
+        {
+            pEntry = &pExtVars->pCache[i];
+            if( pEntry->handle != 0 )
+            {
+                fprintf( fp,
+                         "%-10u %-8u %u\n",
+                         pEntry->handle,
+                         pEntry->hits,
+                         pEntry->misses );
+            }
+        }
+    }
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnBegin                                                         */
+/*!
+    Begin an external variable transaction
+
+    The EXTERNVAR_fnBegin function opens a transaction.  Until the
+    transaction is committed, the values set for the external variables
+    are buffered per handle with the last value set for each variable
+    replacing the previous one, and nothing is sent to the external
+    variable library.  Transactions may be nested, in which case the
+    values are sent when the outermost transaction is committed.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @retval EOK the transaction was opened
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int EXTERNVAR_fnBegin( tzExternVars *pExtVars )
+{
+    int result = EINVAL;
+
+    if( pExtVars != NULL )
+    {
+        pExtVars->txDepth++;
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  EXTERNVAR_fnCommit                                                        */
+/*!
+    Commit an external variable transaction
+
+    The EXTERNVAR_fnCommit function closes a transaction opened by
+    EXTERNVAR_fnBegin.  When the outermost transaction is committed,
+    the buffered string values are set one at a time, and the buffered
+    32-bit integer and floating point values are set with a single call
+    to EXTERNVAR_fnSetMany.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @retval EOK the transaction was committed
+    @retval EINVAL no transaction is open
+    @retval other result of EXTERNVAR_fnSetMany
+
+==============================================================================*/
+int EXTERNVAR_fnCommit( tzExternVars *pExtVars )
+{
+    int result = EINVAL;
+
+    if( ( pExtVars != NULL ) &&
+        ( pExtVars->txDepth > 0 ) )
+    {
+        pExtVars->txDepth--;
+        result = ( pExtVars->txDepth == 0 ) ? extvar_fnFlushTx( pExtVars )
+                                            : EOK;
+    }
+
+    return result;
+}
+
+/*==============================================================================
+        Private Function Definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  extvar_fnGetHandle                                                        */
+/*!
+    Get the handle of an external variable
+
+    The extvar_fnGetHandle function gets the handle of an external variable
+    given its name.  If the variable is not found, one will be allocated.
+
+    @param[in]
+        pExt
+            opaque pointer to the external variable list
+
+    @param[in]
+        name
+            name of the external variable
+
+    @retval handle to the external variable
+
+==============================================================================*/
+static uint32_t extvar_fnGetHandle( void *pExt, char *name )
+{
+    struct ExtVar *pExtVar;
+    uint32_t handle;
+
+    pExtVar = extvar_fnFindByName( pExt, name );
+    if( pExtVar != NULL )
+    {
+        handle = pExtVar->handle;
+    }
+    else
+    {
+        handle = extvar_fnNew( pExt, name );
+    }
+
+    return handle;
+}
+
+/*============================================================================*/
+/*  extvar_fnSet                                                              */
+/*!
+    Set the value of an external variable
+
+    The extvar_fnSet function sets the value of an external variable
+
+    @param[in]
+        pExt
+            opaque pointer to the external variable list
+
+    @param[in]
+        handle
+            external variable handle
+
+    @param[in]
+        val
+            32-bit integer value to set
+
+==============================================================================*/
+static void extvar_fnSet( void *pExt, uint32_t handle, uint32_t val )
+{
+    struct ExtVar *pExtVar;
+
+    pExtVar = extvar_fnFindByHandle( pExt, handle );
+    if( pExtVar != NULL )
+    {
+        pExtVar->val = val;
+    }
+}
+
+/*============================================================================*/
+/*  extvar_fnSetFloat                                                         */
+/*!
+    Set the floating point value of an external variable
+
+    The extvar_fnSetFloat function sets the 32-bit IEEE754 floating point
+    value of an external variable
+
+    @param[in]
+        pExt
+            opaque pointer to the external variable list
+
+    @param[in]
+        handle
+            external variable handle
+
+    @param[in]
+        val
+            32-bit IEEE743 floating point value to set
+
+==============================================================================*/
+static void extvar_fnSetFloat( void *pExt, uint32_t handle, float val )
+{
+    struct ExtVar *pExtVar;
+
+    pExtVar = extvar_fnFindByHandle( pExt, handle );
+    if( pExtVar != NULL )
+    {
+        pExtVar->fval = val;
+    }
+}
+
+/*============================================================================*/
 /*  extvar_fnSetString                                                        */
 /*!
     Set the string value of an external variable
@@ -732,6 +1635,10 @@ static void extvar_fnSetString( void *pExt, uint32_t handle, char * val )
 	    	if( pExtVar->sval != NULL )
 	    	{
 	    		strcpy(pExtVar->sval, val );
+	    		if( len > pExtVar->len )
+	    		{
+	    			pExtVar->len = len;
+	    		}
 	    	}
 	    }
 	}
@@ -842,8 +1749,10 @@ static char *extvar_fnGetString( void *pExt, uint32_t handle )
     Create a new external variable
 
     The extvar_fnNew function creates a new external variable.
-    It allocates memory for the external variable and inserts it
-    into the external variable list.
+    It appends the external variable to the external variable array,
+    so its handle is its position in the array, and adds the handle
+    to the name hash table.  The arrays are doubled in size when they
+    are full.
 
     @param[in]
         pExt
@@ -859,42 +1768,56 @@ static char *extvar_fnGetString( void *pExt, uint32_t handle )
 ==============================================================================*/
 static uint32_t extvar_fnNew( void *pExt, char *name )
 {
-	struct ExtVar *pNew;
-	size_t len;
-    struct ExtVar **ppExtVars = (struct ExtVar **)pExt;
+    struct ExtVarList *pList = (struct ExtVarList *)pExt;
+    struct ExtVar *pVars;
+    struct ExtVar *pNew;
+    uint32_t handle = 0;
+    uint32_t n;
+    bool indexed = false;
 
     if( ( pExt != NULL ) &&
         ( name != NULL ) )
     {
-        /* allocate memory for the new ExtVar */
-        pNew = malloc( sizeof( struct ExtVar ) );
-        if( pNew != (struct ExtVar *)NULL )
+        if( pList->numVars == pList->maxVars )
         {
-            /* allocate memory for the name */
-            len = strlen(name);
-            pNew->name = malloc( len + 1 );
-            if( pNew->name == (char *)NULL )
+            /* enlarge the external variable array */
+            n = ( pList->maxVars < EXTERNVAR_MIN_VARS )
+                ? EXTERNVAR_MIN_VARS
+                : pList->maxVars * 2;
+
+            pVars = realloc( pList->pVars, n * sizeof( struct ExtVar ) );
+            if( pVars != NULL )
             {
-                free( pNew );
-                return 0;
+                pList->pVars = pVars;
+                pList->maxVars = n;
             }
-            else
-            {
-                strcpy(pNew->name, name);
-                pNew->name[len] = '\0';
-                pNew->handle = ++handle;
+        }
 
-                /* insert the extvar at the head of the list */
-                pNew->pNext = *ppExtVars;
-                *ppExtVars = pNew;
+        /* keep the name hash table at most three quarters full */
+        if( ( ( pList->numVars + 1 ) * 4 <= pList->indexSize * 3 ) ||
+            ( extvar_fnGrowIndex( pList ) == EOK ) )
+        {
+            indexed = true;
+        }
+
+        if( ( indexed == true ) &&
+            ( pList->numVars < pList->maxVars ) )
+        {
+            pNew = &pList->pVars[pList->numVars];
+            memset( pNew, 0, sizeof( struct ExtVar ) );
 
-                /* return the handle of the new ExtVar */
-                return pNew->handle;
+            pNew->name = strdup( name );
+            if( pNew->name != NULL )
+            {
+                pNew->hash = extvar_fnHash( name );
+                pNew->handle = ++pList->numVars;
+                *extvar_fnFindIndex( pList, name, pNew->hash ) = pNew->handle;
+                handle = pNew->handle;
             }
         }
     }
 
-	return 0;
+	return handle;
 }
 
 /*============================================================================*/
@@ -903,8 +1826,7 @@ static uint32_t extvar_fnNew( void *pExt, char *name )
     Find an external variable given its name
 
     The extvar_fnFindByName function searches for an external variable
-    in the external variable list given its name.
-
+    in the name hash table of the external variable list.
 
     @param[in]
         pExt
@@ -914,31 +1836,28 @@ static uint32_t extvar_fnNew( void *pExt, char *name )
         name
             external variable name
 
-    @retval variable value.
+    @retval pointer to the ExtVar object for the specified variable
     @retval NULL if no variable is found.
 
 ==============================================================================*/
 static struct ExtVar *extvar_fnFindByName( void *pExt, char *name )
 {
-    struct ExtVar **ppExtVars = (struct ExtVar **)pExt;
+    struct ExtVarList *pList = (struct ExtVarList *)pExt;
 	struct ExtVar *pExtVar = NULL;
+    uint32_t handle;
 
     if( ( pExt != NULL ) &&
-        ( name != NULL ) )
+        ( name != NULL ) &&
+        ( pList->indexSize > 0 ) )
     {
-        pExtVar = *ppExtVars;
-        while( pExtVar != NULL )
+        handle = *extvar_fnFindIndex( pList, name, extvar_fnHash( name ) );
+        if( handle != 0 )
         {
-            if( strcmp( name, pExtVar->name ) == 0 )
-            {
-                break;
-            }
-
-            pExtVar = pExtVar->pNext;
+            pExtVar = &pList->pVars[handle - 1];
         }
     }
 
-	return (struct ExtVar *)pExtVar;
+	return pExtVar;
 }
 
 /*============================================================================*/
@@ -946,16 +1865,16 @@ static struct ExtVar *extvar_fnFindByName( void *pExt, char *name )
 /*!
     Find an external variable given its handle
 
-    The extvar_fnFindByHandle function searches for an external variable
-    in the external variable list given its handle.
+    The extvar_fnFindByHandle function gets an external variable from
+    the external variable array given its handle.
 
     @param[in]
         pExt
             opaque pointer to the external variable list
 
     @param[in]
-        name
-            external variable name
+        handle
+            external variable handle
 
     @retval pointer to the ExtVar object for the specified variable
     @retval NULL if no variable is found.
@@ -963,25 +1882,760 @@ static struct ExtVar *extvar_fnFindByName( void *pExt, char *name )
 ==============================================================================*/
 static struct ExtVar *extvar_fnFindByHandle( void *pExt, uint32_t handle )
 {
-    struct ExtVar **ppExtVars = (struct ExtVar **)pExt;
+    struct ExtVarList *pList = (struct ExtVarList *)pExt;
 	struct ExtVar *pExtVar = NULL;
 
-    if( pExt != NULL )
+    if( ( pExt != NULL ) &&
+        ( handle != 0 ) &&
+        ( handle <= pList->numVars ) )
     {
-        pExtVar = *ppExtVars;
-        while( pExtVar != NULL )
+        pExtVar = &pList->pVars[handle - 1];
+    }
+
+	return pExtVar;
+}
+
+/*============================================================================*/
+/*  extvar_fnHash                                                             */
+/*!
+    Calculate the hash of an external variable name
+
+    The extvar_fnHash function calculates the 32-bit FNV-1a hash of an
+    external variable name.
+
+    @param[in]
+        name
+            external variable name
+
+    @retval hash of the name
+
+==============================================================================*/
+static uint32_t extvar_fnHash( char *name )
+{
+    uint32_t hash = 0x811C9DC5u;
+
+    while( *name != '\0' )
+    {
+        hash ^= (uint8_t)*name++;
+        hash *= 0x01000193u;
+    }
+
+    return hash;
+}
+
+/*============================================================================*/
+/*  extvar_fnFindIndex                                                        */
+/*!
+    Find the name hash table entry of an external variable
+
+    The extvar_fnFindIndex function finds the entry of the name hash
+    table which holds the handle of the specified variable name, or else
+    the unused entry where it would be added.  The name hash table must
+    have at least one unused entry.
+
+    @param[in]
+        pList
+            pointer to the external variable list
+
+    @param[in]
+        name
+            external variable name
+
+    @param[in]
+        hash
+            hash of the external variable name
+
+    @retval pointer to the name hash table entry
+
+==============================================================================*/
+static uint32_t *extvar_fnFindIndex( struct ExtVarList *pList,
+                                     char *name,
+                                     uint32_t hash )
+{
+    size_t mask = pList->indexSize - 1;
+    size_t i;
+    struct ExtVar *pExtVar;
+
+    i = (size_t)hash & mask;
+    while( pList->pIndex[i] != 0 )
+    {
+        pExtVar = &pList->pVars[pList->pIndex[i] - 1];
+        if( ( pExtVar->hash == hash ) &&
+            ( strcmp( pExtVar->name, name ) == 0 ) )
         {
-            if( pExtVar->handle == handle )
-            {
+            break;
+        }
+
+        i = ( i + 1 ) & mask;
+    }
+
+    return &pList->pIndex[i];
+}
+
+/*============================================================================*/
+/*  extvar_fnGrowIndex                                                        */
+/*!
+    Enlarge the name hash table
+
+    The extvar_fnGrowIndex function doubles the size of the name hash
+    table and re-inserts the handles of all of the external variables.
+
+    @param[in]
+        pList
+            pointer to the external variable list
+
+    @retval EOK the name hash table was enlarged
+    @retval ENOMEM memory allocation failed
+
+==============================================================================*/
+static int extvar_fnGrowIndex( struct ExtVarList *pList )
+{
+    uint32_t *pIndex;
+    size_t n;
+    uint32_t i;
+    int result = ENOMEM;
+
+    n = ( pList->indexSize < EXTERNVAR_MIN_VARS * 2 )
+        ? EXTERNVAR_MIN_VARS * 2
+        : pList->indexSize * 2;
+
+    pIndex = calloc( n, sizeof( uint32_t ) );
+    if( pIndex != NULL )
+    {
+        free( pList->pIndex );
+        pList->pIndex = pIndex;
+        pList->indexSize = n;
+
+        for( i = 0; i < pList->numVars; i++ )
+        {
+            *extvar_fnFindIndex( pList,
+                                 pList->pVars[i].name,
+                                 pList->pVars[i].hash ) = i + 1;
+        }
+
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  extvar_fnGetMany                                                          */
+/*!
+    Get the values of several external variables
+
+    The extvar_fnGetMany function gets the values of an array of
+    external variables from the external variable list.
+
+    @param[in]
+        pExt
+            opaque pointer to the external variable list
+
+    @param[in,out]
+        pValues
+            array of handles and value types, which receives the values
+
+    @param[in]
+        n
+            number of elements in the array
+
+    @retval EOK the values were retrieved
+    @retval ENOTSUP an element has an unsupported value type
+
+==============================================================================*/
+static int extvar_fnGetMany( void *pExt, tzExternValue *pValues, size_t n )
+{
+    size_t i;
+    int result = EOK;
+
+    for( i = 0; i < n; i++ )
+    {
+        switch( pValues[i].type )
+        {
+            case EXTERNVAR_TYPE_UINT32:
+                pValues[i].val.ul = extvar_fnGet( pExt, pValues[i].handle );
+                break;
+
+            case EXTERNVAR_TYPE_FLOAT:
+                pValues[i].val.f = extvar_fnGetFloat( pExt,
+                                                      pValues[i].handle );
                 break;
+
+            default:
+                result = ENOTSUP;
+                break;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  extvar_fnSetMany                                                          */
+/*!
+    Set the values of several external variables
+
+    The extvar_fnSetMany function sets the values of an array of
+    external variables in the external variable list.
+
+    @param[in]
+        pExt
+            opaque pointer to the external variable list
+
+    @param[in]
+        pValues
+            array of handles, value types and values to set
+
+    @param[in]
+        n
+            number of elements in the array
+
+    @retval EOK the values were set
+    @retval ENOTSUP an element has an unsupported value type
+
+==============================================================================*/
+static int extvar_fnSetMany( void *pExt, tzExternValue *pValues, size_t n )
+{
+    size_t i;
+    int result = EOK;
+
+    for( i = 0; i < n; i++ )
+    {
+        switch( pValues[i].type )
+        {
+            case EXTERNVAR_TYPE_UINT32:
+                extvar_fnSet( pExt, pValues[i].handle, pValues[i].val.ul );
+                break;
+
+            case EXTERNVAR_TYPE_FLOAT:
+                extvar_fnSetFloat( pExt, pValues[i].handle, pValues[i].val.f );
+                break;
+
+            default:
+                result = ENOTSUP;
+                break;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  extvar_fnFindCache                                                        */
+/*!
+    Find an external variable in the read-through cache table
+
+    The extvar_fnFindCache function searches the cache table for the
+    entry of the specified handle using linear probing.  The table is
+    never full, so the search ends at the entry of the handle or at the
+    unused entry where it would be inserted.
+
+    @param[in]
+        pCache
+            pointer to the cache table
+
+    @param[in]
+        cacheSize
+            number of entries in the cache table (a power of 2)
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @retval pointer to the entry of the handle, or to an unused entry
+
+==============================================================================*/
+static tzExternCacheEntry *extvar_fnFindCache( tzExternCacheEntry *pCache,
+                                               size_t cacheSize,
+                                               uint32_t handle )
+{
+    size_t mask = cacheSize - 1;
+    size_t i;
+
+    i = (size_t)( handle * 0x9E3779B1u ) & mask;
+    while( ( pCache[i].handle != 0 ) &&
+           ( pCache[i].handle != handle ) )
+    {
+        i = ( i + 1 ) & mask;
+    }
+
+    return &pCache[i];
+}
+
+/*============================================================================*/
+/*  extvar_fnCacheEntry                                                       */
+/*!
+    Get the read-through cache entry of an external variable
+
+    The extvar_fnCacheEntry function gets the cache entry of the
+    specified handle, adding an entry if the variable is not yet in the
+    cache.  The cache table is enlarged when it is three quarters full.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @retval pointer to the cache entry of the variable
+    @retval NULL the cache is not enabled, or the entry could not be added
+
+==============================================================================*/
+static tzExternCacheEntry *extvar_fnCacheEntry( tzExternVars *pExtVars,
+                                                uint32_t handle )
+{
+    tzExternCacheEntry *pEntry = NULL;
+
+    if( ( pExtVars->pCache != NULL ) && ( handle != 0 ) )
+    {
+        pEntry = extvar_fnFindCache( pExtVars->pCache,
+                                     pExtVars->cacheSize,
+                                     handle );
+        if( pEntry->handle == 0 )
+        {
+            if( ( ( pExtVars->cacheUsed + 1 ) * 4 >
+                  pExtVars->cacheSize * 3 ) &&
+                ( extvar_fnGrowCache( pExtVars ) == EOK ) )
+            {
+                pEntry = extvar_fnFindCache( pExtVars->pCache,
+                                             pExtVars->cacheSize,
+                                             handle );
+            }
+
+            if( ( pExtVars->cacheUsed + 1 ) * 4 <= pExtVars->cacheSize * 3 )
+            {
+                pEntry->handle = handle;
+                pExtVars->cacheUsed++;
+            }
+            else
+            {
+                /* the table could not be enlarged */
+                pEntry = NULL;
+            }
+        }
+    }
+
+    return pEntry;
+}
+
+/*============================================================================*/
+/*  extvar_fnGrowCache                                                        */
+/*!
+    Enlarge the read-through cache table
+
+    The extvar_fnGrowCache function doubles the size of the cache table
+    (or creates it) and re-inserts its entries.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @retval EOK the cache table was enlarged
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int extvar_fnGrowCache( tzExternVars *pExtVars )
+{
+    tzExternCacheEntry *pCache;
+    tzExternCacheEntry *pOld;
+    size_t n;
+    size_t i;
+    int result = ENOMEM;
+
+    n = ( pExtVars->cacheSize < EXTERNVAR_MIN_CACHE )
+        ? EXTERNVAR_MIN_CACHE
+        : pExtVars->cacheSize * 2;
+
+    pCache = calloc( n, sizeof( tzExternCacheEntry ) );
+    if( pCache != NULL )
+    {
+        for( i = 0; i < pExtVars->cacheSize; i++ )
+        {
+            pOld = &pExtVars->pCache[i];
+            if( pOld->handle != 0 )
+            {
+                *extvar_fnFindCache( pCache, n, pOld->handle ) = *pOld;
             }
+        }
+
+        free( pExtVars->pCache );
+        pExtVars->pCache = pCache;
+        pExtVars->cacheSize = n;
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  extvar_fnFindTx                                                           */
+/*!
+    Find the transaction index entry of an external variable
+
+    The extvar_fnFindTx function finds the entry of the transaction
+    index which refers to the buffered value of the specified handle,
+    or else the unused entry where it would be added.
+
+    @param[in]
+        pIndex
+            pointer to the transaction index
+
+    @param[in]
+        indexSize
+            number of entries in the index (a power of two)
+
+    @param[in]
+        pTx
+            pointer to the buffered values referred to by the index
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @retval pointer to the index entry
+
+==============================================================================*/
+static uint32_t *extvar_fnFindTx( uint32_t *pIndex,
+                                  size_t indexSize,
+                                  tzExternValue *pTx,
+                                  uint32_t handle )
+{
+    size_t mask = indexSize - 1;
+    size_t i;
+
+    i = (size_t)( handle * 0x9E3779B1u ) & mask;
+    while( ( pIndex[i] != 0 ) &&
+           ( pTx[pIndex[i] - 1].handle != handle ) )
+    {
+        i = ( i + 1 ) & mask;
+    }
+
+    return &pIndex[i];
+}
+
+/*============================================================================*/
+/*  extvar_fnTxGet                                                            */
+/*!
+    Get the value buffered for an external variable
+
+    The extvar_fnTxGet function gets the value of the specified type
+    buffered for an external variable by the open transaction.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
 
-            pExtVar = pExtVar->pNext;
+    @param[in]
+        handle
+            handle of the external variable
+
+    @param[in]
+        type
+            type of the value (EXTERNVAR_TYPE_xxx)
+
+    @retval pointer to the buffered value
+    @retval NULL no transaction is open, or no value of the specified
+            type is buffered for the variable
+
+==============================================================================*/
+static tzExternValue *extvar_fnTxGet( tzExternVars *pExtVars,
+                                      uint32_t handle,
+                                      uint32_t type )
+{
+    tzExternValue *pValue = NULL;
+    uint32_t *pIndex;
+
+    if( ( pExtVars->txDepth > 0 ) &&
+        ( pExtVars->pTxIndex != NULL ) )
+    {
+        pIndex = extvar_fnFindTx( pExtVars->pTxIndex,
+                                  pExtVars->txSize * 2,
+                                  pExtVars->pTx,
+                                  handle );
+        if( ( *pIndex != 0 ) &&
+            ( pExtVars->pTx[*pIndex - 1].type == type ) )
+        {
+            pValue = &pExtVars->pTx[*pIndex - 1];
+        }
+    }
+
+    return pValue;
+}
+
+/*============================================================================*/
+/*  extvar_fnTxSet                                                            */
+/*!
+    Get the buffer for a value set by the open transaction
+
+    The extvar_fnTxSet function gets the value buffered for an external
+    variable by the open transaction, adding one if the variable has
+    not been set by the transaction yet, and sets its type.  A string
+    previously buffered for the variable is released.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        handle
+            handle of the external variable
+
+    @param[in]
+        type
+            type of the value to be set (EXTERNVAR_TYPE_xxx)
+
+    @retval pointer to the buffered value to be set
+    @retval NULL no transaction is open, or the value could not be added
+
+==============================================================================*/
+static tzExternValue *extvar_fnTxSet( tzExternVars *pExtVars,
+                                      uint32_t handle,
+                                      uint32_t type )
+{
+    tzExternValue *pValue = NULL;
+    uint32_t *pIndex = NULL;
+    size_t i;
+
+    if( pExtVars->txDepth > 0 )
+    {
+        if( ( pExtVars->txUsed < pExtVars->txSize ) ||
+            ( extvar_fnGrowTx( pExtVars ) == EOK ) )
+        {
+            pIndex = extvar_fnFindTx( pExtVars->pTxIndex,
+                                      pExtVars->txSize * 2,
+                                      pExtVars->pTx,
+                                      handle );
         }
 
+        if( ( pIndex != NULL ) && ( *pIndex == 0 ) )
+        {
+            i = pExtVars->txUsed++;
+            pExtVars->pTx[i].handle = handle;
+            pExtVars->ppTxStr[i] = NULL;
+            *pIndex = i + 1;
+        }
+
+        if( pIndex != NULL )
+        {
+            i = *pIndex - 1;
+            free( pExtVars->ppTxStr[i] );
+            pExtVars->ppTxStr[i] = NULL;
 
+            pValue = &pExtVars->pTx[i];
+            pValue->type = type;
+        }
     }
-	return pExtVar;
+
+    return pValue;
+}
+
+/*============================================================================*/
+/*  extvar_fnGrowTx                                                           */
+/*!
+    Enlarge the transaction buffer
+
+    The extvar_fnGrowTx function doubles the capacity of the transaction
+    buffer (or creates it) and rebuilds its index.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @retval EOK the transaction buffer was enlarged
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int extvar_fnGrowTx( tzExternVars *pExtVars )
+{
+    tzExternValue *pTx;
+    char **ppTxStr;
+    uint32_t *pIndex;
+    size_t n;
+    size_t i;
+    int result = ENOMEM;
+
+    n = ( pExtVars->txSize < EXTERNVAR_MIN_TX )
+        ? EXTERNVAR_MIN_TX
+        : pExtVars->txSize * 2;
+
+    pIndex = calloc( n * 2, sizeof( uint32_t ) );
+    if( pIndex != NULL )
+    {
+        pTx = realloc( pExtVars->pTx, n * sizeof( tzExternValue ) );
+        if( pTx != NULL )
+        {
+            pExtVars->pTx = pTx;
+        }
+
+        ppTxStr = realloc( pExtVars->ppTxStr, n * sizeof( char * ) );
+        if( ppTxStr != NULL )
+        {
+            pExtVars->ppTxStr = ppTxStr;
+        }
+
+        if( ( pTx != NULL ) && ( ppTxStr != NULL ) )
+        {
+            for( i = 0; i < pExtVars->txUsed; i++ )
+            {
+                *extvar_fnFindTx( pIndex,
+                                  n * 2,
+                                  pExtVars->pTx,
+                                  pExtVars->pTx[i].handle ) = i + 1;
+            }
+
+            free( pExtVars->pTxIndex );
+            pExtVars->pTxIndex = pIndex;
+            pExtVars->txSize = n;
+            result = EOK;
+        }
+        else
+        {
+            free( pIndex );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  extvar_fnFlushTx                                                          */
+/*!
+    Send the values buffered by a transaction
+
+    The extvar_fnFlushTx function sets the external variables to the
+    values buffered by a committed transaction, and empties the buffer.
+    The string values are set one at a time, and the 32-bit integer and
+    floating point values are gathered at the front of the buffer and
+    set with one call to EXTERNVAR_fnSetMany.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @retval EOK the values were set
+    @retval other result of EXTERNVAR_fnSetMany
+
+==============================================================================*/
+static int extvar_fnFlushTx( tzExternVars *pExtVars )
+{
+    tzExternValue *pValue;
+    size_t n = 0;
+    size_t i;
+    int result;
+
+    for( i = 0; i < pExtVars->txUsed; i++ )
+    {
+        pValue = &pExtVars->pTx[i];
+        if( pValue->type == EXTERNVAR_TYPE_STRING )
+        {
+            if( pExtVars->ppTxStr[i] != NULL )
+            {
+                EXTERNVAR_fnSetString( pExtVars,
+                                       pValue->handle,
+                                       pExtVars->ppTxStr[i] );
+                free( pExtVars->ppTxStr[i] );
+                pExtVars->ppTxStr[i] = NULL;
+            }
+        }
+        else
+        {
+            pExtVars->pTx[n++] = *pValue;
+        }
+    }
+
+    result = EXTERNVAR_fnSetMany( pExtVars, pExtVars->pTx, n );
+
+    pExtVars->txUsed = 0;
+    if( pExtVars->pTxIndex != NULL )
+    {
+        memset( pExtVars->pTxIndex,
+                0,
+                pExtVars->txSize * 2 * sizeof( uint32_t ) );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  extvar_fnDiscardTx                                                        */
+/*!
+    Discard the transaction buffer
+
+    The extvar_fnDiscardTx function releases the transaction buffer
+    without sending the values buffered by an uncommitted transaction.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+==============================================================================*/
+static void extvar_fnDiscardTx( tzExternVars *pExtVars )
+{
+    size_t i;
+
+    for( i = 0; i < pExtVars->txUsed; i++ )
+    {
+        free( pExtVars->ppTxStr[i] );
+    }
+
+    free( pExtVars->pTx );
+    free( pExtVars->ppTxStr );
+    free( pExtVars->pTxIndex );
+    pExtVars->pTx = NULL;
+    pExtVars->ppTxStr = NULL;
+    pExtVars->pTxIndex = NULL;
+    pExtVars->txUsed = 0;
+    pExtVars->txSize = 0;
+    pExtVars->txDepth = 0;
+}
+
+/*============================================================================*/
+/*  extvar_fnRequest                                                          */
+/*!
+    Request a notification from the external variable library
+
+    The extvar_fnRequest function calls the request hook, if one is
+    set, and then requests the notification from the external variable
+    library.  The hook is called first so that a notification which is
+    sent as soon as it is requested can be delivered.
+
+    @param[in]
+        pExtVars
+            pointer to the external variables of the VM instance
+
+    @param[in]
+        handle
+            handle of the variable to request a notification for
+
+    @param[in]
+        request
+            notification request type
+
+    @retval result of ExtVar Notify function
+    @retval ENOTSUP the library does not support notifications
+
+==============================================================================*/
+static int extvar_fnRequest( tzExternVars *pExtVars,
+                             uint32_t handle,
+                             uint32_t request )
+{
+    int result = ENOTSUP;
+
+    if( pExtVars->pAPI->pfnNotify != NULL )
+    {
+        if( pExtVars->pfnRequest != NULL )
+        {
+            pExtVars->pfnRequest( pExtVars->pRequestArg, handle, request );
+        }
+
+        result = pExtVars->pAPI->pfnNotify( pExtVars->pExt,
+                                            handle,
+                                            request );
+    }
+
+    return result;
 }
 
 /*! @}
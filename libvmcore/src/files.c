@@ -61,50 +61,15 @@ SOFTWARE.
 #include <fcntl.h>
 #include <unistd.h>
 #include "files.h"
-#include "strbuf.h"
-
-/*==============================================================================
-        Definitions
-==============================================================================*/
-
-/*! Maximum number of open files in the virtual machine */
-#define MAX_OPEN_FILES ( 20 )
-
-/*! File Descriptor object to associated the file descriptor and its mode */
-typedef struct _FileDescriptor
-{
-    /*! file descriptor id */
-    uint32_t fd;
-
-    /*! file descriptor mode 'r' or 'w' */
-    char mode;
-
-} FileDescriptor;
 
 /*==============================================================================
         Private function declarations
 ==============================================================================*/
 
-static int Findfd( int fd );
-static int ScanNumber( void );
-static char GetMode( int fd );
-static int GetFreeFDIndex( void );
-
-/*==============================================================================
-        File scoped variables
-==============================================================================*/
-
-/*! the currently active read file descriptor */
-static int active_read_fd = STDIN_FILENO;
-
-/*! the currently active write file descriptor */
-static int active_write_fd = STDOUT_FILENO;
-
-/*! number of open files */
-static int numOpenFiles = 3;
-
-/*! file descriptor storage */
-FileDescriptor FILES[MAX_OPEN_FILES];
+static int Findfd( tzFiles *pFiles, int fd );
+static int ScanNumber( tzFiles *pFiles );
+static char GetMode( tzFiles *pFiles, int fd );
+static int GetFreeFDIndex( tzFiles *pFiles );
 
 /*==============================================================================
         Function definitions
@@ -121,27 +86,61 @@ FileDescriptor FILES[MAX_OPEN_FILES];
     1 = stdout
     2 = stderr
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
 ==============================================================================*/
-void InitFiles( void )
+void InitFiles( tzFiles *pFiles )
 {
     int i;
 
-    memset( FILES, 0, sizeof( FILES ) );
+    memset( pFiles, 0, sizeof( tzFiles ) );
+
+    pFiles->active_read_fd = STDIN_FILENO;
+    pFiles->active_write_fd = STDOUT_FILENO;
 
-    FILES[STDIN_FILENO].fd = 0;
-    FILES[STDIN_FILENO].mode = 'r';
+    pFiles->files[STDIN_FILENO].fd = 0;
+    pFiles->files[STDIN_FILENO].mode = 'r';
 
-    FILES[STDOUT_FILENO].fd = 1;
-    FILES[STDOUT_FILENO].mode = 'w';
+    pFiles->files[STDOUT_FILENO].fd = 1;
+    pFiles->files[STDOUT_FILENO].mode = 'w';
 
-    FILES[STDERR_FILENO].fd = 2;
-    FILES[STDERR_FILENO].mode = 'w';
+    pFiles->files[STDERR_FILENO].fd = 2;
+    pFiles->files[STDERR_FILENO].mode = 'w';
 
-    numOpenFiles = 3;
+    pFiles->numOpenFiles = 3;
 
-    for( i=numOpenFiles ; i < MAX_OPEN_FILES; i++ )
+    for( i=pFiles->numOpenFiles ; i < MAX_OPEN_FILES; i++ )
     {
-        FILES[i].fd = -1;
+        pFiles->files[i].fd = -1;
+    }
+}
+
+/*============================================================================*/
+/*  CloseFiles                                                                */
+/*!
+    Close all the files opened by the VM instance
+
+    The CloseFiles function closes all the files which were opened by
+    the VM instance via OpenFileDescriptor.  External file descriptors
+    are not closed since they are owned by the external variable library.
+
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
+==============================================================================*/
+void CloseFiles( tzFiles *pFiles )
+{
+    int i;
+
+    for( i = 3; i < MAX_OPEN_FILES; i++ )
+    {
+        if( pFiles->files[i].opened == true )
+        {
+            (void)CloseFileDescriptor( pFiles, pFiles->files[i].fd );
+        }
     }
 }
 
@@ -153,18 +152,22 @@ void InitFiles( void )
     The GetFreeFDIndex function scans the file descriptor list looking for the
     first available slot.  (where fd == -1 )
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @retval index of free file descriptor
     @retval -1 if there are no free indexes
 
 ==============================================================================*/
-static int GetFreeFDIndex( void )
+static int GetFreeFDIndex( tzFiles *pFiles )
 {
     int idx;
     int result = -1;
 
     for ( idx = 3; idx < MAX_OPEN_FILES ; idx++ )
     {
-        if ( FILES[idx].fd == -1 )
+        if ( pFiles->files[idx].fd == -1 )
         {
             result = idx;
             break;
@@ -182,6 +185,10 @@ static int GetFreeFDIndex( void )
     The SetExternFileDescriptor function inserts a new external write
     file descriptor in the file descriptor list.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         fd
             the new external write file descriptor
@@ -196,7 +203,7 @@ static int GetFreeFDIndex( void )
     @retval EXIST the file descriptor already exists
 
 ==============================================================================*/
-int SetExternWriteFileDescriptor( int fd, char mode )
+int SetExternWriteFileDescriptor( tzFiles *pFiles, int fd, char mode )
 {
     int result = EBADF;
     int i;
@@ -206,17 +213,17 @@ int SetExternWriteFileDescriptor( int fd, char mode )
     if ( fd > 0 )
     {
         /* confirm it does not already exist */
-        if (Findfd( fd ) == -1 )
+        if (Findfd( pFiles, fd ) == -1 )
         {
-            idx = GetFreeFDIndex();
+            idx = GetFreeFDIndex( pFiles );
             if( idx != -1 )
             {
                 /* insert the new file descriptor */
-                FILES[idx].fd = fd;
-                FILES[idx].mode = mode;
+                pFiles->files[idx].fd = fd;
+                pFiles->files[idx].mode = mode;
 
                 /* increment the number of file descriptors we are tracking */
-                numOpenFiles++;
+                pFiles->numOpenFiles++;
 
                 /* indicate success */
                 result = EOK;
@@ -245,6 +252,10 @@ int SetExternWriteFileDescriptor( int fd, char mode )
     The ClearExternFileDescriptor function cleans up the specified
     file descriptor reservation in the file descriptor list
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         fd
             the file descriptor to clean up
@@ -254,22 +265,22 @@ int SetExternWriteFileDescriptor( int fd, char mode )
     @retval ENOENT the specified file descriptor does not exists
 
 ==============================================================================*/
-int ClearExternFileDescriptor( int fd )
+int ClearExternFileDescriptor( tzFiles *pFiles, int fd )
 {
     int result = EBADF;
     int idx;
 
     if ( fd > 0 )
     {
-        idx = Findfd( fd );
+        idx = Findfd( pFiles, fd );
         if ( idx != -1 )
         {
             /* free up the file descriptor */
-            FILES[idx].fd = -1;
-            FILES[idx].mode = 0;
+            pFiles->files[idx].fd = -1;
+            pFiles->files[idx].mode = 0;
 
             /* decrement the number of file descriptors we are tracking */
-            numOpenFiles--;
+            pFiles->numOpenFiles--;
 
             /* indicate success */
             result = EOK;
@@ -291,6 +302,10 @@ int ClearExternFileDescriptor( int fd )
     The SetActiveFileDescriptor function selects the currently active
     file that the I/O functions will target.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         fd
             the new active file descriptor
@@ -301,7 +316,7 @@ int ClearExternFileDescriptor( int fd )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int SetActiveFileDescriptor( int fd )
+int SetActiveFileDescriptor( tzFiles *pFiles, int fd )
 {
     int result = EBADF;
     int idx;
@@ -309,17 +324,17 @@ int SetActiveFileDescriptor( int fd )
     if( ( fd > 0 ) &&
         ( fd < MAX_OPEN_FILES ) )
     {
-        idx = Findfd( fd );
+        idx = Findfd( pFiles, fd );
         if( idx != -1 )
         {
-            if( tolower( FILES[idx].mode ) == 'r' )
+            if( tolower( pFiles->files[idx].mode ) == 'r' )
             {
-                active_read_fd = fd;
+                pFiles->active_read_fd = fd;
                 result = EOK;
             }
-            else if ( tolower( FILES[idx].mode ) == 'w' )
+            else if ( tolower( pFiles->files[idx].mode ) == 'w' )
             {
-                active_write_fd = fd;
+                pFiles->active_write_fd = fd;
                 result = EOK;
             }
         }
@@ -331,14 +346,17 @@ int SetActiveFileDescriptor( int fd )
 /*============================================================================*/
 /*  OpenFileDescriptor                                                        */
 /*!
-    Open a file give the file name in a stringbuffer
+    Open a file given its file name
 
     The Open File Descriptor function opens a file whose pathspec is
-    specified in a stringbuffer.
+    specified by the caller, usually from a stringbuffer.
+
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
 
     @param[in]
-        stringID
-            specifies the id of the stringbuffer which contains the
+        pFileName
             path specification for the file to be opened
 
     @param[in]
@@ -355,9 +373,11 @@ int SetActiveFileDescriptor( int fd )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int OpenFileDescriptor( int stringID, char mode, int *fd )
+int OpenFileDescriptor( tzFiles *pFiles,
+                        char *pFileName,
+                        char mode,
+                        int *fd )
 {
-    char *pFileName;
     int result = EINVAL;
     FILE *fp;
     int idx;
@@ -369,8 +389,6 @@ int OpenFileDescriptor( int stringID, char mode, int *fd )
           ( mode == 'R' ) ||
           ( mode == 'W' ) ) )
     {
-        /* get the name of the file to open */
-        pFileName = STRINGBUFFER_fnGet( stringID );
         if( pFileName != NULL )
         {
             if( mode == 'r' || mode == 'R' )
@@ -383,7 +401,7 @@ int OpenFileDescriptor( int stringID, char mode, int *fd )
             }
 
             /* get the index for the new file descriptor */
-            idx = GetFreeFDIndex();
+            idx = GetFreeFDIndex( pFiles );
             if( idx != -1 )
             {
                 /* open the file */
@@ -391,11 +409,12 @@ int OpenFileDescriptor( int stringID, char mode, int *fd )
                 if( *fd != -1 )
                 {
                     /* store the file descriptor and open mode */
-                    FILES[idx].fd = *fd;
-                    FILES[idx].mode = mode;
+                    pFiles->files[idx].fd = *fd;
+                    pFiles->files[idx].mode = mode;
+                    pFiles->files[idx].opened = true;
 
                     /* increment the number of open files */
-                    numOpenFiles++;
+                    pFiles->numOpenFiles++;
 
                     /* indicate success */
                     result = EOK;
@@ -423,6 +442,10 @@ int OpenFileDescriptor( int stringID, char mode, int *fd )
     The Close File Descriptor function closes the file with the specified
     file descriptor
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         fd
             the file descriptor of the file to close
@@ -432,7 +455,7 @@ int OpenFileDescriptor( int stringID, char mode, int *fd )
     @retval EBADF Bad file descriptor
 
 ==============================================================================*/
-int CloseFileDescriptor( int fd )
+int CloseFileDescriptor( tzFiles *pFiles, int fd )
 {
     int result = EBADF;
     int i;
@@ -444,14 +467,15 @@ int CloseFileDescriptor( int fd )
 
         for ( i=3; i<MAX_OPEN_FILES; i++ )
         {
-            if ( FILES[i].fd == fd )
+            if ( pFiles->files[i].fd == fd )
             {
                 close( fd );
-                FILES[i].fd = -1;
-                FILES[i].mode = 0;
+                pFiles->files[i].fd = -1;
+                pFiles->files[i].mode = 0;
+                pFiles->files[i].opened = false;
 
                 /* decrement the number of open files */
-                numOpenFiles--;
+                pFiles->numOpenFiles--;
 
                 result = EOK;
             }
@@ -469,6 +493,10 @@ int CloseFileDescriptor( int fd )
     The WriteString function writes the specified string to the active
     output file descriptor
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         str
             pointer to the nul terminated string to write
@@ -478,7 +506,7 @@ int CloseFileDescriptor( int fd )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int WriteString( char *str )
+int WriteString( tzFiles *pFiles, char *str )
 {
     int result = EINVAL;
     char mode;
@@ -486,9 +514,9 @@ int WriteString( char *str )
 
     if( str != NULL )
     {
-        if ( active_write_fd != -1 )
+        if ( pFiles->active_write_fd != -1 )
         {
-            dprintf( active_write_fd, "%s", str );
+            dprintf( pFiles->active_write_fd, "%s", str );
             result = EOK;
         }
         else
@@ -512,6 +540,10 @@ int WriteString( char *str )
     as a text file with mode = 'w', then the number will be written as
     a text value.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         n
             the number to be written
@@ -521,14 +553,14 @@ int WriteString( char *str )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int WriteNum( int n )
+int WriteNum( tzFiles *pFiles, int n )
 {
     int result = EBADF;
     char mode;
 
-    if( active_write_fd != -1 )
+    if( pFiles->active_write_fd != -1 )
     {
-        mode = GetMode( active_write_fd );
+        mode = GetMode( pFiles, pFiles->active_write_fd );
         if( mode == 0 )
         {
             mode = 'w';
@@ -536,12 +568,12 @@ int WriteNum( int n )
 
         if( mode == 'W' )
         {
-            write( active_write_fd, &n, sizeof(int) );
+            write( pFiles->active_write_fd, &n, sizeof(int) );
             result = EOK;
         }
         else if( mode == 'w' )
         {
-            dprintf( active_write_fd, "%d", n );
+            dprintf( pFiles->active_write_fd, "%d", n );
             result = EOK;
         }
         else
@@ -567,6 +599,10 @@ int WriteNum( int n )
     as a text file with mode = 'w', then the number will be written as
     a text value.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         f
             the floating point number to be written
@@ -576,15 +612,15 @@ int WriteNum( int n )
     @retval EBADF bad file descriptor
 
 ==============================================================================*/
-int WriteFloat( float f )
+int WriteFloat( tzFiles *pFiles, float f )
 {
     int result = EBADF;
     char mode;
     FILE *fp;
 
-    if( active_write_fd != -1 )
+    if( pFiles->active_write_fd != -1 )
     {
-        mode = GetMode( active_write_fd );
+        mode = GetMode( pFiles, pFiles->active_write_fd );
         if( mode == 0 )
         {
             mode = 'w';
@@ -592,12 +628,12 @@ int WriteFloat( float f )
 
         if( mode == 'W' )
         {
-            write( active_write_fd, &f, sizeof(float) );
+            write( pFiles->active_write_fd, &f, sizeof(float) );
             result = EOK;
         }
         else if( mode == 'w' )
         {
-            dprintf( active_write_fd, "%f", f );
+            dprintf( pFiles->active_write_fd, "%f", f );
             result = EOK;
         }
         else
@@ -623,6 +659,10 @@ int WriteFloat( float f )
     as a text file with mode = 'w', then the character will be written as
     a text value.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
         c
             the character to be written
@@ -632,27 +672,27 @@ int WriteFloat( float f )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int WriteChar( char c )
+int WriteChar( tzFiles *pFiles, char c )
 {
     int result = EINVAL;
     char mode;
     FILE *fp;
 
-    mode = GetMode( active_write_fd );
+    mode = GetMode( pFiles, pFiles->active_write_fd );
     if( mode == 0 )
     {
         mode = 'w';
     }
-    if( active_write_fd != -1 )
+    if( pFiles->active_write_fd != -1 )
     {
         if( mode == 'W' )
         {
-            write( active_write_fd, &c, 1 );
+            write( pFiles->active_write_fd, &c, 1 );
             result = EOK;
         }
         else if( mode == 'w' )
         {
-            dprintf( active_write_fd, "%c", c );
+            dprintf( pFiles->active_write_fd, "%c", c );
             result = EOK;
         }
         else
@@ -677,6 +717,10 @@ int WriteChar( char c )
     as a text file with mode = 'r', then the number will be read as
     a text value.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in,out]
         n
             pointer to the location to store the number being read
@@ -686,7 +730,7 @@ int WriteChar( char c )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int ReadNum( int *n )
+int ReadNum( tzFiles *pFiles, int *n )
 {
     int result = EINVAL;
     FILE *fp;
@@ -694,7 +738,7 @@ int ReadNum( int *n )
 
     if( n != NULL )
     {
-        mode = GetMode(active_read_fd);
+        mode = GetMode( pFiles, pFiles->active_read_fd );
         if( mode == 0 )
         {
             mode = 'r';
@@ -704,14 +748,14 @@ int ReadNum( int *n )
         if( mode == 'R' )
         {
             /* read an integer from the file descriptor */
-            if( read( active_read_fd, n, sizeof(int) ) == sizeof(int) )
+            if( read( pFiles->active_read_fd, n, sizeof(int) ) == sizeof(int) )
             {
                 result = EOK;
             }
         }
         else if( mode == 'r' )
         {
-            *n = ScanNumber();
+            *n = ScanNumber( pFiles );
             result = EOK;
         }
     }
@@ -728,10 +772,14 @@ int ReadNum( int *n )
     file descriptor and converts it to an integer using atol
     The last non numeric character in the input stream is lost
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @retval the scanned number
 
 ==============================================================================*/
-static int ScanNumber( void )
+static int ScanNumber( tzFiles *pFiles )
 {
     char ch;
     char buf[BUFSIZ];
@@ -747,7 +795,7 @@ static int ScanNumber( void )
     while( !done && ( idx < BUFSIZ-1 ) )
     {
         /* read the number one character at a time */
-        if( read( active_read_fd, &ch, 1 ) == 1 )
+        if( read( pFiles->active_read_fd, &ch, 1 ) == 1 )
         {
             switch( state )
             {
@@ -809,6 +857,10 @@ static int ScanNumber( void )
     as a text file with mode = 'r', then the character will be read as
     a text value.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in,out]
         c
             pointer to the location to store the character being read
@@ -819,7 +871,7 @@ static int ScanNumber( void )
     @retval EINVAL invalid arguments
 
 ==============================================================================*/
-int ReadChar( char *c )
+int ReadChar( tzFiles *pFiles, char *c )
 {
     int result = EINVAL;
     int n;
@@ -828,10 +880,10 @@ int ReadChar( char *c )
 
     if( c != NULL )
     {
-        if( active_read_fd != -1 )
+        if( pFiles->active_read_fd != -1 )
         {
             /* read the character from the file descriptor */
-            n = read( active_read_fd, &ch, 1 );
+            n = read( pFiles->active_read_fd, &ch, 1 );
             if( n == 1 )
             {
                 *c = ch;
@@ -860,6 +912,10 @@ int ReadChar( char *c )
     the read or write mode associated with the specified file descriptor.
     If the file descriptor is not found, an invalid mode will be returned.
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
        fd
             file descriptor to search for
@@ -871,15 +927,15 @@ int ReadChar( char *c )
     @retval -1 if the file descriptor is not found
 
 ==============================================================================*/
-static char GetMode( int fd )
+static char GetMode( tzFiles *pFiles, int fd )
 {
     int idx;
     char mode = '\0';
 
-    idx = Findfd( fd );
+    idx = Findfd( pFiles, fd );
     if( idx != -1 )
     {
-        mode = FILES[idx].mode;
+        mode = pFiles->files[idx].mode;
     }
 
     return mode;
@@ -893,6 +949,10 @@ static char GetMode( int fd )
     The Findfd function searches the open files array for the specified
     file descriptor and returns its index
 
+    @param[in]
+        pFiles
+            pointer to the open files of the VM instance
+
     @param[in]
        fd
             file descriptor to search for
@@ -901,7 +961,7 @@ static char GetMode( int fd )
     @retval -1 if the file descriptor is not found
 
 ==============================================================================*/
-static int Findfd( int fd )
+static int Findfd( tzFiles *pFiles, int fd )
 {
     int idx;
     int result = -1;
@@ -911,7 +971,7 @@ static int Findfd( int fd )
         /* search for the file descriptor in the open files list */
         for ( idx=3; idx < MAX_OPEN_FILES; idx++ )
         {
-            if( FILES[idx].fd == fd )
+            if( pFiles->files[idx].fd == fd )
             {
                 result = idx;
                 break;
@@ -0,0 +1,2142 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+
+/*!
+ * @defgroup jit JIT Compiler
+ * @brief Translate VM byte code into x86-64 machine code
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file jit.c
+
+    JIT Compiler
+
+    The JIT Compiler translates basic blocks of VM byte code into
+    native x86-64 machine code using a fixed machine code template
+    for each supported operation.
+
+    Data movement (LOD, STR, MOV), integer arithmetic, comparisons and
+    branches are translated directly.  All other operations are executed
+    by calling back into the VM core interpreter from the translated code.
+    Any instruction the translated code cannot execute safely (for example
+    a memory access which is out of range, or a store into the program
+    image) ends the block and is executed by the interpreter instead.
+
+    Translations are discarded when the program writes into its own
+    program image.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <vmcore/core.h>
+#include <vmcore/datatypes.h>
+#include "jit.h"
+
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+#include <sys/mman.h>
+#endif
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+#ifndef EOK
+/*! success response */
+#define EOK 0
+#endif
+
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+
+/*! maximum number of VM instructions translated into a single block */
+#define JIT_MAX_BLOCK_INSTRUCTIONS ( 64 )
+
+/*! maximum size of the machine code generated for a single block */
+#define JIT_MAX_BLOCK_SIZE ( 16384 )
+
+/*! size of the machine code buffer */
+#define JIT_CODE_SIZE ( 1024 * 1024 )
+
+/*! block map marker for a program address which cannot be translated */
+#define JIT_NO_BLOCK ( (void *)1 )
+
+/*! offset of a VM register from the register base */
+#define JIT_REG(R) ( (uint8_t)( (R) * sizeof( int32_t ) ) )
+
+/*! offset of the program counter (R15) from the register base */
+#define JIT_PC JIT_REG( 15 )
+
+/*! number of bytes accessed by a LOD or STR with the specified width flags */
+#define JIT_WIDTH(OP) ( ( (OP) & BYTE ) ? 1 : ( (OP) & WORD ) ? 2 : 4 )
+
+/*! x86-64 condition code: jump if below */
+#define JB  0x72
+
+/*! x86-64 condition code: jump if above or equal */
+#define JAE 0x73
+
+/*! x86-64 condition code: jump if equal / zero */
+#define JE  0x74
+
+/*! x86-64 condition code: jump if not equal / not zero */
+#define JNE 0x75
+
+/*! x86-64 condition code: jump if below or equal */
+#define JBE 0x76
+
+/*! x86-64 condition code: jump if above */
+#define JA  0x77
+
+/*! x86-64 condition code: jump if less (signed) */
+#define JL  0x7C
+
+/*! x86-64 condition code: jump if greater or equal (signed) */
+#define JGE 0x7D
+
+/*! x86-64 condition code: jump if less or equal (signed) */
+#define JLE 0x7E
+
+/*! x86-64 condition code: jump if greater (signed) */
+#define JG  0x7F
+
+/*! x86-64 unconditional short jump */
+#define JMP8 0xEB
+
+/*! classification of a VM instruction for translation */
+typedef enum eJITClass
+{
+    /*! translated into machine code */
+    eJIT_NATIVE,
+
+    /*! translated into machine code, and ends the block */
+    eJIT_BRANCH,
+
+    /*! executed by the interpreter, and the block continues */
+    eJIT_CALLBACK,
+
+    /*! executed by the interpreter, and ends the block */
+    eJIT_EXIT,
+
+    /*! cannot be translated, the block ends before this instruction */
+    eJIT_BAIL
+} teJITClass;
+
+/*! the tzJITInst object describes a decoded VM instruction */
+typedef struct zJITInst
+{
+    /*! address of the instruction */
+    int32_t pc;
+
+    /*! address of the next sequential instruction */
+    int32_t next;
+
+    /*! literal value, memory address or branch target */
+    int32_t imm;
+
+    /*! instruction byte containing the width and mode flags */
+    uint8_t op;
+
+    /*! operation code within the extended instruction set */
+    uint8_t ext;
+
+    /*! destination register */
+    uint8_t dst;
+
+    /*! source register */
+    uint8_t src;
+
+    /*! base register of an LDL, STL, LDX or STX memory access */
+    uint8_t base;
+
+    /*! index register of an LDX or STX memory access */
+    uint8_t index;
+
+    /*! scale applied to the index register, or 0 for no index */
+    int8_t scale;
+
+    /*! width flags of an LDL, STL, LDX or STX memory access */
+    uint8_t width;
+
+    /*! translation class */
+    teJITClass cls;
+
+    /*! true if the instruction sets the status flags */
+    bool setsFlags;
+
+    /*! true if the status flags must be calculated by the instruction */
+    bool emitFlags;
+} tzJITInst;
+
+/*! the tzJIT object holds the state of the JIT compiler for a VM core */
+struct zJIT
+{
+    /*! VM core state accessed by the translated code */
+    tzJITConfig config;
+
+    /*! executable machine code buffer */
+    uint8_t *pCode;
+
+    /*! number of bytes used in the machine code buffer */
+    size_t codeUsed;
+
+    /*! map from program address to translated block */
+    void **pBlocks;
+
+    /*! number of entries in the block map */
+    size_t numBlocks;
+
+    /*! set when translations are discarded while a block is running */
+    uint8_t invalidated;
+};
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static void *jit_fnTranslate( tzJIT *pJIT, int32_t pc );
+static bool jit_fnDecode( tzJIT *pJIT, int32_t pc, tzJITInst *pInst );
+static bool jit_fnDecodeCompare( tzJIT *pJIT, int32_t pc, tzJITInst *pInst );
+static void jit_fnFlagLiveness( tzJITInst *pInsts, size_t n );
+static void jit_fnEmitInst( tzJIT *pJIT,
+                            tzJITInst *pInst,
+                            int32_t start,
+                            size_t body );
+static void jit_fnEmitLOD( tzJIT *pJIT, tzJITInst *pInst );
+static void jit_fnEmitSTR( tzJIT *pJIT, tzJITInst *pInst );
+static void jit_fnEmitLocal( tzJIT *pJIT, tzJITInst *pInst );
+static void jit_fnEmitALU( tzJIT *pJIT, tzJITInst *pInst );
+static void jit_fnEmitBranch( tzJIT *pJIT,
+                              tzJITInst *pInst,
+                              int32_t start,
+                              size_t body );
+static void jit_fnEmitCallback( tzJIT *pJIT, tzJITInst *pInst );
+static void jit_fnEmitFlags( tzJIT *pJIT );
+static void jit_fnEmitPrologue( tzJIT *pJIT );
+static void jit_fnEmitEpilogue( tzJIT *pJIT );
+static void jit_fnEmitExit( tzJIT *pJIT, bool setPC, int32_t pc, int result );
+static void jit_fnEmitLoadReg( tzJIT *pJIT, uint8_t modrm, uint8_t reg );
+static size_t jit_fnEmitJcc( tzJIT *pJIT, uint8_t jcc );
+static void jit_fnPatch( tzJIT *pJIT, size_t pos );
+static void jit_fnEmit( tzJIT *pJIT, const uint8_t *pBytes, size_t len );
+static void jit_fnEmit8( tzJIT *pJIT, uint8_t val );
+static void jit_fnEmit32( tzJIT *pJIT, uint32_t val );
+static void jit_fnEmit64( tzJIT *pJIT, uint64_t val );
+static void jit_fnFlush( tzJIT *pJIT );
+
+#endif
+
+/*==============================================================================
+        Public function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  JIT_fnSupported                                                           */
+/*!
+    Determine if the JIT compiler is available
+
+    The JIT_fnSupported function determines if the JIT compiler was
+    included in this build of the VM core library.  The JIT compiler
+    is only available for x86-64 targets.
+
+    @retval true the JIT compiler is available
+    @retval false the JIT compiler is not available
+
+==============================================================================*/
+bool JIT_fnSupported( void )
+{
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*============================================================================*/
+/*  JIT_fnCreate                                                              */
+/*!
+    Create a JIT compiler for a VM core
+
+    The JIT_fnCreate function creates a JIT compiler which translates the
+    program loaded into the VM core described by the configuration object.
+
+    @param[in]
+        pConfig
+            pointer to the VM core state accessed by the translated code
+
+    @retval pointer to the new JIT compiler
+    @retval NULL the JIT compiler could not be created
+
+==============================================================================*/
+tzJIT *JIT_fnCreate( tzJITConfig *pConfig )
+{
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+    tzJIT *pJIT;
+    void *p;
+
+    if( pConfig == NULL )
+    {
+        return NULL;
+    }
+
+    pJIT = calloc( 1, sizeof( tzJIT ) );
+    if( pJIT == NULL )
+    {
+        return NULL;
+    }
+
+    pJIT->config = *pConfig;
+
+    /* the code buffer is only made executable while it is not written */
+    p = mmap( NULL,
+              JIT_CODE_SIZE,
+              PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS,
+              -1,
+              0 );
+    if( p == MAP_FAILED )
+    {
+        free( pJIT );
+        return NULL;
+    }
+
+    pJIT->pCode = p;
+
+    JIT_fnReset( pJIT, pConfig->programSize );
+    if( ( pJIT->pBlocks == NULL ) && ( pConfig->programSize > 0 ) )
+    {
+        munmap( pJIT->pCode, JIT_CODE_SIZE );
+        free( pJIT );
+        return NULL;
+    }
+
+    return pJIT;
+#else
+    (void)pConfig;
+    return NULL;
+#endif
+}
+
+/*============================================================================*/
+/*  JIT_fnDestroy                                                             */
+/*!
+    Destroy a JIT compiler
+
+    The JIT_fnDestroy function releases the code buffer and the block
+    table of a JIT compiler created by JIT_fnCreate.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler, or NULL
+
+==============================================================================*/
+void JIT_fnDestroy( tzJIT *pJIT )
+{
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+    if( pJIT == NULL )
+    {
+        return;
+    }
+
+    munmap( pJIT->pCode, JIT_CODE_SIZE );
+    free( pJIT->pBlocks );
+    free( pJIT );
+#else
+    (void)pJIT;
+#endif
+}
+
+/*============================================================================*/
+/*  JIT_fnExecute                                                             */
+/*!
+    Execute translated code at the program counter
+
+    The JIT_fnExecute function executes the translated block at the
+    VM core program counter, translating it first if necessary.
+    The translated block returns when it reaches a branch which leaves
+    the block, when an instruction executed by the interpreter changes
+    the flow of the program, or when it reaches an instruction which
+    must be executed by the interpreter.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @retval EOK the translated block was executed
+    @retval EAGAIN the instruction at the program counter must be
+            executed by the interpreter
+    @retval ENOENT no translation exists at the program counter
+    @retval EINVAL invalid arguments
+
+==============================================================================*/
+int JIT_fnExecute( tzJIT *pJIT )
+{
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+    int32_t pc;
+    void *pBlock;
+    int (*fn)( void );
+
+    if( pJIT == NULL )
+    {
+        return EINVAL;
+    }
+
+    pc = pJIT->config.pReg[15];
+    if( ( pc < 0 ) || ( (size_t)pc >= pJIT->numBlocks ) )
+    {
+        return ENOENT;
+    }
+
+    pBlock = pJIT->pBlocks[pc];
+    if( pBlock == NULL )
+    {
+        pBlock = jit_fnTranslate( pJIT, pc );
+        pJIT->pBlocks[pc] = pBlock;
+    }
+
+    if( pBlock == JIT_NO_BLOCK )
+    {
+        return ENOENT;
+    }
+
+    pJIT->invalidated = 0;
+
+    fn = (int (*)( void ))pBlock;
+
+    return ( fn() == 0 ) ? EOK : EAGAIN;
+#else
+    (void)pJIT;
+    return ENOTSUP;
+#endif
+}
+
+/*============================================================================*/
+/*  JIT_fnReset                                                               */
+/*!
+    Discard all translations
+
+    The JIT_fnReset function discards all translated blocks and sets the
+    size of the program to be translated.  It must be called whenever a
+    new program is loaded into the VM core memory, and must not be
+    called from an instruction executed by translated code.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        programSize
+            size of the program loaded into the VM core memory
+
+==============================================================================*/
+void JIT_fnReset( tzJIT *pJIT, size_t programSize )
+{
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+    if( pJIT == NULL )
+    {
+        return;
+    }
+
+    free( pJIT->pBlocks );
+    pJIT->pBlocks = NULL;
+    pJIT->numBlocks = 0;
+    pJIT->codeUsed = 0;
+    pJIT->config.programSize = programSize;
+
+    if( programSize > 0 )
+    {
+        pJIT->pBlocks = calloc( programSize, sizeof( void * ) );
+        if( pJIT->pBlocks != NULL )
+        {
+            pJIT->numBlocks = programSize;
+        }
+    }
+#else
+    (void)pJIT;
+    (void)programSize;
+#endif
+}
+
+/*============================================================================*/
+/*  JIT_fnInvalidate                                                          */
+/*!
+    Discard translations after a write to the program image
+
+    The JIT_fnInvalidate function is called when the VM core memory is
+    modified.  If the modified memory is inside the program image, all
+    translated blocks are discarded and any block which is currently
+    running returns as soon as control comes back to it.
+
+    The machine code buffer is not re-used until the next translation,
+    so it is safe to call this function from an instruction executed
+    by translated code.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        addr
+            address of the modified VM core memory
+
+    @param[in]
+        len
+            number of bytes modified
+
+==============================================================================*/
+void JIT_fnInvalidate( tzJIT *pJIT, uint32_t addr, size_t len )
+{
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+    (void)len;
+
+    if( ( pJIT == NULL ) ||
+        ( pJIT->pBlocks == NULL ) ||
+        ( addr >= pJIT->numBlocks ) )
+    {
+        return;
+    }
+
+    memset( pJIT->pBlocks, 0, pJIT->numBlocks * sizeof( void * ) );
+    pJIT->invalidated = 1;
+#else
+    (void)pJIT;
+    (void)addr;
+    (void)len;
+#endif
+}
+
+#if defined( VMCORE_JIT ) && defined( __x86_64__ )
+
+/*==============================================================================
+        Private function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  jit_fnTranslate                                                           */
+/*!
+    Translate a basic block
+
+    The jit_fnTranslate function decodes the VM instructions starting at
+    the specified program address up to the end of the basic block, and
+    generates the machine code for them.
+
+    Generated blocks have the signature int fn( void ), and return 0
+    if execution can continue at the VM program counter, or 1 if the
+    instruction at the VM program counter must be executed by the
+    interpreter.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pc
+            address of the first instruction in the block
+
+    @retval pointer to the translated block
+    @retval JIT_NO_BLOCK the block cannot be translated
+
+==============================================================================*/
+static void *jit_fnTranslate( tzJIT *pJIT, int32_t pc )
+{
+    tzJITInst insts[JIT_MAX_BLOCK_INSTRUCTIONS];
+    size_t n = 0;
+    size_t i;
+    size_t body;
+    int32_t addr = pc;
+    uint8_t *pBlock;
+    tzJITInst *pLast;
+
+    /* decode the basic block */
+    while( n < JIT_MAX_BLOCK_INSTRUCTIONS )
+    {
+        if( jit_fnDecode( pJIT, addr, &insts[n] ) == false )
+        {
+            insts[n].cls = eJIT_BAIL;
+        }
+
+        if( ( insts[n++].cls != eJIT_NATIVE ) &&
+            ( insts[n-1].cls != eJIT_CALLBACK ) )
+        {
+            break;
+        }
+
+        addr = insts[n-1].next;
+        if( (size_t)addr >= pJIT->config.programSize )
+        {
+            break;
+        }
+    }
+
+    if( ( insts[0].cls == eJIT_BAIL ) || ( insts[0].cls == eJIT_EXIT ) )
+    {
+        /* there is nothing to gain from translating this block */
+        return JIT_NO_BLOCK;
+    }
+
+    jit_fnFlagLiveness( insts, n );
+
+    if( pJIT->codeUsed + JIT_MAX_BLOCK_SIZE > JIT_CODE_SIZE )
+    {
+        jit_fnFlush( pJIT );
+    }
+
+    if( mprotect( pJIT->pCode, JIT_CODE_SIZE, PROT_READ | PROT_WRITE ) != 0 )
+    {
+        return JIT_NO_BLOCK;
+    }
+
+    pBlock = &pJIT->pCode[pJIT->codeUsed];
+
+    jit_fnEmitPrologue( pJIT );
+    body = pJIT->codeUsed;
+
+    for( i = 0; i < n; i++ )
+    {
+        jit_fnEmitInst( pJIT, &insts[i], pc, body );
+    }
+
+    pLast = &insts[n-1];
+    if( ( pLast->cls == eJIT_NATIVE ) || ( pLast->cls == eJIT_CALLBACK ) )
+    {
+        /* fall through to the next block */
+        jit_fnEmitExit( pJIT, true, pLast->next, 0 );
+    }
+
+    if( mprotect( pJIT->pCode, JIT_CODE_SIZE, PROT_READ | PROT_EXEC ) != 0 )
+    {
+        return JIT_NO_BLOCK;
+    }
+
+    return pBlock;
+}
+
+/*============================================================================*/
+/*  jit_fnDecode                                                              */
+/*!
+    Decode a VM instruction for translation
+
+    The jit_fnDecode function decodes the VM instruction at the specified
+    program address, and classifies how it is to be translated.  The
+    decoding follows exactly how the interpreter opXXX functions
+    interpret the instruction bytes.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pc
+            address of the instruction
+
+    @param[out]
+        pInst
+            pointer to the tzJITInst object to populate
+
+    @retval true the instruction was decoded
+    @retval false the instruction cannot be translated
+
+==============================================================================*/
+static bool jit_fnDecode( tzJIT *pJIT, int32_t pc, tzJITInst *pInst )
+{
+    uint8_t *instr = &pJIT->config.pMemory[pc];
+    uint8_t op = instr[0];
+    bool isReg = ( ( op & MODE_REG ) == MODE_REG );
+    bool isFloat = ( ( op & FLOAT32 ) == FLOAT32 );
+    bool isSigned = ( ( op & 0x1F ) >= HMOV );
+    bool native = *pJIT->config.pNativeEndian;
+    size_t size;
+    size_t len = 0;
+    uint32_t val;
+    uint16_t val16;
+
+    memset( pInst, 0, sizeof( tzJITInst ) );
+    pInst->pc = pc;
+    pInst->op = op;
+    pInst->dst = ( instr[1] >> 4 ) & 0x0F;
+    pInst->src = instr[1] & 0x0F;
+    pInst->cls = eJIT_NATIVE;
+
+    /* size of a literal value encoded by the width flags */
+    switch( op & ( BYTE | WORD ) )
+    {
+        case BYTE:
+            size = 1;
+            break;
+
+        case WORD:
+            size = 2;
+            break;
+
+        default:
+            size = 4;
+            break;
+    }
+
+    switch( op & 0x1F )
+    {
+        case HNOP:
+            len = 1;
+            break;
+
+        case HLOD:
+        case HSTR:
+        case HMOV:
+        case HADD:
+        case HSUB:
+        case HMUL:
+        case HDIV:
+        case HAND:
+        case HOR:
+        case HCMP:
+            len = isReg ? 2 : 2 + size;
+            if( isReg == false )
+            {
+                /* register in the low nibble, followed by a literal */
+                pInst->dst = instr[1] & 0x0F;
+            }
+            break;
+
+        case HNOT:
+        case HTOF:
+        case HTOI:
+        case HPSH:
+        case HPOP:
+            pInst->dst = instr[1] & 0x0F;
+            len = 2;
+            break;
+
+        case HSHR:
+            pInst->dst = instr[1] & 0x0F;
+            pInst->imm = instr[2] & 0x1F;
+            len = 3;
+            break;
+
+        case HSHL:
+            len = 3 + size;
+            break;
+
+        case HJMP:
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            len = 3;
+            break;
+
+        case HNEXT:
+            pInst->ext = instr[2] & 0x1F;
+            if( ( ( instr[1] & 0x1F ) == HNEXT ) &&
+                ( pInst->ext >= HBLT ) &&
+                ( pInst->ext <= HBNE ) )
+            {
+                return jit_fnDecodeCompare( pJIT, pc, pInst );
+            }
+
+            if( ( instr[1] & 0x1F ) != HNEXT )
+            {
+                /* the other extended instructions */
+                pInst->cls = eJIT_EXIT;
+                return true;
+            }
+
+            if( ( pInst->ext == HLDL ) || ( pInst->ext == HSTL ) )
+            {
+                /* 32-bit access at a displacement from the frame pointer */
+                pInst->dst = instr[3] & 0x0F;
+                pInst->src = instr[3] & 0x0F;
+                pInst->base = 1;
+                pInst->index = 0;
+                pInst->scale = 0;
+                pInst->width = 0;
+                len = 4;
+            }
+            else if( ( pInst->ext == HLDX ) || ( pInst->ext == HSTX ) )
+            {
+                /* access at a base register plus a scaled index */
+                pInst->dst = ( instr[3] >> 4 ) & 0x0F;
+                pInst->src = pInst->dst;
+                pInst->base = instr[3] & 0x0F;
+                pInst->index = ( instr[4] >> 4 ) & 0x0F;
+                pInst->scale = (int8_t)( ( instr[4] & 0x0F ) ^ 0x08 ) - 8;
+                pInst->width = instr[2] & ( BYTE | WORD );
+                len = 5;
+            }
+            else
+            {
+                /* the other extended instructions */
+                pInst->cls = eJIT_EXIT;
+                return true;
+            }
+
+            /* the displacement width is taken from the second HNEXT byte */
+            switch( instr[1] & ( BYTE | WORD ) )
+            {
+                case BYTE:
+                    val = (uint32_t)(int32_t)(int8_t)instr[len];
+                    len += 1;
+                    break;
+
+                case WORD:
+                    if( native )
+                    {
+                        memcpy( &val16, &instr[len], sizeof( val16 ) );
+                    }
+                    else
+                    {
+                        val16 = (uint16_t)( ( instr[len] << 8 ) +
+                                            instr[len + 1] );
+                    }
+                    val = (uint32_t)(int32_t)(int16_t)val16;
+                    len += 2;
+                    break;
+
+                default:
+                    /* 32-bit displacements are left to the interpreter */
+                    return false;
+            }
+
+            pInst->next = pc + len;
+            pInst->imm = val;
+
+            /* the interpreter repeats an access which leaves the block, so
+               the address must not depend on R2, which has been updated */
+            return ( (size_t)pInst->next <= pJIT->config.programSize ) &&
+                   ( pInst->dst != 15 ) &&
+                   ( pInst->base != 15 ) &&
+                   ( pInst->base != 2 ) &&
+                   ( ( pInst->scale == 0 ) ||
+                     ( ( pInst->index != 15 ) && ( pInst->index != 2 ) ) );
+
+        default:
+            /* CAL, RET, HLT, EXT, GET, SET and the extended instructions */
+            pInst->cls = eJIT_EXIT;
+            return true;
+    }
+
+    pInst->next = pc + len;
+    if( (size_t)pInst->next > pJIT->config.programSize )
+    {
+        return false;
+    }
+
+    if( len == 1 )
+    {
+        /* NOP */
+        return true;
+    }
+
+    /* read a literal value */
+    if( ( ( op & 0x1F ) >= HJMP ) && ( ( op & 0x1F ) <= HJNC ) )
+    {
+        if( size != 2 )
+        {
+            /* only 16-bit branch targets are translated */
+            pInst->cls = eJIT_EXIT;
+            return true;
+        }
+
+        /* branch target follows the opcode */
+        isSigned = false;
+        instr++;
+    }
+    else
+    {
+        /* literal follows the opcode and register */
+        instr += 2;
+    }
+
+    switch( size )
+    {
+        case 1:
+            val = instr[0];
+            if( isSigned )
+            {
+                val = (uint32_t)(int32_t)(int8_t)val;
+            }
+            break;
+
+        case 2:
+            if( native )
+            {
+                memcpy( &val16, instr, sizeof( val16 ) );
+                val = val16;
+            }
+            else
+            {
+                val = ( instr[0] << 8 ) + instr[1];
+            }
+
+            if( isSigned )
+            {
+                val = (uint32_t)(int32_t)(int16_t)val;
+            }
+            break;
+
+        default:
+            if( native )
+            {
+                memcpy( &val, instr, sizeof( val ) );
+            }
+            else
+            {
+                val = ( (uint32_t)instr[0] << 24 ) +
+                      ( instr[1] << 16 ) +
+                      ( instr[2] << 8 ) +
+                      instr[3];
+            }
+            break;
+    }
+
+    switch( op & 0x1F )
+    {
+        case HLOD:
+        case HSTR:
+            if( isReg )
+            {
+                /* reading the PC register is not supported */
+                return ( pInst->dst != 15 ) && ( pInst->src != 15 );
+            }
+
+            pInst->imm = val;
+            pInst->src = pInst->dst;
+
+            /* out of range addresses and stores into the program image
+               are left to the interpreter */
+            if( ( val > pJIT->config.coreSize - JIT_WIDTH( op ) ) ||
+                ( ( ( op & 0x1F ) == HSTR ) &&
+                  ( val < pJIT->config.programSize ) ) )
+            {
+                return false;
+            }
+
+            return ( pInst->dst != 15 );
+
+        case HMOV:
+        case HADD:
+        case HSUB:
+        case HMUL:
+        case HDIV:
+        case HAND:
+        case HOR:
+        case HCMP:
+            if( isReg == false )
+            {
+                pInst->imm = val;
+                pInst->src = 0;
+            }
+
+            if( ( isFloat ) && ( ( op & 0x1F ) != HMOV ) &&
+                ( ( op & 0x1F ) != HAND ) && ( ( op & 0x1F ) != HOR ) )
+            {
+                /* floating point operations use the interpreter */
+                pInst->cls = eJIT_CALLBACK;
+                return true;
+            }
+
+            pInst->setsFlags = ( ( op & 0x1F ) != HMOV );
+            return ( pInst->dst != 15 ) && ( pInst->src != 15 );
+
+        case HNOT:
+        case HSHR:
+            return ( pInst->dst != 15 );
+
+        case HTOF:
+        case HTOI:
+        case HPSH:
+        case HPOP:
+        case HSHL:
+            pInst->cls = eJIT_CALLBACK;
+            return true;
+
+        case HJMP:
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            pInst->imm = val;
+            pInst->cls = eJIT_BRANCH;
+            return true;
+
+        default:
+            return true;
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnDecodeCompare                                                       */
+/*!
+    Decode a compare and branch instruction for translation
+
+    The jit_fnDecodeCompare function decodes the BLT, BLE, BEQ and BNE
+    instructions.  Integer comparisons with a 16-bit branch target are
+    translated, the floating point comparisons are executed by the
+    interpreter.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pc
+            address of the instruction
+
+    @param[in,out]
+        pInst
+            pointer to the tzJITInst object to populate
+
+    @retval true the instruction was decoded
+    @retval false the instruction cannot be translated
+
+==============================================================================*/
+static bool jit_fnDecodeCompare( tzJIT *pJIT, int32_t pc, tzJITInst *pInst )
+{
+    uint8_t *instr = &pJIT->config.pMemory[pc];
+    uint16_t val16;
+
+    if( ( ( instr[1] & ( BYTE | WORD ) ) != WORD ) ||
+        ( ( instr[2] & FLOAT32 ) == FLOAT32 ) )
+    {
+        pInst->cls = eJIT_EXIT;
+        return true;
+    }
+
+    pInst->next = pc + 6;
+    if( (size_t)pInst->next > pJIT->config.programSize )
+    {
+        return false;
+    }
+
+    if( *pJIT->config.pNativeEndian )
+    {
+        memcpy( &val16, &instr[4], sizeof( val16 ) );
+    }
+    else
+    {
+        val16 = (uint16_t)( ( instr[4] << 8 ) + instr[5] );
+    }
+
+    pInst->imm = val16;
+    pInst->dst = ( instr[3] >> 4 ) & 0x0F;
+    pInst->src = instr[3] & 0x0F;
+    pInst->cls = eJIT_BRANCH;
+
+    /* reading the PC register is not supported */
+    return ( pInst->dst != 15 ) && ( pInst->src != 15 );
+}
+
+/*============================================================================*/
+/*  jit_fnFlagLiveness                                                        */
+/*!
+    Determine which instructions must calculate the status flags
+
+    The jit_fnFlagLiveness function walks the decoded block backwards to
+    find the instructions whose status flags are never observed because
+    they are overwritten by a later instruction before the flags are
+    tested, or before the block can exit.  These instructions do not
+    need to calculate the status flags.
+
+    @param[in,out]
+        pInsts
+            pointer to the decoded block
+
+    @param[in]
+        n
+            number of instructions in the block
+
+==============================================================================*/
+static void jit_fnFlagLiveness( tzJITInst *pInsts, size_t n )
+{
+    bool live = true;
+    size_t i = n;
+
+    while( i-- > 0 )
+    {
+        if( pInsts[i].cls != eJIT_NATIVE )
+        {
+            /* branches, block exits and the interpreter observe the flags */
+            live = true;
+        }
+        else if( pInsts[i].setsFlags )
+        {
+            pInsts[i].emitFlags = live;
+            live = false;
+        }
+        else if( ( ( pInsts[i].op & 0x1F ) == HLOD ) ||
+                 ( ( pInsts[i].op & 0x1F ) == HSTR ) ||
+                 ( ( pInsts[i].op & 0x1F ) == HNEXT ) )
+        {
+            /* memory accesses may leave the block */
+            live = true;
+        }
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitInst                                                            */
+/*!
+    Generate the machine code for a VM instruction
+
+    The jit_fnEmitInst function generates the machine code template
+    for a decoded VM instruction.
+
+    Translated code uses the following x86-64 registers:
+
+    rbx - pointer to the VM registers
+    r12 - pointer to the VM core memory
+    r13 - pointer to the VM core
+    r14 - VM status register
+    r15 - pointer to the VM core status register
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded instruction
+
+    @param[in]
+        start
+            address of the first instruction in the block
+
+    @param[in]
+        body
+            offset of the first instruction in the machine code buffer
+
+==============================================================================*/
+static void jit_fnEmitInst( tzJIT *pJIT,
+                            tzJITInst *pInst,
+                            int32_t start,
+                            size_t body )
+{
+    uint8_t d = JIT_REG( pInst->dst );
+    uint8_t s = JIT_REG( pInst->src );
+
+    switch( pInst->cls )
+    {
+        case eJIT_BAIL:
+            jit_fnEmitExit( pJIT, true, pInst->pc, 1 );
+            return;
+
+        case eJIT_BRANCH:
+            jit_fnEmitBranch( pJIT, pInst, start, body );
+            return;
+
+        case eJIT_CALLBACK:
+        case eJIT_EXIT:
+            jit_fnEmitCallback( pJIT, pInst );
+            return;
+
+        default:
+            break;
+    }
+
+    switch( pInst->op & 0x1F )
+    {
+        case HNOP:
+            break;
+
+        case HLOD:
+            jit_fnEmitLOD( pJIT, pInst );
+            break;
+
+        case HSTR:
+            jit_fnEmitSTR( pJIT, pInst );
+            break;
+
+        case HNEXT:
+            jit_fnEmitLocal( pJIT, pInst );
+            break;
+
+        case HMOV:
+            if( pInst->op & MODE_REG )
+            {
+                /* mov eax, [rbx+s] ; mov [rbx+d], eax */
+                jit_fnEmitLoadReg( pJIT, 0x43, s );
+                jit_fnEmit( pJIT, (uint8_t[]){ 0x89, 0x43, d }, 3 );
+            }
+            else
+            {
+                /* mov dword [rbx+d], imm32 */
+                jit_fnEmit( pJIT, (uint8_t[]){ 0xC7, 0x43, d }, 3 );
+                jit_fnEmit32( pJIT, pInst->imm );
+            }
+            break;
+
+        case HNOT:
+            /* mov eax, [rbx+d] ; not eax ; mov [rbx+d], eax */
+            jit_fnEmitLoadReg( pJIT, 0x43, d );
+            jit_fnEmit( pJIT, (uint8_t[]){ 0xF7, 0xD0, 0x89, 0x43, d }, 5 );
+            break;
+
+        case HSHR:
+            /* mov eax, [rbx+d] */
+            jit_fnEmitLoadReg( pJIT, 0x43, d );
+            if( pInst->op & BYTE )
+            {
+                /* and eax, 0xFF */
+                jit_fnEmit8( pJIT, 0x25 );
+                jit_fnEmit32( pJIT, 0xFF );
+            }
+            else if( pInst->op & WORD )
+            {
+                /* and eax, 0xFFFF */
+                jit_fnEmit8( pJIT, 0x25 );
+                jit_fnEmit32( pJIT, 0xFFFF );
+            }
+
+            /* shr eax, imm8 ; mov [rbx+d], eax */
+            jit_fnEmit( pJIT,
+                        (uint8_t[]){ 0xC1, 0xE8, (uint8_t)pInst->imm,
+                                     0x89, 0x43, d },
+                        6 );
+            break;
+
+        default:
+            jit_fnEmitALU( pJIT, pInst );
+            break;
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitLOD                                                             */
+/*!
+    Generate the machine code for a LOD instruction
+
+    The jit_fnEmitLOD function generates the machine code to load a
+    value from the VM core memory into a VM register, byte swapping it
+    unless the VM core memory uses the host byte order.  Only the bytes
+    specified by the instruction width are replaced in the destination
+    register.  An address which is out of range leaves the block so the
+    interpreter can report the error.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded LOD instruction
+
+==============================================================================*/
+static void jit_fnEmitLOD( tzJIT *pJIT, tzJITInst *pInst )
+{
+    uint8_t d = JIT_REG( pInst->dst );
+    size_t skip;
+
+    if( pInst->op & MODE_REG )
+    {
+        /* mov ecx, [rbx+s] */
+        jit_fnEmitLoadReg( pJIT, 0x4B, JIT_REG( pInst->src ) );
+
+        /* cmp ecx, coreSize - width ; jbe ok */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x81, 0xF9 }, 2 );
+        jit_fnEmit32( pJIT,
+                      (uint32_t)( pJIT->config.coreSize -
+                                  JIT_WIDTH( pInst->op ) ) );
+        skip = jit_fnEmitJcc( pJIT, JBE );
+        jit_fnEmitExit( pJIT, true, pInst->pc, 1 );
+        jit_fnPatch( pJIT, skip );
+    }
+    else
+    {
+        /* mov ecx, imm32 */
+        jit_fnEmit8( pJIT, 0xB9 );
+        jit_fnEmit32( pJIT, pInst->imm );
+    }
+
+    if( pInst->op & BYTE )
+    {
+        /* mov dl, [r12+rcx] ; mov [rbx+d], dl */
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x41, 0x8A, 0x14, 0x0C, 0x88, 0x53, d },
+                    7 );
+    }
+    else if( *pJIT->config.pNativeEndian )
+    {
+        if( pInst->op & WORD )
+        {
+            /* movzx edx, word [r12+rcx] ; mov [rbx+d], dx */
+            jit_fnEmit( pJIT,
+                        (uint8_t[]){ 0x41, 0x0F, 0xB7, 0x14, 0x0C,
+                                     0x66, 0x89, 0x53, d },
+                        9 );
+        }
+        else
+        {
+            /* mov edx, [r12+rcx] ; mov [rbx+d], edx */
+            jit_fnEmit( pJIT,
+                        (uint8_t[]){ 0x41, 0x8B, 0x14, 0x0C,
+                                     0x89, 0x53, d },
+                        7 );
+        }
+    }
+    else if( pInst->op & WORD )
+    {
+        /* movzx edx, word [r12+rcx] ; rol dx, 8 ; mov [rbx+d], dx */
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x41, 0x0F, 0xB7, 0x14, 0x0C,
+                                 0x66, 0xC1, 0xC2, 0x08,
+                                 0x66, 0x89, 0x53, d },
+                    13 );
+    }
+    else
+    {
+        /* mov edx, [r12+rcx] ; bswap edx ; mov [rbx+d], edx */
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x41, 0x8B, 0x14, 0x0C,
+                                 0x0F, 0xCA,
+                                 0x89, 0x53, d },
+                    9 );
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitSTR                                                             */
+/*!
+    Generate the machine code for a STR instruction
+
+    The jit_fnEmitSTR function generates the machine code to store a
+    VM register into the VM core memory, in big endian format unless the
+    VM core memory uses the host byte order.  An address which is out of
+    range, or inside the program image, leaves the block so the
+    interpreter can perform the store.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded STR instruction
+
+==============================================================================*/
+static void jit_fnEmitSTR( tzJIT *pJIT, tzJITInst *pInst )
+{
+    size_t bad;
+    size_t code;
+    size_t ok;
+
+    if( pInst->op & MODE_REG )
+    {
+        /* mov ecx, [rbx+d] */
+        jit_fnEmitLoadReg( pJIT, 0x4B, JIT_REG( pInst->dst ) );
+
+        /* cmp ecx, coreSize - width ; ja bail */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x81, 0xF9 }, 2 );
+        jit_fnEmit32( pJIT,
+                      (uint32_t)( pJIT->config.coreSize -
+                                  JIT_WIDTH( pInst->op ) ) );
+        bad = jit_fnEmitJcc( pJIT, JA );
+
+        /* cmp ecx, programSize ; jb bail */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x81, 0xF9 }, 2 );
+        jit_fnEmit32( pJIT, (uint32_t)pJIT->config.programSize );
+        code = jit_fnEmitJcc( pJIT, JB );
+
+        /* jmp ok */
+        ok = jit_fnEmitJcc( pJIT, JMP8 );
+
+        jit_fnPatch( pJIT, bad );
+        jit_fnPatch( pJIT, code );
+        jit_fnEmitExit( pJIT, true, pInst->pc, 1 );
+        jit_fnPatch( pJIT, ok );
+    }
+    else
+    {
+        /* mov ecx, imm32 */
+        jit_fnEmit8( pJIT, 0xB9 );
+        jit_fnEmit32( pJIT, pInst->imm );
+    }
+
+    /* mov edx, [rbx+s] */
+    jit_fnEmitLoadReg( pJIT, 0x53, JIT_REG( pInst->src ) );
+
+    if( pInst->op & BYTE )
+    {
+        /* mov [r12+rcx], dl */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x41, 0x88, 0x14, 0x0C }, 4 );
+    }
+    else if( *pJIT->config.pNativeEndian )
+    {
+        if( pInst->op & WORD )
+        {
+            /* mov [r12+rcx], dx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x66, 0x41, 0x89, 0x14, 0x0C }, 5 );
+        }
+        else
+        {
+            /* mov [r12+rcx], edx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x41, 0x89, 0x14, 0x0C }, 4 );
+        }
+    }
+    else if( pInst->op & WORD )
+    {
+        /* rol dx, 8 ; mov [r12+rcx], dx */
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x66, 0xC1, 0xC2, 0x08,
+                                 0x66, 0x41, 0x89, 0x14, 0x0C },
+                    9 );
+    }
+    else
+    {
+        /* bswap edx ; mov [r12+rcx], edx */
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x0F, 0xCA, 0x41, 0x89, 0x14, 0x0C },
+                    6 );
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitLocal                                                           */
+/*!
+    Generate the machine code for an LDL, STL, LDX or STX instruction
+
+    The jit_fnEmitLocal function generates the machine code to calculate
+    the address of a local variable from the frame pointer (R1), or of an
+    indexed memory access from its base and scaled index registers, into
+    R2, followed by the code for the equivalent LOD or STR through R2.
+    If the access leaves the block, the interpreter executes the whole
+    instruction again, which calculates the same address.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded LDL, STL, LDX or STX instruction
+
+==============================================================================*/
+static void jit_fnEmitLocal( tzJIT *pJIT, tzJITInst *pInst )
+{
+    tzJITInst access = *pInst;
+
+    /* mov ecx, [rbx+b] */
+    jit_fnEmitLoadReg( pJIT, 0x4B, JIT_REG( pInst->base ) );
+
+    if( pInst->scale != 0 )
+    {
+        /* mov edx, [rbx+i] ; imul edx, edx, scale ; add ecx, edx */
+        jit_fnEmitLoadReg( pJIT, 0x53, JIT_REG( pInst->index ) );
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x6B, 0xD2, (uint8_t)pInst->scale,
+                                 0x01, 0xD1 },
+                    5 );
+    }
+
+    /* add ecx, imm32 ; mov [rbx+R2], ecx */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x81, 0xC1 }, 2 );
+    jit_fnEmit32( pJIT, (uint32_t)pInst->imm );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x89, 0x4B, JIT_REG( 2 ) }, 3 );
+
+    /* register mode access through R2 */
+    if( ( pInst->ext == HLDL ) || ( pInst->ext == HLDX ) )
+    {
+        access.op = HLOD | MODE_REG | pInst->width;
+        access.src = 2;
+        jit_fnEmitLOD( pJIT, &access );
+    }
+    else
+    {
+        access.op = HSTR | MODE_REG | pInst->width;
+        access.dst = 2;
+        jit_fnEmitSTR( pJIT, &access );
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitALU                                                             */
+/*!
+    Generate the machine code for an integer arithmetic instruction
+
+    The jit_fnEmitALU function generates the machine code for the
+    integer ADD, SUB, MUL, DIV, AND, OR and CMP instructions.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded instruction
+
+==============================================================================*/
+static void jit_fnEmitALU( tzJIT *pJIT, tzJITInst *pInst )
+{
+    uint8_t d = JIT_REG( pInst->dst );
+
+    /* mov eax, [rbx+d] */
+    jit_fnEmitLoadReg( pJIT, 0x43, d );
+
+    if( pInst->op & MODE_REG )
+    {
+        /* mov ecx, [rbx+s] */
+        jit_fnEmitLoadReg( pJIT, 0x4B, JIT_REG( pInst->src ) );
+    }
+    else
+    {
+        /* mov ecx, imm32 */
+        jit_fnEmit8( pJIT, 0xB9 );
+        jit_fnEmit32( pJIT, pInst->imm );
+    }
+
+    if( pInst->emitFlags )
+    {
+        /* keep the old value for the carry flag: mov esi, eax */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x89, 0xC6 }, 2 );
+    }
+
+    switch( pInst->op & 0x1F )
+    {
+        case HADD:
+            /* add eax, ecx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x01, 0xC8 }, 2 );
+            break;
+
+        case HSUB:
+        case HCMP:
+            /* sub eax, ecx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x29, 0xC8 }, 2 );
+            break;
+
+        case HMUL:
+            /* imul eax, ecx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x0F, 0xAF, 0xC1 }, 3 );
+            break;
+
+        case HDIV:
+            /* cdq ; idiv ecx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x99, 0xF7, 0xF9 }, 3 );
+            break;
+
+        case HAND:
+            /* and eax, ecx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x21, 0xC8 }, 2 );
+            break;
+
+        default:
+            /* or eax, ecx */
+            jit_fnEmit( pJIT, (uint8_t[]){ 0x09, 0xC8 }, 2 );
+            break;
+    }
+
+    if( ( pInst->op & 0x1F ) != HCMP )
+    {
+        /* mov [rbx+d], eax */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x89, 0x43, d }, 3 );
+    }
+
+    if( pInst->emitFlags )
+    {
+        jit_fnEmitFlags( pJIT );
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitBranch                                                          */
+/*!
+    Generate the machine code for a branch instruction
+
+    The jit_fnEmitBranch function generates the machine code for the JMP,
+    conditional jump, and compare and branch instructions.  A branch back
+    to the start of the block jumps directly to the start of the
+    translated code, otherwise the block returns with the branch target
+    in the VM program counter.  A branch back to the start of the block
+    is charged to the instruction budget, and returns to the VM core
+    when the budget has been used.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded branch instruction
+
+    @param[in]
+        start
+            address of the first instruction in the block
+
+    @param[in]
+        body
+            offset of the first instruction in the machine code buffer
+
+==============================================================================*/
+static void jit_fnEmitBranch( tzJIT *pJIT,
+                              tzJITInst *pInst,
+                              int32_t start,
+                              size_t body )
+{
+    uint32_t mask = 0;
+    uint8_t jcc = JE;
+    size_t skip = 0;
+    size_t loop;
+    size_t preempt;
+    int32_t rel;
+    bool conditional = false;
+
+    if( ( pInst->op & 0x1F ) == HNEXT )
+    {
+        /* compare and branch: select the jump which skips the branch */
+        switch( pInst->ext )
+        {
+            case HBLT:
+                jcc = JGE;
+                break;
+
+            case HBLE:
+                jcc = JG;
+                break;
+
+            case HBEQ:
+                jcc = JNE;
+                break;
+
+            default:
+                jcc = JE;
+                break;
+        }
+
+        /* mov eax, [rbx+d] ; cmp eax, [rbx+s] ; jcc not_taken */
+        jit_fnEmitLoadReg( pJIT, 0x43, JIT_REG( pInst->dst ) );
+        jit_fnEmit( pJIT,
+                    (uint8_t[]){ 0x3B, 0x43, JIT_REG( pInst->src ) },
+                    3 );
+        skip = jit_fnEmitJcc( pJIT, jcc );
+        conditional = true;
+    }
+
+    /* select the flag to test, and the jump which skips the branch */
+    switch( pInst->op & 0x1F )
+    {
+        case HJZR:
+            mask = JIT_ZFLAG;
+            jcc = JE;
+            break;
+
+        case HJNZ:
+            mask = JIT_ZFLAG;
+            jcc = JNE;
+            break;
+
+        case HJNE:
+            mask = JIT_NFLAG;
+            jcc = JE;
+            break;
+
+        case HJPO:
+            mask = JIT_NFLAG;
+            jcc = JNE;
+            break;
+
+        case HJCA:
+            mask = JIT_CFLAG;
+            jcc = JE;
+            break;
+
+        case HJNC:
+            /* matches the flag tested by opJNC */
+            mask = JIT_ZFLAG;
+            jcc = JNE;
+            break;
+
+        default:
+            break;
+    }
+
+    if( mask != 0 )
+    {
+        /* test r14d, mask ; jcc not_taken */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x41, 0xF7, 0xC6 }, 3 );
+        jit_fnEmit32( pJIT, mask );
+        skip = jit_fnEmitJcc( pJIT, jcc );
+        conditional = true;
+    }
+
+    if( pInst->imm == start )
+    {
+        /* mov rax, pBudgeted ; cmp byte [rax], 0 ; je loop */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xB8 }, 2 );
+        jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pBudgeted );
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x80, 0x38, 0x00 }, 3 );
+        loop = jit_fnEmitJcc( pJIT, JE );
+
+        /* mov rax, pBudget ; cmp dword [rax], 0 ; je preempt ;
+           dec dword [rax] */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xB8 }, 2 );
+        jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pBudget );
+        jit_fnEmit( pJIT, (uint8_t[]){ 0x83, 0x38, 0x00 }, 3 );
+        preempt = jit_fnEmitJcc( pJIT, JE );
+        jit_fnEmit( pJIT, (uint8_t[]){ 0xFF, 0x08 }, 2 );
+
+        /* loop: jmp body */
+        jit_fnPatch( pJIT, loop );
+        rel = (int32_t)( body - ( pJIT->codeUsed + 5 ) );
+        jit_fnEmit8( pJIT, 0xE9 );
+        jit_fnEmit32( pJIT, (uint32_t)rel );
+
+        /* preempt: return to the VM core at the start of the block */
+        jit_fnPatch( pJIT, preempt );
+        jit_fnEmitExit( pJIT, true, start, 0 );
+    }
+    else
+    {
+        jit_fnEmitExit( pJIT, true, pInst->imm, 0 );
+    }
+
+    if( conditional )
+    {
+        jit_fnPatch( pJIT, skip );
+        jit_fnEmitExit( pJIT, true, pInst->next, 0 );
+    }
+}
+
+/*============================================================================*/
+/*  jit_fnEmitCallback                                                        */
+/*!
+    Generate the machine code to execute an instruction in the interpreter
+
+    The jit_fnEmitCallback function generates the machine code to execute
+    an instruction using the VM core interpreter.  The block continues
+    after the instruction only if the VM core is still running, the
+    program image was not modified, and the program counter was advanced
+    to the next sequential instruction.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pInst
+            pointer to the decoded instruction
+
+==============================================================================*/
+static void jit_fnEmitCallback( tzJIT *pJIT, tzJITInst *pInst )
+{
+    size_t exits[4];
+    size_t cont;
+    int i;
+
+    /* mov dword [rbx+PC], pc ; mov [r15], r14d ; mov rdi, r13 */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0xC7, 0x43, JIT_PC }, 3 );
+    jit_fnEmit32( pJIT, pInst->pc );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x45, 0x89, 0x37, 0x4C, 0x89, 0xEF }, 6 );
+
+    /* mov rax, pfnStep ; call rax ; mov r14d, [r15] */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xB8 }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pfnStep );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0xFF, 0xD0, 0x45, 0x8B, 0x37 }, 5 );
+
+    if( pInst->cls == eJIT_EXIT )
+    {
+        jit_fnEmitExit( pJIT, false, 0, 0 );
+        return;
+    }
+
+    /* mov rax, pRunning ; cmp byte [rax], 0 ; je exit */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xB8 }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pRunning );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x80, 0x38, 0x00 }, 3 );
+    exits[0] = jit_fnEmitJcc( pJIT, JE );
+
+    /* mov rax, pError ; cmp byte [rax], 0 ; jne exit */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xB8 }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pError );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x80, 0x38, 0x00 }, 3 );
+    exits[1] = jit_fnEmitJcc( pJIT, JNE );
+
+    /* mov rax, &invalidated ; cmp byte [rax], 0 ; jne exit */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xB8 }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)&pJIT->invalidated );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x80, 0x38, 0x00 }, 3 );
+    exits[2] = jit_fnEmitJcc( pJIT, JNE );
+
+    /* cmp dword [rbx+PC], next ; jne exit */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x81, 0x7B, JIT_PC }, 3 );
+    jit_fnEmit32( pJIT, pInst->next );
+    exits[3] = jit_fnEmitJcc( pJIT, JNE );
+
+    /* jmp continue */
+    cont = jit_fnEmitJcc( pJIT, JMP8 );
+
+    for( i = 0; i < 4; i++ )
+    {
+        jit_fnPatch( pJIT, exits[i] );
+    }
+
+    /* leave the program counter where the interpreter put it */
+    jit_fnEmitExit( pJIT, false, 0, 0 );
+
+    jit_fnPatch( pJIT, cont );
+}
+
+/*============================================================================*/
+/*  jit_fnEmitFlags                                                           */
+/*!
+    Generate the machine code to calculate the status flags
+
+    The jit_fnEmitFlags function generates the machine code to calculate
+    the zero, negative and carry flags from the result in eax and the
+    previous value of the destination register in esi, in the same way
+    as the SETFLAGS operation of the VM core.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+==============================================================================*/
+static void jit_fnEmitFlags( tzJIT *pJIT )
+{
+    static const uint8_t flags[] =
+    {
+        0x31, 0xC6,             /* xor esi, eax */
+        0xC1, 0xEE, 0x1F,       /* shr esi, 31 */
+        0xC1, 0xE6, 0x02,       /* shl esi, 2 (carry flag) */
+        0x85, 0xC0,             /* test eax, eax */
+        0x0F, 0x94, 0xC2,       /* sete dl */
+        0x0F, 0x98, 0xC1,       /* sets cl */
+        0x0F, 0xB6, 0xD2,       /* movzx edx, dl */
+        0x0F, 0xB6, 0xC9,       /* movzx ecx, cl */
+        0x8D, 0x14, 0x4A,       /* lea edx, [rdx+rcx*2] */
+        0x09, 0xF2,             /* or edx, esi */
+        0x41, 0x83, 0xE6, 0xF8, /* and r14d, ~7 */
+        0x41, 0x09, 0xD6        /* or r14d, edx */
+    };
+
+    jit_fnEmit( pJIT, flags, sizeof( flags ) );
+}
+
+/*============================================================================*/
+/*  jit_fnEmitPrologue                                                        */
+/*!
+    Generate the machine code to enter a translated block
+
+    The jit_fnEmitPrologue function generates the machine code which saves
+    the callee-saved registers used by the translated code, and loads them
+    with the VM core state.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+==============================================================================*/
+static void jit_fnEmitPrologue( tzJIT *pJIT )
+{
+    /* push rbx ; push r12 ; push r13 ; push r14 ; push r15 */
+    jit_fnEmit( pJIT,
+                (uint8_t[]){ 0x53, 0x41, 0x54, 0x41, 0x55,
+                             0x41, 0x56, 0x41, 0x57 },
+                9 );
+
+    /* mov rbx, pReg */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x48, 0xBB }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pReg );
+
+    /* mov r12, pMemory */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x49, 0xBC }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pMemory );
+
+    /* mov r13, pCore */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x49, 0xBD }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pCore );
+
+    /* mov r15, pStatus ; mov r14d, [r15] */
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x49, 0xBF }, 2 );
+    jit_fnEmit64( pJIT, (uint64_t)(uintptr_t)pJIT->config.pStatus );
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x45, 0x8B, 0x37 }, 3 );
+}
+
+/*============================================================================*/
+/*  jit_fnEmitEpilogue                                                        */
+/*!
+    Generate the machine code to leave a translated block
+
+    The jit_fnEmitEpilogue function generates the machine code which
+    stores the VM status register and restores the callee-saved registers
+    used by the translated code.  The block return value must already
+    be in eax.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+==============================================================================*/
+static void jit_fnEmitEpilogue( tzJIT *pJIT )
+{
+    /* mov [r15], r14d ; pop r15 ; pop r14 ; pop r13 ; pop r12 ; pop rbx ;
+       ret */
+    jit_fnEmit( pJIT,
+                (uint8_t[]){ 0x45, 0x89, 0x37,
+                             0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D,
+                             0x41, 0x5C, 0x5B, 0xC3 },
+                13 );
+}
+
+/*============================================================================*/
+/*  jit_fnEmitExit                                                            */
+/*!
+    Generate the machine code to return from a translated block
+
+    The jit_fnEmitExit function generates the machine code which
+    optionally sets the VM program counter, and returns from the
+    translated block.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        setPC
+            true if the VM program counter is to be set
+
+    @param[in]
+        pc
+            value for the VM program counter
+
+    @param[in]
+        result
+            block return value: 0 to continue at the program counter,
+            1 to execute the instruction at the program counter in
+            the interpreter
+
+==============================================================================*/
+static void jit_fnEmitExit( tzJIT *pJIT, bool setPC, int32_t pc, int result )
+{
+    if( setPC )
+    {
+        /* mov dword [rbx+PC], pc */
+        jit_fnEmit( pJIT, (uint8_t[]){ 0xC7, 0x43, JIT_PC }, 3 );
+        jit_fnEmit32( pJIT, pc );
+    }
+
+    /* mov eax, result */
+    jit_fnEmit8( pJIT, 0xB8 );
+    jit_fnEmit32( pJIT, result );
+
+    jit_fnEmitEpilogue( pJIT );
+}
+
+/*============================================================================*/
+/*  jit_fnEmitLoadReg                                                         */
+/*!
+    Generate the machine code to load a VM register
+
+    The jit_fnEmitLoadReg function generates a mov r32, [rbx+disp8]
+    instruction to load a VM register into an x86-64 register.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        modrm
+            ModRM byte selecting the x86-64 register
+            (0x43=eax, 0x4B=ecx, 0x53=edx)
+
+    @param[in]
+        reg
+            offset of the VM register from the register base
+
+==============================================================================*/
+static void jit_fnEmitLoadReg( tzJIT *pJIT, uint8_t modrm, uint8_t reg )
+{
+    jit_fnEmit( pJIT, (uint8_t[]){ 0x8B, modrm, reg }, 3 );
+}
+
+/*============================================================================*/
+/*  jit_fnEmitJcc                                                             */
+/*!
+    Generate a short forward jump
+
+    The jit_fnEmitJcc function generates a short conditional or
+    unconditional jump whose target is set later using jit_fnPatch.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        jcc
+            short jump opcode
+
+    @retval offset of the jump displacement to be patched
+
+==============================================================================*/
+static size_t jit_fnEmitJcc( tzJIT *pJIT, uint8_t jcc )
+{
+    jit_fnEmit8( pJIT, jcc );
+    jit_fnEmit8( pJIT, 0 );
+
+    return pJIT->codeUsed - 1;
+}
+
+/*============================================================================*/
+/*  jit_fnPatch                                                               */
+/*!
+    Set the target of a short forward jump
+
+    The jit_fnPatch function sets the target of a short jump generated
+    by jit_fnEmitJcc to the current position in the machine code buffer.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pos
+            offset of the jump displacement
+
+==============================================================================*/
+static void jit_fnPatch( tzJIT *pJIT, size_t pos )
+{
+    pJIT->pCode[pos] = (uint8_t)( pJIT->codeUsed - ( pos + 1 ) );
+}
+
+/*============================================================================*/
+/*  jit_fnEmit                                                                */
+/*!
+    Append machine code to the code buffer
+
+    The jit_fnEmit function appends a sequence of bytes to the
+    machine code buffer.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        pBytes
+            pointer to the bytes to append
+
+    @param[in]
+        len
+            number of bytes to append
+
+==============================================================================*/
+static void jit_fnEmit( tzJIT *pJIT, const uint8_t *pBytes, size_t len )
+{
+    memcpy( &pJIT->pCode[pJIT->codeUsed], pBytes, len );
+    pJIT->codeUsed += len;
+}
+
+/*============================================================================*/
+/*  jit_fnEmit8                                                               */
+/*!
+    Append a byte to the code buffer
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        val
+            byte to append
+
+==============================================================================*/
+static void jit_fnEmit8( tzJIT *pJIT, uint8_t val )
+{
+    pJIT->pCode[pJIT->codeUsed++] = val;
+}
+
+/*============================================================================*/
+/*  jit_fnEmit32                                                              */
+/*!
+    Append a 32-bit little endian value to the code buffer
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        val
+            value to append
+
+==============================================================================*/
+static void jit_fnEmit32( tzJIT *pJIT, uint32_t val )
+{
+    memcpy( &pJIT->pCode[pJIT->codeUsed], &val, sizeof( val ) );
+    pJIT->codeUsed += sizeof( val );
+}
+
+/*============================================================================*/
+/*  jit_fnEmit64                                                              */
+/*!
+    Append a 64-bit little endian value to the code buffer
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+    @param[in]
+        val
+            value to append
+
+==============================================================================*/
+static void jit_fnEmit64( tzJIT *pJIT, uint64_t val )
+{
+    memcpy( &pJIT->pCode[pJIT->codeUsed], &val, sizeof( val ) );
+    pJIT->codeUsed += sizeof( val );
+}
+
+/*============================================================================*/
+/*  jit_fnFlush                                                               */
+/*!
+    Discard all translations to reclaim the code buffer
+
+    The jit_fnFlush function discards all translated blocks when the
+    machine code buffer is full.  It is only called while no translated
+    block is running.
+
+    @param[in]
+        pJIT
+            pointer to the JIT compiler
+
+==============================================================================*/
+static void jit_fnFlush( tzJIT *pJIT )
+{
+    memset( pJIT->pBlocks, 0, pJIT->numBlocks * sizeof( void * ) );
+    pJIT->codeUsed = 0;
+}
+
+#endif
+
+/*! @}
+ * end of jit group */
@@ -60,55 +60,83 @@ SOFTWARE.
 /*! initial starting size of the string buffer */
 #define BUFSIZE 256
 
-/*! The tzStringBuffer object defines the attributes of a string buffer */
-typedef struct zStringBuffer
-{
-	/*! string buffer identifier */
-	int id;
-
-	/*! call stack level */
-	int level;
-
-	/*! string buffer write location (for append operations) */
-	size_t offset;
+/*==============================================================================
+        Private Function Declarations
+==============================================================================*/
 
-	/*! string buffer read/write location for character operations */
-	size_t rwOffset;
+static tzStringBuffer *stringbuffer_fnFind( tzStringBufferList *pList,
+                                            int id );
+static void stringbuffer_fnAppend( tzStringBuffer *p, char *str );
 
-	/*! total size of the string buffer */
-	size_t size;
+/*==============================================================================
+        Public Function Definitions
+==============================================================================*/
 
-	/*! pointer to the memory buffer */
-	char *pBuffer;
+/*============================================================================*/
+/*  STRINGBUFFER_fnInit                                                       */
+/*!
+    Initialize a string buffer list
 
-	/*! pointer to the next string buffer in the list */
-	struct zStringBuffer *pNext;
+    The STRINGBUFFER_fnInit function initializes an empty string buffer
+    list.  Each VM instance owns its own string buffer list.
 
-} tzStringBuffer;
+    @param[in]
+       pList
+            pointer to the string buffer list to initialize
 
-/*==============================================================================
-        File Scoped Variables
 ==============================================================================*/
+void STRINGBUFFER_fnInit( tzStringBufferList *pList )
+{
+	if( pList != NULL )
+	{
+		pList->pFirst = NULL;
+		pList->pFreeList = NULL;
+		pList->level = 0;
+	}
+}
 
-/*! pointer to the first string buffer */
-static tzStringBuffer *pFirst = NULL;
+/*============================================================================*/
+/*  STRINGBUFFER_fnDestroy                                                    */
+/*!
+    Release all the string buffers in a string buffer list
 
-/*! pointer to the last string buffer */
-static tzStringBuffer *pFreeList = NULL;
+    The STRINGBUFFER_fnDestroy function releases the memory of all the
+    in-use and free string buffers in the string buffer list.
+    The list is left empty.
 
-/* current call stack level */
-static int level = 0;
+    @param[in]
+       pList
+            pointer to the string buffer list to destroy
 
-/*==============================================================================
-        Private Function Declarations
 ==============================================================================*/
+void STRINGBUFFER_fnDestroy( tzStringBufferList *pList )
+{
+	tzStringBuffer *p;
+	tzStringBuffer *pNext;
 
-tzStringBuffer *stringbuffer_fnFind( int id );
-void stringbuffer_fnAppend( tzStringBuffer *p, char *str );
+	if( pList != NULL )
+	{
+		p = pList->pFirst;
+		while( p != NULL )
+		{
+			pNext = p->pNext;
+			free( p->pBuffer );
+			free( p );
+			p = pNext;
+		}
 
-/*==============================================================================
-        Public Function Definitions
-==============================================================================*/
+		p = pList->pFreeList;
+		while( p != NULL )
+		{
+			pNext = p->pNext;
+			free( p->pBuffer );
+			free( p );
+			p = pNext;
+		}
+
+		STRINGBUFFER_fnInit( pList );
+	}
+}
 
 /*============================================================================*/
 /*  STRINGBUFFER_fnSetLevel                                                   */
@@ -118,14 +146,21 @@ void stringbuffer_fnAppend( tzStringBuffer *p, char *str );
     The STRINGBUFFER_fnSetLevel function sets the current call stack level
     which is used when creating string buffers.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        l
             current call stack level
 
 ==============================================================================*/
-void STRINGBUFFER_fnSetLevel(int l)
+void STRINGBUFFER_fnSetLevel( tzStringBufferList *pList, int l )
 {
-	level = l;
+	if( pList != NULL )
+	{
+		pList->level = l;
+	}
 }
 
 /*============================================================================*/
@@ -135,7 +170,12 @@ void STRINGBUFFER_fnSetLevel(int l)
 
     The STRINGBUFFER_fnCreate function creates a new string buffer and
     populates the default string buffer object attributes.  It is then
-    added to the string buffer list.
+    added to the string buffer list.  A previously freed string buffer
+    is re-used if one is available.
+
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
 
     @param[in]
        id
@@ -145,19 +185,23 @@ void STRINGBUFFER_fnSetLevel(int l)
     @retval false string buffer could not be created
 
 ==============================================================================*/
-bool STRINGBUFFER_fnCreate( int id )
+bool STRINGBUFFER_fnCreate( tzStringBufferList *pList, int id )
 {
 	tzStringBuffer *p = NULL;
 
+	if( pList == NULL )
+	{
+		return false;
+	}
+
 	/* search for an existing StringBuffer which was previously freed */
-	if( pFreeList != NULL )
+	if( pList->pFreeList != NULL )
 	{
-		p = pFreeList;
-		pFreeList = p->pNext;
+		p = pList->pFreeList;
+		pList->pFreeList = p->pNext;
 		p->pNext = NULL;
 	}
-
-	if( p == NULL )
+	else
 	{
 		/* allocate memory for a new string buffer */
 		p = malloc( sizeof( tzStringBuffer ));
@@ -167,15 +211,7 @@ bool STRINGBUFFER_fnCreate( int id )
 			p->pBuffer = malloc( BUFSIZE );
 			if( p->pBuffer != NULL )
 			{
-				/* populate the new string buffer */
-				p->id = id;
-				p->offset = 0L;
-				p->level = level;
 				p->size = BUFSIZE;
-
-				/* append the string buffer to the front of the list */
-				p->pNext = pFirst;
-				pFirst = p;
 			}
 			else
 			{
@@ -192,6 +228,20 @@ bool STRINGBUFFER_fnCreate( int id )
 		}
 	}
 
+	if( p != NULL )
+	{
+		/* populate the string buffer */
+		p->id = id;
+		p->offset = 0L;
+		p->rwOffset = 0L;
+		p->level = pList->level;
+		p->pBuffer[0] = '\0';
+
+		/* append the string buffer to the front of the list */
+		p->pNext = pList->pFirst;
+		pList->pFirst = p;
+	}
+
 	return ( p != NULL ) ? true : false;
 }
 
@@ -203,6 +253,10 @@ bool STRINGBUFFER_fnCreate( int id )
     The STRINGBUFFER_fnAppendChar function appends the specified character
     to the specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        id
             string buffer identifier
@@ -212,7 +266,7 @@ bool STRINGBUFFER_fnCreate( int id )
             character to append
 
 ==============================================================================*/
-void STRINGBUFFER_fnAppendChar( int id, char c )
+void STRINGBUFFER_fnAppendChar( tzStringBufferList *pList, int id, char c )
 {
 	tzStringBuffer *p;
 	char buf[2];
@@ -220,7 +274,7 @@ void STRINGBUFFER_fnAppendChar( int id, char c )
 	buf[0] = c;
 	buf[1] = 0;
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		stringbuffer_fnAppend(p, buf);
@@ -235,6 +289,10 @@ void STRINGBUFFER_fnAppendChar( int id, char c )
     The STRINGBUFFER_fnAppendNumber function appends the specified 32-bit
     integer number as a string to the specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        id
             string buffer identifier
@@ -244,14 +302,16 @@ void STRINGBUFFER_fnAppendChar( int id, char c )
             32-bit integer to append to the string buffer
 
 ==============================================================================*/
-void STRINGBUFFER_fnAppendNumber( int id, int32_t number )
+void STRINGBUFFER_fnAppendNumber( tzStringBufferList *pList,
+                                  int id,
+                                  int32_t number )
 {
 	char numstring[20];
 	tzStringBuffer *p;
 
 	sprintf(numstring, "%d", number );
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		stringbuffer_fnAppend(p, numstring);
@@ -266,6 +326,10 @@ void STRINGBUFFER_fnAppendNumber( int id, int32_t number )
     The STRINGBUFFER_fnAppendFloat function appends the specified 32-bit
     IEEE754 floating point number as a string to the specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        id
             string buffer identifier
@@ -275,14 +339,16 @@ void STRINGBUFFER_fnAppendNumber( int id, int32_t number )
             32-bit integer to append to the string buffer
 
 ==============================================================================*/
-void STRINGBUFFER_fnAppendFloat( int id, float number )
+void STRINGBUFFER_fnAppendFloat( tzStringBufferList *pList,
+                                 int id,
+                                 float number )
 {
 	char numstring[32];
 	tzStringBuffer *p;
 
 	sprintf(numstring, "%f", number );
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		stringbuffer_fnAppend(p, numstring);
@@ -297,6 +363,10 @@ void STRINGBUFFER_fnAppendFloat( int id, float number )
     The STRINGBUFFER_fnAppendString function appends the specified string
     to the specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        id
             string buffer identifier
@@ -306,11 +376,13 @@ void STRINGBUFFER_fnAppendFloat( int id, float number )
             pointer to the string to append
 
 ==============================================================================*/
-void STRINGBUFFER_fnAppendString( int id, char *string )
+void STRINGBUFFER_fnAppendString( tzStringBufferList *pList,
+                                  int id,
+                                  char *string )
 {
 	tzStringBuffer *p;
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		stringbuffer_fnAppend(p, string);
@@ -325,6 +397,10 @@ void STRINGBUFFER_fnAppendString( int id, char *string )
     The STRINGBUFFER_fnAppendBuffer function appends the specified string
     buffer to the specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        dest_id
             target string buffer identifier
@@ -334,13 +410,15 @@ void STRINGBUFFER_fnAppendString( int id, char *string )
             identifier of the source string buffer to append
 
 ==============================================================================*/
-void STRINGBUFFER_fnAppendBuffer( int dest_id, int src_id )
+void STRINGBUFFER_fnAppendBuffer( tzStringBufferList *pList,
+                                  int dest_id,
+                                  int src_id )
 {
 	tzStringBuffer *pDst;
 	tzStringBuffer *pSrc;
 
-	pDst = stringbuffer_fnFind( dest_id );
-	pSrc = stringbuffer_fnFind( src_id );
+	pDst = stringbuffer_fnFind( pList, dest_id );
+	pSrc = stringbuffer_fnFind( pList, src_id );
 	if( ( pSrc != NULL ) && ( pDst != NULL ) )
 	{
 		stringbuffer_fnAppend( pDst, pSrc->pBuffer );
@@ -355,16 +433,20 @@ void STRINGBUFFER_fnAppendBuffer( int dest_id, int src_id )
     The STRINGBUFFER_fnClear function clears the specified string
     buffer.  The string buffer still exists, but it has no content.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
        id
             string buffer identifier
 
 ==============================================================================*/
-void STRINGBUFFER_fnClear( int id )
+void STRINGBUFFER_fnClear( tzStringBufferList *pList, int id )
 {
 	tzStringBuffer *p;
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		if( p->pBuffer != NULL )
@@ -381,27 +463,33 @@ void STRINGBUFFER_fnClear( int id )
     Write a string buffer
 
     The STRINGBUFFER_fnWrite function writes the content of the specified
-    string buffer to the specified FILE *
+    string buffer to the active output file of the VM instance
 
     @param[in]
-       fp
-            output FILE *
+       pList
+            pointer to the string buffer list of the VM instance
+
+    @param[in]
+       pFiles
+            pointer to the open files of the VM instance
 
     @param[in]
         id
             string buffer identifier
 
 ==============================================================================*/
-void STRINGBUFFER_fnWrite( FILE *fp, int id )
+void STRINGBUFFER_fnWrite( tzStringBufferList *pList,
+                           tzFiles *pFiles,
+                           int id )
 {
 	tzStringBuffer *p;
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		if( p->pBuffer != NULL )
 		{
-            WriteString( p->pBuffer );
+            WriteString( pFiles, p->pBuffer );
 		}
 	}
 }
@@ -415,6 +503,10 @@ void STRINGBUFFER_fnWrite( FILE *fp, int id )
     The STRINGBUFFER_fnGet function gets a pointer to the string containined
     in the specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         id
             string buffer identifier
@@ -423,12 +515,12 @@ void STRINGBUFFER_fnWrite( FILE *fp, int id )
     @retval NULL if the string buffer is not found
 
 ==============================================================================*/
-char *STRINGBUFFER_fnGet( int id )
+char *STRINGBUFFER_fnGet( tzStringBufferList *pList, int id )
 {
 	tzStringBuffer *p;
 	char *buf = NULL;
 
-	p = stringbuffer_fnFind( id );
+	p = stringbuffer_fnFind( pList, id );
 	if( p != NULL )
 	{
 		buf = p->pBuffer;
@@ -445,16 +537,27 @@ char *STRINGBUFFER_fnGet( int id )
     The STRINGBUFFER_fnFree function frees all string buffers at the
     specified scope level.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         level
             function scope level
 
 ==============================================================================*/
-void STRINGBUFFER_fnFree( int level )
+void STRINGBUFFER_fnFree( tzStringBufferList *pList, int level )
 {
 	/* clear all string buffers at the current level
 	   and decrement the level */
-	tzStringBuffer *p = pFirst;
+	tzStringBuffer *p;
+
+	if( pList == NULL )
+	{
+		return;
+	}
+
+	p = pList->pFirst;
 
 	while( p != NULL )
 	{
@@ -464,14 +567,14 @@ void STRINGBUFFER_fnFree( int level )
 			p->id = 0;
 
 			/* pop the string buffer from the in-use list */
-			pFirst = p->pNext;
+			pList->pFirst = p->pNext;
 
 			/* push the string buffer to the head of the free list */
-			p->pNext = pFreeList;
-			pFreeList = p;
+			p->pNext = pList->pFreeList;
+			pList->pFreeList = p;
 
 			/* select the next String Buffer to process */
-			p = pFirst;
+			p = pList->pFirst;
 		}
 		else
 		{
@@ -495,6 +598,10 @@ void STRINGBUFFER_fnFree( int level )
     The STRINGBUFFER_fnGetLength gets the length of the specified string
     buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         id
             string buffer identifier
@@ -503,12 +610,12 @@ void STRINGBUFFER_fnFree( int level )
     @retval 0 if the string buffer is not found
 
 ==============================================================================*/
-size_t STRINGBUFFER_fnGetLength( int id )
+size_t STRINGBUFFER_fnGetLength( tzStringBufferList *pList, int id )
 {
 	tzStringBuffer *pStringBuffer;
 	size_t len = 0;
 
-	pStringBuffer = stringbuffer_fnFind( id );
+	pStringBuffer = stringbuffer_fnFind( pList, id );
 	if( pStringBuffer != NULL )
 	{
 		len = pStringBuffer->offset;
@@ -526,6 +633,10 @@ size_t STRINGBUFFER_fnGetLength( int id )
     The STRINGBUFFER_fnSetRWOffset sets the read and write offset in the
     specified string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         id
             string buffer identifier
@@ -535,11 +646,13 @@ size_t STRINGBUFFER_fnGetLength( int id )
             offset into the string buffer (0-based)
 
 ==============================================================================*/
-void STRINGBUFFER_fnSetRWOffset( int id, uint32_t offset )
+void STRINGBUFFER_fnSetRWOffset( tzStringBufferList *pList,
+                                 int id,
+                                 uint32_t offset )
 {
 	tzStringBuffer *pStringBuffer;
 
-	pStringBuffer = stringbuffer_fnFind( id );
+	pStringBuffer = stringbuffer_fnFind( pList, id );
 	if( pStringBuffer != NULL )
 	{
 		if( offset < pStringBuffer->offset )
@@ -558,6 +671,10 @@ void STRINGBUFFER_fnSetRWOffset( int id, uint32_t offset )
     The STRINGBUFFER_fnGetCharAtOffset gets the character at the current
     read/write offset in the string buffer.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         id
             string buffer identifier
@@ -566,13 +683,13 @@ void STRINGBUFFER_fnSetRWOffset( int id, uint32_t offset )
     @retval 0 if the offset is invalid or the string buffer doesn't exist
 
 ==============================================================================*/
-char STRINGBUFFER_fnGetCharAtOffset( int id )
+char STRINGBUFFER_fnGetCharAtOffset( tzStringBufferList *pList, int id )
 {
 	tzStringBuffer *pStringBuffer;
 	size_t offset = 0L;
 	char c = '\0';
 
-	pStringBuffer = stringbuffer_fnFind( id );
+	pStringBuffer = stringbuffer_fnFind( pList, id );
 	if( pStringBuffer != NULL )
 	{
 		offset = pStringBuffer->rwOffset;
@@ -596,6 +713,10 @@ char STRINGBUFFER_fnGetCharAtOffset( int id )
     If the string buffer is not found, or the offset is invalid, then
     no action is taken.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         id
             string buffer identifier
@@ -605,12 +726,12 @@ char STRINGBUFFER_fnGetCharAtOffset( int id )
             character to write
 
 ==============================================================================*/
-void STRINGBUFFER_fnSetCharAtOffset( int id, char c )
+void STRINGBUFFER_fnSetCharAtOffset( tzStringBufferList *pList, int id, char c )
 {
 	tzStringBuffer *pStringBuffer;
 	size_t offset;
 
-	pStringBuffer = stringbuffer_fnFind( id );
+	pStringBuffer = stringbuffer_fnFind( pList, id );
 	if( pStringBuffer != NULL )
 	{
 		offset = pStringBuffer->rwOffset;
@@ -642,6 +763,10 @@ void STRINGBUFFER_fnSetCharAtOffset( int id, char c )
     The stringbuffer_fnFind function searches through all the string buffers
     looking for the string buffer with the specified id.
 
+    @param[in]
+       pList
+            pointer to the string buffer list of the VM instance
+
     @param[in]
         id
             string buffer identifier
@@ -650,9 +775,10 @@ void STRINGBUFFER_fnSetCharAtOffset( int id, char c )
     @retval NULL no tzStringBuffer object found.
 
 ==============================================================================*/
-tzStringBuffer *stringbuffer_fnFind( int id )
+static tzStringBuffer *stringbuffer_fnFind( tzStringBufferList *pList,
+                                            int id )
 {
-	tzStringBuffer *p = pFirst;
+	tzStringBuffer *p = ( pList != NULL ) ? pList->pFirst : NULL;
 
 	while( p != NULL )
 	{
@@ -686,7 +812,7 @@ tzStringBuffer *stringbuffer_fnFind( int id )
             pointer to the string to be appended
 
 ==============================================================================*/
-void stringbuffer_fnAppend( tzStringBuffer *p, char *str )
+static void stringbuffer_fnAppend( tzStringBuffer *p, char *str )
 {
 	size_t len;
 	size_t newsize;
@@ -0,0 +1,263 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*============================================================================*/
+/*!
+@file eventrace.c
+
+    Event Ready Queue Race Test
+
+    The eventrace test posts signals to an event backend from a second
+    thread, in the same way as the vmd event thread, while the main
+    thread takes them with EVENT_fnPending and EVENT_fnWait, in the same
+    way as the EVQ and WFS instructions of a program run by vmd.  The
+    wait does not block, as the program would be suspended instead.
+
+    Every signal taken from the ready queue must have been passed to the
+    filter, and the accepted signals must be received in the order they
+    were posted.  The test fails if the ready queue stops making
+    progress.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "event.h"
+
+/*==============================================================================
+        Private Definitions
+==============================================================================*/
+
+#ifndef EOK
+#define EOK 0
+#endif
+
+/*! number of signals posted by the producer thread */
+#define NUM_SIGNALS ( 200000 )
+
+/*! seconds before the test is considered to have hung */
+#define TIMEOUT ( 60 )
+
+/*==============================================================================
+        Private Function Declarations
+==============================================================================*/
+
+static bool Filter( void *pArg, int signum, int id );
+static void *Producer( void *pArg );
+
+/*==============================================================================
+        File Scoped Variables
+==============================================================================*/
+
+/*! event backend shared by the producer and consumer threads */
+static tzEvents events;
+
+/*! set for each signal id which was passed to the filter */
+static bool filtered[NUM_SIGNALS + 1];
+
+/*==============================================================================
+        Function Definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  main                                                                      */
+/*!
+    Main entry point for the eventrace test
+
+    @retval 0 the test passed
+    @retval 1 the test failed
+
+==============================================================================*/
+int main( void )
+{
+    pthread_t producer;
+    size_t pending;
+    int expected = 1;
+    int signum;
+    int id;
+    int rc;
+    int result = 0;
+
+    /* a lost wakeup or a stuck ready queue ends the test */
+    alarm( TIMEOUT );
+
+    if( EVENT_fnInit( &events ) != EOK )
+    {
+        fprintf( stderr, "eventrace: setup failed\n" );
+        return 1;
+    }
+
+    EVENT_fnSetFilter( &events, Filter, NULL );
+
+    if( pthread_create( &producer, NULL, Producer, NULL ) != 0 )
+    {
+        fprintf( stderr, "eventrace: setup failed\n" );
+        return 1;
+    }
+
+    while( ( result == 0 ) && ( expected <= NUM_SIGNALS ) )
+    {
+        /* EVQ */
+        pending = EVENT_fnPending( &events );
+        if( pending > EVENT_QUEUE_SIZE )
+        {
+            fprintf( stderr, "eventrace: %zu signals pending\n", pending );
+            result = 1;
+        }
+
+        /* WFS */
+        rc = EVENT_fnWait( &events, false, &signum, &id );
+        if( rc == EAGAIN )
+        {
+            continue;
+        }
+        else if( rc != EOK )
+        {
+            fprintf( stderr, "eventrace: wait failed: %d\n", rc );
+            result = 1;
+        }
+        else if( ( id < 1 ) || ( id > NUM_SIGNALS ) || !filtered[id] )
+        {
+            fprintf( stderr, "eventrace: signal %d was not filtered\n", id );
+            result = 1;
+        }
+        else
+        {
+            if( id != expected )
+            {
+                fprintf( stderr,
+                         "eventrace: received %d, expected %d\n",
+                         id,
+                         expected );
+                result = 1;
+            }
+
+            /* skip over the signals discarded by the filter */
+            expected++;
+            while( ( expected <= NUM_SIGNALS ) && ( ( expected % 3 ) == 0 ) )
+            {
+                expected++;
+            }
+        }
+    }
+
+    if( result == 0 )
+    {
+        pthread_join( producer, NULL );
+        EVENT_fnDestroy( &events );
+    }
+
+    printf( "eventrace: %s\n", ( result == 0 ) ? "passed" : "failed" );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Filter                                                                    */
+/*!
+    Filter a received signal
+
+    The Filter function records each signal passed to it, and discards
+    every third signal, as the extern cache discards the notifications
+    it has consumed.
+
+    @param[in]
+        pArg
+            unused
+
+    @param[in]
+        signum
+            signal number
+
+    @param[in]
+        id
+            signal id
+
+    @retval true the signal is queued
+    @retval false the signal is discarded
+
+==============================================================================*/
+static bool Filter( void *pArg, int signum, int id )
+{
+    (void)pArg;
+    (void)signum;
+
+    if( ( id >= 1 ) && ( id <= NUM_SIGNALS ) )
+    {
+        filtered[id] = true;
+    }
+
+    return ( id % 3 ) != 0;
+}
+
+/*============================================================================*/
+/*  Producer                                                                  */
+/*!
+    Post signals to the event backend
+
+    The Producer thread posts the signal ids 1 to NUM_SIGNALS in order,
+    retrying each one while the ready queue is full.
+
+    @param[in]
+        pArg
+            unused
+
+    @retval NULL
+
+==============================================================================*/
+static void *Producer( void *pArg )
+{
+    int id;
+    int rc;
+
+    (void)pArg;
+
+    for( id = 1; id <= NUM_SIGNALS; id++ )
+    {
+        while( ( rc = EVENT_fnPost( &events, EVENT_SIG_FIRST, id ) ) ==
+               ENOSPC )
+        {
+            sched_yield();
+        }
+
+        if( rc != EOK )
+        {
+            fprintf( stderr, "eventrace: post failed: %d\n", rc );
+            exit( 1 );
+        }
+    }
+
+    return NULL;
+}
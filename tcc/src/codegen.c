@@ -51,6 +51,20 @@ SOFTWARE.
 
 #define SUPPORTCODE "tcc_support.v"
 
+/*! smallest frame displacement supported by the LDL and STL instructions */
+#define MIN_LOCAL_DISPLACEMENT ( -32768 )
+
+/*! largest frame displacement supported by the LDL and STL instructions */
+#define MAX_LOCAL_DISPLACEMENT ( 32767 )
+
+/*! register receiving the signal number from the DSP instruction, which
+    is passed to the signal handler by the handler stub */
+#define DISPATCH_SIGNUM_REG ( 3 )
+
+/*! register receiving the signal id from the DSP instruction, which
+    is passed to the signal handler by the handler stub */
+#define DISPATCH_ID_REG ( 4 )
+
 /*! defines the break statement type */
 typedef enum eBREAK_TYPE
 {
@@ -217,6 +231,8 @@ static int generateParameter( CodeGen *pCodeGen, struct Node *root );
 
 static int generateDelay( CodeGen *pCodeGen, struct Node *root );
 static int generateWaitSig( CodeGen *pCodeGen, struct Node *root );
+static int generateOnSignal( CodeGen *pCodeGen, struct Node *root );
+static int generateDispatchSig( CodeGen *pCodeGen, struct Node *root );
 static int generateSetTimer( CodeGen *pCodeGen, struct Node *root );
 static int generateClearTimer( CodeGen *pCodeGen, struct Node *root );
 static int generateNotify( CodeGen *pCodeGen, struct Node *root );
@@ -226,6 +242,9 @@ static int generateValidateEnd( CodeGen *pCodeGen, struct Node *root );
 static int generateOpenPrintSession( CodeGen *pCodeGen, struct Node *root );
 static int generateClosePrintSession( CodeGen *pCodeGen, struct Node *root );
 static int generateSystem( CodeGen *pCodeGen, struct Node *root );
+static int generatePendingSig( CodeGen *pCodeGen, struct Node *root );
+static int generateBeginTx( CodeGen *pCodeGen, struct Node *root );
+static int generateCommitTx( CodeGen *pCodeGen, struct Node *root );
 static int generateFileOpen( CodeGen *pCodeGen, struct Node *root );
 static int generateFileClose( CodeGen *pCodeGen, struct Node *root );
 static int generateFileRead( CodeGen *pCodeGen, struct Node *root );
@@ -255,6 +274,10 @@ static int generateLessThanOrEqual( CodeGen *pCodeGen, struct Node *root );
 static int generateGreaterThanOrEqual( CodeGen *pCodeGen, struct Node *root );
 static int generateLessThan( CodeGen *pCodeGen, struct Node *root );
 static int generateGreaterThan( CodeGen *pCodeGen, struct Node *root );
+static int generateCondition( CodeGen *pCodeGen,
+                              struct Node *root,
+                              bool sense,
+                              char *label );
 
 static int generateRShift( CodeGen *pCodeGen, struct Node *root );
 static int generateLShift( CodeGen *pCodeGen, struct Node *root );
@@ -277,6 +300,9 @@ static int SetExternal( CodeGen *pCodeGen,
                   int src,
                   char *comment );
 
+static void LoadLocal( CodeGen *pCodeGen, int dst, int offset );
+static void StoreLocal( CodeGen *pCodeGen, int src, int offset );
+
 static int generateLeftChild( CodeGen *pCodeGen, struct Node *root );
 static int generateChildren( CodeGen *pCodeGen, struct Node *root );
 static int generateOutputID( CodeGen *pCodeGen,
@@ -547,6 +573,14 @@ int GenerateCode( CodeGen *pCodeGen, struct Node *root)
             result = generateWaitSig( pCodeGen, root );
             break;
 
+        case ONSIGNAL:
+            result = generateOnSignal( pCodeGen, root );
+            break;
+
+        case DISPATCHSIG:
+            result = generateDispatchSig( pCodeGen, root );
+            break;
+
         case NOTIFY:
             result = generateNotify( pCodeGen, root );
             break;
@@ -575,6 +609,18 @@ int GenerateCode( CodeGen *pCodeGen, struct Node *root)
             result = generateSystem( pCodeGen, root );
             break;
 
+        case PENDINGSIG:
+            result = generatePendingSig( pCodeGen, root );
+            break;
+
+        case BEGINTX:
+            result = generateBeginTx( pCodeGen, root );
+            break;
+
+        case COMMITTX:
+            result = generateCommitTx( pCodeGen, root );
+            break;
+
         case FILE_OPEN:
             result = generateFileOpen( pCodeGen, root );
             break;
@@ -1034,8 +1080,6 @@ static int generateDeclarationID( CodeGen *pCodeGen, struct Node *root )
     int n;
     int h;
     struct identEntry *idEntry;    /* access to identifiers */
-    char label[7];
-    char label1[7];            /* label generation */
     FILE *fp;
     int result = -1;
 
@@ -1052,15 +1096,9 @@ static int generateDeclarationID( CodeGen *pCodeGen, struct Node *root )
             n = AllocReg( idEntry, 0 );
             if( idEntry->isExternal == true )
             {
-                /* generate a label */
-                sprintf( (char *)label, "_SV%d", GetLabelNumber() );
-                fprintf( fp, "\tJMP %s\n", label );
-                sprintf( (char *)label1, "_sv%d", GetLabelNumber() );
-
-                /* generate the variable name */
-                fprintf( fp, "%s\n\tDAT \"%s\"\n", label1,idEntry->name );
-                fprintf( fp, "%s\n\tMOV R%d,%s\n", label, n, label1 );
-                fprintf( fp, "\tEXT R%d\n", n );
+                /* get the handle from the program import table, which is
+                   resolved once when the program is loaded */
+                fprintf( fp, "\tIMP R%d,\"%s\"\n", n, idEntry->name );
                 fprintf( fp, "\tSUB SP,%d\n", idEntry->size );
                 fprintf( fp, "\tMOV R2,SP\n" );
                 fprintf( fp, "\tSTR R2,R%d", n );
@@ -1161,10 +1199,8 @@ static int generateLValueID( CodeGen *pCodeGen, struct Node *root )
         if( idEntry != NULL )
         {
             n = AllocReg( idEntry, 0 );
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d", idEntry->offset );
+            LoadLocal( pCodeGen, n, idEntry->offset );
             fprintf( fp, "\t;l-value: %s\n", idEntry->name );
-            fprintf( fp, "\tLOD R%d,R2\n", n );
             result = n;
         }
     }
@@ -1208,9 +1244,7 @@ static int generateExternLValueID( CodeGen *pCodeGen, struct Node *root )
         if( idEntry != NULL )
         {
             n = AllocReg( root->ident, 0 );
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d\n", idEntry->offset );
-            fprintf( fp, "\tLOD R%d,R2", n );
+            LoadLocal( pCodeGen, n, idEntry->offset );
             fprintf( fp, "\t;external l-value: %s\n", idEntry->name );
 
             result = n;
@@ -1311,9 +1345,7 @@ static int generateID( CodeGen *pCodeGen, struct Node *root )
             }
             else
             {
-                fprintf( fp, "\tMOV R2,R1\n" );
-                fprintf( fp, "\tADD R2,%d\n", idEntry->offset );
-                fprintf( fp, "\tLOD R%d,R2", n );
+                LoadLocal( pCodeGen, n, idEntry->offset );
                 fprintf( fp, "\t;id: %s\n", idEntry->name );
 
                 if( idEntry->isExternal == true )
@@ -1647,24 +1679,20 @@ static int generateCompoundStatement( CodeGen *pCodeGen, struct Node *root )
 static int generateIf( CodeGen *pCodeGen, struct Node *root )
 {
     int result = -1;
-    int a;
-    FILE *fp;
 
     if( ( pCodeGen != NULL ) &&
         ( pCodeGen->fp != NULL ) &&
         ( root != NULL ) )
     {
-        fp = pCodeGen->fp;
-
         ifLevel++;
 
         sprintf( (char *)startELSE[ifLevel], "_IF%d", GetLabelNumber() );
         sprintf( (char *)endELSE[ifLevel], "_IF%d", GetLabelNumber() );
 
-        a = GenerateCode( pCodeGen, root->left );
-
-        fprintf( fp, "\tCMP R%d,0\n", a );
-        fprintf( fp, "\tJZR %s\n", startELSE[ifLevel] );
+        generateCondition( pCodeGen,
+                           root->left,
+                           false,
+                           (char *)startELSE[ifLevel] );
 
         GenerateCode( pCodeGen, root->right );
 
@@ -1784,7 +1812,6 @@ static int generateFor( CodeGen *pCodeGen, struct Node *root )
 static int generateFor1( CodeGen *pCodeGen, struct Node *root )
 {
     int result = -1;
-    int a;
     FILE *fp;
 
     if( ( pCodeGen != NULL ) &&
@@ -1794,10 +1821,10 @@ static int generateFor1( CodeGen *pCodeGen, struct Node *root )
         fp = pCodeGen->fp;
 
         fprintf( fp, "%s\n", startFOR[forLevel] );
-        a = GenerateCode( pCodeGen, root->left );
-
-        fprintf( fp, "\tCMP R%d,0\n", a );
-        fprintf( fp, "\tJZR %s\n", endFOR[forLevel] );
+        generateCondition( pCodeGen,
+                           root->left,
+                           false,
+                           (char *)endFOR[forLevel] );
 
         GenerateCode( pCodeGen, root->right );
     }
@@ -1875,7 +1902,6 @@ static int generateFor2( CodeGen *pCodeGen, struct Node *root )
 static int generateWhile( CodeGen *pCodeGen, struct Node *root )
 {
     int result = -1;
-    int b;
     FILE *fp;
 
     if( ( pCodeGen != NULL ) &&
@@ -1894,10 +1920,10 @@ static int generateWhile( CodeGen *pCodeGen, struct Node *root )
         fprintf( fp, "%s\n", startWHILE[whileLevel] );
 
         GenerateCode( pCodeGen, root->left );
-        b = GenerateCode( pCodeGen, root->right );
-
-        fprintf( fp, "\tCMP R%d, 0\n", b );
-        fprintf( fp, "\tJNZ %s\n", startWHILE[whileLevel] );
+        generateCondition( pCodeGen,
+                           root->right,
+                           true,
+                           (char *)startWHILE[whileLevel] );
         fprintf( fp, "%s\n", endWHILE[whileLevel] );
 
         /* restore the previous breakType */
@@ -2120,8 +2146,11 @@ static int generateCase( CodeGen *pCodeGen, struct Node *root )
 
         a = GenerateCode( pCodeGen, root->left );
 
-        fprintf( fp, "\tCMP R%d, R%d\n", a, regSwitch[switchLevel] );
-        fprintf( fp, "\tJNZ _CASE%d\n", caseLabelIndex );
+        fprintf( fp,
+                 "\tBNE R%d,R%d,_CASE%d\n",
+                 a,
+                 regSwitch[switchLevel],
+                 caseLabelIndex );
 
         GenerateCode( pCodeGen, root->right );
     }
@@ -2716,9 +2745,7 @@ static int generateOpenPrintSession( CodeGen *pCodeGen, struct Node *root )
             fprintf( fp, "\tOPS R%d,R%d", a, b );
             fprintf( fp, "\t; open the print session\n");
 
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d\n", idEntry2->offset );
-            fprintf( fp, "\tSTR R2,R%d", b );
+            StoreLocal( pCodeGen, b, idEntry2->offset );
             fprintf( fp, "\t;variable handle\n" );
         }
 
@@ -2830,6 +2857,131 @@ static int generateSystem( CodeGen *pCodeGen, struct Node *root )
     return result;
 }
 
+/*============================================================================*/
+/*  generatePendingSig                                                        */
+/*!
+    Generate assembly code to get the number of queued signals
+
+    The generatePendingSig function processes the PENDINGSIG node and
+    generates the assembly code to get the number of signals which can
+    be received by wait_sig without waiting
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        root
+            pointer to the root node from the parse (sub)tree
+
+    @retval register number of register containing the number of signals
+
+==============================================================================*/
+static int generatePendingSig( CodeGen *pCodeGen, struct Node *root )
+{
+    int result = -1;
+    int r;
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) &&
+        ( root != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        /* allocate a register for the result */
+        r = AllocReg( NULL, 0 );
+        fprintf( fp, "\tEVQ R%d", r );
+        fprintf( fp, "\t; get the number of queued signals\n" );
+
+        result = r;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  generateBeginTx                                                           */
+/*!
+    Generate assembly code to begin an extern transaction
+
+    The generateBeginTx function processes the BEGINTX node and generates
+    the assembly code to open an extern transaction.  Until the
+    transaction is committed, assignments to extern variables are
+    buffered by the virtual machine.
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        root
+            pointer to the root node from the parse (sub)tree
+
+    @retval -1
+
+==============================================================================*/
+static int generateBeginTx( CodeGen *pCodeGen, struct Node *root )
+{
+    int result = -1;
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) &&
+        ( root != NULL ) )
+    {
+        fp = pCodeGen->fp;
+        fprintf( fp, "\tTXB" );
+        fprintf( fp, "\t\t; begin extern transaction\n" );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  generateCommitTx                                                          */
+/*!
+    Generate assembly code to commit an extern transaction
+
+    The generateCommitTx function processes the COMMITTX node and
+    generates the assembly code to commit the extern transaction opened
+    by begin_transaction, which sends the last value assigned to each
+    extern variable in one batch
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        root
+            pointer to the root node from the parse (sub)tree
+
+    @retval register number of register containing the commit result
+
+==============================================================================*/
+static int generateCommitTx( CodeGen *pCodeGen, struct Node *root )
+{
+    int result = -1;
+    int r;
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) &&
+        ( root != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        /* allocate a register for the result */
+        r = AllocReg( NULL, 0 );
+        fprintf( fp, "\tTXC R%d", r );
+        fprintf( fp, "\t; commit extern transaction\n" );
+
+        result = r;
+    }
+
+    return result;
+}
+
 /*============================================================================*/
 /*  generateFileOpen                                                          */
 /*!
@@ -3507,14 +3659,10 @@ static int generateWaitSig( CodeGen *pCodeGen, struct Node *root )
             fprintf( fp, "\tWFS R%d,R%d", a, b );
             fprintf( fp, "\t;wait for signal\n" );
 
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d\n", idEntry1->offset );
-            fprintf( fp, "\tSTR R2,R%d", a );
+            StoreLocal( pCodeGen, a, idEntry1->offset );
             fprintf( fp, "\t;signal number\n" );
 
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d\n", idEntry2->offset );
-            fprintf( fp, "\tSTR R2,R%d", b );
+            StoreLocal( pCodeGen, b, idEntry2->offset );
             fprintf( fp, "\t;signal identifier\n" );
 
             result = b;
@@ -3524,6 +3672,159 @@ static int generateWaitSig( CodeGen *pCodeGen, struct Node *root )
     return result;
 }
 
+/*============================================================================*/
+/*  generateOnSignal                                                          */
+/*!
+    Generate assembly code to set a signal handler
+
+    The generateOnSignal function processes the ONSIGNAL node and
+    generates the assembly code to set a function as the handler of
+    a signal number and signal id.  The VEC instruction is given the
+    address of a stub which passes the signal number and signal id
+    received by the DSP instruction to the handler function as its
+    arguments, i.e. the handler is declared as:
+
+    int handler( int sig, int id )
+
+    The stub restores the signal number and signal id registers when the
+    handler returns, so dispatch_sig can store them into its arguments.
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        root
+            pointer to the root node from the parse (sub)tree
+
+    @retval -1
+
+==============================================================================*/
+static int generateOnSignal( CodeGen *pCodeGen, struct Node *root )
+{
+    int result = -1;
+    int a;
+    int b;
+    int c;
+    char label[7];
+    char label1[7];
+    struct identEntry *idEntry;
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) &&
+        ( root != NULL ) &&
+        ( root->left != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        idEntry = GetIdentEntry( root->right );
+        if( ( idEntry != NULL ) &&
+            ( idEntry->name != NULL ) )
+        {
+            sprintf( (char *)label, "_HV%d", GetLabelNumber() );
+            sprintf( (char *)label1, "_hv%d", GetLabelNumber() );
+
+            /* generate the handler stub */
+            fprintf( fp, "\tJMP %s\n", label );
+            fprintf( fp, "%s\n", label1 );
+            fprintf( fp, "\tMOV R0,SP" );
+            fprintf( fp, "\t;save stack pointer\n" );
+            fprintf( fp, "\tPSH R%d", DISPATCH_ID_REG );
+            fprintf( fp, "\t\t;push signal identifier\n" );
+            fprintf( fp, "\tPSH R%d", DISPATCH_SIGNUM_REG );
+            fprintf( fp, "\t\t;push signal number\n" );
+            fprintf( fp, "\tPSH R0" );
+            fprintf( fp, "\t\t;procedure invokation\n" );
+            fprintf( fp, "\tPSH R1\n" );
+            fprintf( fp, "\tCAL _%s\n", idEntry->name );
+            fprintf( fp, "\tPOP R1\n" );
+            fprintf( fp, "\tPOP R2\n" );
+            fprintf( fp, "\tPOP R%d", DISPATCH_SIGNUM_REG );
+            fprintf( fp, "\t\t;restore signal number\n" );
+            fprintf( fp, "\tPOP R%d", DISPATCH_ID_REG );
+            fprintf( fp, "\t\t;restore signal identifier\n" );
+            fprintf( fp, "\tRET" );
+            fprintf( fp, "\t\t;return to dispatcher\n" );
+            fprintf( fp, "%s\n", label );
+
+            a = GenerateCode( pCodeGen, root->left->left );
+            b = GenerateCode( pCodeGen, root->left->right );
+            c = AllocReg( NULL, 0 );
+
+            fprintf( fp, "\tMOV R%d,%s\n", c, label1 );
+            fprintf( fp, "\tVEC R%d,R%d,R%d", a, b, c );
+            fprintf( fp, "\t;set signal handler\n" );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  generateDispatchSig                                                       */
+/*!
+    Generate assembly code to dispatch a signal
+
+    The generateDispatchSig function processes the DISPATCHSIG node
+    and generates the assembly code to wait for a signal and call its
+    handler.  The signal number and signal id are always received in the
+    registers used by the handler stubs generated by generateOnSignal.
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        root
+            pointer to the root node from the parse (sub)tree
+
+    @retval register number for the register containing the signal id
+
+==============================================================================*/
+static int generateDispatchSig( CodeGen *pCodeGen, struct Node *root )
+{
+    int result = -1;
+    struct identEntry *idEntry1;
+    struct identEntry *idEntry2;
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) &&
+        ( root != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        idEntry1 = GetIdentEntry( root->left );
+        idEntry2 = GetIdentEntry( root->right );
+
+        if( ( idEntry1 != NULL ) &&
+            ( idEntry2 != NULL ) )
+        {
+            /* the handler may use any register, and the fixed signal
+               registers no longer hold any identifiers */
+            FreeReg( DISPATCH_SIGNUM_REG );
+            FreeReg( DISPATCH_ID_REG );
+
+            fprintf( fp,
+                     "\tDSP R%d,R%d",
+                     DISPATCH_SIGNUM_REG,
+                     DISPATCH_ID_REG );
+            fprintf( fp, "\t;dispatch signal\n" );
+
+            StoreLocal( pCodeGen, DISPATCH_SIGNUM_REG, idEntry1->offset );
+            fprintf( fp, "\t;signal number\n" );
+
+            StoreLocal( pCodeGen, DISPATCH_ID_REG, idEntry2->offset );
+            fprintf( fp, "\t;signal identifier\n" );
+
+            result = DISPATCH_ID_REG;
+        }
+    }
+
+    return result;
+}
+
 /*============================================================================*/
 /*  generateNotify                                                            */
 /*!
@@ -3561,9 +3862,7 @@ static int generateNotify( CodeGen *pCodeGen, struct Node *root )
         if( idEntry != NULL )
         {
             a = AllocReg( NULL, 0 );
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d\n", idEntry->offset );
-            fprintf( fp, "\tLOD R%d,R2", a );
+            LoadLocal( pCodeGen, a, idEntry->offset );
             fprintf( fp, "\t;var handle\n");
 
             b = GenerateCode( pCodeGen, root->right );
@@ -3617,9 +3916,7 @@ static int generateHandle( CodeGen *pCodeGen, struct Node *root )
             if( external == true )
             {
                 b = AllocReg( NULL, 0 );
-                fprintf( fp, "\tMOV R2,R1\n" );
-                fprintf( fp, "\tADD R2,%d\n", idEntry->offset );
-                fprintf( fp, "\tLOD R%d,R2", b );
+                LoadLocal( pCodeGen, b, idEntry->offset );
                 fprintf( fp, "\t;var handle\n");
 
                 result = b;
@@ -3676,9 +3973,7 @@ static int generateValidateStart( CodeGen *pCodeGen, struct Node *root )
         if( idEntry != NULL )
         {
             b = AllocReg( NULL, 0 );
-            fprintf( fp, "\tMOV R2,R1\n" );
-            fprintf( fp, "\tADD R2,%d\n", idEntry->offset );
-            fprintf( fp, "\tLOD R%d,R2", b );
+            LoadLocal( pCodeGen, b, idEntry->offset );
             fprintf( fp, "\t;notification identifier\n");
 
             a = AllocReg( NULL, 0 );
@@ -4474,7 +4769,10 @@ static int generateXorEquals( CodeGen *pCodeGen, struct Node *root )
     Generate assembly code to perform array indexing
 
     The generateArray function processes the ARRAY node
-    and generates the assembly code to perform array indexing
+    and generates the assembly code to perform array indexing.
+    Arrays of local variables which are within the reach of a 16-bit
+    displacement are accessed with a single indexed LOD which leaves
+    the element address in R2, otherwise the MUL/SUB/LOD sequence is used.
 
     @param[in]
         pCodeGen
@@ -4492,6 +4790,7 @@ static int generateArray( CodeGen *pCodeGen, struct Node *root )
     int result = -1;
     int a;
     int b;
+    struct Node *lval;
     FILE *fp;
 
     if( ( pCodeGen != NULL ) &&
@@ -4501,14 +4800,39 @@ static int generateArray( CodeGen *pCodeGen, struct Node *root )
         fp = pCodeGen->fp;
 
         b = GenerateCode( pCodeGen, root->right );
-        a = GenerateCode( pCodeGen, root->left );
-        if (a != -1)
+
+        lval = root->left;
+        if( ( lval != NULL ) &&
+            ( lval->type == LVAL_ID ) &&
+            ( lval->ident != NULL ) &&
+            ( lval->ident->offset >= MIN_LOCAL_DISPLACEMENT ) &&
+            ( lval->ident->offset <= MAX_LOCAL_DISPLACEMENT ) )
+        {
+            /* array elements are stored downwards from the base */
+            a = AllocReg( lval->ident, 0 );
+            fprintf( fp,
+                     "\tLOD R%d,[R1+R%d*%d%+d]",
+                     a,
+                     b,
+                     -(int)sizeof(uint32_t),
+                     lval->ident->offset );
+            fprintf( fp, "\t;l-value: %s[]\n", lval->ident->name );
+        }
+        else
         {
-            fprintf( fp, "\tMUL R%d,%lu", b, (unsigned long)sizeof(uint32_t) );
-            fprintf( fp, "\t;multiply array offset by stack element size\n" );
-            fprintf( fp, "\tSUB R2,R%d", b );
-            fprintf( fp, "\t;calculate array offset\n" );
-            fprintf( fp, "\tLOD R%d,R2\n", a );
+            a = GenerateCode( pCodeGen, root->left );
+            if (a != -1)
+            {
+                fprintf( fp,
+                         "\tMUL R%d,%lu",
+                         b,
+                         (unsigned long)sizeof(uint32_t) );
+                fprintf( fp,
+                         "\t;multiply array offset by stack element size\n" );
+                fprintf( fp, "\tSUB R2,R%d", b );
+                fprintf( fp, "\t;calculate array offset\n" );
+                fprintf( fp, "\tLOD R%d,R2\n", a );
+            }
         }
 
         result = a;
@@ -5096,6 +5420,149 @@ static int generateBnot( CodeGen *pCodeGen, struct Node *root )
     return result;
 }
 
+/*============================================================================*/
+/*  generateCondition                                                         */
+/*!
+    Generate assembly code to branch on a condition
+
+    The generateCondition function generates the assembly code to jump
+    to the specified label when a condition evaluates to the specified
+    sense.  A relational (==, !=, <, <=, >, >=) condition is generated
+    as a single compare and branch instruction.  Any other condition is
+    evaluated into a register and compared with zero.
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        root
+            pointer to the condition node from the parse (sub)tree
+
+    @param[in]
+        sense
+            true to jump if the condition is true,
+            false to jump if the condition is false
+
+    @param[in]
+        label
+            label to jump to
+
+    @retval -1
+
+==============================================================================*/
+static int generateCondition( CodeGen *pCodeGen,
+                              struct Node *root,
+                              bool sense,
+                              char *label )
+{
+    int result = -1;
+    int a;
+    int b;
+    int type;
+    bool swap = false;
+    char *op = NULL;
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) &&
+        ( label != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        type = ( root != NULL ) ? root->type : -1;
+        if( sense == false )
+        {
+            /* jump on the opposite relation */
+            switch( type )
+            {
+                case EQUALS:
+                    type = NOTEQUALS;
+                    break;
+
+                case NOTEQUALS:
+                    type = EQUALS;
+                    break;
+
+                case LT:
+                    type = GTE;
+                    break;
+
+                case GTE:
+                    type = LT;
+                    break;
+
+                case GT:
+                    type = LTE;
+                    break;
+
+                case LTE:
+                    type = GT;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        /* greater than relations swap the operands */
+        switch( type )
+        {
+            case EQUALS:
+                op = "BEQ";
+                break;
+
+            case NOTEQUALS:
+                op = "BNE";
+                break;
+
+            case LT:
+                op = "BLT";
+                break;
+
+            case LTE:
+                op = "BLE";
+                break;
+
+            case GT:
+                op = "BLT";
+                swap = true;
+                break;
+
+            case GTE:
+                op = "BLE";
+                swap = true;
+                break;
+
+            default:
+                break;
+        }
+
+        if( op != NULL )
+        {
+            a = GenerateCode( pCodeGen, root->left );
+            b = GenerateCode( pCodeGen, root->right );
+
+            fprintf( fp,
+                     "\t%s%s R%d,R%d,%s\n",
+                     op,
+                     ( root->datatype == TYPE_FLOAT ) ? ".F" : "",
+                     swap ? b : a,
+                     swap ? a : b,
+                     label );
+        }
+        else
+        {
+            a = GenerateCode( pCodeGen, root );
+
+            fprintf( fp, "\tCMP R%d,0\n", a );
+            fprintf( fp, "\t%s %s\n", sense ? "JNZ" : "JZR", label );
+        }
+    }
+
+    return result;
+}
+
 /*============================================================================*/
 /*  generateEquals                                                            */
 /*!
@@ -5141,16 +5608,15 @@ static int generateEquals( CodeGen *pCodeGen, struct Node *root )
 
         if( root->datatype == TYPE_FLOAT )
         {
-            fprintf( fp, "\tCMP.F R%d,R%d", a, b );
+            fprintf( fp, "\tBEQ.F R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;floating point equals comparison\n" );
         }
         else
         {
-            fprintf( fp, "\tCMP R%d,R%d", a ,b );
+            fprintf( fp, "\tBEQ R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;equals comparison\n" );
         }
 
-        fprintf( fp, "\tJZR %s\n", label );
         fprintf( fp, "\tMOV R%d,0\n", c );
         fprintf( fp, "\tJMP %s\n", label1 );
         fprintf( fp, "%s\n\tMOV R%d,1\n", label, c );
@@ -5188,6 +5654,7 @@ static int generateNotEquals( CodeGen *pCodeGen, struct Node *root )
     int b;
     int c;
     char label[7];
+    char label1[7];            /* label generation */
     FILE *fp;
 
     if( ( pCodeGen != NULL ) &&
@@ -5202,21 +5669,23 @@ static int generateNotEquals( CodeGen *pCodeGen, struct Node *root )
         c = AllocReg( NULL, 0 );
 
         sprintf( (char *)label, "_NEQ%d", GetLabelNumber() );
+        sprintf( (char *)label1, "_NEQ%d", GetLabelNumber() );
+
         if( root->datatype == TYPE_FLOAT )
         {
-            fprintf( fp, "\tCMP.F R%d,R%d", a, b );
+            fprintf( fp, "\tBNE.F R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;floating point not equals comparison\n" );
         }
         else
         {
-            fprintf( fp, "\tCMP R%d,R%d", a, b );
+            fprintf( fp, "\tBNE R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;not equals comparison\n" );
         }
 
         fprintf( fp, "\tMOV R%d,0\n", c );
-        fprintf( fp, "\tJZR %s\n", label );
-        fprintf( fp, "\tMOV R%d,1\n", c );
-        fprintf( fp, "%s\n", label );
+        fprintf( fp, "\tJMP %s\n", label1 );
+        fprintf( fp, "%s\n\tMOV R%d,1\n", label, c );
+        fprintf( fp, "%s\n", label1 );
 
         result = c;
     }
@@ -5269,16 +5738,15 @@ static int generateLessThanOrEqual( CodeGen *pCodeGen, struct Node *root )
 
         if( root->datatype == TYPE_FLOAT )
         {
-            fprintf( fp, "\tCMP.F R%d,R%d", b, a );
+            fprintf( fp, "\tBLE.F R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;floating point LTE comparison\n" );
         }
         else
         {
-            fprintf( fp, "\tCMP R%d,R%d", b, a );
+            fprintf( fp, "\tBLE R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;LTE comparison\n" );
         }
 
-        fprintf( fp, "\tJPO %s\n", label );
         fprintf( fp, "\tMOV R%d,0\n", c );
         fprintf( fp, "\tJMP %s\n", label1 );
         fprintf( fp, "%s\n\tMOV R%d,1\n", label, c );
@@ -5334,16 +5802,15 @@ static int generateGreaterThanOrEqual( CodeGen *pCodeGen, struct Node *root )
 
         if( root->datatype == TYPE_FLOAT )
         {
-            fprintf( fp, "\tCMP.F R%d,R%d", a, b );
+            fprintf( fp, "\tBLE.F R%d,R%d,%s", b, a, label );
             fprintf( fp, "\t;floating point GTE comparison\n" );
         }
         else
         {
-            fprintf( fp, "\tCMP R%d,R%d", a, b );
+            fprintf( fp, "\tBLE R%d,R%d,%s", b, a, label );
             fprintf( fp, "\t;GTE comparison\n" );
         }
 
-        fprintf( fp,"\tJPO %s\n", label );
         fprintf( fp,"\tMOV R%d,0\n", c );
         fprintf( fp,"\tJMP %s\n", label1 );
         fprintf( fp,"%s\n\tMOV R%d,1\n", label, c );
@@ -5400,16 +5867,15 @@ static int generateLessThan( CodeGen *pCodeGen, struct Node *root )
 
         if( root->datatype == TYPE_FLOAT )
         {
-            fprintf( fp, "\tCMP.F R%d,R%d", a, b );
+            fprintf( fp, "\tBLT.F R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;floating point LT comparison\n" );
         }
         else
         {
-            fprintf( fp, "\tCMP R%d,R%d", a, b );
+            fprintf( fp, "\tBLT R%d,R%d,%s", a, b, label );
             fprintf( fp, "\t;LT comparison\n" );
         }
 
-        fprintf( fp, "\tJNE %s\n", label );
         fprintf( fp, "\tMOV R%d,0\n", c );
         fprintf( fp, "\tJMP %s\n", label1 );
         fprintf( fp, "%s\n\tMOV R%d,1\n", label, c );
@@ -5466,16 +5932,15 @@ static int generateGreaterThan( CodeGen *pCodeGen, struct Node *root )
 
         if( root->datatype == TYPE_FLOAT )
         {
-            fprintf( fp, "\tCMP.F R%d,R%d", b, a );
+            fprintf( fp, "\tBLT.F R%d,R%d,%s", b, a, label );
             fprintf( fp, "\t;floating point GT comparison\n" );
         }
         else
         {
-            fprintf( fp, "\tCMP R%d,R%d", b, a );
+            fprintf( fp, "\tBLT R%d,R%d,%s", b, a, label );
             fprintf( fp, "\t;GT comparison\n" );
         }
 
-        fprintf( fp, "\tJNE %s\n", label );
         fprintf( fp, "\tMOV R%d,0\n", c );
         fprintf( fp, "\tJMP %s\n", label1 );
         fprintf( fp, "%s\n\tMOV R%d,1\n", label, c );
@@ -6090,9 +6555,7 @@ static int GetExternal( CodeGen *pCodeGen,
 
         /* get a register to store the external value */
         a = AllocReg( ident, 1 );
-        fprintf( fp, "\tMOV R2, R1\n" );
-        fprintf( fp, "\tADD R2, %d\n", ident->offset2 );
-        fprintf( fp, "\tLOD R%d,R2", a );
+        LoadLocal( pCodeGen, a, ident->offset2 );
         fprintf( fp, "\t;external value for %s\n", ident->name );
 
         switch( ident->type )
@@ -6195,14 +6658,12 @@ static int SetExternal( CodeGen *pCodeGen,
         if( dest == -1 )
         {
             dest = AllocReg( ident, 0 );
-            fprintf(fp, "\tMOV R2,R1\n");
-            fprintf( fp, "\tADD R2,%d\n", ident->offset );
-            fprintf( fp, "\tLOD R%d,R2\n", dest );
+            LoadLocal( pCodeGen, dest, ident->offset );
+            fprintf( fp, "\n" );
         }
 
-        fprintf( fp, "\tMOV R2,R1\n");
-        fprintf( fp, "\tADD R2,%d\n", ident->offset2);
-        fprintf( fp, "\tSTR R2,R%d\n", src);
+        StoreLocal( pCodeGen, src, ident->offset2 );
+        fprintf( fp, "\n" );
         fprintf( fp,
                 "\tSET%s R%d,R%d\t;%s : %s\n",
                 modifier,
@@ -6217,5 +6678,101 @@ static int SetExternal( CodeGen *pCodeGen,
     return result;
 }
 
+/*============================================================================*/
+/*  LoadLocal                                                                 */
+/*!
+    Generate assembly code to load a local variable
+
+    The LoadLocal function generates the assembly code to load a register
+    from the stack frame at the specified offset from the frame pointer (R1).
+    The address of the variable is left in R2.  The fused LDL instruction
+    is used when the offset fits in its 16-bit displacement, otherwise the
+    MOV/ADD/LOD sequence is used.  No newline is output so the caller can
+    append a comment.
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        dst
+            number of the register to load
+
+    @param[in]
+        offset
+            offset of the variable from the frame pointer
+
+==============================================================================*/
+static void LoadLocal( CodeGen *pCodeGen, int dst, int offset )
+{
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        if( ( offset >= MIN_LOCAL_DISPLACEMENT ) &&
+            ( offset <= MAX_LOCAL_DISPLACEMENT ) )
+        {
+            fprintf( fp, "\tLDL R%d,%d", dst, offset );
+        }
+        else
+        {
+            fprintf( fp, "\tMOV R2,R1\n" );
+            fprintf( fp, "\tADD R2,%d\n", offset );
+            fprintf( fp, "\tLOD R%d,R2", dst );
+        }
+    }
+}
+
+/*============================================================================*/
+/*  StoreLocal                                                                */
+/*!
+    Generate assembly code to store a local variable
+
+    The StoreLocal function generates the assembly code to store a register
+    into the stack frame at the specified offset from the frame pointer (R1).
+    The address of the variable is left in R2.  The fused STL instruction
+    is used when the offset fits in its 16-bit displacement, otherwise the
+    MOV/ADD/STR sequence is used.  No newline is output so the caller can
+    append a comment.
+
+    @param[in]
+        pCodeGen
+            pointer to the CodeGen object containing the output FILE *
+
+    @param[in]
+        src
+            number of the register to store
+
+    @param[in]
+        offset
+            offset of the variable from the frame pointer
+
+==============================================================================*/
+static void StoreLocal( CodeGen *pCodeGen, int src, int offset )
+{
+    FILE *fp;
+
+    if( ( pCodeGen != NULL ) &&
+        ( pCodeGen->fp != NULL ) )
+    {
+        fp = pCodeGen->fp;
+
+        if( ( offset >= MIN_LOCAL_DISPLACEMENT ) &&
+            ( offset <= MAX_LOCAL_DISPLACEMENT ) )
+        {
+            fprintf( fp, "\tSTL R%d,%d", src, offset );
+        }
+        else
+        {
+            fprintf( fp, "\tMOV R2,R1\n" );
+            fprintf( fp, "\tADD R2,%d\n", offset );
+            fprintf( fp, "\tSTR R2,R%d", src );
+        }
+    }
+}
+
 /*! @}
  * end of codegen group */
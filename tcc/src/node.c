@@ -328,6 +328,14 @@ void parseTree(struct Node *root, int lvl)
             printf("system");
             break;
 
+        case PENDINGSIG:
+            printf("pending_sig");
+            break;
+
+        case COMMITTX:
+            printf("commit_transaction");
+            break;
+
         case FILE_OPEN:
             printf("file_open");
             break;
@@ -560,6 +568,22 @@ void parseTree(struct Node *root, int lvl)
             printf("WAITSIG");
             break;
 
+        case ONSIGNAL:
+            printf("ONSIGNAL");
+            break;
+
+        case ONSIGNAL1:
+            printf("ONSIGNAL1");
+            break;
+
+        case DISPATCHSIG:
+            printf("DISPATCHSIG");
+            break;
+
+        case BEGINTX:
+            printf("BEGINTX");
+            break;
+
         case NOTIFY:
             printf("NOTIFY");
             break;
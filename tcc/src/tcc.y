@@ -114,6 +114,12 @@ static int ParamCount( struct Node *root );
 %token SETTIMER
 %token CLEARTIMER
 %token WAITSIG
+%token PENDINGSIG
+%token BEGINTX
+%token COMMITTX
+%token ONSIGNAL
+%token ONSIGNAL1
+%token DISPATCHSIG
 %token NOTIFY
 %token FILE_OPEN
 %token FILE_CLOSE
@@ -322,6 +328,12 @@ statement:    expression SEMI
             { $$ = $1; }
         |   waitsignal_statement SEMI
             { $$ = $1; }
+        |   onsignal_statement SEMI
+            { $$ = $1; }
+        |   dispatchsignal_statement SEMI
+            { $$ = $1; }
+        |   begintx_statement SEMI
+            { $$ = $1; }
         |   notify_statement SEMI
             { $$ = $1; }
         |   validate_end_statement SEMI
@@ -525,6 +537,46 @@ waitsignal_statement: WAITSIG LPAREN BAND lval_expression COMMA BAND lval_expres
             }
         ;
 
+onsignal_statement: ONSIGNAL LPAREN expression COMMA expression COMMA identifier RPAREN
+            {
+                int type1 = TypeCheck( $3, 0, false );
+                int type2 = TypeCheck( $5, 0, false );
+                CheckIdent( $7, ident );
+                if( ( (type1 == TYPE_INT) || (type1 == TYPE_CHAR) ) &&
+                    ( (type2 == TYPE_INT) || (type2 == TYPE_CHAR) ) )
+                {
+                    $$ = (struct Node *)createNode( ONSIGNAL,
+                            (struct Node *)createNode( ONSIGNAL1, $3, $5 ), $7 );
+                }
+                else
+                {
+                    fprintf(stderr, "E: Invalid arguments to on_signal on line %d\n", getlineno() + 1 );
+                    errorFlag = true;
+                }
+            }
+        ;
+
+dispatchsignal_statement: DISPATCHSIG LPAREN BAND lval_expression COMMA BAND lval_expression RPAREN
+            {
+                if( ( TypeCheck($4, 0, false ) == TYPE_INT ) &&
+                    ( TypeCheck($7, 0, false ) == TYPE_INT ) )
+                {
+                    $$ = (struct Node *)createNode( DISPATCHSIG, $4, $7 );
+                }
+                else
+                {
+                    fprintf(stderr, "E: Invalid arguments to dispatch_sig on line %d\n", getlineno() + 1 );
+                    errorFlag = true;
+                }
+            }
+        ;
+
+begintx_statement: BEGINTX LPAREN RPAREN
+            {
+                $$ = (struct Node *)createNode( BEGINTX, NULL, NULL );
+            }
+        ;
+
 notify_statement: NOTIFY LPAREN identifier COMMA expression RPAREN
             {
                 $$ = (struct Node *)createNode( NOTIFY, $3, $5 );
@@ -827,6 +879,16 @@ postfix_expression
                 }
             }
 
+        |   PENDINGSIG LPAREN RPAREN
+            {
+                $$ = (struct Node *)createNode( PENDINGSIG, NULL, NULL );
+            }
+
+        |   COMMITTX LPAREN RPAREN
+            {
+                $$ = (struct Node *)createNode( COMMITTX, NULL, NULL );
+            }
+
         |   SYSTEM LPAREN expression RPAREN
             {
                 $$ = (struct Node *)createNode( SYSTEM, $3, NULL );
@@ -1670,6 +1732,7 @@ int main(int argC, char *argV[])
 
     /* insert global constants */
     InsertConstant( "SIG_TIMER", TYPE_INT, SIGRTMIN+5 );
+    InsertConstant( "TIMER_ONESHOT", TYPE_INT, 0x40000000 );
     InsertConstant( "NOTIFY_MODIFIED", TYPE_INT, 1 );
     InsertConstant( "NOTIFY_CALC", TYPE_INT, 2 );
     InsertConstant( "NOTIFY_VALIDATE", TYPE_INT, 3 );
@@ -172,6 +172,16 @@ int TypeCheck(struct Node *root, int level, bool debug)
         return( TYPE_INT );
     }
 
+    if( root->type == PENDINGSIG )
+    {
+        return( TYPE_INT );
+    }
+
+    if( root->type == COMMITTX )
+    {
+        return( TYPE_INT );
+    }
+
     if( root->type == CHARAT )
     {
         return( TYPE_CHAR );
@@ -0,0 +1,75 @@
+int main()
+{
+    int a;
+    int b;
+    int i;
+    int n;
+    float x;
+    float y;
+
+    a = 0 - 3;
+    b = 2;
+
+    // if statements jump on the opposite relation, so each relation
+    // which holds writes its number, and each one which does not
+    // writes its number negated
+    if( a < b ) { write( 1, ' ' ); };
+    if( b < a ) { write( -2, ' ' ); };
+    if( a <= b ) { write( 3, ' ' ); };
+    if( b <= a ) { write( -4, ' ' ); };
+    if( b > a ) { write( 5, ' ' ); };
+    if( a > b ) { write( -6, ' ' ); };
+    if( b >= b ) { write( 7, ' ' ); };
+    if( a >= b ) { write( -8, ' ' ); };
+    if( a == a ) { write( 9, ' ' ); };
+    if( a == b ) { write( -10, ' ' ); };
+    if( a != b ) { write( 11, ' ' ); };
+    if( a != a ) { write( -12, ' ' ); };
+    write( '\n' );
+
+    // for loops leave the loop on the opposite relation
+    n = 0;
+    for( i = a; i <= b; i++ )
+    {
+        n = n + i;
+    };
+    write( n, ' ' );
+
+    n = 0;
+    for( i = b; i > a; i-- )
+    {
+        n++;
+    };
+    write( n, ' ' );
+
+    // while loops test the relation before each iteration
+    i = 0;
+    while( i != 5 )
+    {
+        i++;
+    };
+    write( i, ' ' );
+
+    i = 10;
+    while( i >= 7 )
+    {
+        i--;
+    };
+    write( i, '\n' );
+
+    // floating point relations
+    x = 0.0 - 1.5;
+    y = 0.25;
+    if( x < y ) { write( 1, ' ' ); };
+    if( x >= y ) { write( -2, ' ' ); };
+    if( y > x ) { write( 3, ' ' ); };
+    if( y <= x ) { write( -4, ' ' ); };
+    if( x != y ) { write( 5, ' ' ); };
+    if( x == y ) { write( -6, ' ' ); };
+
+    // other conditions compare their value with zero
+    n = b - 2;
+    if( n ) { write( -7, ' ' ); };
+    if( a ) { write( 8, ' ' ); };
+    write( '\n' );
+}
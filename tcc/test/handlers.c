@@ -0,0 +1,51 @@
+int timer1( int sig, int id )
+{
+    write("Timer 1 expired\n");
+    return(0);
+}
+
+int timer2( int sig, int id )
+{
+    write("Timer 2 expired\n");
+    return(0);
+}
+
+int timers( int sig, int id )
+{
+    write("Timer ", id, " expired once\n");
+    return(0);
+}
+
+int main()
+{
+    int sig;
+    int id;
+    int count = 0;
+
+    // call a handler for each of the first two timers
+    on_signal( SIG_TIMER, 1, timer1 );
+    on_signal( SIG_TIMER, 2, timer2 );
+
+    // handle every other timer in a single handler
+    on_signal( SIG_TIMER, 0, timers );
+
+    // set up timer 1 to fire every 1.5 seconds
+    set_timer( 1, 1500 );
+
+    // set up timer 2 to fire every 2 seconds
+    set_timer( 2, 2000 );
+
+    // set up timer 3 to fire once after 1 second
+    set_timer( 3, 1000 | TIMER_ONESHOT );
+
+    // run until we have received 4 timer 1 signals
+    while( count < 4 )
+    {
+        // wait for a signal and call its handler
+        dispatch_sig( &sig, &id );
+        if( ( sig == SIG_TIMER ) && ( id == 1 ) )
+        {
+            count++;
+        }
+    }
+}
@@ -0,0 +1,29 @@
+int main()
+{
+    int sig;
+    int id;
+    int n;
+    int i;
+
+    // start three one-shot timers which all expire during the delay
+    set_timer( 1, 200 | TIMER_ONESHOT );
+    set_timer( 2, 300 | TIMER_ONESHOT );
+    set_timer( 3, 400 | TIMER_ONESHOT );
+    delay( 500 );
+
+    // the expirations are queued, so wait_sig does not have to wait
+    n = pending_sig();
+    write( "pending signals: ", n, "\n" );
+
+    for( i = 0; i < n; i++ )
+    {
+        wait_sig( &sig, &id );
+        if( sig == SIG_TIMER )
+        {
+            write( "timer ", id, " expired\n" );
+        };
+    };
+
+    n = pending_sig();
+    write( "pending signals: ", n, "\n" );
+}
@@ -0,0 +1,14 @@
+int main()
+{
+    int i;
+    extern int __sys__test__shm;
+
+    // give the waiting program time to request its notification
+    delay( 200 );
+
+    for( i = 1; i <= 3; i++ )
+    {
+        __sys__test__shm = i * 1000;
+        delay( 200 );
+    };
+}
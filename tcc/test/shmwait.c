@@ -0,0 +1,20 @@
+int main()
+{
+    int sig;
+    int id;
+    int count = 0;
+    extern int __sys__test__shm;
+
+    // ask to be told when another program sets /sys/test/shm
+    notify( __sys__test__shm, NOTIFY_MODIFIED );
+
+    while( count < 3 )
+    {
+        wait_sig( &sig, &id );
+        if( sig == SIG_VAR_MODIFIED )
+        {
+            write( "/sys/test/shm changed to ", __sys__test__shm, "\n" );
+            count++;
+        };
+    };
+}
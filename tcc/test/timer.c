@@ -11,6 +11,9 @@ int main()
     // set up timer 2 to fire every 2 seconds
     set_timer( 2, 2000 );
 
+    // set up timer 3 to fire once after 1 second
+    set_timer( 3, 1000 | TIMER_ONESHOT );
+
     // run until we have received 10 timer 1 signals
     while( !done )
     {
@@ -38,6 +41,11 @@ int main()
                     write("Timer 2 expired\n");
                     break;
 
+                case 3:
+                    // Timer 3
+                    write("Timer 3 expired once\n");
+                    break;
+
                 default:
                     break;
             }
@@ -0,0 +1,33 @@
+int main()
+{
+    extern int __sys__test__a;
+    extern int __sys__test__b;
+    extern float __sys__test__f;
+    extern string __sys__test__c;
+    int count;
+    int result;
+
+    write("Running extern transaction test\n");
+
+    // the extern variables are only updated when the transaction commits
+    begin_transaction();
+
+    for( count = 0; count < 100; count++ )
+    {
+        __sys__test__a = count;
+        __sys__test__b += 2;
+    }
+
+    __sys__test__f = 1.5;
+    __sys__test__c = "updated in a transaction";
+
+    write("/SYS/TEST/A = ", __sys__test__a, '\n' );
+
+    result = commit_transaction();
+
+    write("commit result = ", result, '\n' );
+    write("/SYS/TEST/A = ", __sys__test__a, '\n' );
+    write("/SYS/TEST/B = ", __sys__test__b, '\n' );
+    write("/SYS/TEST/F = ", __sys__test__f, '\n' );
+    write("/SYS/TEST/C = ", __sys__test__c, '\n' );
+}
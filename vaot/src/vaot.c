@@ -0,0 +1,1748 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @defgroup vaot vaot
+ * @brief Virtual Machine Ahead-of-Time Compiler
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file vaot.c
+
+    Virtual Machine Ahead-of-Time Compiler
+
+    The vaot Application translates a binary image produced by the vasm
+    assembler (or vm -o) into C code, and compiles it into a native
+    module which can be loaded by vexe to execute the program without
+    interpreting it.
+
+    The program image is walked from address 0 following the control
+    flow, and each region of the program starting at a subroutine entry
+    point is translated into a C function using goto based control flow.
+    Data movement, integer arithmetic and branches are translated directly,
+    and all other instructions are executed by calling back into the
+    VM core interpreter, so the native module behaves identically to the
+    interpreted program.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vmcore/core.h>
+#include <vmcore/datatypes.h>
+#include <vmcore/aot.h>
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! Default core size for the VM core */
+#define DEFAULT_CORE_SIZE ( 65536 )
+
+/*! Default stack size for the VM core */
+#define DEFAULT_STACK_SIZE ( 4096 )
+
+/*! Default C compiler used to build the native module */
+#define DEFAULT_CC "cc"
+
+#ifndef EOK
+/*! success response */
+#define EOK ( 0 )
+#endif
+
+/*! address flag: an instruction has been decoded at this address */
+#define AOT_INST    0x01
+
+/*! address flag: the native module can be entered at this address */
+#define AOT_ENTRY   0x02
+
+/*! address flag: a region (subroutine) starts at this address */
+#define AOT_REGION  0x04
+
+/*! classification of a VM instruction for translation */
+typedef enum eAOTClass
+{
+    /*! translated into C */
+    eAOT_NATIVE,
+
+    /*! translated into C, and changes the flow of the program */
+    eAOT_BRANCH,
+
+    /*! executed by the interpreter, and the native code continues */
+    eAOT_STEP,
+
+    /*! executed by the interpreter, and the native code returns */
+    eAOT_CALL,
+
+    /*! cannot be translated, the interpreter executes it */
+    eAOT_BAIL
+} teAOTClass;
+
+/*! the tzAOTInst object describes a decoded VM instruction */
+typedef struct zAOTInst
+{
+    /*! address of the instruction */
+    uint32_t pc;
+
+    /*! address of the next sequential instruction */
+    uint32_t next;
+
+    /*! literal value, memory address or branch target */
+    int32_t imm;
+
+    /*! instruction byte containing the width and mode flags */
+    uint8_t op;
+
+    /*! operation code within the extended instruction set */
+    uint8_t ext;
+
+    /*! destination register */
+    uint8_t dst;
+
+    /*! source register */
+    uint8_t src;
+
+    /*! base register of an LDL, STL, LDX or STX memory access */
+    uint8_t base;
+
+    /*! index register of an LDX or STX memory access */
+    uint8_t index;
+
+    /*! scale applied to the index register, or 0 for no index */
+    int8_t scale;
+
+    /*! width flags of an LDL, STL, LDX or STX memory access */
+    uint8_t width;
+
+    /*! translation class */
+    teAOTClass cls;
+
+    /*! true if the next sequential instruction can be executed next */
+    bool fallthrough;
+
+    /*! true if the instruction sets the status flags */
+    bool setsFlags;
+
+    /*! true if the status flags must be calculated by the instruction */
+    bool emitFlags;
+} tzAOTInst;
+
+/*! the tzAOTState object holds the state of the translation */
+typedef struct zAOTState
+{
+    /*! VM core holding the program image */
+    tzCore *pCore;
+
+    /*! pointer to the program image */
+    uint8_t *pMemory;
+
+    /*! size of the program image */
+    size_t programSize;
+
+    /*! true if multi-byte values in the program image use the host
+        byte order instead of big endian format */
+    bool nativeEndian;
+
+    /*! address flags for each program address */
+    uint8_t *pFlags;
+
+    /*! decoded instruction for each program address */
+    tzAOTInst *pInsts;
+
+    /*! stack of addresses still to be decoded */
+    uint32_t *pWork;
+
+    /*! number of addresses on the stack */
+    size_t numWork;
+
+    /*! output file for the generated C code */
+    FILE *fp;
+} tzAOTState;
+
+/*==============================================================================
+        Public function declarations
+==============================================================================*/
+int main( int argc, char **argv );
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+void usage( void );
+static int aot_fnDiscover( tzAOTState *pState );
+static void aot_fnPush( tzAOTState *pState, uint32_t addr, uint8_t flags );
+static bool aot_fnDecode( tzAOTState *pState, uint32_t pc, tzAOTInst *pInst );
+static void aot_fnFlagLiveness( tzAOTState *pState,
+                                uint32_t start,
+                                uint32_t end );
+static void aot_fnGenerate( tzAOTState *pState, char *inputFile );
+static void aot_fnGenerateRegion( tzAOTState *pState,
+                                  uint32_t start,
+                                  uint32_t end );
+static void aot_fnGenerateInst( tzAOTState *pState,
+                                tzAOTInst *pInst,
+                                uint32_t start,
+                                uint32_t end );
+static void aot_fnGenerateJump( tzAOTState *pState,
+                                uint32_t target,
+                                uint32_t start,
+                                uint32_t end );
+static int aot_fnCompile( char *sourceFile,
+                          char *outputFile,
+                          char *includeDir,
+                          bool verbose );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  main                                                                      */
+/*!
+    Main entry point for the vaot application
+
+    The main function starts the vaot application
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @retval 0 the native module was generated
+    @retval 1 the native module could not be generated
+
+==============================================================================*/
+int main(int argc, char **argv)
+{
+    char *inputFile = NULL;
+    char *outputFile = NULL;
+    char *sourceFile = NULL;
+    char *includeDir = NULL;
+    size_t core_size = DEFAULT_CORE_SIZE;
+    bool sourceOnly = false;
+    bool keepSource = false;
+    bool verbose = false;
+    tzAOTState state;
+    size_t len;
+    int result = 1;
+    int c;
+
+    while( ( c = getopt( argc, argv, "c:o:I:Skhv" ) ) != -1 )
+    {
+        switch( c )
+        {
+            case 'c':
+                core_size = atol( optarg );
+                break;
+
+            case 'o':
+                outputFile = optarg;
+                break;
+
+            case 'I':
+                includeDir = optarg;
+                break;
+
+            case 'S':
+                sourceOnly = true;
+                break;
+
+            case 'k':
+                keepSource = true;
+                break;
+
+            case 'v':
+                verbose = true;
+                break;
+
+            case 'h':
+                usage();
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if( optind >= argc )
+    {
+        usage();
+    }
+
+    inputFile = argv[optind];
+
+    memset( &state, 0, sizeof( tzAOTState ) );
+
+    state.pCore = CORE_fnCreate( core_size, DEFAULT_STACK_SIZE );
+    if( state.pCore == NULL )
+    {
+        fprintf( stderr, "Unable to create VM core\n" );
+        exit( 1 );
+    }
+
+    if( CORE_fnLoad( state.pCore, inputFile ) != true )
+    {
+        fprintf( stderr, "Unable to load binary image file: %s\n", inputFile );
+        exit( 1 );
+    }
+
+    /* the native module is written next to the binary image by default */
+    len = strlen( inputFile ) + 4;
+    if( outputFile == NULL )
+    {
+        outputFile = malloc( len );
+        if( outputFile != NULL )
+        {
+            snprintf( outputFile,
+                      len,
+                      "%s.%s",
+                      inputFile,
+                      sourceOnly ? "c" : "so" );
+        }
+    }
+
+    if( outputFile == NULL )
+    {
+        fprintf( stderr, "Out of memory\n" );
+        exit( 1 );
+    }
+
+    if( sourceOnly )
+    {
+        sourceFile = outputFile;
+    }
+    else
+    {
+        len = strlen( outputFile ) + 3;
+        sourceFile = malloc( len );
+        if( sourceFile == NULL )
+        {
+            fprintf( stderr, "Out of memory\n" );
+            exit( 1 );
+        }
+
+        snprintf( sourceFile, len, "%s.c", outputFile );
+    }
+
+    if( aot_fnDiscover( &state ) != EOK )
+    {
+        fprintf( stderr, "Unable to translate %s\n", inputFile );
+        exit( 1 );
+    }
+
+    state.fp = fopen( sourceFile, "w" );
+    if( state.fp == NULL )
+    {
+        fprintf( stderr, "Unable to create %s\n", sourceFile );
+        exit( 1 );
+    }
+
+    aot_fnGenerate( &state, inputFile );
+    fclose( state.fp );
+
+    if( verbose )
+    {
+        printf( "Generated %s\n", sourceFile );
+    }
+
+    if( sourceOnly )
+    {
+        result = 0;
+    }
+    else
+    {
+        if( aot_fnCompile( sourceFile,
+                           outputFile,
+                           includeDir,
+                           verbose ) == EOK )
+        {
+            result = 0;
+        }
+
+        if( keepSource == false )
+        {
+            unlink( sourceFile );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  usage                                                                     */
+/*!
+    Display the application usage
+
+    The usage function describes the application usage and then exits
+
+==============================================================================*/
+void usage( void )
+{
+    printf( "usage: vaot [-c core size] [-o output file] [-I include dir]"
+            " [-S] [-k] [-h] [-v] <binary image>\n" );
+    exit( 1 );
+}
+
+/*============================================================================*/
+/*  aot_fnDiscover                                                            */
+/*!
+    Find and decode the instructions of the program
+
+    The aot_fnDiscover function walks the program image from address 0,
+    following every path of the program's control flow, to separate
+    the instructions from any data stored in the image.  It records the
+    addresses where the native module can be entered, and the start of
+    each subroutine.
+
+    Addresses which are not found by the walk (for example the target of
+    a call through a register) are executed by the interpreter.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @retval EOK the program was decoded
+    @retval ENOMEM memory allocation failure
+    @retval ENOENT the program image is empty
+
+==============================================================================*/
+static int aot_fnDiscover( tzAOTState *pState )
+{
+    tzAOTInst *pInst;
+    uint32_t pc;
+    size_t len;
+
+    pState->pMemory = CORE_fnMemory( pState->pCore );
+    pState->programSize = CORE_fnGetProgramSize( pState->pCore );
+    pState->nativeEndian = CORE_fnIsNativeEndian( pState->pCore );
+    if( pState->programSize == 0 )
+    {
+        return ENOENT;
+    }
+
+    pState->pFlags = calloc( pState->programSize, sizeof( uint8_t ) );
+    pState->pInsts = calloc( pState->programSize, sizeof( tzAOTInst ) );
+    pState->pWork = calloc( pState->programSize, sizeof( uint32_t ) );
+    if( ( pState->pFlags == NULL ) ||
+        ( pState->pInsts == NULL ) ||
+        ( pState->pWork == NULL ) )
+    {
+        return ENOMEM;
+    }
+
+    aot_fnPush( pState, 0, AOT_ENTRY | AOT_REGION );
+
+    while( pState->numWork > 0 )
+    {
+        pc = pState->pWork[--pState->numWork];
+        if( pState->pFlags[pc] & AOT_INST )
+        {
+            continue;
+        }
+
+        pState->pFlags[pc] |= AOT_INST;
+        pInst = &pState->pInsts[pc];
+        if( aot_fnDecode( pState, pc, pInst ) == false )
+        {
+            pInst->cls = eAOT_BAIL;
+        }
+
+        switch( pInst->cls )
+        {
+            case eAOT_BRANCH:
+                /* branch targets can be entered after leaving a region */
+                aot_fnPush( pState, pInst->imm, AOT_ENTRY );
+                break;
+
+            case eAOT_CALL:
+                if( ( ( pInst->op & 0x1F ) == HCAL ) &&
+                    ( ( pInst->op & MODE_REG ) == 0 ) )
+                {
+                    /* each subroutine is a separate region */
+                    aot_fnPush( pState, pInst->imm, AOT_ENTRY | AOT_REGION );
+                }
+
+                if( pInst->fallthrough )
+                {
+                    /* the program continues here after a return or
+                       after the interpreted instruction */
+                    len = CORE_fnInstructionLength( pState->pCore, pc );
+                    if( len == 0 )
+                    {
+                        pInst->fallthrough = false;
+                    }
+                    else
+                    {
+                        pInst->next = pc + len;
+                        aot_fnPush( pState, pInst->next, AOT_ENTRY );
+                    }
+                }
+                break;
+
+            case eAOT_BAIL:
+                /* the interpreter returns to the next instruction */
+                if( pInst->next > pc )
+                {
+                    aot_fnPush( pState, pInst->next, AOT_ENTRY );
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        if( ( pInst->fallthrough ) && ( pInst->cls != eAOT_CALL ) )
+        {
+            aot_fnPush( pState, pInst->next, 0 );
+        }
+    }
+
+    return EOK;
+}
+
+/*============================================================================*/
+/*  aot_fnPush                                                                */
+/*!
+    Add an address to the list of addresses to decode
+
+    The aot_fnPush function records the flags for an address of the
+    program, and adds it to the list of addresses to decode if it has
+    not been decoded yet.  Addresses outside the program are ignored.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        addr
+            address of an instruction
+
+    @param[in]
+        flags
+            address flags to set (AOT_ENTRY, AOT_REGION)
+
+==============================================================================*/
+static void aot_fnPush( tzAOTState *pState, uint32_t addr, uint8_t flags )
+{
+    if( addr >= pState->programSize )
+    {
+        return;
+    }
+
+    pState->pFlags[addr] |= flags;
+
+    if( ( ( pState->pFlags[addr] & AOT_INST ) == 0 ) &&
+        ( pState->numWork < pState->programSize ) )
+    {
+        pState->pWork[pState->numWork++] = addr;
+    }
+}
+
+/*============================================================================*/
+/*  aot_fnDecode                                                              */
+/*!
+    Decode a VM instruction for translation
+
+    The aot_fnDecode function decodes the VM instruction at the specified
+    program address, and classifies how it is to be translated.  The
+    decoding follows exactly how the interpreter opXXX functions
+    interpret the instruction bytes.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        pc
+            address of the instruction
+
+    @param[out]
+        pInst
+            pointer to the tzAOTInst object to populate
+
+    @retval true the instruction was decoded
+    @retval false the instruction must be executed by the interpreter
+
+==============================================================================*/
+static bool aot_fnDecode( tzAOTState *pState, uint32_t pc, tzAOTInst *pInst )
+{
+    uint8_t *instr = &pState->pMemory[pc];
+    uint8_t op = instr[0];
+    uint8_t opcode = op & 0x1F;
+    bool isReg = ( ( op & MODE_REG ) == MODE_REG );
+    bool isFloat = ( ( op & FLOAT32 ) == FLOAT32 );
+    bool isSigned = ( opcode >= HMOV );
+    size_t size;
+    size_t len = 0;
+    uint32_t val;
+    uint16_t val16;
+
+    memset( pInst, 0, sizeof( tzAOTInst ) );
+    pInst->pc = pc;
+    pInst->next = pc;
+    pInst->op = op;
+    pInst->dst = ( instr[1] >> 4 ) & 0x0F;
+    pInst->src = instr[1] & 0x0F;
+    pInst->cls = eAOT_NATIVE;
+    pInst->fallthrough = true;
+
+    /* size of a literal value encoded by the width flags */
+    switch( op & ( BYTE | WORD ) )
+    {
+        case BYTE:
+            size = 1;
+            break;
+
+        case WORD:
+            size = 2;
+            break;
+
+        default:
+            size = 4;
+            break;
+    }
+
+    switch( opcode )
+    {
+        case HNOP:
+            len = 1;
+            break;
+
+        case HLOD:
+        case HSTR:
+        case HMOV:
+        case HADD:
+        case HSUB:
+        case HMUL:
+        case HDIV:
+        case HAND:
+        case HOR:
+        case HCMP:
+            len = isReg ? 2 : 2 + size;
+            if( isReg == false )
+            {
+                /* register in the low nibble, followed by a literal */
+                pInst->dst = instr[1] & 0x0F;
+            }
+            break;
+
+        case HNOT:
+        case HTOF:
+        case HTOI:
+        case HPSH:
+        case HPOP:
+            pInst->dst = instr[1] & 0x0F;
+            len = 2;
+            break;
+
+        case HSHR:
+            pInst->dst = instr[1] & 0x0F;
+            pInst->imm = instr[2] & 0x1F;
+            len = 3;
+            break;
+
+        case HSHL:
+            len = 3 + size;
+            break;
+
+        case HJMP:
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            len = 3;
+            isSigned = false;
+            break;
+
+        case HCAL:
+            len = isReg ? 2 : 1 + size;
+            isSigned = false;
+            break;
+
+        case HNEXT:
+            pInst->ext = instr[2] & 0x1F;
+            if( ( ( instr[1] & 0x1F ) == HNEXT ) &&
+                ( pInst->ext >= HBLT ) &&
+                ( pInst->ext <= HBNE ) )
+            {
+                /* compare and branch: the registers to compare are
+                   followed by the branch target */
+                pInst->dst = ( instr[3] >> 4 ) & 0x0F;
+                pInst->src = instr[3] & 0x0F;
+                if( ( instr[1] & ( BYTE | WORD ) ) != WORD )
+                {
+                    /* only 16-bit branch targets are translated */
+                    pInst->cls = eAOT_CALL;
+                    return true;
+                }
+
+                pInst->next = pc + 6;
+                if( pInst->next > pState->programSize )
+                {
+                    pInst->next = pc;
+                    pInst->fallthrough = false;
+                    return false;
+                }
+
+                if( pState->nativeEndian )
+                {
+                    memcpy( &val16, &instr[4], sizeof( val16 ) );
+                }
+                else
+                {
+                    val16 = (uint16_t)( ( instr[4] << 8 ) + instr[5] );
+                }
+
+                pInst->imm = val16;
+                pInst->cls = eAOT_BRANCH;
+
+                /* the PC register is only accessed by the interpreter */
+                return ( pInst->dst != 15 ) && ( pInst->src != 15 );
+            }
+
+            if( ( instr[1] & 0x1F ) != HNEXT )
+            {
+                /* the other extended instructions */
+                pInst->cls = eAOT_CALL;
+                pInst->fallthrough = true;
+                return true;
+            }
+
+            if( ( pInst->ext == HLDL ) || ( pInst->ext == HSTL ) )
+            {
+                /* 32-bit access at a displacement from the frame pointer */
+                pInst->dst = instr[3] & 0x0F;
+                pInst->src = instr[3] & 0x0F;
+                pInst->base = 1;
+                pInst->index = 0;
+                pInst->scale = 0;
+                pInst->width = 0;
+                len = 4;
+            }
+            else if( ( pInst->ext == HLDX ) || ( pInst->ext == HSTX ) )
+            {
+                /* access at a base register plus a scaled index */
+                pInst->dst = ( instr[3] >> 4 ) & 0x0F;
+                pInst->src = pInst->dst;
+                pInst->base = instr[3] & 0x0F;
+                pInst->index = ( instr[4] >> 4 ) & 0x0F;
+                pInst->scale = (int8_t)( ( instr[4] & 0x0F ) ^ 0x08 ) - 8;
+                pInst->width = instr[2] & ( BYTE | WORD );
+                len = 5;
+            }
+            else
+            {
+                /* the other extended instructions */
+                pInst->cls = eAOT_CALL;
+                pInst->fallthrough = true;
+                return true;
+            }
+
+            /* the displacement width is taken from the second HNEXT byte */
+            switch( instr[1] & ( BYTE | WORD ) )
+            {
+                case BYTE:
+                    val = (uint32_t)(int32_t)(int8_t)instr[len];
+                    len += 1;
+                    break;
+
+                case WORD:
+                    if( pState->nativeEndian )
+                    {
+                        memcpy( &val16, &instr[len], sizeof( val16 ) );
+                    }
+                    else
+                    {
+                        val16 = (uint16_t)( ( instr[len] << 8 ) +
+                                            instr[len + 1] );
+                    }
+                    val = (uint32_t)(int32_t)(int16_t)val16;
+                    len += 2;
+                    break;
+
+                default:
+                    /* 32-bit displacements are left to the interpreter */
+                    pInst->cls = eAOT_STEP;
+                    len += 4;
+                    val = 0;
+                    break;
+            }
+
+            pInst->next = pc + len;
+            if( pInst->next > pState->programSize )
+            {
+                pInst->next = pc;
+                pInst->fallthrough = false;
+                return false;
+            }
+
+            pInst->imm = val;
+
+            /* the PC register is only accessed by the interpreter */
+            return ( pInst->dst != 15 ) &&
+                   ( pInst->base != 15 ) &&
+                   ( ( pInst->scale == 0 ) || ( pInst->index != 15 ) );
+
+        default:
+            /* RET, HLT, EXT, GET, SET and the extended instructions */
+            pInst->cls = eAOT_CALL;
+            pInst->fallthrough = ( opcode != HRET ) && ( opcode != HHLT );
+            return true;
+    }
+
+    pInst->next = pc + len;
+    if( pInst->next > pState->programSize )
+    {
+        pInst->next = pc;
+        pInst->fallthrough = false;
+        return false;
+    }
+
+    if( ( opcode == HNOP ) ||
+        ( opcode == HNOT ) ||
+        ( opcode == HSHR ) ||
+        ( ( isReg ) && ( opcode != HSHL ) ) )
+    {
+        /* no literal value */
+        val = 0;
+    }
+    else
+    {
+        /* branch and call targets follow the opcode, other literal
+           values follow the opcode and register */
+        if( ( opcode >= HJMP ) && ( opcode <= HCAL ) )
+        {
+            instr++;
+        }
+        else
+        {
+            instr += 2;
+        }
+
+        switch( size )
+        {
+            case 1:
+                val = instr[0];
+                if( isSigned )
+                {
+                    val = (uint32_t)(int32_t)(int8_t)val;
+                }
+                break;
+
+            case 2:
+                if( pState->nativeEndian )
+                {
+                    memcpy( &val16, instr, sizeof( val16 ) );
+                    val = val16;
+                }
+                else
+                {
+                    val = ( instr[0] << 8 ) + instr[1];
+                }
+
+                if( isSigned )
+                {
+                    val = (uint32_t)(int32_t)(int16_t)val;
+                }
+                break;
+
+            default:
+                if( pState->nativeEndian )
+                {
+                    memcpy( &val, instr, sizeof( val ) );
+                }
+                else
+                {
+                    val = ( (uint32_t)instr[0] << 24 ) +
+                          ( instr[1] << 16 ) +
+                          ( instr[2] << 8 ) +
+                          instr[3];
+                }
+                break;
+        }
+    }
+
+    switch( opcode )
+    {
+        case HNOP:
+            return true;
+
+        case HLOD:
+        case HSTR:
+            if( isReg == false )
+            {
+                pInst->imm = val;
+                pInst->src = pInst->dst;
+            }
+
+            /* stores into the program image are left to the interpreter */
+            if( ( opcode == HSTR ) &&
+                ( isReg == false ) &&
+                ( val < pState->programSize ) )
+            {
+                return false;
+            }
+
+            /* the PC register is only accessed by the interpreter */
+            return ( pInst->dst != 15 ) && ( pInst->src != 15 );
+
+        case HMOV:
+        case HADD:
+        case HSUB:
+        case HMUL:
+        case HDIV:
+        case HAND:
+        case HOR:
+        case HCMP:
+            if( isReg == false )
+            {
+                pInst->imm = val;
+                pInst->src = 0;
+            }
+
+            if( ( isFloat ) &&
+                ( opcode != HMOV ) &&
+                ( opcode != HAND ) &&
+                ( opcode != HOR ) )
+            {
+                /* floating point operations use the interpreter */
+                pInst->cls = eAOT_STEP;
+                return true;
+            }
+
+            pInst->setsFlags = ( opcode != HMOV );
+            return ( pInst->dst != 15 ) && ( pInst->src != 15 );
+
+        case HNOT:
+        case HSHR:
+            return ( pInst->dst != 15 );
+
+        case HCAL:
+            pInst->imm = val;
+            pInst->cls = eAOT_CALL;
+            return true;
+
+        case HJMP:
+        case HJZR:
+        case HJNZ:
+        case HJNE:
+        case HJPO:
+        case HJCA:
+        case HJNC:
+            pInst->fallthrough = ( opcode != HJMP );
+            if( size != 2 )
+            {
+                /* only 16-bit branch targets are translated */
+                pInst->cls = eAOT_CALL;
+                return true;
+            }
+
+            pInst->imm = val;
+            pInst->cls = eAOT_BRANCH;
+            return true;
+
+        default:
+            /* SHL, TOF, TOI, PSH, POP */
+            pInst->cls = eAOT_STEP;
+            return true;
+    }
+}
+
+/*============================================================================*/
+/*  aot_fnFlagLiveness                                                        */
+/*!
+    Determine which instructions must calculate the status flags
+
+    The aot_fnFlagLiveness function walks the instructions of a region
+    backwards to find the instructions whose status flags are overwritten
+    by the next instruction which sets the status flags before they can
+    be tested, or before the native code can return.  These instructions
+    do not need to calculate the status flags.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        start
+            start address of the region
+
+    @param[in]
+        end
+            end address of the region
+
+==============================================================================*/
+static void aot_fnFlagLiveness( tzAOTState *pState,
+                                uint32_t start,
+                                uint32_t end )
+{
+    tzAOTInst *pInst;
+    uint32_t addr = end;
+    uint32_t following = end;
+    bool live = true;
+
+    while( addr-- > start )
+    {
+        if( ( pState->pFlags[addr] & AOT_INST ) == 0 )
+        {
+            continue;
+        }
+
+        pInst = &pState->pInsts[addr];
+
+        if( pInst->next != following )
+        {
+            /* the native code returns after this instruction */
+            live = true;
+        }
+
+        if( pInst->cls != eAOT_NATIVE )
+        {
+            /* branches and the interpreter observe the flags */
+            live = true;
+        }
+        else if( pInst->setsFlags )
+        {
+            pInst->emitFlags = live;
+            live = false;
+        }
+        else if( ( ( pInst->op & 0x1F ) == HLOD ) ||
+                 ( ( pInst->op & 0x1F ) == HSTR ) ||
+                 ( ( pInst->op & 0x1F ) == HNEXT ) )
+        {
+            /* memory accesses may return to the interpreter */
+            live = true;
+        }
+
+        following = addr;
+    }
+}
+
+/*============================================================================*/
+/*  aot_fnGenerate                                                            */
+/*!
+    Generate the C code for the native module
+
+    The aot_fnGenerate function writes the C code for the native module.
+    One function is generated for each region of the program, followed
+    by the native module entry point which selects the region function
+    to run from the VM program counter.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        inputFile
+            name of the binary image being translated
+
+==============================================================================*/
+static void aot_fnGenerate( tzAOTState *pState, char *inputFile )
+{
+    FILE *fp = pState->fp;
+    uint32_t start;
+    uint32_t end;
+    uint32_t addr;
+
+    fprintf( fp,
+             "/* native module generated by vaot from %s */\n\n"
+             "#include <stdint.h>\n"
+             "#include <stdbool.h>\n"
+             "#include <vmcore/aot.h>\n\n"
+             "int " VMAOT_EXECUTE_SYMBOL "( tzVMAOTContext *pCtx );\n\n"
+             "const tzVMAOTInfo " VMAOT_INFO_SYMBOL " =\n"
+             "{\n"
+             "    VMAOT_VERSION,\n"
+             "    %zu,\n"
+             "    0x%08X\n"
+             "};\n",
+             inputFile,
+             pState->programSize,
+             CORE_fnChecksum( pState->pCore ) );
+
+    /* generate the region functions */
+    start = 0;
+    while( start < pState->programSize )
+    {
+        end = start + 1;
+        while( ( end < pState->programSize ) &&
+               ( ( pState->pFlags[end] & AOT_REGION ) == 0 ) )
+        {
+            end++;
+        }
+
+        aot_fnFlagLiveness( pState, start, end );
+        aot_fnGenerateRegion( pState, start, end );
+
+        start = end;
+    }
+
+    /* generate the entry point */
+    fprintf( fp,
+             "\nint " VMAOT_EXECUTE_SYMBOL "( tzVMAOTContext *pCtx )\n"
+             "{\n"
+             "    int32_t pc = pCtx->pReg[15];\n\n"
+             "    switch( pc )\n"
+             "    {\n" );
+
+    start = 0;
+    for( addr = 0; addr < pState->programSize; addr++ )
+    {
+        if( pState->pFlags[addr] & AOT_REGION )
+        {
+            if( addr > 0 )
+            {
+                fprintf( fp,
+                         "            return vmaot_%04X( pCtx, pc );\n\n",
+                         start );
+            }
+
+            start = addr;
+        }
+
+        if( ( pState->pFlags[addr] & ( AOT_ENTRY | AOT_INST ) ) ==
+            ( AOT_ENTRY | AOT_INST ) )
+        {
+            fprintf( fp, "        case 0x%04X:\n", addr );
+        }
+    }
+
+    fprintf( fp,
+             "            return vmaot_%04X( pCtx, pc );\n\n"
+             "        default:\n"
+             "            return 1;\n"
+             "    }\n"
+             "}\n",
+             start );
+}
+
+/*============================================================================*/
+/*  aot_fnGenerateRegion                                                      */
+/*!
+    Generate the C function for a region of the program
+
+    The aot_fnGenerateRegion function writes a C function which executes
+    the instructions of a region of the program starting at the VM
+    program counter.  Branches inside the region are generated as goto
+    statements, and the function returns to the VM core when the
+    program leaves the region.
+
+    The function returns 0 if execution can continue at the VM program
+    counter, or 1 if the instruction at the VM program counter must be
+    executed by the interpreter.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        start
+            start address of the region
+
+    @param[in]
+        end
+            end address of the region
+
+==============================================================================*/
+static void aot_fnGenerateRegion( tzAOTState *pState,
+                                  uint32_t start,
+                                  uint32_t end )
+{
+    FILE *fp = pState->fp;
+    uint32_t addr;
+
+    fprintf( fp,
+             "\nstatic int vmaot_%04X( tzVMAOTContext *pCtx, int32_t pc )\n"
+             "{\n"
+             "    int32_t *R = pCtx->pReg;\n"
+             "    uint8_t *M = pCtx->pMemory;\n"
+             "    uint32_t st = *pCtx->pStatus;\n"
+             "    uint32_t addr;\n"
+             "    int32_t old;\n"
+             "    int32_t val;\n\n"
+             "    (void)M;\n"
+             "    (void)addr;\n"
+             "    (void)old;\n"
+             "    (void)val;\n\n"
+             "    switch( pc )\n"
+             "    {\n",
+             start );
+
+    for( addr = start; addr < end; addr++ )
+    {
+        if( ( pState->pFlags[addr] & ( AOT_ENTRY | AOT_INST ) ) ==
+            ( AOT_ENTRY | AOT_INST ) )
+        {
+            fprintf( fp, "        case 0x%04X: goto L_%04X;\n", addr, addr );
+        }
+    }
+
+    fprintf( fp,
+             "        default: return 1;\n"
+             "    }\n" );
+
+    for( addr = start; addr < end; addr++ )
+    {
+        if( pState->pFlags[addr] & AOT_INST )
+        {
+            aot_fnGenerateInst( pState, &pState->pInsts[addr], start, end );
+        }
+    }
+
+    fprintf( fp, "}\n" );
+}
+
+/*============================================================================*/
+/*  aot_fnGenerateInst                                                        */
+/*!
+    Generate the C code for a VM instruction
+
+    The aot_fnGenerateInst function writes the C code for a decoded VM
+    instruction, with a label if the instruction can be entered from the
+    native module entry point or from a branch.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        pInst
+            pointer to the decoded instruction
+
+    @param[in]
+        start
+            start address of the region
+
+    @param[in]
+        end
+            end address of the region
+
+==============================================================================*/
+static void aot_fnGenerateInst( tzAOTState *pState,
+                                tzAOTInst *pInst,
+                                uint32_t start,
+                                uint32_t end )
+{
+    FILE *fp = pState->fp;
+    uint8_t opcode = pInst->op & 0x1F;
+    bool isReg = ( ( pInst->op & MODE_REG ) == MODE_REG );
+    int width;
+    char operand[32];
+    char compare[64];
+    const char *cond = NULL;
+    const char *rel;
+    const char *load;
+    const char *store;
+    uint32_t addr;
+    uint32_t i;
+
+    /* memory access functions for the byte order of the program image */
+    load = pState->nativeEndian ? "VMAOT_fnLoadNative" : "VMAOT_fnLoad";
+    store = pState->nativeEndian ? "VMAOT_fnStoreNative" : "VMAOT_fnStore";
+
+    width = ( pInst->op & BYTE ) ? 1 : ( pInst->op & WORD ) ? 2 : 4;
+
+    if( isReg )
+    {
+        snprintf( operand, sizeof( operand ), "R[%d]", pInst->src );
+    }
+    else
+    {
+        snprintf( operand,
+                  sizeof( operand ),
+                  "(int32_t)0x%08XU",
+                  (uint32_t)pInst->imm );
+    }
+
+    if( pState->pFlags[pInst->pc] & AOT_ENTRY )
+    {
+        fprintf( fp, "\nL_%04X:\n", pInst->pc );
+    }
+
+    /* instruction bytes */
+    fprintf( fp, "    /* %04X:", pInst->pc );
+    for( i = pInst->pc; ( i < pInst->next ) && ( i < pInst->pc + 8 ); i++ )
+    {
+        fprintf( fp, " %02X", pState->pMemory[i] );
+    }
+    fprintf( fp, " */\n" );
+
+    switch( pInst->cls )
+    {
+        case eAOT_BAIL:
+            fprintf( fp, "    VMAOT_BAIL( 0x%04X );\n", pInst->pc );
+            return;
+
+        case eAOT_CALL:
+            fprintf( fp, "    VMAOT_CALL( 0x%04X );\n", pInst->pc );
+            return;
+
+        case eAOT_STEP:
+            fprintf( fp,
+                     "    VMAOT_STEP( 0x%04X, 0x%04X );\n",
+                     pInst->pc,
+                     pInst->next );
+            break;
+
+        case eAOT_BRANCH:
+            switch( opcode )
+            {
+                case HJZR:
+                    cond = "st & VMAOT_ZFLAG";
+                    break;
+
+                case HJNZ:
+                case HJNC:
+                    /* JNC tests the zero flag in the same way as opJNC */
+                    cond = "!( st & VMAOT_ZFLAG )";
+                    break;
+
+                case HJNE:
+                    cond = "st & VMAOT_NFLAG";
+                    break;
+
+                case HJPO:
+                    cond = "!( st & VMAOT_NFLAG )";
+                    break;
+
+                case HJCA:
+                    cond = "st & VMAOT_CFLAG";
+                    break;
+
+                case HNEXT:
+                    /* compare and branch */
+                    switch( pInst->ext )
+                    {
+                        case HBLT:
+                            rel = "<";
+                            break;
+
+                        case HBLE:
+                            rel = "<=";
+                            break;
+
+                        case HBEQ:
+                            rel = "==";
+                            break;
+
+                        default:
+                            rel = "!=";
+                            break;
+                    }
+
+                    if( ( pState->pMemory[pInst->pc + 2] & FLOAT32 ) ==
+                        FLOAT32 )
+                    {
+                        snprintf( compare,
+                                  sizeof( compare ),
+                                  "VMAOT_fnFloat( R[%d] ) %s"
+                                  " VMAOT_fnFloat( R[%d] )",
+                                  pInst->dst,
+                                  rel,
+                                  pInst->src );
+                    }
+                    else
+                    {
+                        snprintf( compare,
+                                  sizeof( compare ),
+                                  "R[%d] %s R[%d]",
+                                  pInst->dst,
+                                  rel,
+                                  pInst->src );
+                    }
+
+                    cond = compare;
+                    break;
+
+                default:
+                    break;
+            }
+
+            if( cond != NULL )
+            {
+                fprintf( fp, "    if( %s )\n    {\n    ", cond );
+                aot_fnGenerateJump( pState, pInst->imm, start, end );
+                fprintf( fp, "    }\n" );
+            }
+            else
+            {
+                aot_fnGenerateJump( pState, pInst->imm, start, end );
+                return;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if( pInst->cls == eAOT_NATIVE )
+    {
+        switch( opcode )
+        {
+            case HNOP:
+                break;
+
+            case HLOD:
+                if( isReg )
+                {
+                    fprintf( fp, "    addr = (uint32_t)R[%d];\n", pInst->src );
+                }
+                else
+                {
+                    fprintf( fp, "    addr = 0x%X;\n", (uint32_t)pInst->imm );
+                }
+
+                fprintf( fp,
+                         "    if( addr > pCtx->coreSize - %d )"
+                         " VMAOT_BAIL( 0x%04X );\n"
+                         "    R[%d] = %s( M, addr, %d, R[%d] );\n",
+                         width,
+                         pInst->pc,
+                         pInst->dst,
+                         load,
+                         width,
+                         pInst->dst );
+                break;
+
+            case HSTR:
+                if( isReg )
+                {
+                    fprintf( fp, "    addr = (uint32_t)R[%d];\n", pInst->dst );
+                }
+                else
+                {
+                    fprintf( fp, "    addr = 0x%X;\n", (uint32_t)pInst->imm );
+                }
+
+                /* stores into the program image are left to the
+                   interpreter so the native module can be disabled */
+                fprintf( fp,
+                         "    if( ( addr > pCtx->coreSize - %d ) ||"
+                         " ( addr < 0x%zX ) ) VMAOT_BAIL( 0x%04X );\n"
+                         "    %s( M, addr, %d, R[%d] );\n",
+                         width,
+                         pState->programSize,
+                         pInst->pc,
+                         store,
+                         width,
+                         pInst->src );
+                break;
+
+            case HNEXT:
+                /* LDL, STL, LDX and STX: the effective address is left
+                   in R2 once the access is known to be translated */
+                width = ( pInst->width & BYTE ) ? 1
+                      : ( pInst->width & WORD ) ? 2 : 4;
+                if( pInst->scale != 0 )
+                {
+                    fprintf( fp,
+                             "    addr = (uint32_t)R[%d] +"
+                             " (uint32_t)R[%d] * (uint32_t)%d +"
+                             " 0x%08XU;\n",
+                             pInst->base,
+                             pInst->index,
+                             pInst->scale,
+                             (uint32_t)pInst->imm );
+                }
+                else
+                {
+                    fprintf( fp,
+                             "    addr = (uint32_t)R[%d] + 0x%08XU;\n",
+                             pInst->base,
+                             (uint32_t)pInst->imm );
+                }
+
+                if( ( pInst->ext == HLDL ) || ( pInst->ext == HLDX ) )
+                {
+                    fprintf( fp,
+                             "    if( addr > pCtx->coreSize - %d )"
+                             " VMAOT_BAIL( 0x%04X );\n"
+                             "    R[2] = (int32_t)addr;\n"
+                             "    R[%d] = %s( M, addr, %d, R[%d] );\n",
+                             width,
+                             pInst->pc,
+                             pInst->dst,
+                             load,
+                             width,
+                             pInst->dst );
+                }
+                else
+                {
+                    fprintf( fp,
+                             "    if( ( addr > pCtx->coreSize - %d ) ||"
+                             " ( addr < 0x%zX ) ) VMAOT_BAIL( 0x%04X );\n"
+                             "    R[2] = (int32_t)addr;\n"
+                             "    %s( M, addr, %d, R[%d] );\n",
+                             width,
+                             pState->programSize,
+                             pInst->pc,
+                             store,
+                             width,
+                             pInst->src );
+                }
+                break;
+
+            case HMOV:
+                fprintf( fp, "    R[%d] = %s;\n", pInst->dst, operand );
+                break;
+
+            case HNOT:
+                fprintf( fp, "    R[%d] = ~R[%d];\n", pInst->dst, pInst->dst );
+                break;
+
+            case HSHR:
+                fprintf( fp,
+                         "    R[%d] = (int32_t)( ( (uint32_t)R[%d] & 0x%X )"
+                         " >> %d );\n",
+                         pInst->dst,
+                         pInst->dst,
+                         ( width == 1 ) ? 0xFF
+                            : ( width == 2 ) ? 0xFFFF : 0xFFFFFFFF,
+                         pInst->imm );
+                break;
+
+            default:
+                fprintf( fp, "    old = R[%d];\n", pInst->dst );
+                switch( opcode )
+                {
+                    case HADD:
+                        fprintf( fp,
+                                 "    val = (int32_t)( (uint32_t)old +"
+                                 " (uint32_t)%s );\n",
+                                 operand );
+                        break;
+
+                    case HSUB:
+                    case HCMP:
+                        fprintf( fp,
+                                 "    val = (int32_t)( (uint32_t)old -"
+                                 " (uint32_t)%s );\n",
+                                 operand );
+                        break;
+
+                    case HMUL:
+                        fprintf( fp,
+                                 "    val = (int32_t)( (uint32_t)old *"
+                                 " (uint32_t)%s );\n",
+                                 operand );
+                        break;
+
+                    case HDIV:
+                        fprintf( fp, "    val = old / %s;\n", operand );
+                        break;
+
+                    case HAND:
+                        fprintf( fp, "    val = old & %s;\n", operand );
+                        break;
+
+                    default:
+                        fprintf( fp, "    val = old | %s;\n", operand );
+                        break;
+                }
+
+                if( opcode != HCMP )
+                {
+                    fprintf( fp, "    R[%d] = val;\n", pInst->dst );
+                }
+
+                if( pInst->emitFlags )
+                {
+                    fprintf( fp, "    VMAOT_SETFLAGS( old, val );\n" );
+                }
+                break;
+        }
+    }
+
+    /* find the next instruction generated in this region */
+    for( addr = pInst->pc + 1; addr < end; addr++ )
+    {
+        if( pState->pFlags[addr] & AOT_INST )
+        {
+            break;
+        }
+    }
+
+    if( ( pInst->fallthrough ) && ( addr != pInst->next ) )
+    {
+        /* the next instruction is not part of this region */
+        fprintf( fp, "    VMAOT_EXIT( 0x%04X );\n", pInst->next );
+    }
+}
+
+/*============================================================================*/
+/*  aot_fnGenerateJump                                                        */
+/*!
+    Generate the C code for a jump
+
+    The aot_fnGenerateJump function writes a goto statement for a jump
+    to an instruction in the current region, otherwise it writes the code
+    to return to the VM core and continue at the jump target.  Jumps
+    inside the region are charged to the instruction budget, so a loop
+    in native code returns to the VM core when the budget has been used.
+
+    @param[in]
+        pState
+            pointer to the translation state
+
+    @param[in]
+        target
+            jump target address
+
+    @param[in]
+        start
+            start address of the region
+
+    @param[in]
+        end
+            end address of the region
+
+==============================================================================*/
+static void aot_fnGenerateJump( tzAOTState *pState,
+                                uint32_t target,
+                                uint32_t start,
+                                uint32_t end )
+{
+    if( ( target >= start ) &&
+        ( target < end ) &&
+        ( pState->pFlags[target] & AOT_INST ) &&
+        ( pState->pFlags[target] & AOT_ENTRY ) )
+    {
+        fprintf( pState->fp,
+                 "    VMAOT_PREEMPT( 0x%04X );\n"
+                 "    goto L_%04X;\n",
+                 target,
+                 target );
+    }
+    else
+    {
+        fprintf( pState->fp, "    VMAOT_EXIT( 0x%04X );\n", target );
+    }
+}
+
+/*============================================================================*/
+/*  aot_fnCompile                                                             */
+/*!
+    Compile the generated C code into a native module
+
+    The aot_fnCompile function compiles the generated C code into a
+    shared object using the system C compiler.  The compiler can be
+    changed using the CC environment variable.
+
+    @param[in]
+        sourceFile
+            name of the generated C file
+
+    @param[in]
+        outputFile
+            name of the native module to create
+
+    @param[in]
+        includeDir
+            additional include directory for the vmcore headers
+            (may be NULL)
+
+    @param[in]
+        verbose
+            true to display the compiler command
+
+    @retval EOK the native module was created
+    @retval EIO the compiler failed
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int aot_fnCompile( char *sourceFile,
+                          char *outputFile,
+                          char *includeDir,
+                          bool verbose )
+{
+    char *cc;
+    char *cmd;
+    size_t len;
+    int result = EIO;
+
+    cc = getenv( "CC" );
+    if( cc == NULL )
+    {
+        cc = DEFAULT_CC;
+    }
+
+    len = strlen( cc ) +
+          strlen( sourceFile ) +
+          strlen( outputFile ) +
+          ( ( includeDir != NULL ) ? strlen( includeDir ) : 0 ) +
+          64;
+
+    cmd = malloc( len );
+    if( cmd == NULL )
+    {
+        return ENOMEM;
+    }
+
+    snprintf( cmd,
+              len,
+              "%s -O2 -shared -fPIC%s%s -o %s %s",
+              cc,
+              ( includeDir != NULL ) ? " -I" : "",
+              ( includeDir != NULL ) ? includeDir : "",
+              outputFile,
+              sourceFile );
+
+    if( verbose )
+    {
+        printf( "%s\n", cmd );
+    }
+
+    if( system( cmd ) == 0 )
+    {
+        result = EOK;
+    }
+    else
+    {
+        fprintf( stderr, "Unable to compile %s\n", sourceFile );
+    }
+
+    free( cmd );
+
+    return result;
+}
+
+/*! @}
+ * end of vaot group */
@@ -53,6 +53,7 @@ SOFTWARE.
 #include <vmcore/core.h>
 #include <vmasm/asm.h>
 #include <vmasm/labels.h>
+#include <vmasm/imports.h>
 
 /*==============================================================================
         Private definitions
@@ -105,10 +106,13 @@ void main(int argc, char **argv)
     size_t stack_size = DEFAULT_STACK_SIZE;
     uint8_t *pMem;
     size_t prog_size;
+    size_t numImports;
+    char **ppImports;
     tzCore *pCore;
+    bool nativeEndian = false;
     int c;
 
-    while( ( c = getopt( argc, argv, "c:o:s:h" ) ) != -1 )
+    while( ( c = getopt( argc, argv, "c:o:s:hn" ) ) != -1 )
     {
         switch( c )
         {
@@ -124,6 +128,10 @@ void main(int argc, char **argv)
                 stack_size = atol( optarg );
                 break;
 
+            case 'n':
+                nativeEndian = true;
+                break;
+
             case 'h':
                 usage();
                 break;
@@ -148,15 +156,28 @@ void main(int argc, char **argv)
             /* get a pointer to the start of the VM memory core */
             pMem = CORE_fnMemory( pCore );
 
+            /* select the byte order of the binary image */
+            CORE_fnSetNativeEndian( pCore, nativeEndian );
+            if( nativeEndian != CORE_fnIsNativeEndian( pCore ) )
+            {
+                fprintf( stderr, "Native endian images are not supported\n" );
+                exit( 1 );
+            }
+
             /* assemble the assembly language program */
-            if( assemble_program( inputFile, pMem, &prog_size ) == EOK )
+            if( assemble_program( inputFile,
+                                  pMem,
+                                  &prog_size,
+                                  nativeEndian ) == EOK )
             {
 		        printf("assembly done\n");
 
                 /* link the labels */
-                if( LinkLabels( pMem, false, false ) >= 0 )
+                if( LinkLabels( pMem, nativeEndian, false, false ) >= 0 )
                 {
-                    /* output the program */
+                    /* output the program and its import table */
+                    ppImports = GetImports( &numImports );
+                    CORE_fnSetImports( pCore, ppImports, numImports );
                     CORE_fnSetProgramSize( pCore, prog_size );
                     CORE_fnSave( pCore, outputFile );
                 }
@@ -192,7 +213,7 @@ void main(int argc, char **argv)
 ==============================================================================*/
 void usage( void )
 {
-    printf("usage: vasm [-c core size] [-s stack size] [-h]"
+    printf("usage: vasm [-c core size] [-s stack size] [-h] [-n]"
            " [-o output filename] <assembly file>\n" );
     exit( 0 );
 }
@@ -0,0 +1,56 @@
+; "batch" program for the virtual machine.
+; sets and gets two external variables with a single MST and MGT
+    JMP G_O
+name1
+    DAT "/sys/test/a"
+name2
+    DAT "/sys/test/b"
+table               ; two entries of handle, type (0=int,1=float), value
+    DAT 0x7FFFFFFF
+    DAT 0x7FFFFFFF
+    DAT 0x7FFFFFFF
+    DAT 0x7FFFFFFF
+    DAT 0x7FFFFFFF
+    DAT 0x7FFFFFFF
+G_O
+    MOV R0, name1
+    EXT R0              ; R0 = handle of /sys/test/a
+    MOV R1, name2
+    EXT R1              ; R1 = handle of /sys/test/b
+    MOV R2, table
+    MOV R3, 0
+    STR R2, R0          ; table[0].handle = /sys/test/a
+    ADD R2, 4
+    STR R2, R3          ; table[0].type = integer
+    ADD R2, 4
+    MOV R4, 1234
+    STR R2, R4          ; table[0].value = 1234
+    ADD R2, 4
+    STR R2, R1          ; table[1].handle = /sys/test/b
+    ADD R2, 4
+    STR R2, R3          ; table[1].type = integer
+    ADD R2, 4
+    MOV R4, 42
+    STR R2, R4          ; table[1].value = 42
+    MOV R4, table
+    MOV R5, 2
+    MST R4, R5          ; set both variables
+    MOV R2, table
+    ADD R2, 8
+    STR R2, R3          ; clear table[0].value
+    ADD R2, 12
+    STR R2, R3          ; clear table[1].value
+    MOV R5, 2
+    MGT R4, R5          ; get both variables
+    WRN R5              ; output the result
+    WRC '\n'
+    MOV R2, table
+    ADD R2, 8
+    LOD R3, R2
+    WRN R3              ; output /sys/test/a
+    WRC '\n'
+    ADD R2, 12
+    LOD R3, R2
+    WRN R3              ; output /sys/test/b
+    WRC '\n'
+    HLT
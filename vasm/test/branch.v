@@ -0,0 +1,144 @@
+; "branch" program for the virtual machine.
+; compares registers with the fused BLT, BLE, BEQ and BNE instructions,
+; which branch without changing the flags.  Each comparison writes T if
+; the branch is taken and F if it is not, followed by a check that the
+; flags set by the last CMP are unchanged, and a backward branch loop.
+    MOV R3, 0
+    SUB R3, 3                   ; R3 = -3
+    MOV R4, 2
+    MOV.F R5, -1.5
+    MOV.F R6, 0.25
+    MOV R7, 1
+    CMP R7, 0                   ; clear the zero flag
+
+    ; integer relations, signed
+    BLT R3, R4, T1              ; -3 < 2: T
+    WRC 'F'
+    JMP N1
+T1
+    WRC 'T'
+N1
+    BLT R4, R3, T2              ; 2 < -3: F
+    WRC 'F'
+    JMP N2
+T2
+    WRC 'T'
+N2
+    BLT R4, R4, T3              ; 2 < 2: F
+    WRC 'F'
+    JMP N3
+T3
+    WRC 'T'
+N3
+    BLE R3, R4, T4              ; -3 <= 2: T
+    WRC 'F'
+    JMP N4
+T4
+    WRC 'T'
+N4
+    BLE R4, R4, T5              ; 2 <= 2: T
+    WRC 'F'
+    JMP N5
+T5
+    WRC 'T'
+N5
+    BLE R4, R3, T6              ; 2 <= -3: F
+    WRC 'F'
+    JMP N6
+T6
+    WRC 'T'
+N6
+    BEQ R3, R3, T7              ; -3 == -3: T
+    WRC 'F'
+    JMP N7
+T7
+    WRC 'T'
+N7
+    BEQ R3, R4, T8              ; -3 == 2: F
+    WRC 'F'
+    JMP N8
+T8
+    WRC 'T'
+N8
+    BNE R3, R4, T9              ; -3 != 2: T
+    WRC 'F'
+    JMP N9
+T9
+    WRC 'T'
+N9
+    BNE R4, R4, T10             ; 2 != 2: F
+    WRC 'F'
+    JMP N10
+T10
+    WRC 'T'
+N10
+
+    ; floating point relations
+    BLT.F R5, R6, T11           ; -1.5 < 0.25: T
+    WRC 'F'
+    JMP N11
+T11
+    WRC 'T'
+N11
+    BLT.F R6, R5, T12           ; 0.25 < -1.5: F
+    WRC 'F'
+    JMP N12
+T12
+    WRC 'T'
+N12
+    BLE.F R6, R6, T13           ; 0.25 <= 0.25: T
+    WRC 'F'
+    JMP N13
+T13
+    WRC 'T'
+N13
+    BLE.F R6, R5, T14           ; 0.25 <= -1.5: F
+    WRC 'F'
+    JMP N14
+T14
+    WRC 'T'
+N14
+    BEQ.F R5, R5, T15           ; -1.5 == -1.5: T
+    WRC 'F'
+    JMP N15
+T15
+    WRC 'T'
+N15
+    BEQ.F R5, R6, T16           ; -1.5 == 0.25: F
+    WRC 'F'
+    JMP N16
+T16
+    WRC 'T'
+N16
+    BNE.F R5, R6, T17           ; -1.5 != 0.25: T
+    WRC 'F'
+    JMP N17
+T17
+    WRC 'T'
+N17
+    BNE.F R6, R6, T18           ; 0.25 != 0.25: F
+    WRC 'F'
+    JMP N18
+T18
+    WRC 'T'
+N18
+    WRC '\n'
+
+    ; the flags still hold the result of CMP R7, 0
+    JNZ FLAGS
+    WRC 'F'
+    JMP LOOP
+FLAGS
+    WRC 'T'
+
+    ; count to 5 with a backward branch
+LOOP
+    MOV R8, 0
+    MOV R9, 5
+AGAIN
+    ADD R8, 1
+    BNE R8, R9, AGAIN
+    WRC ' '
+    WRN R8
+    WRC '\n'
+    HLT
@@ -0,0 +1,58 @@
+#!/bin/sh
+
+# Run the sample programs under each of the vexe execution engines and
+# check that they all produce the same output and exit status.
+#
+# usage: ./engines.sh [program.v ...]
+#
+# The VASM, VAOT and VEXE environment variables select the tools to use.
+# The native engine is skipped for a program which vaot cannot translate.
+
+VASM=${VASM:-vasm}
+VAOT=${VAOT:-vaot}
+VEXE=${VEXE:-vexe}
+
+# deterministic programs which need no input, VarServer, or timers
+programs=${*:-"branch.v engines.v extstore.v fact.v hw.v index.v local.v
+rot.v stringmod.v test2.v test4.v testf.v"}
+
+mkdir -p build/engines
+failed=0
+
+for file in $programs
+do
+    name=`basename $file .v`
+    image=build/engines/$name.bin
+    rm -f $image $image.so
+
+    $VASM $file -o $image > /dev/null
+    if [ ! -f $image ]
+    then
+        echo "$name: assembly failed"
+        failed=1
+        continue
+    fi
+
+    engines="decoded threaded jit"
+    if $VAOT $image > /dev/null 2>&1
+    then
+        engines="$engines native"
+    fi
+
+    for engine in $engines
+    do
+        $VEXE -X $engine $image < /dev/null > build/engines/$name.$engine 2>&1
+        echo "exit status $?" >> build/engines/$name.$engine
+
+        if ! cmp -s build/engines/$name.decoded build/engines/$name.$engine
+        then
+            echo "$name: $engine engine differs from decoded engine"
+            diff build/engines/$name.decoded build/engines/$name.$engine
+            failed=1
+        fi
+    done
+
+    echo "$name: $engines"
+done
+
+exit $failed
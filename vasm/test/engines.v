@@ -0,0 +1,107 @@
+; "engines" program for the virtual machine.
+; exercises the arithmetic, flag, stack and call instructions which the
+; execution engines implement separately, so that engines.sh can compare
+; the output of the decoded, threaded, jit and native engines.  The result
+; of the program is the exit status of vexe.
+    ; negative and zero flags from ADD, SUB and CMP
+    MOV R3, 5
+    SUB R3, 7
+    JPO PO1
+    WRC 'N'
+PO1
+    WRN R3                      ; -2
+    WRC ' '
+    ADD R3, 2
+    JNZ NZ1
+    WRC 'Z'
+NZ1
+    WRN R3                      ; 0
+    WRC ' '
+    CMP R3, 1
+    JPO PO2
+    WRC 'N'
+PO2
+    WRC '\n'
+
+    ; bitwise operations and shifts
+    MOV R4, 0x0F0F
+    NOT R4
+    AND R4, 0x7F7F              ; 0x7070 = 28784
+    WRN R4
+    WRC ' '
+    OR R4, 0x0F                 ; 0x707F = 28799
+    MUL R4, 16                  ; 0x707F0 = 460784
+    WRN R4
+    WRC ' '
+    SHR R4, 8                   ; 0x707 = 1799
+    WRN R4
+    WRC '\n'
+
+    ; signed multiplication and division
+    MOV R5, -7
+    MUL R5, 6                   ; -42
+    WRN R5
+    WRC ' '
+    DIV R5, 4                   ; -10
+    WRN R5
+    WRC ' '
+    MOV R6, 3
+    MUL R5, R6                  ; -30
+    WRN R5
+    WRC '\n'
+
+    ; floating point and conversions
+    MOV.F R7, 2.5
+    MUL.F R7, 3.0               ; 7.5
+    WRF R7
+    WRC ' '
+    TOI R7                      ; 7
+    WRN R7
+    WRC ' '
+    TOF R7
+    DIV.F R7, 2.0               ; 3.5
+    WRF R7
+    WRC '\n'
+
+    ; recursive calls with arguments passed on the stack
+    MOV R8, 0
+    MOV R3, 1
+LOOP
+    PSH R3
+    CAL FIB
+    POP R3
+    ADD R8, R0
+    WRN R0
+    WRC ' '
+    ADD R3, 1
+    CMP R3, 13
+    JNZ LOOP
+    WRN R8                      ; fib(1) + ... + fib(12) = 376
+    WRC '\n'
+    MOV R0, R8
+    HLT
+
+; FIB computes fib(n) in R0 where n is pushed before the call
+FIB
+    MOV R2, SP
+    ADD R2, 4
+    LOD R9, R2                  ; n
+    CMP R9, 3
+    JNE FIB1
+    PSH R9
+    SUB R9, 1
+    PSH R9
+    CAL FIB
+    POP R9
+    PSH R0
+    SUB R9, 1
+    PSH R9
+    CAL FIB
+    POP R9
+    POP R10
+    ADD R0, R10
+    POP R9
+    RET
+FIB1
+    MOV R0, 1
+    RET
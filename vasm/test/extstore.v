@@ -0,0 +1,64 @@
+; "extstore" program for the virtual machine.
+; creates 100 external variables in the built-in extern store, which
+; grows its handle and name indexes several times, then finds each of
+; them again by name and reads it back by handle.  It prints the number
+; of variables whose handle changed (0) and the sum of their values
+; (7 * 4950 = 34650).  Run it without an externals library.
+    JMP G_O
+name                ; variable name, with the number at offsets 7 and 8
+    DAT "/test/v00"
+G_O
+    MOV R8, table
+    MOV R3, 0
+CREATE
+    CAL MKNAME
+    MOV R7, name
+    EXT R7                      ; create the variable
+    STR.L [R8+R3*4+0], R7       ; remember its handle
+    MOV R12, R3
+    MUL R12, 7
+    SET R7, R12                 ; variable n = 7 * n
+    ADD R3, 1
+    MOV R12, 100
+    BLT R3, R12, CREATE
+
+    MOV R3, 0
+    MOV R10, 0
+    MOV R11, 0
+FIND
+    CAL MKNAME
+    MOV R7, name
+    EXT R7                      ; find the variable by name
+    LOD.L R12, [R8+R3*4+0]
+    BEQ R7, R12, SAME
+    ADD R10, 1                  ; count the handles which changed
+SAME
+    GET R13, R7                 ; read the variable by handle
+    ADD R11, R13
+    ADD R3, 1
+    MOV R12, 100
+    BLT R3, R12, FIND
+
+    WRN R10
+    WRC '\n'
+    WRN R11
+    WRC '\n'
+    HLT
+
+; write the two digit number in R3 into the variable name
+MKNAME
+    MOV R5, R3
+    DIV R5, 10                  ; tens
+    MOV R6, R5
+    MUL R6, 10
+    MOV R12, R3
+    SUB R12, R6                 ; ones
+    ADD R5, 48
+    ADD R12, 48
+    MOV R9, name
+    STR.B [R9+7], R5
+    STR.B [R9+8], R12
+    RET
+
+table               ; handle of each variable, up to the end of the core
+    DAT 0x7FFFFFFF
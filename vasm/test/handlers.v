@@ -0,0 +1,47 @@
+; "handlers" program for the virtual machine.
+; each timer has its own signal handler, which is called by DSP
+    JMP G_O
+notice
+    DAT "Handler test\n"
+tick1
+    DAT "Timer 1 handler\n"
+tick2
+    DAT "Timer 2 handler: "
+G_O
+    MOV R6,0            ; R6 = timer 2 count
+    MOV R7,10           ; set counter to 10
+    MOV R0, notice      ; set up welcome message
+    WRS R0              ; output welcome message
+    MOV R3,39           ; R3 = timer signal number (SIGRTMIN+5)
+    MOV R4,1            ; R4 = timer 1
+    MOV R5,timer1       ; R5 = timer 1 handler
+    VEC R3,R4,R5        ; set the timer 1 handler
+    MOV R4,2            ; R4 = timer 2
+    MOV R5,timer2       ; R5 = timer 2 handler
+    VEC R3,R4,R5        ; set the timer 2 handler
+    MOV R0,2000         ; R0 = timer delay 2000 ms
+    MOV R1,1            ; R1 = timer 1
+    STM R1,R0           ; Start timer 1 with 2000ms timeout
+    MOV R0,500          ; R0 = timer delay 500 ms
+    MOV R1,2            ; R1 = timer 2
+    STM R1,R0           ; Start timer 2 with 500 ms timeout
+LOOP
+    DSP R3, R4          ; wait for a signal and call its handler
+    CMP R6,R7           ; compare R6 and R7
+    JNZ LOOP            ; if R6 <> R7 jump back to top
+    MOV R4, 2           ; R4 = 2
+    CTM R4              ; cancel timer 2
+    MOV R4, 1           ; R4 = 1
+    CTM R4              ; cancel timer 1
+    HLT                 ; terminate program
+timer1
+    MOV R0, tick1       ; point to timer 1 message
+    WRS R0              ; output timer 1 message
+    RET                 ; return to DSP
+timer2
+    MOV R0, tick2       ; point to timer 2 message
+    WRS R0              ; output timer 2 message
+    ADD R6,1            ; R6 = R6 + 1
+    WRN R6              ; output timer 2 count
+    WRC '\n'            ; output newline
+    RET                 ; return to DSP
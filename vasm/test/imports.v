@@ -0,0 +1,17 @@
+; "imports" program for the virtual machine.
+; gets external variable handles from the program import table, which
+; is resolved once when the program is loaded
+    IMP R0, "/sys/test/a"   ; R0 = handle of /sys/test/a
+    IMP R1, "/sys/test/b"   ; R1 = handle of /sys/test/b
+    IMP R2, "/sys/test/a"   ; the same import slot as the first IMP
+    MOV R3, 10
+    SET R0, R3              ; /sys/test/a = 10
+    MOV R3, 20
+    SET R1, R3              ; /sys/test/b = 20
+    GET R4, R2
+    WRN R4                  ; 10
+    WRC '\n'
+    GET R4, R1
+    WRN R4                  ; 20
+    WRC '\n'
+    HLT
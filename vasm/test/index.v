@@ -0,0 +1,87 @@
+; "index" program for the virtual machine.
+; loads and stores bytes, words and longs with the indexed addressing
+; modes, using R2 as the base and as the index register, and with 8-bit,
+; 16-bit and 32-bit displacements.  The indexed forms leave the effective
+; address in R2, so R2 is set up again before each access.
+    JMP G_O
+data                ; 16 bytes of test data
+    DAT 0x11223344
+    DAT 0x55667788
+    DAT 0x01234567
+    DAT 0x76543210
+scratch             ; store target
+    DAT 0x7FFFFFFF
+G_O
+    MOV R4, 2
+
+    ; R2 is the base register, with an 8-bit displacement
+    MOV R2, data
+    MOV R3, 0
+    LOD.B R3, [R2+R4*1+8]       ; 0x45 = 69
+    WRN R3
+    WRC '\n'
+    MOV R2, data
+    MOV R3, 0
+    LOD.W R3, [R2+R4*1+8]       ; 0x4567 = 17767
+    WRN R3
+    WRC '\n'
+    MOV R2, data
+    LOD.L R3, [R2+R4*2+8]       ; 0x76543210 = 1985229328
+    WRN R3
+    WRC '\n'
+
+    ; R2 is the index register, with a 16-bit displacement
+    MOV R5, data
+    SUB R5, 1000
+    MOV R2, 1
+    MOV R3, 0
+    LOD.B R3, [R5+R2*4+1001]    ; 0x66 = 102
+    WRN R3
+    WRC '\n'
+    MOV R2, 1
+    MOV R3, 0
+    LOD.W R3, [R5+R2*4+1002]    ; 0x7788 = 30600
+    WRN R3
+    WRC '\n'
+    MOV R2, 1
+    LOD.L R3, [R5+R2*4+1000]    ; 0x55667788 = 1432778632
+    WRN R3
+    WRC '\n'
+
+    ; R2 is the base register, with a 32-bit displacement
+    MOV R2, data
+    SUB R2, 100000
+    MOV R3, 0
+    LOD.B R3, [R2+R4*1+100000]  ; 0x33 = 51
+    WRN R3
+    WRC '\n'
+    MOV R2, data
+    SUB R2, 100000
+    MOV R3, 0
+    LOD.W R3, [R2+R4*1+100000]  ; 0x3344 = 13124
+    WRN R3
+    WRC '\n'
+    MOV R2, data
+    SUB R2, 100000
+    LOD.L R3, [R2+R4*2+100000]  ; 0x55667788 = 1432778632
+    WRN R3
+    WRC '\n'
+
+    ; stores with R2 as the base and as the index register
+    MOV R6, 0x41424344
+    MOV R2, scratch
+    STR.B [R2+0], R6            ; 44 FF FF FF
+    MOV R5, scratch
+    MOV R2, 1
+    STR.W [R5+R2*1+1], R6       ; 44 FF 43 44
+    MOV R5, scratch
+    LOD R3, R5
+    WRN R3                      ; 0x44FF4344 = 1157579588
+    WRC '\n'
+    MOV R2, scratch
+    SUB R2, 100000
+    STR.L [R2+100000], R6       ; 41 42 43 44
+    LOD R3, R5
+    WRN R3                      ; 0x41424344 = 1094861636
+    WRC '\n'
+    HLT
@@ -0,0 +1,46 @@
+; "local" program for the virtual machine.
+; loads and stores local variables relative to the frame pointer R1 with
+; the LDL and STL instructions, using positive and negative 8-bit and
+; 16-bit displacements.  LDL and STL leave the address of the local
+; variable in R2.
+    JMP G_O
+data                ; 8 bytes of test data
+    DAT 0x11223344
+    DAT 0x55667788
+G_O
+    ; 8-bit displacements
+    MOV R1, data
+    LDL R3, 4                   ; 0x55667788 = 1432778632
+    WRN R3
+    WRC '\n'
+    MOV R6, R2
+    SUB R6, R1
+    WRN R6                      ; R2 = R1 + 4
+    WRC '\n'
+    ADD R1, 8
+    LDL R3, -8                  ; 0x11223344 = 287454020
+    WRN R3
+    WRC '\n'
+    MOV R7, 42
+    STL R7, -4                  ; replaces 0x55667788
+    MOV R1, data
+    LDL R3, 4                   ; 42
+    WRN R3
+    WRC '\n'
+
+    ; 16-bit displacements
+    MOV R1, data
+    ADD R1, 1000
+    LDL R3, -1000               ; 0x11223344 = 287454020
+    WRN R3
+    WRC '\n'
+    STL R3, 2000                ; store past the end of the program
+    MOV R5, 0
+    LDL R5, 2000                ; 287454020
+    WRN R5
+    WRC '\n'
+    MOV R6, R2
+    SUB R6, R1
+    WRN R6                      ; R2 = R1 + 2000
+    WRC '\n'
+    HLT
@@ -63,6 +63,11 @@ SOFTWARE.
 /*! Default stack size for the VM core */
 #define DEFAULT_STACK_SIZE ( 4096 )
 
+#ifndef EOK
+/*! success response */
+#define EOK ( 0 )
+#endif
+
 /*==============================================================================
         Public function declarations
 ==============================================================================*/
@@ -72,6 +77,7 @@ int main( int argc, char **argv );
         Private function declarations
 ==============================================================================*/
 void usage( void );
+int loadNative( tzCore *pCore, char *inputFile, bool required, bool verbose );
 
 /*==============================================================================
         Function definitions
@@ -103,12 +109,16 @@ int main(int argc, char **argv)
     size_t core_size = DEFAULT_CORE_SIZE;
     size_t stack_size = DEFAULT_STACK_SIZE;
     char *externalsLib = NULL;
+    teCoreEngine engine = eCORE_ENGINE_DECODED;
+    bool engineSelected = false;
     bool verbose = false;
+    bool verify = true;
+    bool externCache = false;
     tzCore *pCore;
     int result = -1;
     int c;
 
-    while( ( c = getopt( argc, argv, "L:c:s:hv" ) ) != -1 )
+    while( ( c = getopt( argc, argv, "L:c:s:X:Chuv" ) ) != -1 )
     {
         switch( c )
         {
@@ -124,10 +134,43 @@ int main(int argc, char **argv)
                 verbose = true;
                 break;
 
+            case 'u':
+                verify = false;
+                break;
+
+            case 'C':
+                externCache = true;
+                break;
+
             case 'L':
                 externalsLib = optarg;
                 break;
 
+            case 'X':
+                if( strcmp( optarg, "threaded" ) == 0 )
+                {
+                    engine = eCORE_ENGINE_THREADED;
+                }
+                else if( strcmp( optarg, "decoded" ) == 0 )
+                {
+                    engine = eCORE_ENGINE_DECODED;
+                }
+                else if( strcmp( optarg, "jit" ) == 0 )
+                {
+                    engine = eCORE_ENGINE_JIT;
+                }
+                else if( strcmp( optarg, "native" ) == 0 )
+                {
+                    engine = eCORE_ENGINE_NATIVE;
+                }
+                else
+                {
+                    fprintf( stderr, "Invalid execution engine: %s\n", optarg );
+                    usage();
+                }
+                engineSelected = true;
+                break;
+
             case 'h':
                 usage();
                 break;
@@ -145,17 +188,58 @@ int main(int argc, char **argv)
         pCore = CORE_fnCreate( core_size, stack_size );
         if( pCore != NULL )
         {
+            /* select the execution engine.  The native engine is
+               selected once the program has been loaded */
+            if( ( engine != eCORE_ENGINE_NATIVE ) &&
+                ( CORE_fnSetEngine( pCore, engine ) != EOK ) )
+            {
+                fprintf( stderr, "Execution engine not supported\n" );
+                exit( 1 );
+            }
+
             /* initialize the externals library */
             CORE_fnInitExternalsLib( pCore, externalsLib );
 
+            if( ( externCache == true ) &&
+                ( CORE_fnEnableExternCache( pCore ) != EOK ) )
+            {
+                fprintf( stderr, "Unable to enable extern cache\n" );
+            }
+
             if( verbose == true )
             {
                 fprintf( stdout, "Loading program: %s\n", inputFile );
             }
 
-            /* load the program */
-            if( CORE_fnLoad( pCore, inputFile ) == true )
+            /* load and verify the program */
+            if( CORE_fnLoad( pCore, inputFile ) == false )
+            {
+                fprintf( stderr, "Program load failed: %s\n", inputFile );
+            }
+            else if( ( verify == true ) &&
+                     ( CORE_fnVerify( pCore ) != EOK ) )
+            {
+                fprintf( stderr,
+                         "Program verification failed: %s\n",
+                         inputFile );
+            }
+            else
             {
+                if( ( engine == eCORE_ENGINE_NATIVE ) ||
+                    ( engineSelected == false ) )
+                {
+                    /* use the native module next to the binary image */
+                    if( ( loadNative( pCore,
+                                      inputFile,
+                                      engineSelected,
+                                      verbose ) != EOK ) &&
+                        ( engineSelected == true ) )
+                    {
+                        fprintf( stderr, "Native module not available\n" );
+                        exit( 1 );
+                    }
+                }
+
                 /* execute the program */
                 result = CORE_fnExecute( pCore );
                 if( result != -1 )
@@ -165,6 +249,8 @@ int main(int argc, char **argv)
                         fprintf( stdout,
                                  "Executing program %s\n",
                                  inputFile );
+
+                        CORE_fnDumpExternCache( pCore, stdout );
                     }
                 }
                 else
@@ -172,13 +258,12 @@ int main(int argc, char **argv)
                     fprintf( stderr, "Execution failed: %s\n", inputFile );
                 }
             }
-            else
-            {
-                fprintf( stderr, "Program load failed: %s\n", inputFile );
-            }
 
             /* shut down the externals library */
             CORE_fnShutdownExternalsLib( pCore );
+
+            /* release the VM core */
+            CORE_fnDestroy( pCore );
         }
         else
         {
@@ -204,10 +289,81 @@ int main(int argc, char **argv)
 ==============================================================================*/
 void usage( void )
 {
-    printf( "usage: vexe [-c core size] [-s stack size] [-h] [-v] "
-            " [-L externals lib name] <binary image>\n" );
+    printf( "usage: vexe [-c core size] [-s stack size] [-h] [-u] [-v] [-C]"
+            " [-L externals lib name] [-X decoded|threaded|jit|native]"
+            " <binary image>\n" );
     exit( 0 );
 }
 
+/*============================================================================*/
+/*  loadNative                                                                */
+/*!
+    Load the native module for a binary image
+
+    The loadNative function loads the native module generated by vaot
+    for the binary image (the binary image name with a .so suffix),
+    and selects the native execution engine.
+
+    @param[in]
+        pCore
+            pointer to the VM core containing the loaded binary image
+
+    @param[in]
+        inputFile
+            name of the binary image
+
+    @param[in]
+        required
+            true if the native module must exist
+
+    @param[in]
+        verbose
+            true to report when the native module is used
+
+    @retval EOK the native execution engine was selected
+    @retval ENOENT the native module does not exist
+    @retval ENOMEM memory allocation failure
+    @retval other the native module could not be loaded
+
+==============================================================================*/
+int loadNative( tzCore *pCore, char *inputFile, bool required, bool verbose )
+{
+    char *filename;
+    size_t len;
+    int result = ENOENT;
+
+    len = strlen( inputFile ) + 6;
+    filename = malloc( len );
+    if( filename == NULL )
+    {
+        return ENOMEM;
+    }
+
+    /* dlopen only searches the library path for names without a '/' */
+    snprintf( filename,
+              len,
+              "%s%s.so",
+              ( strchr( inputFile, '/' ) == NULL ) ? "./" : "",
+              inputFile );
+
+    if( ( required == true ) || ( access( filename, F_OK ) == 0 ) )
+    {
+        result = CORE_fnLoadNative( pCore, filename );
+        if( result == EOK )
+        {
+            result = CORE_fnSetEngine( pCore, eCORE_ENGINE_NATIVE );
+        }
+
+        if( ( result == EOK ) && ( verbose == true ) )
+        {
+            fprintf( stdout, "Using native module: %s\n", filename );
+        }
+    }
+
+    free( filename );
+
+    return result;
+}
+
 /*! @}
  * end of vexe group */
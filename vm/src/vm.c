@@ -35,6 +35,7 @@ SOFTWARE.
 #include <vmcore/core.h>
 #include <vmasm/asm.h>
 #include <vmasm/labels.h>
+#include <vmasm/imports.h>
 
 /*! default virtual machine core memory size */
 #define DEFAULT_CORE_SIZE   65536
@@ -82,6 +83,8 @@ int main(int argC, char *argV[])
     int c;
     tzVMState vmstate;
     size_t prog_size;
+    size_t numImports;
+    char **ppImports;
     int result = 0;
 
     /* flag for post-mortem dump */
@@ -117,10 +120,13 @@ int main(int argC, char *argV[])
     /* pointer to the externals library */
     char *externalsLib = NULL;
 
+    /* execution engine */
+    teCoreEngine engine = eCORE_ENGINE_DECODED;
+
     /* pointer to the VM parser state */
     tzVMState *pVM = &vmstate;
 
-    while( ( c = getopt( argC, argV, "haplrvo:eds:c:L:" ) ) != -1 )
+    while( ( c = getopt( argC, argV, "haplrvo:eds:c:L:X:" ) ) != -1 )
     {
         switch( c )
         {
@@ -167,13 +173,30 @@ int main(int argC, char *argV[])
                 externalsLib = optarg;
                 break;
 
+            case 'X':
+                if( strcmp( optarg, "threaded" ) == 0 )
+                {
+                    engine = eCORE_ENGINE_THREADED;
+                }
+                else if( strcmp( optarg, "jit" ) == 0 )
+                {
+                    engine = eCORE_ENGINE_JIT;
+                }
+                else if( strcmp( optarg, "decoded" ) != 0 )
+                {
+                    fprintf(stderr, "Invalid execution engine: %s\n", optarg);
+                    return -1;
+                }
+                break;
+
             case 'h':
                 fprintf(stderr,
                         "usage: %s [-a] [-e] [-p] [-l] [-r] [-v]"
                         " [-L <external variable handler library]"
                         " [-c <core size (bytes)>]"
                         " [-s <stack size (longwords)>]"
-                        " [-o <output file>] <input file>\n\n"
+                        " [-o <output file>]"
+                        " [-X decoded|threaded|jit] <input file>\n\n"
                         " -a : assemble input file\n"
                         " -e : execute input file\n"
                         " -p : enable postmortem core dump\n"
@@ -183,7 +206,8 @@ int main(int argC, char *argV[])
                         " -L : specify exernvars library\n"
                         " -c : set core size\n"
                         " -s : set stack size\n"
-                        " -o : write out program memory\n",
+                        " -o : write out program memory\n"
+                        " -X : select the execution engine\n",
                         argV[0]);
                 return -1;
 
@@ -234,15 +258,27 @@ int main(int argC, char *argV[])
 
         if( assemble_program( filename,
                               pVM->memory,
-                              &prog_size ) == EOK )
+                              &prog_size,
+                              CORE_fnIsNativeEndian( pCore ) ) == EOK )
         {
-            /* set the program size in the core */
-            CORE_fnSetProgramSize( pCore, prog_size );
-
-            if (LinkLabels(pVM->memory, verbose, showLabels) < 0)
+            if (LinkLabels( pVM->memory,
+                            CORE_fnIsNativeEndian( pCore ),
+                            verbose,
+                            showLabels ) < 0)
             {
                 fprintf(stderr, "Error linking: %s\n", filename );
             }
+
+            /* resolve the imported external variables */
+            ppImports = GetImports( &numImports );
+            if( CORE_fnSetImports( pCore, ppImports, numImports ) != EOK )
+            {
+                fprintf(stderr, "Error importing: %s\n", filename );
+                return -1;
+            }
+
+            /* set the program size in the core once it has been linked */
+            CORE_fnSetProgramSize( pCore, prog_size );
         }
         else
         {
@@ -296,6 +332,12 @@ int main(int argC, char *argV[])
             fprintf(stdout, "Executing binary image\n");
         }
 
+        if( CORE_fnSetEngine( pCore, engine ) != EOK )
+        {
+            fprintf(stderr, "Execution engine not supported\n");
+            return -1;
+        }
+
         result = CORE_fnExecute( pCore );
         if ( result != -1 )
         {
@@ -330,6 +372,9 @@ int main(int argC, char *argV[])
     /* shutdown the "extern" library */
     CORE_fnShutdownExternalsLib( pCore );
 
+    /* release the VM core */
+    CORE_fnDestroy( pCore );
+
     return result;
 }
 
@@ -0,0 +1,1626 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @defgroup vmd vmd
+ * @brief Virtual Machine Host Daemon
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file vmd.c
+
+    Virtual Machine Host Daemon
+
+    The vmd Application hosts many virtual machine programs in a single
+    process.  Each binary image is loaded into its own VM core, and the
+    VM cores are run as tasks on a fixed pool of worker threads, one
+    per CPU by default.
+
+    Ready programs are run round-robin in order of their priority.  Each
+    program runs for an instruction budget scaled by its weight before it
+    is preempted, so a program which never waits cannot occupy a worker
+    thread forever.
+
+    Programs waiting in a DLY or WFS instruction are suspended, and do
+    not occupy a worker thread.  A single event thread waits in epoll for
+    the delay timer of the host and the event file descriptor of each
+    waiting VM core, and returns each program to the run queue when its
+    delay expires or its timer or notification is received.
+
+    The external variable notification signals are received by the
+    event thread with a single signalfd for the whole process.  Each VM
+    core reports the notifications it requests to the host, and the
+    event thread posts each received notification to the VM cores
+    which requested it.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <vmcore/core.h>
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! Default core size for each VM core */
+#define DEFAULT_CORE_SIZE ( 65536 )
+
+/*! Default stack size for each VM core */
+#define DEFAULT_STACK_SIZE ( 4096 )
+
+/*! Default instruction budget for each program before it is preempted */
+#define DEFAULT_QUANTUM ( 10000 )
+
+/*! Number of program priority levels */
+#define VMD_NUM_PRIORITIES ( 8 )
+
+/*! Maximum number of events handled per wakeup of the event thread */
+#define VMD_MAX_EVENTS ( 64 )
+
+/*! Maximum number of notification signals read by one read */
+#define VMD_READ_BATCH ( 32 )
+
+/*! Initial number of entries in the notification route table */
+#define VMD_MIN_ROUTES ( 64 )
+
+/*! MODIFIED notification signal, the first of the notification signals */
+#define VMD_SIG_MODIFIED ( SIGRTMIN+6 )
+
+/*! CALC notification signal */
+#define VMD_SIG_CALC ( SIGRTMIN+7 )
+
+/*! PRINT notification signal, the last of the notification signals */
+#define VMD_SIG_PRINT ( SIGRTMIN+9 )
+
+#ifndef EOK
+/*! success response */
+#define EOK ( 0 )
+#endif
+
+/*! the tzVMTask object is a VM core hosted by the daemon */
+typedef struct zVMTask
+{
+    /*! name of the binary image loaded into the VM core */
+    char *filename;
+
+    /*! VM core running the binary image */
+    tzCore *pCore;
+
+    /*! scheduling priority [0 .. VMD_NUM_PRIORITIES-1], highest last */
+    int priority;
+
+    /*! number of quanta the program runs for before it is preempted */
+    uint32_t weight;
+
+    /*! value of register R0 when the program stopped, or -1 on failure */
+    int result;
+
+    /*! set once the program has started running */
+    bool started;
+
+    /*! set once the VM core event fd is registered with the host */
+    bool registered;
+
+    /*! time when the delay of a suspended DLY instruction expires */
+    struct timespec deadline;
+
+    /*! pointer to the next task in the run queue or delay queue */
+    struct zVMTask *pNext;
+
+    /*! pointer to the VM host running the task */
+    struct zVMHost *pHost;
+} tzVMTask;
+
+/*! the tzVMRoute object delivers a notification signal to a VM task
+    which requested it */
+typedef struct zVMRoute
+{
+    /*! notification signal number, or 0 for an unused entry */
+    int signum;
+
+    /*! variable handle, or 0 for the VALIDATE and PRINT notifications
+        whose signal id is a session id */
+    uint32_t id;
+
+    /*! VM task which requested the notification */
+    tzVMTask *pTask;
+} tzVMRoute;
+
+/*! the tzVMHost object is the state shared by the worker threads */
+typedef struct zVMHost
+{
+    /*! mutex protecting the run queue and task counts */
+    pthread_mutex_t lock;
+
+    /*! signalled when a task is queued or the host is shutting down */
+    pthread_cond_t ready;
+
+    /*! signalled when a task completes */
+    pthread_cond_t done;
+
+    /*! first task in the run queue of each priority */
+    tzVMTask *pHead[VMD_NUM_PRIORITIES];
+
+    /*! last task in the run queue of each priority */
+    tzVMTask *pTail[VMD_NUM_PRIORITIES];
+
+    /*! instruction budget of one quantum, or 0 to disable preemption */
+    uint32_t quantum;
+
+    /*! tasks suspended in DLY, in order of their deadline */
+    tzVMTask *pDelayed;
+
+    /*! epoll instance of the event thread */
+    int epfd;
+
+    /*! timerfd which expires at the deadline of the first delayed task */
+    int timerfd;
+
+    /*! notification signals blocked in every thread */
+    sigset_t sigmask;
+
+    /*! signalfd of the event thread receiving the notification signals */
+    int sigfd;
+
+    /*! mutex protecting the notification route table */
+    pthread_mutex_t routeLock;
+
+    /*! open addressed hash table of the notification routes */
+    tzVMRoute *pRoutes;
+
+    /*! number of entries in the notification route table */
+    size_t numRoutes;
+
+    /*! number of used entries in the notification route table */
+    size_t usedRoutes;
+
+    /*! number of tasks which have not completed */
+    size_t pending;
+
+    /*! set to stop the worker threads */
+    bool shutdown;
+
+    /*! set to report task progress */
+    bool verbose;
+
+    /*! set to report the extern cache counters of each task */
+    bool externCache;
+
+    /*! number of worker threads */
+    long numWorkers;
+
+    /*! number of threads started by the host */
+    long numThreads;
+
+    /*! identifiers of the event thread and worker threads */
+    pthread_t *threads;
+} tzVMHost;
+
+/*! the tzVMOptions object holds the command line options */
+typedef struct zVMOptions
+{
+    /*! size of each VM core in bytes */
+    size_t core_size;
+
+    /*! size of each VM stack in bytes */
+    size_t stack_size;
+
+    /*! name of the external variables library */
+    char *externalsLib;
+
+    /*! execution engine used by each VM core */
+    teCoreEngine engine;
+
+    /*! set to verify each binary image before it is run */
+    bool verify;
+
+    /*! set to report task progress */
+    bool verbose;
+
+    /*! set to enable the extern read-through cache of each VM core */
+    bool externCache;
+
+    /*! number of worker threads, or 0 for one per CPU */
+    long numWorkers;
+
+    /*! instruction budget of one quantum, or 0 to disable preemption */
+    uint32_t quantum;
+} tzVMOptions;
+
+/*==============================================================================
+        Public function declarations
+==============================================================================*/
+int main( int argc, char **argv );
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+void usage( void );
+static int ProcessOptions( int argc, char **argv, tzVMOptions *pOptions );
+static tzVMTask *CreateTask( tzVMHost *pHost,
+                             tzVMOptions *pOptions,
+                             char *spec );
+static void DestroyTask( tzVMTask *pTask );
+static void EnqueueTask( tzVMHost *pHost, tzVMTask *pTask );
+static tzVMTask *DequeueTask( tzVMHost *pHost );
+static void DelayTask( tzVMHost *pHost, tzVMTask *pTask );
+static void WaitTask( tzVMHost *pHost, tzVMTask *pTask );
+static void CompleteTask( tzVMHost *pHost, tzVMTask *pTask );
+static void *Worker( void *arg );
+static void *EventThread( void *arg );
+static void ResumeDelayed( tzVMHost *pHost );
+static void ArmTimer( tzVMHost *pHost );
+static int StartWorkers( tzVMHost *pHost );
+static void StopWorkers( tzVMHost *pHost );
+static void BlockSignals( tzVMHost *pHost );
+static void RouteSignal( void *pArg, tzCore *pCore, int signum, uint32_t id );
+static int AddRoute( tzVMHost *pHost,
+                     int signum,
+                     uint32_t id,
+                     tzVMTask *pTask );
+static int GrowRoutes( tzVMHost *pHost );
+static size_t HashRoute( int signum, uint32_t id, size_t numRoutes );
+static void ReadSignals( tzVMHost *pHost );
+static void DeliverSignal( tzVMHost *pHost, int signum, int id );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  main                                                                      */
+/*!
+    Main entry point for the vmd application
+
+    The main function loads each binary image specified on the command
+    line into its own VM core, runs the VM cores on the worker thread
+    pool, and waits for all of them to complete.
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @retval 0 all programs ran to completion
+    @retval 1 one or more programs could not be loaded or failed
+
+==============================================================================*/
+int main(int argc, char **argv)
+{
+    tzVMOptions options;
+    tzVMHost host;
+    tzVMTask **tasks;
+    size_t numTasks;
+    size_t i;
+    int result = 1;
+
+    ProcessOptions( argc, argv, &options );
+
+    numTasks = argc - optind;
+    if( numTasks == 0 )
+    {
+        fprintf( stderr, "No execution binary specified\n" );
+        exit( 1 );
+    }
+
+    tasks = calloc( numTasks, sizeof( tzVMTask * ) );
+    if( tasks == NULL )
+    {
+        fprintf( stderr, "Unable to allocate tasks\n" );
+        exit( 1 );
+    }
+
+    memset( &host, 0, sizeof( tzVMHost ) );
+    pthread_mutex_init( &host.lock, NULL );
+    pthread_cond_init( &host.ready, NULL );
+    pthread_cond_init( &host.done, NULL );
+    pthread_mutex_init( &host.routeLock, NULL );
+    host.epfd = -1;
+    host.timerfd = -1;
+    host.sigfd = -1;
+    host.verbose = options.verbose;
+    host.externCache = options.externCache;
+    host.quantum = options.quantum;
+    host.numWorkers = options.numWorkers;
+    if( host.numWorkers <= 0 )
+    {
+        host.numWorkers = sysconf( _SC_NPROCESSORS_ONLN );
+        if( host.numWorkers <= 0 )
+        {
+            host.numWorkers = 1;
+        }
+    }
+
+    /* the signals used by the VM cores must be blocked in every thread
+       before the worker threads are started */
+    BlockSignals( &host );
+
+    /* load all of the binary images before any of them are run */
+    result = 0;
+    for( i = 0; i < numTasks; i++ )
+    {
+        tasks[i] = CreateTask( &host, &options, argv[optind + i] );
+        if( tasks[i] == NULL )
+        {
+            result = 1;
+        }
+    }
+
+    if( StartWorkers( &host ) == EOK )
+    {
+        pthread_mutex_lock( &host.lock );
+        for( i = 0; i < numTasks; i++ )
+        {
+            if( tasks[i] != NULL )
+            {
+                host.pending++;
+                EnqueueTask( &host, tasks[i] );
+            }
+        }
+
+        /* wait for all of the programs to complete */
+        while( host.pending > 0 )
+        {
+            pthread_cond_wait( &host.done, &host.lock );
+        }
+        pthread_mutex_unlock( &host.lock );
+
+        StopWorkers( &host );
+    }
+    else
+    {
+        fprintf( stderr, "Unable to start worker threads\n" );
+        result = 1;
+    }
+
+    for( i = 0; i < numTasks; i++ )
+    {
+        if( tasks[i] != NULL )
+        {
+            if( tasks[i]->result == -1 )
+            {
+                fprintf( stderr, "Execution failed: %s\n", tasks[i]->filename );
+                result = 1;
+            }
+
+            DestroyTask( tasks[i] );
+        }
+    }
+
+    free( tasks );
+    free( host.pRoutes );
+    pthread_mutex_destroy( &host.routeLock );
+    pthread_cond_destroy( &host.done );
+    pthread_cond_destroy( &host.ready );
+    pthread_mutex_destroy( &host.lock );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  ProcessOptions                                                            */
+/*!
+    Process the command line options
+
+    The ProcessOptions function processes the command line options and
+    populates the tzVMOptions object
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @param[out]
+        pOptions
+            pointer to the tzVMOptions object to populate
+
+    @retval EOK options processed successfully
+
+==============================================================================*/
+static int ProcessOptions( int argc, char **argv, tzVMOptions *pOptions )
+{
+    int c;
+
+    pOptions->core_size = DEFAULT_CORE_SIZE;
+    pOptions->stack_size = DEFAULT_STACK_SIZE;
+    pOptions->externalsLib = NULL;
+    pOptions->engine = eCORE_ENGINE_DECODED;
+    pOptions->verify = true;
+    pOptions->verbose = false;
+    pOptions->externCache = false;
+    pOptions->numWorkers = 0;
+    pOptions->quantum = DEFAULT_QUANTUM;
+
+    while( ( c = getopt( argc, argv, "L:c:s:t:q:X:Chuv" ) ) != -1 )
+    {
+        switch( c )
+        {
+            case 'c':
+                pOptions->core_size = atol( optarg );
+                break;
+
+            case 's':
+                pOptions->stack_size = atol( optarg );
+                break;
+
+            case 't':
+                pOptions->numWorkers = atol( optarg );
+                break;
+
+            case 'q':
+                pOptions->quantum = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'v':
+                pOptions->verbose = true;
+                break;
+
+            case 'u':
+                pOptions->verify = false;
+                break;
+
+            case 'C':
+                pOptions->externCache = true;
+                break;
+
+            case 'L':
+                pOptions->externalsLib = optarg;
+                break;
+
+            case 'X':
+                if( strcmp( optarg, "threaded" ) == 0 )
+                {
+                    pOptions->engine = eCORE_ENGINE_THREADED;
+                }
+                else if( strcmp( optarg, "decoded" ) == 0 )
+                {
+                    pOptions->engine = eCORE_ENGINE_DECODED;
+                }
+                else if( strcmp( optarg, "jit" ) == 0 )
+                {
+                    pOptions->engine = eCORE_ENGINE_JIT;
+                }
+                else
+                {
+                    fprintf( stderr, "Invalid execution engine: %s\n", optarg );
+                    usage();
+                }
+                break;
+
+            case 'h':
+                usage();
+                break;
+
+        }
+    }
+
+    return EOK;
+}
+
+/*============================================================================*/
+/*  usage                                                                     */
+/*!
+    Program usage message
+
+    The usage function outputs the program usage message to stdout
+    and aborts the application
+
+==============================================================================*/
+void usage( void )
+{
+    printf( "usage: vmd [-c core size] [-s stack size] [-t worker threads]"
+            " [-q quantum] [-h] [-u] [-v] [-C] [-L externals lib name]"
+            " [-X decoded|threaded|jit]"
+            " <binary image>[:priority[:weight]] ...\n" );
+    exit( 0 );
+}
+
+/*============================================================================*/
+/*  CreateTask                                                                */
+/*!
+    Create a VM task for a binary image
+
+    The CreateTask function creates a VM core, routes its notification
+    signals through the host, initializes its externals library, and
+    loads and verifies the specified binary image into it.
+
+    The binary image name may be followed by the scheduling priority
+    and weight of the program, separated by colons, for example
+    validate.bin:7 or logger.bin:0:4
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        pOptions
+            pointer to the command line options
+
+    @param[in]
+        spec
+            name of the binary image to load, with optional priority
+            and weight
+
+    @retval pointer to the new VM task
+    @retval NULL the VM task could not be created
+
+==============================================================================*/
+static tzVMTask *CreateTask( tzVMHost *pHost,
+                             tzVMOptions *pOptions,
+                             char *spec )
+{
+    tzVMTask *pTask;
+    char *filename;
+    char *pPriority;
+    char *pWeight = NULL;
+    bool ok = false;
+
+    pTask = calloc( 1, sizeof( tzVMTask ) );
+    if( pTask != NULL )
+    {
+        /* split the priority and weight from the binary image name */
+        filename = spec;
+        pPriority = strchr( spec, ':' );
+        if( pPriority != NULL )
+        {
+            *pPriority++ = '\0';
+            pWeight = strchr( pPriority, ':' );
+            if( pWeight != NULL )
+            {
+                *pWeight++ = '\0';
+            }
+        }
+
+        pTask->filename = filename;
+        pTask->pHost = pHost;
+        pTask->result = -1;
+        pTask->priority = ( pPriority != NULL ) ? atoi( pPriority ) : 0;
+        pTask->weight = ( pWeight != NULL ) ? strtoul( pWeight, NULL, 0 ) : 1;
+        if( ( pTask->priority < 0 ) ||
+            ( pTask->priority >= VMD_NUM_PRIORITIES ) ||
+            ( pTask->weight == 0 ) )
+        {
+            fprintf( stderr, "Invalid priority or weight: %s\n", filename );
+            free( pTask );
+            return NULL;
+        }
+
+        pTask->pCore = CORE_fnCreate( pOptions->core_size,
+                                      pOptions->stack_size );
+        if( pTask->pCore == NULL )
+        {
+            fprintf( stderr, "Unable to create VM core\n" );
+        }
+        else if( CORE_fnSetEngine( pTask->pCore,
+                                   pOptions->engine ) != EOK )
+        {
+            fprintf( stderr, "Execution engine not supported\n" );
+        }
+        else
+        {
+            /* the notification signals are received by the event thread,
+               so the VM core must not open its own signalfd */
+            CORE_fnSetSignalRouter( pTask->pCore, RouteSignal, pTask );
+            CORE_fnInitExternalsLib( pTask->pCore, pOptions->externalsLib );
+
+            if( ( pOptions->externCache == true ) &&
+                ( CORE_fnEnableExternCache( pTask->pCore ) != EOK ) )
+            {
+                fprintf( stderr, "Unable to enable extern cache: %s\n",
+                         filename );
+            }
+
+            if( pOptions->verbose == true )
+            {
+                fprintf( stdout, "Loading program: %s\n", filename );
+            }
+
+            if( CORE_fnLoad( pTask->pCore, filename ) == false )
+            {
+                fprintf( stderr, "Program load failed: %s\n", filename );
+            }
+            else if( ( pOptions->verify == true ) &&
+                     ( CORE_fnVerify( pTask->pCore ) != EOK ) )
+            {
+                fprintf( stderr,
+                         "Program verification failed: %s\n",
+                         filename );
+            }
+            else
+            {
+                ok = true;
+            }
+        }
+
+        if( ok == false )
+        {
+            DestroyTask( pTask );
+            pTask = NULL;
+        }
+    }
+
+    return pTask;
+}
+
+/*============================================================================*/
+/*  DestroyTask                                                               */
+/*!
+    Destroy a VM task
+
+    The DestroyTask function shuts down the externals library of the
+    VM task, and releases its VM core.
+
+    @param[in]
+        pTask
+            pointer to the VM task to destroy
+
+==============================================================================*/
+static void DestroyTask( tzVMTask *pTask )
+{
+    if( pTask != NULL )
+    {
+        if( pTask->pCore != NULL )
+        {
+            CORE_fnShutdownExternalsLib( pTask->pCore );
+            CORE_fnDestroy( pTask->pCore );
+        }
+
+        free( pTask );
+    }
+}
+
+/*============================================================================*/
+/*  EnqueueTask                                                               */
+/*!
+    Add a VM task to the run queue
+
+    The EnqueueTask function adds a VM task to the tail of the run queue
+    for its priority, and wakes up a worker thread to run it.  The caller
+    must hold the host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        pTask
+            pointer to the VM task to add
+
+==============================================================================*/
+static void EnqueueTask( tzVMHost *pHost, tzVMTask *pTask )
+{
+    int priority = pTask->priority;
+
+    pTask->pNext = NULL;
+    if( pHost->pTail[priority] == NULL )
+    {
+        pHost->pHead[priority] = pTask;
+    }
+    else
+    {
+        pHost->pTail[priority]->pNext = pTask;
+    }
+
+    pHost->pTail[priority] = pTask;
+
+    pthread_cond_signal( &pHost->ready );
+}
+
+/*============================================================================*/
+/*  DequeueTask                                                               */
+/*!
+    Remove a VM task from the run queue
+
+    The DequeueTask function waits until a VM task is available in the
+    run queue, or the host is shutting down.  VM tasks are taken from the
+    highest priority run queue which is not empty.  The caller must hold
+    the host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @retval pointer to the next VM task to run
+    @retval NULL the host is shutting down
+
+==============================================================================*/
+static tzVMTask *DequeueTask( tzVMHost *pHost )
+{
+    tzVMTask *pTask = NULL;
+    int priority;
+
+    while( ( pTask == NULL ) && ( pHost->shutdown == false ) )
+    {
+        for( priority = VMD_NUM_PRIORITIES - 1;
+             ( pTask == NULL ) && ( priority >= 0 );
+             priority-- )
+        {
+            pTask = pHost->pHead[priority];
+            if( pTask != NULL )
+            {
+                pHost->pHead[priority] = pTask->pNext;
+                if( pHost->pHead[priority] == NULL )
+                {
+                    pHost->pTail[priority] = NULL;
+                }
+
+                pTask->pNext = NULL;
+            }
+        }
+
+        if( pTask == NULL )
+        {
+            pthread_cond_wait( &pHost->ready, &pHost->lock );
+        }
+    }
+
+    return pTask;
+}
+
+/*============================================================================*/
+/*  DelayTask                                                                 */
+/*!
+    Add a VM task to the delay queue
+
+    The DelayTask function adds a VM task which is suspended in a DLY
+    instruction to the delay queue, in order of the time when its delay
+    expires.  The host timer is re-armed when the task becomes the first
+    task in the delay queue.  The caller must hold the host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        pTask
+            pointer to the suspended VM task
+
+==============================================================================*/
+static void DelayTask( tzVMHost *pHost, tzVMTask *pTask )
+{
+    tzVMTask **ppTask;
+    uint32_t delay;
+
+    delay = CORE_fnGetDelay( pTask->pCore );
+
+    clock_gettime( CLOCK_MONOTONIC, &pTask->deadline );
+    pTask->deadline.tv_sec += delay / 1000;
+    pTask->deadline.tv_nsec += ( delay % 1000 ) * 1000000L;
+    if( pTask->deadline.tv_nsec >= 1000000000L )
+    {
+        pTask->deadline.tv_sec++;
+        pTask->deadline.tv_nsec -= 1000000000L;
+    }
+
+    /* tasks with the same deadline are resumed in the order they
+       were suspended */
+    ppTask = &pHost->pDelayed;
+    while( ( *ppTask != NULL ) &&
+           ( ( (*ppTask)->deadline.tv_sec < pTask->deadline.tv_sec ) ||
+             ( ( (*ppTask)->deadline.tv_sec == pTask->deadline.tv_sec ) &&
+               ( (*ppTask)->deadline.tv_nsec <= pTask->deadline.tv_nsec ) ) ) )
+    {
+        ppTask = &(*ppTask)->pNext;
+    }
+
+    pTask->pNext = *ppTask;
+    *ppTask = pTask;
+
+    if( pHost->pDelayed == pTask )
+    {
+        ArmTimer( pHost );
+    }
+}
+
+/*============================================================================*/
+/*  WaitTask                                                                  */
+/*!
+    Wait for the events of a VM task
+
+    The WaitTask function arms the event file descriptor of a VM task
+    which is suspended in a WFS instruction, so the event thread returns
+    the VM task to the run queue when one of its timers expires or one
+    of its notifications is received.  The event file descriptor is
+    registered once, as a one-shot event which is re-armed by each call.
+    The caller must hold the host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        pTask
+            pointer to the suspended VM task
+
+==============================================================================*/
+static void WaitTask( tzVMHost *pHost, tzVMTask *pTask )
+{
+    struct epoll_event ev;
+    int op;
+
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = pTask;
+
+    op = ( pTask->registered == true ) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if( epoll_ctl( pHost->epfd,
+                   op,
+                   CORE_fnGetEventFd( pTask->pCore ),
+                   &ev ) == 0 )
+    {
+        pTask->registered = true;
+    }
+    else
+    {
+        fprintf( stderr, "Unable to wait for events: %s\n", pTask->filename );
+        CompleteTask( pHost, pTask );
+        pTask->result = -1;
+    }
+}
+
+/*============================================================================*/
+/*  CompleteTask                                                              */
+/*!
+    Complete a VM task
+
+    The CompleteTask function records the result of a VM task whose
+    program has stopped, reports any events it lost because its ready
+    queue was full and its extern cache counters, and wakes up the main
+    thread.  The caller must
+    hold the host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        pTask
+            pointer to the completed VM task
+
+==============================================================================*/
+static void CompleteTask( tzVMHost *pHost, tzVMTask *pTask )
+{
+    unsigned int lost;
+
+    pTask->result = CORE_fnGetResult( pTask->pCore );
+
+    lost = CORE_fnGetEventOverflow( pTask->pCore );
+    if( lost > 0 )
+    {
+        fprintf( stderr, "%s: %u events lost\n", pTask->filename, lost );
+    }
+
+    if( ( pHost->verbose == true ) && ( pHost->externCache == true ) )
+    {
+        fprintf( stdout, "Extern cache of %s:\n", pTask->filename );
+        CORE_fnDumpExternCache( pTask->pCore, stdout );
+    }
+
+    pHost->pending--;
+    pthread_cond_signal( &pHost->done );
+}
+
+/*============================================================================*/
+/*  Worker                                                                    */
+/*!
+    Worker thread
+
+    The Worker function is the body of each worker thread.  It takes
+    VM tasks from the run queue and runs them until they stop, suspend,
+    or use their instruction budget.  Preempted VM tasks are returned to
+    the tail of their run queue, and suspended VM tasks are moved to the
+    delay queue or wait for their events.  The worker thread exits when the
+    host shuts down.
+
+    @param[in]
+        arg
+            pointer to the VM host
+
+    @retval NULL
+
+==============================================================================*/
+static void *Worker( void *arg )
+{
+    tzVMHost *pHost = (tzVMHost *)arg;
+    tzVMTask *pTask;
+    teCoreRunStatus status;
+
+    pthread_mutex_lock( &pHost->lock );
+    while( ( pTask = DequeueTask( pHost ) ) != NULL )
+    {
+        pthread_mutex_unlock( &pHost->lock );
+
+        if( ( pHost->verbose == true ) &&
+            ( pTask->started == false ) )
+        {
+            fprintf( stdout, "Executing program %s\n", pTask->filename );
+        }
+
+        pTask->started = true;
+
+        status = CORE_fnRun( pTask->pCore, pHost->quantum * pTask->weight );
+
+        pthread_mutex_lock( &pHost->lock );
+        switch( status )
+        {
+            case eCORE_RUN_BLOCKED_DELAY:
+                DelayTask( pHost, pTask );
+                break;
+
+            case eCORE_RUN_BLOCKED_SIGNAL:
+                WaitTask( pHost, pTask );
+                break;
+
+            case eCORE_RUN_PREEMPTED:
+                EnqueueTask( pHost, pTask );
+                break;
+
+            default:
+                CompleteTask( pHost, pTask );
+                break;
+        }
+    }
+    pthread_mutex_unlock( &pHost->lock );
+
+    return NULL;
+}
+
+/*============================================================================*/
+/*  EventThread                                                               */
+/*!
+    Event thread
+
+    The EventThread function is the body of the event thread.  It waits
+    for the host timer, which expires at the deadline of the first VM
+    task in the delay queue, and for the event file descriptors of the
+    VM tasks suspended in WFS.  Each VM task whose delay has expired or
+    whose event is ready is moved to the run queue, where CORE_fnRun
+    completes its WFS instruction with the received event.
+
+    It also waits for the notification signalfd of the host, and posts
+    the received notifications to the VM cores which requested them.
+    A suspended VM task is then resumed through its event file
+    descriptor.
+
+    @param[in]
+        arg
+            pointer to the VM host
+
+    @retval NULL
+
+==============================================================================*/
+static void *EventThread( void *arg )
+{
+    tzVMHost *pHost = (tzVMHost *)arg;
+    struct epoll_event evs[VMD_MAX_EVENTS];
+    tzVMTask *pTask;
+    bool running = true;
+    int n;
+    int i;
+
+    while( running == true )
+    {
+        n = epoll_wait( pHost->epfd, evs, VMD_MAX_EVENTS, -1 );
+
+        pthread_mutex_lock( &pHost->lock );
+        for( i = 0; i < n; i++ )
+        {
+            pTask = (tzVMTask *)evs[i].data.ptr;
+            if( pTask == NULL )
+            {
+                /* the host timer has expired */
+                ResumeDelayed( pHost );
+            }
+            else if( evs[i].data.ptr == (void *)pHost )
+            {
+                /* notification signals have been received */
+                ReadSignals( pHost );
+            }
+            else
+            {
+                EnqueueTask( pHost, pTask );
+            }
+        }
+
+        running = !pHost->shutdown;
+        pthread_mutex_unlock( &pHost->lock );
+    }
+
+    return NULL;
+}
+
+/*============================================================================*/
+/*  ResumeDelayed                                                             */
+/*!
+    Resume the delayed VM tasks
+
+    The ResumeDelayed function moves each VM task whose delay has expired
+    from the delay queue to the run queue, and re-arms the host timer for
+    the next deadline.  The caller must hold the host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+==============================================================================*/
+static void ResumeDelayed( tzVMHost *pHost )
+{
+    tzVMTask *pTask;
+    struct timespec now;
+    uint64_t expirations;
+
+    /* acknowledge the timer expiration, which may already have been
+       cleared by re-arming the timer */
+    if( read( pHost->timerfd, &expirations, sizeof( expirations ) ) == -1 )
+    {
+        expirations = 0;
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    while( ( ( pTask = pHost->pDelayed ) != NULL ) &&
+           ( ( pTask->deadline.tv_sec < now.tv_sec ) ||
+             ( ( pTask->deadline.tv_sec == now.tv_sec ) &&
+               ( pTask->deadline.tv_nsec <= now.tv_nsec ) ) ) )
+    {
+        pHost->pDelayed = pTask->pNext;
+        EnqueueTask( pHost, pTask );
+    }
+
+    if( pHost->pDelayed != NULL )
+    {
+        ArmTimer( pHost );
+    }
+}
+
+/*============================================================================*/
+/*  ArmTimer                                                                  */
+/*!
+    Arm the host timer
+
+    The ArmTimer function sets the host timer to expire at the deadline
+    of the first VM task in the delay queue.  The caller must hold the
+    host lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+==============================================================================*/
+static void ArmTimer( tzVMHost *pHost )
+{
+    struct itimerspec its;
+
+    memset( &its, 0, sizeof( its ) );
+    its.it_value = pHost->pDelayed->deadline;
+
+    timerfd_settime( pHost->timerfd, TFD_TIMER_ABSTIME, &its, NULL );
+}
+
+/*============================================================================*/
+/*  StartWorkers                                                              */
+/*!
+    Start the worker thread pool
+
+    The StartWorkers function creates the epoll instance, the timer and
+    the notification signalfd of the VM host, and starts the event
+    thread and the worker threads
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @retval EOK worker threads started
+    @retval ENOMEM memory allocation failure
+    @retval other the worker threads could not be created
+
+==============================================================================*/
+static int StartWorkers( tzVMHost *pHost )
+{
+    void *(*start)( void * );
+    struct epoll_event ev;
+    struct epoll_event sig;
+    long n;
+    int result = ENOMEM;
+
+    pHost->epfd = epoll_create1( EPOLL_CLOEXEC );
+    pHost->timerfd = timerfd_create( CLOCK_MONOTONIC,
+                                     TFD_NONBLOCK | TFD_CLOEXEC );
+
+    pHost->sigfd = signalfd( -1,
+                             &pHost->sigmask,
+                             SFD_NONBLOCK | SFD_CLOEXEC );
+
+    /* the host timer is identified by a NULL task */
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+
+    /* the notification signals are identified by the host */
+    sig.events = EPOLLIN;
+    sig.data.ptr = pHost;
+
+    /* the event thread is started first */
+    n = pHost->numWorkers + 1;
+    pHost->threads = calloc( n, sizeof( pthread_t ) );
+    if( pHost->threads == NULL )
+    {
+        StopWorkers( pHost );
+    }
+    else if( ( pHost->epfd == -1 ) ||
+             ( pHost->timerfd == -1 ) ||
+             ( pHost->sigfd == -1 ) ||
+             ( epoll_ctl( pHost->epfd,
+                          EPOLL_CTL_ADD,
+                          pHost->timerfd,
+                          &ev ) == -1 ) ||
+             ( epoll_ctl( pHost->epfd,
+                          EPOLL_CTL_ADD,
+                          pHost->sigfd,
+                          &sig ) == -1 ) )
+    {
+        result = errno;
+        StopWorkers( pHost );
+    }
+    else
+    {
+        result = EOK;
+        while( ( result == EOK ) && ( pHost->numThreads < n ) )
+        {
+            start = ( pHost->numThreads == 0 ) ? EventThread : Worker;
+
+            result = pthread_create( &pHost->threads[pHost->numThreads],
+                                     NULL,
+                                     start,
+                                     pHost );
+            if( result == EOK )
+            {
+                pHost->numThreads++;
+            }
+        }
+
+        if( result != EOK )
+        {
+            /* only stop the threads which were started */
+            StopWorkers( pHost );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  StopWorkers                                                               */
+/*!
+    Stop the worker thread pool
+
+    The StopWorkers function wakes up the threads of the VM host, waits
+    for them to exit, and releases the thread list, the timer, the
+    notification signalfd and the epoll instance.  The event thread is
+    woken up by expiring the host timer immediately.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+==============================================================================*/
+static void StopWorkers( tzVMHost *pHost )
+{
+    struct itimerspec its;
+    long i;
+
+    memset( &its, 0, sizeof( its ) );
+    its.it_value.tv_nsec = 1;
+
+    pthread_mutex_lock( &pHost->lock );
+    pHost->shutdown = true;
+    pthread_cond_broadcast( &pHost->ready );
+    if( pHost->timerfd != -1 )
+    {
+        timerfd_settime( pHost->timerfd, 0, &its, NULL );
+    }
+    pthread_mutex_unlock( &pHost->lock );
+
+    for( i = 0; i < pHost->numThreads; i++ )
+    {
+        pthread_join( pHost->threads[i], NULL );
+    }
+
+    free( pHost->threads );
+    pHost->threads = NULL;
+    pHost->numThreads = 0;
+
+    if( pHost->timerfd != -1 )
+    {
+        close( pHost->timerfd );
+        pHost->timerfd = -1;
+    }
+
+    if( pHost->sigfd != -1 )
+    {
+        close( pHost->sigfd );
+        pHost->sigfd = -1;
+    }
+
+    if( pHost->epfd != -1 )
+    {
+        close( pHost->epfd );
+        pHost->epfd = -1;
+    }
+}
+
+/*============================================================================*/
+/*  BlockSignals                                                              */
+/*!
+    Block the VM notification signals
+
+    The BlockSignals function blocks the real-time signals used for
+    external variable notifications [SIGRTMIN+6 .. SIGRTMIN+9] in the
+    calling thread.  The threads of the VM host inherit the signal mask,
+    so the signals are only received through the signalfd of the event
+    thread.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+==============================================================================*/
+static void BlockSignals( tzVMHost *pHost )
+{
+    int sig;
+
+    sigemptyset( &pHost->sigmask );
+    for( sig = VMD_SIG_MODIFIED; sig <= VMD_SIG_PRINT; sig++ )
+    {
+        sigaddset( &pHost->sigmask, sig );
+    }
+
+    pthread_sigmask( SIG_BLOCK, &pHost->sigmask, NULL );
+}
+
+/*============================================================================*/
+/*  RouteSignal                                                               */
+/*!
+    Route a notification signal to a VM task
+
+    The RouteSignal function is called by a VM core before it requests a
+    notification, and adds a route for the notification signal to the
+    VM task.  MODIFIED and CALC notifications are routed by their
+    variable handle to every VM task which requested them.  The VALIDATE
+    and PRINT notifications carry a session id rather than a variable
+    handle, so each of them is routed to the first VM task which
+    requested it.
+
+    @param[in]
+        pArg
+            pointer to the VM task
+
+    @param[in]
+        pCore
+            pointer to the VM core of the task
+
+    @param[in]
+        signum
+            notification signal number
+
+    @param[in]
+        id
+            handle of the external variable
+
+==============================================================================*/
+static void RouteSignal( void *pArg, tzCore *pCore, int signum, uint32_t id )
+{
+    tzVMTask *pTask = (tzVMTask *)pArg;
+
+    (void)pCore;
+
+    if( ( signum != VMD_SIG_MODIFIED ) && ( signum != VMD_SIG_CALC ) )
+    {
+        id = 0;
+    }
+
+    if( AddRoute( pTask->pHost, signum, id, pTask ) != EOK )
+    {
+        fprintf( stderr,
+                 "Unable to route notification: %s\n",
+                 pTask->filename );
+    }
+}
+
+/*============================================================================*/
+/*  AddRoute                                                                  */
+/*!
+    Add a notification route
+
+    The AddRoute function adds a route for the specified notification
+    signal and id to a VM task, unless the task already has one.  Only
+    one route is added for each session notification (id 0).
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        signum
+            notification signal number
+
+    @param[in]
+        id
+            variable handle, or 0 for a session notification
+
+    @param[in]
+        pTask
+            pointer to the VM task which requested the notification
+
+    @retval EOK the route was added
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int AddRoute( tzVMHost *pHost,
+                     int signum,
+                     uint32_t id,
+                     tzVMTask *pTask )
+{
+    tzVMRoute *pRoute;
+    size_t i;
+    int result = EOK;
+
+    pthread_mutex_lock( &pHost->routeLock );
+
+    /* keep the table at most half full */
+    if( ( pHost->usedRoutes + 1 ) * 2 > pHost->numRoutes )
+    {
+        result = GrowRoutes( pHost );
+    }
+
+    if( result == EOK )
+    {
+        i = HashRoute( signum, id, pHost->numRoutes );
+        pRoute = &pHost->pRoutes[i];
+        while( ( pRoute->signum != 0 ) &&
+               ( ( pRoute->signum != signum ) ||
+                 ( pRoute->id != id ) ||
+                 ( ( pRoute->pTask != pTask ) && ( id != 0 ) ) ) )
+        {
+            i = ( i + 1 ) & ( pHost->numRoutes - 1 );
+            pRoute = &pHost->pRoutes[i];
+        }
+
+        if( pRoute->signum == 0 )
+        {
+            pRoute->signum = signum;
+            pRoute->id = id;
+            pRoute->pTask = pTask;
+            pHost->usedRoutes++;
+        }
+    }
+
+    pthread_mutex_unlock( &pHost->routeLock );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  GrowRoutes                                                                */
+/*!
+    Grow the notification route table
+
+    The GrowRoutes function doubles the size of the notification route
+    table and re-inserts the existing routes.  The caller must hold the
+    route lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @retval EOK the route table was grown
+    @retval ENOMEM memory allocation failure
+
+==============================================================================*/
+static int GrowRoutes( tzVMHost *pHost )
+{
+    tzVMRoute *pRoutes;
+    size_t numRoutes;
+    size_t i;
+    size_t j;
+    int result = ENOMEM;
+
+    numRoutes = ( pHost->numRoutes == 0 ) ? VMD_MIN_ROUTES
+                                          : pHost->numRoutes * 2;
+
+    pRoutes = calloc( numRoutes, sizeof( tzVMRoute ) );
+    if( pRoutes != NULL )
+    {
+        for( i = 0; i < pHost->numRoutes; i++ )
+        {
+            if( pHost->pRoutes[i].signum != 0 )
+            {
+                j = HashRoute( pHost->pRoutes[i].signum,
+                               pHost->pRoutes[i].id,
+                               numRoutes );
+                while( pRoutes[j].signum != 0 )
+                {
+                    j = ( j + 1 ) & ( numRoutes - 1 );
+                }
+
+                pRoutes[j] = pHost->pRoutes[i];
+            }
+        }
+
+        free( pHost->pRoutes );
+        pHost->pRoutes = pRoutes;
+        pHost->numRoutes = numRoutes;
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  HashRoute                                                                 */
+/*!
+    Get the first route table entry of a notification
+
+    The HashRoute function hashes a notification signal number and id
+    to the index of the first route table entry to probe.
+
+    @param[in]
+        signum
+            notification signal number
+
+    @param[in]
+        id
+            variable handle, or 0 for a session notification
+
+    @param[in]
+        numRoutes
+            number of entries in the route table (a power of 2)
+
+    @retval index of the route table entry
+
+==============================================================================*/
+static size_t HashRoute( int signum, uint32_t id, size_t numRoutes )
+{
+    uint32_t hash;
+
+    hash = ( id * 2654435761U ) ^ (uint32_t)signum;
+
+    return (size_t)( hash & ( numRoutes - 1 ) );
+}
+
+/*============================================================================*/
+/*  ReadSignals                                                               */
+/*!
+    Read the received notification signals
+
+    The ReadSignals function drains the notification signals from the
+    signalfd of the host, reading up to VMD_READ_BATCH signals with each
+    read, and delivers each of them to the VM tasks which requested it.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+==============================================================================*/
+static void ReadSignals( tzVMHost *pHost )
+{
+    struct signalfd_siginfo info[VMD_READ_BATCH];
+    ssize_t rc;
+    size_t n;
+    size_t i;
+
+    do
+    {
+        rc = read( pHost->sigfd, info, sizeof( info ) );
+
+        /* the signalfd only returns whole signals */
+        n = ( rc > 0 ) ? (size_t)rc / sizeof( info[0] ) : 0;
+
+        pthread_mutex_lock( &pHost->routeLock );
+        for( i = 0; i < n; i++ )
+        {
+            DeliverSignal( pHost, info[i].ssi_signo, info[i].ssi_int );
+        }
+        pthread_mutex_unlock( &pHost->routeLock );
+    } while( n == VMD_READ_BATCH );
+}
+
+/*============================================================================*/
+/*  DeliverSignal                                                             */
+/*!
+    Deliver a notification signal
+
+    The DeliverSignal function posts a received notification signal to
+    the VM core of each VM task with a route for it.  A VM task which is
+    suspended in WFS is resumed through its event file descriptor.  The
+    caller must hold the route lock.
+
+    @param[in]
+        pHost
+            pointer to the VM host
+
+    @param[in]
+        signum
+            notification signal number
+
+    @param[in]
+        id
+            notification signal id
+
+==============================================================================*/
+static void DeliverSignal( tzVMHost *pHost, int signum, int id )
+{
+    tzVMRoute *pRoute;
+    uint32_t key;
+    size_t i;
+
+    key = ( ( signum == VMD_SIG_MODIFIED ) || ( signum == VMD_SIG_CALC ) )
+          ? (uint32_t)id
+          : 0;
+
+    if( pHost->numRoutes > 0 )
+    {
+        i = HashRoute( signum, key, pHost->numRoutes );
+        pRoute = &pHost->pRoutes[i];
+        while( pRoute->signum != 0 )
+        {
+            if( ( pRoute->signum == signum ) && ( pRoute->id == key ) )
+            {
+                /* a full ready queue is counted by the VM core */
+                (void)CORE_fnPostEvent( pRoute->pTask->pCore, signum, id );
+            }
+
+            i = ( i + 1 ) & ( pHost->numRoutes - 1 );
+            pRoute = &pHost->pRoutes[i];
+        }
+    }
+}
+
+/*! @}
+ * end of vmd group */